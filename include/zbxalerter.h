@@ -44,6 +44,19 @@ zbx_am_source_stats_t;
 
 ZBX_PTR_VECTOR_DECL(am_source_stats_ptr, zbx_am_source_stats_t *)
 
+/* upper bounds (in seconds) of alert queue latency histogram buckets, the last bucket is unbounded */
+#define ZBX_AM_LATENCY_BOUNDS		1, 5, 30, 60, 300
+#define ZBX_AM_LATENCY_BUCKETS_NUM	6
+
+typedef struct
+{
+	zbx_uint64_t	mediatypeid;
+	zbx_uint64_t	alerts_num[ZBX_AM_LATENCY_BUCKETS_NUM];
+}
+zbx_am_latency_stats_t;
+
+ZBX_PTR_VECTOR_DECL(am_latency_stats_ptr, zbx_am_latency_stats_t *)
+
 typedef struct
 {
 	char	*recipient;
@@ -92,6 +105,7 @@ ZBX_THREAD_ENTRY(zbx_alert_syncer_thread, args);
 int	zbx_alerter_get_diag_stats(zbx_uint64_t *alerts_num, char **error);
 int	zbx_alerter_get_top_mediatypes(int limit, zbx_vector_uint64_pair_t *mediatypes, char **error);
 int	zbx_alerter_get_top_sources(int limit, zbx_vector_am_source_stats_ptr_t *sources, char **error);
+int	zbx_alerter_get_diag_latency(zbx_vector_am_latency_stats_ptr_t *latencies, char **error);
 
 zbx_uint32_t	zbx_alerter_serialize_alert_send(unsigned char **data, zbx_uint64_t mediatypeid, unsigned char type,
 		const char *smtp_server, const char *smtp_helo, const char *smtp_email, const char *exec_path,
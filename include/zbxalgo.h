@@ -288,6 +288,62 @@ void			zbx_binary_heap_remove_direct(zbx_binary_heap_t *heap, zbx_uint64_t key);
 
 void			zbx_binary_heap_clear(zbx_binary_heap_t *heap);
 
+/* hierarchical timer wheel */
+
+/* Timer wheel stores elements scheduled at whole seconds. Elements are linked in per second slots */
+/* of 4 levels with 256 slots each - the first level covers the current 256 seconds, the next      */
+/* levels cover 256 times longer periods and are cascaded down when the wheel time advances. Due   */
+/* elements are moved to pairing heap, ordered by the specified compare function, which must order */
+/* elements by their scheduled time first. The compare function is called with binary heap         */
+/* elements, having data set to the wheel elements.                                                */
+/*                                                                                                 */
+/* Both slot lists and due heap are linked through the nodes embedded in the elements, so memory   */
+/* is allocated only when the wheel is created. Timer wheel is not thread safe, but operations on  */
+/* different wheels need no serialization with each other or with the wheel allocator.             */
+
+#define ZBX_TIMER_WHEEL_LEVELS		4
+#define ZBX_TIMER_WHEEL_SLOTS		256
+
+typedef struct zbx_timer_wheel_node
+{
+	/* in due heap the previous node is the previous sibling or the parent of the first child */
+	struct zbx_timer_wheel_node	*prev;
+	struct zbx_timer_wheel_node	*next;
+	struct zbx_timer_wheel_node	*child;		/* the first child in due heap */
+	void				*data;
+	int				time;
+	int				slot;
+}
+zbx_timer_wheel_node_t;
+
+typedef struct
+{
+	zbx_timer_wheel_node_t	**slots;
+	int			slots_num[ZBX_TIMER_WHEEL_LEVELS];	/* number of nodes in each level */
+	int			time;					/* elements scheduled before this */
+									/* time are in due heap           */
+	zbx_timer_wheel_node_t	*due;					/* root of due heap               */
+	int			due_num;
+	zbx_compare_func_t	compare_func;
+
+	zbx_mem_malloc_func_t	mem_malloc_func;
+	zbx_mem_free_func_t	mem_free_func;
+}
+zbx_timer_wheel_t;
+
+void	zbx_timer_wheel_create_ext(zbx_timer_wheel_t *wheel, zbx_compare_func_t compare_func,
+		zbx_mem_malloc_func_t mem_malloc_func, zbx_mem_free_func_t mem_free_func);
+void	zbx_timer_wheel_destroy(zbx_timer_wheel_t *wheel);
+
+void	zbx_timer_wheel_insert(zbx_timer_wheel_t *wheel, zbx_timer_wheel_node_t *node, void *data, int time);
+void	zbx_timer_wheel_update(zbx_timer_wheel_t *wheel, zbx_timer_wheel_node_t *node, int time);
+void	zbx_timer_wheel_remove(zbx_timer_wheel_t *wheel, zbx_timer_wheel_node_t *node);
+void	zbx_timer_wheel_advance(zbx_timer_wheel_t *wheel, int now);
+void	*zbx_timer_wheel_find_min(const zbx_timer_wheel_t *wheel);
+void	zbx_timer_wheel_remove_min(zbx_timer_wheel_t *wheel);
+int	zbx_timer_wheel_get_nexttime(const zbx_timer_wheel_t *wheel);
+int	zbx_timer_wheel_size(const zbx_timer_wheel_t *wheel);
+
 /* vector implementation start */
 
 #define ZBX_VECTOR_STRUCT_DECL(__id, __type)									\
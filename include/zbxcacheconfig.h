@@ -317,6 +317,7 @@ ZBX_PTR_VECTOR_DECL(item_tag, zbx_item_tag_t *)
 typedef struct _DC_TRIGGER
 {
 	zbx_uint64_t		triggerid;
+	zbx_uint64_t		revision;
 	char			*description;
 	char			*expression;
 	char			*recovery_expression;
@@ -673,6 +674,8 @@ typedef struct
 	zbx_list_t		data_point_link_queue;
 	int			time_flush;
 	int			senders;
+	int			queued_values_num;
+	size_t			queued_bytes;
 
 	int			item_value_type;
 	char			*attempt_interval;
@@ -717,6 +720,7 @@ typedef struct
 {
 	zbx_uint64_t			druleid;
 	zbx_uint64_t			proxyid;
+	zbx_timer_wheel_node_t		queue_node;
 	time_t				nextcheck;
 	int				delay;
 	char				*delay_str;
@@ -775,6 +779,7 @@ typedef struct zbx_um_cache zbx_um_cache_t;
 zbx_uint64_t	zbx_dc_sync_configuration(unsigned char mode, zbx_synced_new_config_t synced,
 		zbx_vector_uint64_t *deleted_itemids, const zbx_config_vault_t *config_vault,
 		int proxyconfig_frequency);
+void	zbx_dc_set_snapshot_file(const char *path);
 void	zbx_dc_sync_kvs_paths(const struct zbx_json_parse *jp_kvs_paths, const zbx_config_vault_t *config_vault,
 		const char *config_source_ip, const char *config_ssl_ca_location, const char *config_ssl_cert_location,
 		const char *config_ssl_key_location);
@@ -931,6 +936,26 @@ int	zbx_dc_get_host_inventory_value_by_hostid(zbx_uint64_t hostid, char **replac
 #define ZBX_CONFSTATS_BUFFER_PFREE	5
 void	*zbx_dc_config_get_stats(int request);
 
+typedef struct
+{
+	zbx_uint64_t	rdlock_num;
+	zbx_uint64_t	wrlock_num;
+	double		rdlock_wait;
+	double		wrlock_wait;
+}
+zbx_dc_lock_stats_t;
+
+void	zbx_dc_config_get_lock_stats(zbx_dc_lock_stats_t *stats);
+
+typedef struct
+{
+	zbx_uint64_t	hits;
+	zbx_uint64_t	misses;
+}
+zbx_dc_um_memo_stats_t;
+
+void	zbx_dc_config_get_um_memo_stats(zbx_dc_um_memo_stats_t *stats);
+
 int	zbx_dc_config_get_last_sync_time(void);
 int	zbx_dc_config_get_proxypoller_hosts(zbx_dc_proxy_t *proxies, int max_hosts);
 int	zbx_dc_config_get_proxypoller_nextcheck(void);
@@ -1032,6 +1057,12 @@ void	zbx_dc_correlation_rules_get(zbx_correlation_rules_t *rules);
 
 void	zbx_dc_get_nested_hostgroupids(zbx_uint64_t *groupids, int groupids_num, zbx_vector_uint64_t *nested_groupids);
 void	zbx_dc_get_hostids_by_group_name(const char *name, zbx_vector_uint64_t *hostids);
+void	zbx_dc_get_triggers_by_hostgroup(const zbx_vector_uint64_t *triggerids, zbx_uint64_t groupid,
+		zbx_vector_uint64_t *matched_triggerids);
+void	zbx_dc_get_triggers_by_template(const zbx_vector_uint64_t *triggerids, zbx_uint64_t templateid,
+		zbx_vector_uint64_t *matched_triggerids);
+void	zbx_dc_get_triggers_by_parent(const zbx_vector_uint64_t *triggerids, zbx_uint64_t parent_triggerid,
+		zbx_vector_uint64_t *matched_triggerids);
 
 void	zbx_free_item_tag(zbx_item_tag_t *item_tag);
 
@@ -48,6 +48,16 @@ typedef struct
 }
 zbx_dc_stats_t;
 
+/* the trigger processing statistics */
+typedef struct
+{
+	zbx_uint64_t	triggers_num;		/* the number of processed triggers */
+	zbx_uint64_t	deserialized_num;	/* the number of deserialized trigger expressions */
+	zbx_uint64_t	cached_num;		/* the number of trigger expressions copied from cache */
+	double		time;			/* the time spent processing triggers */
+}
+zbx_hc_trigger_stats_t;
+
 /* the write cache statistics */
 typedef struct
 {
@@ -157,6 +167,8 @@ zbx_uint64_t	zbx_dc_get_nextid(const char *table_name, int num);
 void	zbx_dc_update_interfaces_availability(void);
 void	zbx_hc_get_diag_stats(zbx_uint64_t *items_num, zbx_uint64_t *values_num);
 void	zbx_hc_get_mem_stats(zbx_shmem_stats_t *data, zbx_shmem_stats_t *index);
+void	zbx_hc_add_trigger_stats(const zbx_hc_trigger_stats_t *stats);
+void	zbx_hc_get_trigger_stats(zbx_hc_trigger_stats_t *stats, double *time_start);
 void	zbx_hc_get_items(zbx_vector_uint64_pair_t *items);
 int	zbx_db_trigger_queue_locked(void);
 void	zbx_db_trigger_queue_unlock(void);
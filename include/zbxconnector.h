@@ -71,11 +71,12 @@ void	zbx_connector_deserialize_object(const unsigned char *data, zbx_uint32_t si
 		zbx_vector_connector_object_t *connector_objects);
 void	zbx_connector_object_free(zbx_connector_object_t connector_object);
 void	zbx_connector_serialize_connector(unsigned char **data, size_t *data_alloc, size_t *data_offset,
-		const zbx_connector_t *connector);
+		zbx_uint64_t taskid, const zbx_connector_t *connector);
 void	zbx_connector_serialize_data_point(unsigned char **data, size_t *data_alloc, size_t *data_offset,
 		const zbx_connector_data_point_t *connector_data_point);
 void	zbx_connector_deserialize_connector_and_data_point(const unsigned char *data, zbx_uint32_t size,
-		zbx_connector_t *connector, zbx_vector_connector_data_point_t *connector_data_points);
+		zbx_uint64_t *taskid, zbx_connector_t *connector,
+		zbx_vector_connector_data_point_t *connector_data_points);
 void	zbx_connector_data_point_free(zbx_connector_data_point_t connector_data_point);
 
 int		zbx_connector_get_diag_stats(zbx_uint64_t *queued, char **error);
@@ -75,6 +75,9 @@ int	zbx_curl_has_bearer(char **error);
 int	zbx_curl_has_smtp_auth(char **error);
 int	zbx_curl_good_for_elasticsearch(char **error);
 
+void	zbx_curl_setopt_multiplex(CURL *easyhandle);
+void	zbx_curl_multi_setopt_multiplex(CURLM *multi_handle);
+
 #endif /* HAVE_LIBCURL */
 
 #endif /* ZABBIX_CURL_H */
@@ -146,6 +146,7 @@ zbx_escape_sequence_t;
 
 #define ZBX_SQL_LIKE_ESCAPE_CHAR '!'
 char		*zbx_db_dyn_escape_like_pattern(const char *src);
+int		zbx_db_like_match(const char *value, const char *pattern);
 
 size_t		zbx_db_strlen_n(const char *text_loc, size_t maxlen);
 
@@ -385,6 +386,10 @@ char	*zbx_db_get_schema_esc(void);
 int	zbx_dbconn_execute_overflowed_sql(zbx_dbconn_t *db, char **sql, size_t *sql_alloc, size_t *sql_offset);
 int	zbx_dbconn_flush_overflowed_sql(zbx_dbconn_t *db, char *sql, size_t sql_offset);
 
+int	zbx_dbconn_pipeline_begin(zbx_dbconn_t *db);
+int	zbx_dbconn_pipeline_end(zbx_dbconn_t *db);
+int	zbx_dbconn_pipeline_execute_sql(zbx_dbconn_t *db, char **sql, size_t *sql_alloc, size_t *sql_offset);
+
 const char	*zbx_db_sql_id_ins(zbx_uint64_t id);
 const char	*zbx_db_sql_id_cmp(zbx_uint64_t id);
 
@@ -395,6 +400,7 @@ void	zbx_db_check_character_set(void);
 void	zbx_db_init_autoincrement_options(void);
 int	zbx_db_connect(int flag);
 void	zbx_db_close(void);
+int	zbx_db_set_connect_options(int flag);
 void	zbx_db_begin(void);
 int	zbx_db_commit(void);
 void	zbx_db_rollback(void);
@@ -416,6 +422,9 @@ int	zbx_db_lock_ids(const char *table_name, const char *field_name, zbx_vector_u
 int	zbx_db_check_extension(struct zbx_db_version_info_t *info, int allow_unsupported);
 int	zbx_db_flush_overflowed_sql(char *sql, size_t sql_offset);
 int	zbx_db_execute_overflowed_sql(char **sql, size_t *sql_alloc, size_t *sql_offset);
+int	zbx_db_pipeline_begin(void);
+int	zbx_db_pipeline_end(void);
+int	zbx_db_pipeline_execute_sql(char **sql, size_t *sql_alloc, size_t *sql_offset);
 int	zbx_db_table_exists(const char *table_name);
 int	zbx_db_field_exists(const char *table_name, const char *field_name);
 #if !defined(HAVE_SQLITE3)
@@ -39,6 +39,7 @@ int		zbx_es_compile(zbx_es_t *es, const char *script, char **code, int *size, ch
 int		zbx_es_execute(zbx_es_t *es, const char *script, const char *code, int size, const char *param,
 		char **script_ret, char **error);
 void		zbx_es_set_timeout(zbx_es_t *es, int timeout);
+void		zbx_es_get_heap_stats(const zbx_es_t *es, zbx_uint64_t *used, zbx_uint64_t *peak);
 void		zbx_es_debug_enable(zbx_es_t *es);
 void		zbx_es_debug_disable(zbx_es_t *es);
 const char	*zbx_es_debug_info(const zbx_es_t *es);
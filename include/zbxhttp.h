@@ -99,6 +99,8 @@ int	zbx_http_request_prepare(zbx_http_context_t *context, unsigned char request_
 		const char *config_ssl_ca_location, const char *config_ssl_cert_location,
 		const char *config_ssl_key_location, char **error);
 
+int	zbx_http_request_check_attempt(CURL *easyhandle, zbx_http_context_t *context, CURLcode *err,
+		int check_response_code);
 CURLcode	zbx_http_request_sync_perform(CURL *easyhandle, zbx_http_context_t *context, int attempt_interval,
 		int check_response_code);
 int	zbx_http_handle_response(CURL *easyhandle, zbx_http_context_t *context, CURLcode err, long *response_code,
@@ -30,6 +30,8 @@ typedef HANDLE zbx_mutex_t;
 #	define zbx_mutex_lock(mutex)		__zbx_mutex_lock(__FILE__, __LINE__, mutex)
 #	define zbx_mutex_unlock(mutex)		__zbx_mutex_unlock(__FILE__, __LINE__, mutex)
 #else	/* not _WINDOWS */
+#define ZBX_MUTEX_CONFIG_QUEUE_NUM	12	/* must match number of poller types */
+
 typedef enum
 {
 	ZBX_MUTEX_LOG = 0,
@@ -52,6 +54,9 @@ typedef enum
 	ZBX_MUTEX_REMOTE_COMMANDS,
 	ZBX_MUTEX_PROXY_BUFFER,
 	ZBX_MUTEX_VPS_MONITOR,
+	/* configuration cache poller queue mutexes, one per poller type */
+	ZBX_MUTEX_CONFIG_QUEUE,
+	ZBX_MUTEX_CONFIG_QUEUE_LAST = ZBX_MUTEX_CONFIG_QUEUE + ZBX_MUTEX_CONFIG_QUEUE_NUM - 1,
 	/* NOTE: Do not forget to sync changes here with mutex names in diag_add_locks_info()! */
 	ZBX_MUTEX_COUNT
 }
@@ -104,7 +104,10 @@ char	*zbx_async_check_snmp_get_reverse_dns(zbx_snmp_context_t *snmp_context);
 void	zbx_async_check_snmp_clean(zbx_snmp_context_t *snmp_context);
 int	zbx_async_check_snmp(zbx_dc_item_t *item, AGENT_RESULT *result, zbx_async_task_clear_cb_t clear_cb,
 		void *arg, void *arg_action, struct event_base *base, struct evdns_base *dnsbase,
-		const char *config_source_ip, zbx_async_resolve_reverse_dns_t resolve_reverse_dns, int retries);
+		const char *config_source_ip, zbx_async_resolve_reverse_dns_t resolve_reverse_dns, int retries,
+		zbx_dc_item_t **shared_items, int shared_items_num);
+void	zbx_async_check_snmp_fan_out(zbx_snmp_context_t *snmp_context, zbx_dc_item_context_t **items,
+		int *items_num);
 
 void	zbx_set_snmp_bulkwalk_options(const char *progname);
 #endif
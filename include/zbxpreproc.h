@@ -99,6 +99,18 @@ zbx_pp_sequence_stats_t;
 
 ZBX_PTR_VECTOR_DECL(pp_sequence_stats_ptr, zbx_pp_sequence_stats_t *)
 
+typedef struct
+{
+	zbx_uint64_t	itemid;		/* the last item that executed the script */
+	zbx_uint64_t	executions;
+	zbx_uint64_t	failures;
+	zbx_uint64_t	heap_peak;	/* peak scripting engine heap usage */
+	double		time;		/* total execution time in seconds */
+}
+zbx_pp_script_stats_t;
+
+ZBX_PTR_VECTOR_DECL(pp_script_stats_ptr, zbx_pp_script_stats_t *)
+
 int	zbx_diag_add_preproc_info(const struct zbx_json_parse *jp, struct zbx_json *json, char **error);
 void zbx_preproc_stats_ext_get(struct zbx_json *json, const void *arg);
 zbx_uint64_t	zbx_preprocessor_get_queue_size(void);
@@ -109,6 +121,7 @@ void	zbx_preprocessor_flush(void);
 int	zbx_preprocessor_get_diag_stats(zbx_uint64_t *preproc_num, zbx_uint64_t *pending_num,
 		zbx_uint64_t *finished_num, zbx_uint64_t *sequences_num, char **error);
 int	zbx_preprocessor_get_top_sequences(int limit, zbx_vector_pp_sequence_stats_ptr_t *sequences, char **error);
+int	zbx_preprocessor_get_top_scripts(int limit, zbx_vector_pp_script_stats_ptr_t *scripts, char **error);
 int	zbx_preprocessor_test(unsigned char value_type, const char *value, const zbx_timespec_t *ts,
 		unsigned char state, const zbx_vector_pp_step_ptr_t *steps, zbx_vector_pp_result_ptr_t *results,
 		zbx_pp_history_t *history, char **error);
@@ -107,6 +107,10 @@ void	zbx_free_key_access_rules(void);
 int	zbx_execute_agent_check(const char *in_command, unsigned flags, AGENT_RESULT *result, int timeout);
 
 void	zbx_set_user_parameter_dir(const char *path);
+
+#define ZBX_PROC_SNAPSHOT_TTL_DEFAULT	1
+#define ZBX_PROC_SNAPSHOT_TTL_MAX	SEC_PER_MIN
+void	zbx_set_proc_snapshot_ttl(int ttl);
 int	zbx_add_user_parameter(const char *itemkey, char *command, char *error, size_t max_error_len);
 void	zbx_remove_user_parameters(void);
 void	zbx_get_metrics_copy(zbx_metric_t **metrics);
@@ -95,6 +95,7 @@ typedef struct
 zbx_thread_args_t;
 
 void	zbx_thread_start(ZBX_THREAD_ENTRY_POINTER(handler), zbx_thread_args_t *thread_args, ZBX_THREAD_HANDLE *thread);
+const zbx_thread_info_t	*zbx_get_thread_info(void);
 int	zbx_thread_wait(ZBX_THREAD_HANDLE thread);
 void	zbx_threads_kill_and_wait(ZBX_THREAD_HANDLE *threads, const int *threads_flags, int threads_num, int ret);
 
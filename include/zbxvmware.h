@@ -595,6 +595,9 @@ typedef struct
 	zbx_hashset_t			strpool;
 	zbx_uint64_t			strpool_sz;
 	zbx_binary_heap_t		jobs_queue;
+	double				lock_wait;
+	zbx_uint64_t			lock_num;
+	int				lock_stats;
 }
 zbx_vmware_t;
 
@@ -603,6 +606,8 @@ typedef struct
 {
 	zbx_uint64_t	memory_used;
 	zbx_uint64_t	memory_total;
+	double		lock_wait;
+	zbx_uint64_t	lock_num;
 }
 zbx_vmware_stats_t;
 
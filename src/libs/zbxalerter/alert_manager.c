@@ -57,6 +57,9 @@
 
 #define ZBX_MEDIA_MESSAGE_FORMAT_DEFAULT	255
 
+/* retry burst size of media types with unlimited concurrent sessions */
+#define ZBX_AM_RETRY_BURST_UNLIMITED		100
+
 /*
  * The alert queue is implemented as a nested queue.
  *
@@ -89,6 +92,10 @@
  *       was not removed
  *    5) release media type object, put it back into media types queue if the media type object
  *       was not removed
+ *
+ * Failed alerts are not retried all at once after media type attempt interval. Retries are shaped
+ * with a token bucket per media type, releasing at most maxsessions (or ZBX_AM_RETRY_BURST_UNLIMITED
+ * for unlimited sessions) retries per attempt interval.
  */
 
 typedef char * zbx_shared_str_t;
@@ -905,6 +912,43 @@ static void	am_remove_alert(zbx_am_t *manager, zbx_am_alert_t *alert)
 	manager->alerts_num--;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: calculates time of the next alert retry                           *
+ *                                                                            *
+ * Parameters: mediatype - [IN/OUT]                                           *
+ *             now       - [IN] current timestamp                             *
+ *                                                                            *
+ * Return value: The retry time.                                              *
+ *                                                                            *
+ * Comments: Retries are shaped with a token bucket, refilled with burst      *
+ *           tokens per attempt interval and holding at most burst tokens.    *
+ *           The bucket is tracked by theoretical arrival time of the next    *
+ *           retry - a retry can be sent when it is not earlier than the      *
+ *           bucket capacity before the theoretical arrival time.             *
+ *                                                                            *
+ ******************************************************************************/
+static int	am_schedule_retry(zbx_am_mediatype_t *mediatype, int now)
+{
+	int	burst;
+	double	interval, sendtime, tat_limit;
+
+	sendtime = now + mediatype->attempt_interval;
+
+	if (0 == mediatype->attempt_interval)
+		return (int)sendtime;
+
+	burst = (0 != mediatype->maxsessions ? mediatype->maxsessions : ZBX_AM_RETRY_BURST_UNLIMITED);
+	interval = (double)mediatype->attempt_interval / burst;
+
+	if (sendtime < (tat_limit = mediatype->retry_tat - (burst - 1) * interval))
+		sendtime = tat_limit;
+
+	mediatype->retry_tat = MAX(sendtime, mediatype->retry_tat) + interval;
+
+	return (int)ceil(sendtime);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: retries alert if there are attempts left or removes it            *
@@ -931,7 +975,7 @@ static int	am_retry_alert(zbx_am_t *manager, zbx_am_alert_t *alert)
 	if (++alert->retries >= mediatype->maxattempts)
 		goto out;
 
-	alert->nextsend = time(NULL) + mediatype->attempt_interval;
+	alert->nextsend = am_schedule_retry(mediatype, time(NULL));
 
 	alertpool = am_get_alertpool(manager, alert->mediatypeid, alert->alertpoolid);
 
@@ -1237,6 +1281,26 @@ static void	am_db_update_alert(zbx_am_t *manager, zbx_am_alert_t *alert, int sta
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: updates media type alert queue latency histogram                  *
+ *                                                                            *
+ * Parameters: mediatype - [IN/OUT]                                           *
+ *             alert     - [IN] alert being sent                              *
+ *             now       - [IN] current timestamp                             *
+ *                                                                            *
+ ******************************************************************************/
+static void	am_update_latency(zbx_am_mediatype_t *mediatype, const zbx_am_alert_t *alert, int now)
+{
+	static const int	bounds[] = {ZBX_AM_LATENCY_BOUNDS};
+	int			i, latency = now - alert->nextsend;
+
+	for (i = 0; i < (int)ARRSIZE(bounds) && latency > bounds[i]; i++)
+		;
+
+	mediatype->latency[i]++;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: sends response to external alert request                          *
@@ -1502,6 +1566,8 @@ static int	am_process_alert(zbx_am_t *manager, zbx_am_alerter_t *alerter, zbx_am
 		goto out;
 	}
 
+	am_update_latency(mediatype, alert, time(NULL));
+
 	switch (mediatype->type)
 	{
 		case MEDIA_TYPE_EMAIL:
@@ -2194,6 +2260,50 @@ static void	am_process_diag_top_mediatypes(zbx_am_t *manager, zbx_ipc_client_t *
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: processes alert queue latency histogram request                   *
+ *                                                                            *
+ * Parameters: manager - [IN]                                                 *
+ *             client  - [IN] connected worker IPC client data                *
+ *                                                                            *
+ ******************************************************************************/
+static void	am_process_diag_latency(zbx_am_t *manager, zbx_ipc_client_t *client)
+{
+	unsigned char			*data;
+	zbx_uint32_t			data_len;
+	zbx_vector_am_mediatype_ptr_t	view;
+	zbx_hashset_iter_t		iter;
+	zbx_am_mediatype_t		*mediatype;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
+
+	zbx_vector_am_mediatype_ptr_create(&view);
+
+	zbx_hashset_iter_reset(&manager->mediatypes, &iter);
+	while (NULL != (mediatype = (zbx_am_mediatype_t *)zbx_hashset_iter_next(&iter)))
+	{
+		for (int i = 0; i < ZBX_AM_LATENCY_BUCKETS_NUM; i++)
+		{
+			if (0 != mediatype->latency[i])
+			{
+				zbx_vector_am_mediatype_ptr_append(&view, mediatype);
+				break;
+			}
+		}
+	}
+
+	zbx_vector_am_mediatype_ptr_sort(&view, ZBX_DEFAULT_UINT64_PTR_COMPARE_FUNC);
+
+	data_len = zbx_alerter_serialize_diag_latency(&data, view.values, view.values_num);
+	zbx_ipc_client_send(client, ZBX_IPC_ALERTER_DIAG_LATENCY_RESULT, data, data_len);
+	zbx_free(data);
+
+	zbx_vector_am_mediatype_ptr_destroy(&view);
+
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
+}
+
 /* alert source hashset support */
 
 static zbx_hash_t	am_source_hash_func(const void *data)
@@ -2474,6 +2584,9 @@ ZBX_THREAD_ENTRY(zbx_alert_manager_thread, args)
 				case ZBX_IPC_ALERTER_DIAG_TOP_SOURCES:
 					am_process_diag_top_sources(&manager, client, message);
 					break;
+				case ZBX_IPC_ALERTER_DIAG_LATENCY:
+					am_process_diag_latency(&manager, client);
+					break;
 				case ZBX_IPC_ALERTER_BEGIN_DISPATCH:
 					am_process_begin_dispatch(client, message->data);
 					break;
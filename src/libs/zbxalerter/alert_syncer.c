@@ -746,6 +746,76 @@ static void	am_service_add_event_tags(zbx_vector_events_tags_t *events_tags)
 	zbx_free(data);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: compares alert results by the updated alert status fields         *
+ *                                                                            *
+ ******************************************************************************/
+static int	am_result_compare_status(const void *d1, const void *d2)
+{
+	const zbx_am_result_t	*r1 = *(const zbx_am_result_t * const *)d1;
+	const zbx_am_result_t	*r2 = *(const zbx_am_result_t * const *)d2;
+
+	ZBX_RETURN_IF_NOT_EQUAL(r1->status, r2->status);
+	ZBX_RETURN_IF_NOT_EQUAL(r1->retries, r2->retries);
+
+	return strcmp(ZBX_NULL2EMPTY_STR(r1->error), ZBX_NULL2EMPTY_STR(r2->error));
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: adds alert status update statements to sql buffer                 *
+ *                                                                            *
+ * Parameters: results     - [IN] alert results sorted by status fields       *
+ *             results_num - [IN]                                             *
+ *             sql         - [IN/OUT] sql buffer                              *
+ *             sql_alloc   - [IN/OUT]                                         *
+ *             sql_offset  - [IN/OUT]                                         *
+ *                                                                            *
+ * Comments: Alerts with the same status, retries and error are updated with  *
+ *           a single statement.                                              *
+ *                                                                            *
+ ******************************************************************************/
+static void	am_db_update_alert_statuses(zbx_am_result_t **results, int results_num, char **sql,
+		size_t *sql_alloc, size_t *sql_offset)
+{
+	zbx_vector_uint64_t	alertids;
+
+	zbx_vector_uint64_create(&alertids);
+
+	for (int i = 0, j; i < results_num; i = j)
+	{
+		zbx_vector_uint64_clear(&alertids);
+
+		for (j = i; j < results_num && 0 == am_result_compare_status(&results[i], &results[j]); j++)
+			zbx_vector_uint64_append(&alertids, results[j]->alertid);
+
+		zbx_snprintf_alloc(sql, sql_alloc, sql_offset, "update alerts set status=%d,retries=%d",
+				results[i]->status, results[i]->retries);
+
+		if (NULL != results[i]->error)
+		{
+			char	*error_esc;
+
+			error_esc = zbx_db_dyn_escape_field("alerts", "error", results[i]->error);
+			zbx_snprintf_alloc(sql, sql_alloc, sql_offset, ",error='%s'", error_esc);
+			zbx_free(error_esc);
+		}
+		else
+			zbx_strcpy_alloc(sql, sql_alloc, sql_offset, ",error=''");
+
+		zbx_strcpy_alloc(sql, sql_alloc, sql_offset, " where");
+		zbx_vector_uint64_sort(&alertids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+		zbx_db_add_condition_alloc(sql, sql_alloc, sql_offset, "alertid", alertids.values,
+				alertids.values_num);
+		zbx_strcpy_alloc(sql, sql_alloc, sql_offset, ";\n");
+
+		zbx_db_execute_overflowed_sql(sql, sql_alloc, sql_offset);
+	}
+
+	zbx_vector_uint64_destroy(&alertids);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: flushes alert results to database                                 *
@@ -774,9 +844,15 @@ static int	am_db_flush_results(zbx_hashset_t *mediatypes, const unsigned char *d
 		char		*sql;
 		size_t		sql_alloc = results_num * 128, sql_offset;
 		zbx_db_insert_t	db_event, db_problem;
+		zbx_am_result_t	**results_status;
 
 		sql = (char *)zbx_malloc(NULL, sql_alloc);
 
+		/* results are received sorted by alertid, group them by status to reduce update statements */
+		results_status = (zbx_am_result_t **)zbx_malloc(NULL, sizeof(zbx_am_result_t *) * results_num);
+		memcpy(results_status, results, sizeof(zbx_am_result_t *) * results_num);
+		qsort(results_status, results_num, sizeof(zbx_am_result_t *), am_result_compare_status);
+
 		do
 		{
 			zbx_vector_events_tags_clear_ext(&update_events_tags, event_tags_free);
@@ -793,24 +869,6 @@ static int	am_db_flush_results(zbx_hashset_t *mediatypes, const unsigned char *d
 				zbx_am_db_mediatype_t	*mediatype;
 				zbx_am_result_t		*result = results[i];
 
-				zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
-						"update alerts set status=%d,retries=%d",
-						result->status, result->retries);
-
-				if (NULL != result->error)
-				{
-					char	*error_esc;
-
-					error_esc = zbx_db_dyn_escape_field("alerts", "error", result->error);
-					zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, ",error='%s'", error_esc);
-					zbx_free(error_esc);
-				}
-				else
-					zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, ",error=''");
-
-				zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, " where alertid=" ZBX_FS_UI64 ";\n",
-						result->alertid);
-
 				if ((EVENT_SOURCE_TRIGGERS == result->source ||
 						EVENT_SOURCE_INTERNAL == result->source ||
 						EVENT_SOURCE_SERVICE == result->source) && NULL != result->value)
@@ -822,9 +880,9 @@ static int	am_db_flush_results(zbx_hashset_t *mediatypes, const unsigned char *d
 								&update_events_tags);
 					}
 				}
-				zbx_db_execute_overflowed_sql(&sql, &sql_alloc, &sql_offset);
 			}
 
+			am_db_update_alert_statuses(results_status, results_num, &sql, &sql_alloc, &sql_offset);
 			am_db_validate_tags_for_update(&update_events_tags, &db_event, &db_problem);
 
 			(void)zbx_db_flush_overflowed_sql(sql, sql_offset);
@@ -850,6 +908,7 @@ static int	am_db_flush_results(zbx_hashset_t *mediatypes, const unsigned char *d
 			zbx_free(result);
 		}
 
+		zbx_free(results_status);
 		zbx_free(sql);
 	}
 
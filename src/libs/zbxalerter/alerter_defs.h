@@ -39,11 +39,13 @@
 #define ZBX_IPC_ALERTER_BEGIN_DISPATCH		1204
 #define ZBX_IPC_ALERTER_SEND_DISPATCH		1205
 #define ZBX_IPC_ALERTER_END_DISPATCH		1206
+#define ZBX_IPC_ALERTER_DIAG_LATENCY		1207
 
 /* manager -> process */
 #define ZBX_IPC_ALERTER_DIAG_STATS_RESULT		1300
 #define ZBX_IPC_ALERTER_DIAG_TOP_MEDIATYPES_RESULT	1301
 #define ZBX_IPC_ALERTER_DIAG_TOP_SOURCES_RESULT		1302
 #define ZBX_IPC_ALERTER_ABORT_DISPATCH			1303
+#define ZBX_IPC_ALERTER_DIAG_LATENCY_RESULT		1304
 
 #endif
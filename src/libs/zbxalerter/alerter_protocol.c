@@ -920,6 +920,64 @@ static void	zbx_alerter_deserialize_top_sources_result(const unsigned char *data
 	}
 }
 
+zbx_uint32_t	zbx_alerter_serialize_diag_latency(unsigned char **data, zbx_am_mediatype_t **mediatypes,
+		int mediatypes_num)
+{
+	unsigned char	*ptr;
+	zbx_uint32_t	data_len = 0, mediatype_len = 0;
+
+	if (0 != mediatypes_num)
+	{
+		zbx_serialize_prepare_value(mediatype_len, mediatypes[0]->mediatypeid);
+
+		for (int j = 0; j < ZBX_AM_LATENCY_BUCKETS_NUM; j++)
+			zbx_serialize_prepare_value(mediatype_len, mediatypes[0]->latency[j]);
+	}
+
+	zbx_serialize_prepare_value(data_len, mediatypes_num);
+	data_len += mediatype_len * mediatypes_num;
+	*data = (unsigned char *)zbx_malloc(NULL, data_len);
+
+	ptr = *data;
+	ptr += zbx_serialize_value(ptr, mediatypes_num);
+
+	for (int i = 0; i < mediatypes_num; i++)
+	{
+		ptr += zbx_serialize_value(ptr, mediatypes[i]->mediatypeid);
+
+		for (int j = 0; j < ZBX_AM_LATENCY_BUCKETS_NUM; j++)
+			ptr += zbx_serialize_value(ptr, mediatypes[i]->latency[j]);
+	}
+
+	return data_len;
+}
+
+static void	zbx_alerter_deserialize_diag_latency(const unsigned char *data,
+		zbx_vector_am_latency_stats_ptr_t *latencies)
+{
+	int	mediatypes_num;
+
+	data += zbx_deserialize_value(data, &mediatypes_num);
+
+	if (0 != mediatypes_num)
+	{
+		zbx_vector_am_latency_stats_ptr_reserve(latencies, (size_t)mediatypes_num);
+
+		for (int i = 0; i < mediatypes_num; i++)
+		{
+			zbx_am_latency_stats_t	*latency;
+
+			latency = (zbx_am_latency_stats_t *)zbx_malloc(NULL, sizeof(zbx_am_latency_stats_t));
+			data += zbx_deserialize_value(data, &latency->mediatypeid);
+
+			for (int j = 0; j < ZBX_AM_LATENCY_BUCKETS_NUM; j++)
+				data += zbx_deserialize_value(data, &latency->alerts_num[j]);
+
+			zbx_vector_am_latency_stats_ptr_append(latencies, latency);
+		}
+	}
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: gets alerter manager diagnostic statistics                        *
@@ -1016,6 +1074,33 @@ out:
 	return ret;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets alert queue latency histograms of media types                *
+ *                                                                            *
+ * Parameters latencies - [OUT] vector of zbx_am_latency_stats_t structures   *
+ *            error     - [OUT]                                               *
+ *                                                                            *
+ * Return value: SUCCEED - the latency histograms were returned successfully  *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_alerter_get_diag_latency(zbx_vector_am_latency_stats_ptr_t *latencies, char **error)
+{
+	unsigned char	*result;
+
+	if (SUCCEED != zbx_ipc_async_exchange(ZBX_IPC_SERVICE_ALERTER, ZBX_IPC_ALERTER_DIAG_LATENCY, SEC_PER_MIN,
+			NULL, 0, &result, error))
+	{
+		return FAIL;
+	}
+
+	zbx_alerter_deserialize_diag_latency(result, latencies);
+	zbx_free(result);
+
+	return SUCCEED;
+}
+
 /******************************************************************************
  *                                                                            *
  * ZBX_IPC_ALERTER_BEGIN_DISPATCH message serialization/deserialization       *
@@ -65,6 +65,12 @@ typedef struct
 	int			script_bin_sz;
 	unsigned char		message_format;
 	unsigned char		flags;
+
+	/* theoretical arrival time of the next retry, used to shape retry rate */
+	double			retry_tat;
+
+	/* alert queue latency histogram */
+	zbx_uint64_t		latency[ZBX_AM_LATENCY_BUCKETS_NUM];
 }
 zbx_am_mediatype_t;
 
@@ -238,6 +244,9 @@ zbx_uint32_t	zbx_alerter_serialize_top_mediatypes_result(unsigned char **data, z
 zbx_uint32_t	zbx_alerter_serialize_top_sources_result(unsigned char **data, zbx_am_source_stats_t **sources,
 		int sources_num);
 
+zbx_uint32_t	zbx_alerter_serialize_diag_latency(unsigned char **data, zbx_am_mediatype_t **mediatypes,
+		int mediatypes_num);
+
 zbx_uint32_t	zbx_alerter_serialize_begin_dispatch(unsigned char **data, const char *subject, const char *message,
 		const char *content_name, const char *message_format, const char *content, zbx_uint32_t content_size);
 void	zbx_alerter_deserialize_begin_dispatch(const unsigned char *data, char **subject, char **message,
@@ -0,0 +1,471 @@
+/*
+** Copyright (C) 2001-2024 Zabbix SIA
+**
+** This program is free software: you can redistribute it and/or modify it under the terms of
+** the GNU Affero General Public License as published by the Free Software Foundation, version 3.
+**
+** This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+** without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+** See the GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License along with this program.
+** If not, see <https://www.gnu.org/licenses/>.
+**/
+
+#include "zbxalgo.h"
+
+#define TIMER_WHEEL_SLOT_BITS	8
+#define TIMER_WHEEL_SLOT_MASK	(ZBX_TIMER_WHEEL_SLOTS - 1)
+
+/* the node is in due heap */
+#define TIMER_WHEEL_SLOT_DUE	-1
+/* the node is not linked */
+#define TIMER_WHEEL_SLOT_NONE	-2
+
+#define TIMER_WHEEL_NODE_KEY(node)	((zbx_uint64_t)(uintptr_t)(node))
+
+/* helper functions */
+
+static int	timer_wheel_compare(const zbx_timer_wheel_t *wheel, const zbx_timer_wheel_node_t *node1,
+		const zbx_timer_wheel_node_t *node2)
+{
+	zbx_binary_heap_elem_t	elem1 = {TIMER_WHEEL_NODE_KEY(node1), node1->data},
+				elem2 = {TIMER_WHEEL_NODE_KEY(node2), node2->data};
+
+	return wheel->compare_func(&elem1, &elem2);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: merges two due heap roots                                         *
+ *                                                                            *
+ * Return value: the root of merged heap                                      *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_timer_wheel_node_t	*timer_wheel_due_meld(const zbx_timer_wheel_t *wheel,
+		zbx_timer_wheel_node_t *node1, zbx_timer_wheel_node_t *node2)
+{
+	if (0 > timer_wheel_compare(wheel, node2, node1))
+	{
+		zbx_timer_wheel_node_t	*node = node1;
+
+		node1 = node2;
+		node2 = node;
+	}
+
+	node2->prev = node1;
+
+	if (NULL != (node2->next = node1->child))
+		node1->child->prev = node2;
+
+	node1->child = node2;
+
+	return node1;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: merges list of sibling due heap nodes into single heap            *
+ *                                                                            *
+ * Return value: the root of merged heap or NULL if the list is empty         *
+ *                                                                            *
+ * Comments: Siblings are merged in pairs from left to right and then the     *
+ *           pairs are merged from right to left, which keeps the amortized   *
+ *           cost of removal logarithmic.                                     *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_timer_wheel_node_t	*timer_wheel_due_merge_pairs(const zbx_timer_wheel_t *wheel,
+		zbx_timer_wheel_node_t *node)
+{
+	zbx_timer_wheel_node_t	*pairs = NULL, *next, *root;
+
+	for (; NULL != node; node = next)
+	{
+		zbx_timer_wheel_node_t	*sibling = node->next;
+
+		node->prev = NULL;
+		node->next = NULL;
+
+		if (NULL != sibling)
+		{
+			next = sibling->next;
+			sibling->prev = NULL;
+			sibling->next = NULL;
+			node = timer_wheel_due_meld(wheel, node, sibling);
+		}
+		else
+			next = NULL;
+
+		/* merged pairs are stacked, so they are popped from right to left */
+		node->next = pairs;
+		pairs = node;
+	}
+
+	if (NULL == (root = pairs))
+		return NULL;
+
+	pairs = root->next;
+	root->next = NULL;
+
+	for (; NULL != pairs; pairs = next)
+	{
+		next = pairs->next;
+		pairs->next = NULL;
+		root = timer_wheel_due_meld(wheel, pairs, root);
+	}
+
+	return root;
+}
+
+static void	timer_wheel_due_insert(zbx_timer_wheel_t *wheel, zbx_timer_wheel_node_t *node)
+{
+	node->prev = NULL;
+	node->next = NULL;
+	node->child = NULL;
+
+	wheel->due = (NULL == wheel->due ? node : timer_wheel_due_meld(wheel, wheel->due, node));
+	wheel->due_num++;
+}
+
+static void	timer_wheel_due_remove(zbx_timer_wheel_t *wheel, zbx_timer_wheel_node_t *node)
+{
+	zbx_timer_wheel_node_t	*root;
+
+	if (node == wheel->due)
+	{
+		wheel->due = timer_wheel_due_merge_pairs(wheel, node->child);
+	}
+	else
+	{
+		/* the first child is linked to its parent */
+		if (node->prev->child == node)
+			node->prev->child = node->next;
+		else
+			node->prev->next = node->next;
+
+		if (NULL != node->next)
+			node->next->prev = node->prev;
+
+		if (NULL != (root = timer_wheel_due_merge_pairs(wheel, node->child)))
+			wheel->due = timer_wheel_due_meld(wheel, wheel->due, root);
+	}
+
+	node->child = NULL;
+	wheel->due_num--;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets wheel slot for the specified time                            *
+ *                                                                            *
+ * Comments: The level is selected by the highest bits where the time         *
+ *           differs from the wheel time, so all nodes in a slot of higher    *
+ *           level can be cascaded down when wheel time reaches that slot.    *
+ *                                                                            *
+ ******************************************************************************/
+static int	timer_wheel_get_slot(const zbx_timer_wheel_t *wheel, int time)
+{
+	unsigned int	diff = (unsigned int)time ^ (unsigned int)wheel->time;
+	int		level;
+
+	for (level = 0; level < ZBX_TIMER_WHEEL_LEVELS - 1; level++)
+	{
+		if (diff < (1U << ((level + 1) * TIMER_WHEEL_SLOT_BITS)))
+			break;
+	}
+
+	return level * ZBX_TIMER_WHEEL_SLOTS +
+			(int)(((unsigned int)time >> (level * TIMER_WHEEL_SLOT_BITS)) & TIMER_WHEEL_SLOT_MASK);
+}
+
+static void	timer_wheel_link(zbx_timer_wheel_t *wheel, zbx_timer_wheel_node_t *node)
+{
+	if (node->time < wheel->time)
+	{
+		node->slot = TIMER_WHEEL_SLOT_DUE;
+		timer_wheel_due_insert(wheel, node);
+		return;
+	}
+
+	node->slot = timer_wheel_get_slot(wheel, node->time);
+	node->prev = NULL;
+
+	if (NULL != (node->next = wheel->slots[node->slot]))
+		node->next->prev = node;
+
+	wheel->slots[node->slot] = node;
+	wheel->slots_num[node->slot / ZBX_TIMER_WHEEL_SLOTS]++;
+}
+
+static void	timer_wheel_unlink(zbx_timer_wheel_t *wheel, zbx_timer_wheel_node_t *node)
+{
+	switch (node->slot)
+	{
+		case TIMER_WHEEL_SLOT_NONE:
+			return;
+		case TIMER_WHEEL_SLOT_DUE:
+			timer_wheel_due_remove(wheel, node);
+			break;
+		default:
+			if (NULL != node->prev)
+				node->prev->next = node->next;
+			else
+				wheel->slots[node->slot] = node->next;
+
+			if (NULL != node->next)
+				node->next->prev = node->prev;
+
+			wheel->slots_num[node->slot / ZBX_TIMER_WHEEL_SLOTS]--;
+	}
+
+	node->slot = TIMER_WHEEL_SLOT_NONE;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: relinks nodes of the specified slot according to the current      *
+ *          wheel time                                                        *
+ *                                                                            *
+ ******************************************************************************/
+static void	timer_wheel_cascade(zbx_timer_wheel_t *wheel, int slot)
+{
+	zbx_timer_wheel_node_t	*node, *next;
+
+	if (NULL == (node = wheel->slots[slot]))
+		return;
+
+	wheel->slots[slot] = NULL;
+
+	for (; NULL != node; node = next)
+	{
+		next = node->next;
+		wheel->slots_num[slot / ZBX_TIMER_WHEEL_SLOTS]--;
+		timer_wheel_link(wheel, node);
+	}
+}
+
+/* public timer wheel interface */
+
+void	zbx_timer_wheel_create_ext(zbx_timer_wheel_t *wheel, zbx_compare_func_t compare_func,
+		zbx_mem_malloc_func_t mem_malloc_func, zbx_mem_free_func_t mem_free_func)
+{
+	size_t	size = sizeof(zbx_timer_wheel_node_t *) * ZBX_TIMER_WHEEL_LEVELS * ZBX_TIMER_WHEEL_SLOTS;
+
+	wheel->slots = (zbx_timer_wheel_node_t **)mem_malloc_func(NULL, size);
+	memset(wheel->slots, 0, size);
+	memset(wheel->slots_num, 0, sizeof(wheel->slots_num));
+	wheel->time = 0;
+	wheel->due = NULL;
+	wheel->due_num = 0;
+	wheel->compare_func = compare_func;
+
+	wheel->mem_malloc_func = mem_malloc_func;
+	wheel->mem_free_func = mem_free_func;
+}
+
+void	zbx_timer_wheel_destroy(zbx_timer_wheel_t *wheel)
+{
+	wheel->mem_free_func(wheel->slots);
+	wheel->slots = NULL;
+	wheel->due = NULL;
+	wheel->due_num = 0;
+
+	wheel->mem_malloc_func = NULL;
+	wheel->mem_free_func = NULL;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: schedules element at the specified time                           *
+ *                                                                            *
+ * Parameters: wheel - [IN] the timer wheel                                   *
+ *             node  - [IN] the wheel node, embedded in the element           *
+ *             data  - [IN] the element                                       *
+ *             time  - [IN] the scheduled time                                *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_timer_wheel_insert(zbx_timer_wheel_t *wheel, zbx_timer_wheel_node_t *node, void *data, int time)
+{
+	node->data = data;
+	node->time = time;
+	timer_wheel_link(wheel, node);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: reschedules element at the specified time                         *
+ *                                                                            *
+ * Comments: Due elements are also reordered if the ordering fields other     *
+ *           than time have changed, as they are removed from and inserted    *
+ *           into due heap again.                                             *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_timer_wheel_update(zbx_timer_wheel_t *wheel, zbx_timer_wheel_node_t *node, int time)
+{
+	timer_wheel_unlink(wheel, node);
+	node->time = time;
+	timer_wheel_link(wheel, node);
+}
+
+void	zbx_timer_wheel_remove(zbx_timer_wheel_t *wheel, zbx_timer_wheel_node_t *node)
+{
+	timer_wheel_unlink(wheel, node);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: sets wheel time                                                   *
+ *                                                                            *
+ * Comments: Higher level slots are cascaded as soon as the wheel time enters *
+ *           their periods, so the nodes scheduled in the current period of   *
+ *           any level are always kept in the lowest level slots.             *
+ *                                                                            *
+ ******************************************************************************/
+static void	timer_wheel_set_time(zbx_timer_wheel_t *wheel, int now)
+{
+	unsigned int	time = (unsigned int)now;
+	int		level;
+
+	wheel->time = now;
+
+	if (0 != (time & TIMER_WHEEL_SLOT_MASK))
+		return;
+
+	/* cascade starting with the highest level, so its nodes can be cascaded further down */
+	for (level = ZBX_TIMER_WHEEL_LEVELS - 1; 0 < level; level--)
+	{
+		int	shift = level * TIMER_WHEEL_SLOT_BITS;
+
+		if (0 != (time & ((1U << shift) - 1)))
+			continue;
+
+		timer_wheel_cascade(wheel, level * ZBX_TIMER_WHEEL_SLOTS +
+				(int)((time >> shift) & TIMER_WHEEL_SLOT_MASK));
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: moves elements scheduled at or before the specified time to due   *
+ *          heap                                                              *
+ *                                                                            *
+ * Comments: Periods without scheduled elements are skipped, so the cost      *
+ *           does not depend on the time since the last call.                 *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_timer_wheel_advance(zbx_timer_wheel_t *wheel, int now)
+{
+	while (wheel->time <= now)
+	{
+		unsigned int	time = (unsigned int)wheel->time;
+		int		level;
+
+		if (0 != wheel->slots_num[0])
+		{
+			/* nodes of the current slot are scheduled at the current time, so they become due */
+			wheel->time++;
+			timer_wheel_cascade(wheel, (int)(time & TIMER_WHEEL_SLOT_MASK));
+			timer_wheel_set_time(wheel, wheel->time);
+			continue;
+		}
+
+		/* skip to the next period of the lowest non empty level */
+		for (level = 1; level < ZBX_TIMER_WHEEL_LEVELS && 0 == wheel->slots_num[level]; level++)
+			;
+
+		if (ZBX_TIMER_WHEEL_LEVELS == level)
+		{
+			timer_wheel_set_time(wheel, now + 1);
+			break;
+		}
+
+		time = (time | ((1U << (level * TIMER_WHEEL_SLOT_BITS)) - 1)) + 1;
+		timer_wheel_set_time(wheel, time > (unsigned int)now ? now + 1 : (int)time);
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets the first due element                                        *
+ *                                                                            *
+ * Return value: the first due element or NULL if there are no due elements   *
+ *                                                                            *
+ * Comments: The elements become due when the wheel is advanced past their    *
+ *           scheduled time.                                                  *
+ *                                                                            *
+ ******************************************************************************/
+void	*zbx_timer_wheel_find_min(const zbx_timer_wheel_t *wheel)
+{
+	if (NULL == wheel->due)
+		return NULL;
+
+	return wheel->due->data;
+}
+
+void	zbx_timer_wheel_remove_min(zbx_timer_wheel_t *wheel)
+{
+	zbx_timer_wheel_node_t	*node = wheel->due;
+
+	timer_wheel_due_remove(wheel, node);
+	node->slot = TIMER_WHEEL_SLOT_NONE;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets the time of the earliest scheduled element                   *
+ *                                                                            *
+ * Return value: the earliest scheduled time or FAIL if the wheel is empty    *
+ *                                                                            *
+ * Comments: Nodes of higher level slots are scanned for the earliest time,   *
+ *           which happens only when lower levels are empty.                  *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_timer_wheel_get_nexttime(const zbx_timer_wheel_t *wheel)
+{
+	int	level, slot;
+
+	if (NULL != wheel->due)
+		return wheel->due->time;
+
+	for (level = 0; level < ZBX_TIMER_WHEEL_LEVELS; level++)
+	{
+		if (0 == wheel->slots_num[level])
+			continue;
+
+		/* slots before the current wheel time slot are empty */
+		slot = (int)(((unsigned int)wheel->time >> (level * TIMER_WHEEL_SLOT_BITS)) & TIMER_WHEEL_SLOT_MASK);
+
+		for (; slot < ZBX_TIMER_WHEEL_SLOTS; slot++)
+		{
+			const zbx_timer_wheel_node_t	*node;
+			int				time;
+
+			if (NULL == (node = wheel->slots[level * ZBX_TIMER_WHEEL_SLOTS + slot]))
+				continue;
+
+			/* first level slot nodes are scheduled at the same time */
+			if (0 == level)
+				return node->time;
+
+			for (time = node->time; NULL != (node = node->next);)
+			{
+				if (node->time < time)
+					time = node->time;
+			}
+
+			return time;
+		}
+	}
+
+	return FAIL;
+}
+
+int	zbx_timer_wheel_size(const zbx_timer_wheel_t *wheel)
+{
+	int	i, size = wheel->due_num;
+
+	for (i = 0; i < ZBX_TIMER_WHEEL_LEVELS; i++)
+		size += wheel->slots_num[i];
+
+	return size;
+}
@@ -54,6 +54,7 @@
 #include "zbxcomms.h"
 #include "zbxdb.h"
 #include "zbxmutexs.h"
+#include "zbxthreads.h"
 #include "zbxautoreg.h"
 #include "zbxpgservice.h"
 #include "zbxinterface.h"
@@ -188,16 +189,139 @@ void	set_dc_config(zbx_dc_config_t *in)
 
 zbx_rwlock_t		config_lock = ZBX_RWLOCK_NULL;
 
+#if ZBX_MUTEX_CONFIG_QUEUE_NUM != ZBX_POLLER_TYPE_COUNT
+#	error "number of configuration cache queue mutexes does not match number of poller types"
+#endif
+
+static zbx_mutex_t	queue_locks[ZBX_POLLER_TYPE_COUNT];
+
+#define	LOCK_QUEUE(poller_type)		zbx_mutex_lock(queue_locks[poller_type])
+#define	UNLOCK_QUEUE(poller_type)	zbx_mutex_unlock(queue_locks[poller_type])
+
+/* index of the first process of each type in configuration cache lock statistics */
+static int	lock_stats_index[ZBX_PROCESS_TYPE_COUNT];
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets index of the current process in per process statistics       *
+ *                                                                            *
+ * Return value: statistics index or FAIL if the current thread was not       *
+ *               started by zbx_thread_start()                                *
+ *                                                                            *
+ ******************************************************************************/
+static int	dc_get_stats_index_local(void)
+{
+	static ZBX_THREAD_LOCAL const zbx_thread_info_t	*info = NULL;
+	static ZBX_THREAD_LOCAL int			index = FAIL;
+	const zbx_thread_info_t				*info_current;
+
+	/* forked processes inherit the cached index of parent, so check if thread information has changed */
+	if (info == (info_current = zbx_get_thread_info()))
+		return index;
+
+	info = info_current;
+	index = FAIL;
+
+	if (NULL != info && ZBX_PROCESS_TYPE_COUNT > info->process_type && 0 < info->process_num &&
+			info->process_num <= get_config_forks_cb(info->process_type))
+	{
+		index = lock_stats_index[info->process_type] + info->process_num - 1;
+	}
+
+	return index;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets configuration cache lock statistics of the current process   *
+ *                                                                            *
+ * Return value: lock statistics or NULL if the current thread was not        *
+ *               started by zbx_thread_start()                                *
+ *                                                                            *
+ * Comments: Each process updates only its own statistics, so they are        *
+ *           updated without locking.                                         *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_dc_lock_stats_t	*dc_get_lock_stats_local(void)
+{
+	int	index;
+
+	if (NULL == config || NULL == config->lock_stats || FAIL == (index = dc_get_stats_index_local()))
+		return NULL;
+
+	return &config->lock_stats[index];
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets user macro resolution cache statistics of the current        *
+ *          process                                                           *
+ *                                                                            *
+ * Return value: resolution cache statistics or NULL if the current thread    *
+ *               was not started by zbx_thread_start()                        *
+ *                                                                            *
+ * Comments: Each process updates only its own statistics, so they are        *
+ *           updated without locking.                                         *
+ *                                                                            *
+ ******************************************************************************/
+zbx_dc_um_memo_stats_t	*dc_get_um_memo_stats_local(void)
+{
+	int	index;
+
+	if (NULL == config || NULL == config->um_memo_stats || FAIL == (index = dc_get_stats_index_local()))
+		return NULL;
+
+	return &config->um_memo_stats[index];
+}
+
 void	rdlock_cache(void)
 {
-	if (0 == sync_in_progress)
+	zbx_dc_lock_stats_t	*stats;
+	double			time_start;
+
+	if (0 != sync_in_progress)
+		return;
+
+	/* lock statistics are collected only after they have been requested */
+	if (NULL == config || 0 == config->lock_stats_enabled)
+	{
 		zbx_rwlock_rdlock(config_lock);
+		return;
+	}
+
+	time_start = zbx_time();
+	zbx_rwlock_rdlock(config_lock);
+
+	if (NULL != (stats = dc_get_lock_stats_local()))
+	{
+		stats->rdlock_num++;
+		stats->rdlock_wait += zbx_time() - time_start;
+	}
 }
 
 void	wrlock_cache(void)
 {
-	if (0 == sync_in_progress)
+	zbx_dc_lock_stats_t	*stats;
+	double			time_start;
+
+	if (0 != sync_in_progress)
+		return;
+
+	/* lock statistics are collected only after they have been requested */
+	if (NULL == config || 0 == config->lock_stats_enabled)
+	{
 		zbx_rwlock_wrlock(config_lock);
+		return;
+	}
+
+	time_start = zbx_time();
+	zbx_rwlock_wrlock(config_lock);
+
+	if (NULL != (stats = dc_get_lock_stats_local()))
+	{
+		stats->wrlock_num++;
+		stats->wrlock_wait += zbx_time() - time_start;
+	}
 }
 
 void	unlock_cache(void)
@@ -251,6 +375,7 @@ zbx_uint64_t	dbconfig_used_size(void)
 }
 
 static void	dc_maintenance_precache_nested_groups(void);
+static void	dc_action_precache_nested_groups(void);
 static void	dc_item_reset_triggers(ZBX_DC_ITEM *item, ZBX_DC_TRIGGER *trigger_exclude);
 
 static void	dc_reschedule_items(const zbx_hashset_t *activated_hosts);
@@ -951,15 +1076,13 @@ int	dc_strpool_replace(int found, const char **curr, const char *new_str)
 
 static void	DCupdate_item_queue(ZBX_DC_ITEM *item, unsigned char old_poller_type, int old_nextcheck)
 {
-	zbx_binary_heap_elem_t	elem;
-
 	if (ZBX_LOC_POLLER == item->location)
 		return;
 
 	if (ZBX_LOC_QUEUE == item->location && old_poller_type != item->poller_type)
 	{
 		item->location = ZBX_LOC_NOWHERE;
-		zbx_binary_heap_remove_direct(&config->queues[old_poller_type], item->itemid);
+		zbx_timer_wheel_remove(&config->queues[old_poller_type], &item->queue_node);
 	}
 
 	if (item->poller_type == ZBX_NO_POLLER)
@@ -968,22 +1091,17 @@ static void	DCupdate_item_queue(ZBX_DC_ITEM *item, unsigned char old_poller_type
 	if (ZBX_LOC_QUEUE == item->location && old_nextcheck == item->nextcheck)
 		return;
 
-	elem.key = item->itemid;
-	elem.data = (void *)item;
-
 	if (ZBX_LOC_QUEUE != item->location)
 	{
 		item->location = ZBX_LOC_QUEUE;
-		zbx_binary_heap_insert(&config->queues[item->poller_type], &elem);
+		zbx_timer_wheel_insert(&config->queues[item->poller_type], &item->queue_node, item, item->nextcheck);
 	}
 	else
-		zbx_binary_heap_update_direct(&config->queues[item->poller_type], &elem);
+		zbx_timer_wheel_update(&config->queues[item->poller_type], &item->queue_node, item->nextcheck);
 }
 
 static void	DCupdate_proxy_queue(ZBX_DC_PROXY *proxy)
 {
-	zbx_binary_heap_elem_t	elem;
-
 	if (ZBX_LOC_POLLER == proxy->location)
 		return;
 
@@ -993,16 +1111,13 @@ static void	DCupdate_proxy_queue(ZBX_DC_PROXY *proxy)
 	if (proxy->proxy_config_nextcheck < proxy->nextcheck)
 		proxy->nextcheck = proxy->proxy_config_nextcheck;
 
-	elem.key = proxy->proxyid;
-	elem.data = (void *)proxy;
-
 	if (ZBX_LOC_QUEUE != proxy->location)
 	{
 		proxy->location = ZBX_LOC_QUEUE;
-		zbx_binary_heap_insert(&config->pqueue, &elem);
+		zbx_timer_wheel_insert(&config->pqueue, &proxy->queue_node, proxy, proxy->nextcheck);
 	}
 	else
-		zbx_binary_heap_update_direct(&config->pqueue, &elem);
+		zbx_timer_wheel_update(&config->pqueue, &proxy->queue_node, proxy->nextcheck);
 }
 
 /******************************************************************************
@@ -1716,7 +1831,7 @@ static void	DCsync_proxy_remove(ZBX_DC_PROXY *proxy)
 
 	if (ZBX_LOC_QUEUE == proxy->location)
 	{
-		zbx_binary_heap_remove_direct(&config->pqueue, proxy->proxyid);
+		zbx_timer_wheel_remove(&config->pqueue, &proxy->queue_node);
 		proxy->location = ZBX_LOC_NOWHERE;
 	}
 
@@ -4051,7 +4166,7 @@ static void	DCsync_items(zbx_dbsync_t *sync, zbx_uint64_t revision, int flags, z
 		}
 
 		if (ZBX_LOC_QUEUE == item->location)
-			zbx_binary_heap_remove_direct(&config->queues[item->poller_type], item->itemid);
+			zbx_timer_wheel_remove(&config->queues[item->poller_type], &item->queue_node);
 
 		dc_strpool_release(item->key);
 		dc_strpool_release(item->error);
@@ -4170,6 +4285,8 @@ static void	DCsync_triggers(zbx_dbsync_t *sync, zbx_uint64_t revision)
 		/* store new information in trigger structure */
 
 		ZBX_STR2UCHAR(trigger->flags, row[19]);
+		ZBX_DBROW2UINT64(trigger->templateid, row[20]);
+		ZBX_DBROW2UINT64(trigger->parent_triggerid, row[21]);
 
 		if (ZBX_FLAG_DISCOVERY_PROTOTYPE == trigger->flags)
 			continue;
@@ -6394,25 +6511,20 @@ static time_t	dc_calculate_nextcheck(zbx_uint64_t seed, int delay, time_t now)
 
 static void	dc_drule_queue(zbx_dc_drule_t *drule)
 {
-	zbx_binary_heap_elem_t	elem;
-
-	elem.key = drule->druleid;
-	elem.data = (void *)drule;
-
 	if (ZBX_LOC_QUEUE != drule->location)
 	{
-		zbx_binary_heap_insert(&config->drule_queue, &elem);
+		zbx_timer_wheel_insert(&config->drule_queue, &drule->queue_node, drule, (int)drule->nextcheck);
 		drule->location = ZBX_LOC_QUEUE;
 	}
 	else
-		zbx_binary_heap_update_direct(&config->drule_queue, &elem);
+		zbx_timer_wheel_update(&config->drule_queue, &drule->queue_node, (int)drule->nextcheck);
 }
 
 static void	dc_drule_dequeue(zbx_dc_drule_t *drule)
 {
 	if (ZBX_LOC_QUEUE == drule->location)
 	{
-		zbx_binary_heap_remove_direct(&config->drule_queue, drule->druleid);
+		zbx_timer_wheel_remove(&config->drule_queue, &drule->queue_node);
 		drule->location = ZBX_LOC_NOWHERE;
 	}
 }
@@ -6711,25 +6823,21 @@ static int	dc_httpstep_update_revision(zbx_dc_httpstep_t *httpstep, zbx_uint64_t
 
 static void	dc_httptest_queue(zbx_dc_httptest_t *httptest)
 {
-	zbx_binary_heap_elem_t	elem;
-
-	elem.key = httptest->httptestid;
-	elem.data = (void *)httptest;
-
 	if (ZBX_LOC_QUEUE != httptest->location)
 	{
-		zbx_binary_heap_insert(&config->httptest_queue, &elem);
+		zbx_timer_wheel_insert(&config->httptest_queue, &httptest->queue_node, httptest,
+				(int)httptest->nextcheck);
 		httptest->location = ZBX_LOC_QUEUE;
 	}
 	else
-		zbx_binary_heap_update_direct(&config->httptest_queue, &elem);
+		zbx_timer_wheel_update(&config->httptest_queue, &httptest->queue_node, (int)httptest->nextcheck);
 }
 
 static void	dc_httptest_dequeue(zbx_dc_httptest_t *httptest)
 {
 	if (ZBX_LOC_QUEUE == httptest->location)
 	{
-		zbx_binary_heap_remove_direct(&config->httptest_queue, httptest->httptestid);
+		zbx_timer_wheel_remove(&config->httptest_queue, &httptest->queue_node);
 		httptest->location = ZBX_LOC_NOWHERE;
 	}
 }
@@ -7714,7 +7822,7 @@ static void	DCsync_proxies(zbx_dbsync_t *sync, zbx_uint64_t revision, const zbx_
 		}
 		else if (PROXY_OPERATING_MODE_ACTIVE == mode && ZBX_LOC_QUEUE == proxy->location)
 		{
-			zbx_binary_heap_remove_direct(&config->pqueue, proxy->proxyid);
+			zbx_timer_wheel_remove(&config->pqueue, &proxy->queue_node);
 			proxy->location = ZBX_LOC_NOWHERE;
 		}
 
@@ -7901,6 +8009,7 @@ zbx_uint64_t	zbx_dc_sync_configuration(unsigned char mode, zbx_synced_new_config
 	zbx_hashset_t			psk_owners;
 	zbx_vector_objmove_t		pg_host_reloc, *pg_host_reloc_ref;
 	zbx_vector_dc_item_ptr_t	new_items, *pnew_items = NULL;
+	zbx_dbsync_loader_t		*loader = NULL;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
@@ -7910,6 +8019,10 @@ zbx_uint64_t	zbx_dc_sync_configuration(unsigned char mode, zbx_synced_new_config
 	{
 		zbx_hashset_create(&trend_queue, 1000, ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
 		dc_load_trigger_queue(&trend_queue);
+
+		/* tables using changelog are synchronized incrementally from snapshot if it's available */
+		if (0 != (get_program_type_cb() & ZBX_PROGRAM_TYPE_SERVER) && SUCCEED == zbx_dbsync_env_restore())
+			changelog_sync_mode = ZBX_DBSYNC_UPDATE;
 	}
 	else if (ZBX_DBSYNC_STATUS_INITIALIZED != sync_status)
 	{
@@ -7921,7 +8034,8 @@ zbx_uint64_t	zbx_dc_sync_configuration(unsigned char mode, zbx_synced_new_config
 		pnew_items = &new_items;
 	}
 
-	if (ZBX_DBSYNC_INIT != changelog_sync_mode && 0 != (get_program_type_cb() & ZBX_PROGRAM_TYPE_SERVER))
+	if (ZBX_DBSYNC_INIT != mode && ZBX_DBSYNC_INIT != changelog_sync_mode &&
+			0 != (get_program_type_cb() & ZBX_PROGRAM_TYPE_SERVER))
 	{
 		/* track host - proxy group relocations only during incremental sync */
 		zbx_vector_objmove_create(&pg_host_reloc);
@@ -7940,19 +8054,19 @@ zbx_uint64_t	zbx_dc_sync_configuration(unsigned char mode, zbx_synced_new_config
 
 	zbx_dbsync_init(&autoreg_config_sync, "config_autoreg_tls", mode);
 	zbx_dbsync_init(&autoreg_host_sync, "autoreg_host", mode);
-	zbx_dbsync_init_changelog(&proxy_group_sync, "proxy_group", changelog_sync_mode);
-	zbx_dbsync_init_changelog(&hosts_sync, "hosts", changelog_sync_mode);
-	zbx_dbsync_init_changelog(&hp_sync, "host_proxy", changelog_sync_mode);
+	zbx_dbsync_init_changelog(&proxy_group_sync, "proxy_group", ZBX_DBSYNC_OBJ_PROXY_GROUP, changelog_sync_mode);
+	zbx_dbsync_init_changelog(&hosts_sync, "hosts", ZBX_DBSYNC_OBJ_HOST, changelog_sync_mode);
+	zbx_dbsync_init_changelog(&hp_sync, "host_proxy", ZBX_DBSYNC_OBJ_HOST_PROXY, changelog_sync_mode);
 	zbx_dbsync_init(&hi_sync, "host_inventory", mode);
 	zbx_dbsync_init(&htmpl_sync, "hosts_templates", mode);
 	zbx_dbsync_init(&gmacro_sync, "globalmacro", mode);
 	zbx_dbsync_init(&hmacro_sync, "hostmacro", mode);
 	zbx_dbsync_init(&if_sync, "interface", mode);
-	zbx_dbsync_init_changelog(&items_sync, "items", changelog_sync_mode);
+	zbx_dbsync_init_changelog(&items_sync, "items", ZBX_DBSYNC_OBJ_ITEM, changelog_sync_mode);
 	zbx_dbsync_init(&item_discovery_sync, "item_discovery", mode);
-	zbx_dbsync_init_changelog(&triggers_sync, "triggers", changelog_sync_mode);
+	zbx_dbsync_init_changelog(&triggers_sync, "triggers", ZBX_DBSYNC_OBJ_TRIGGER, changelog_sync_mode);
 	zbx_dbsync_init(&tdep_sync, "trigger_depends", mode);
-	zbx_dbsync_init_changelog(&func_sync, "functions", changelog_sync_mode);
+	zbx_dbsync_init_changelog(&func_sync, "functions", ZBX_DBSYNC_OBJ_FUNCTION, changelog_sync_mode);
 	zbx_dbsync_init(&expr_sync, "regexps", mode);
 	zbx_dbsync_init(&action_sync, "actions", mode);
 
@@ -7962,15 +8076,15 @@ zbx_uint64_t	zbx_dc_sync_configuration(unsigned char mode, zbx_synced_new_config
 	zbx_dbsync_init(&action_op_sync, "operations", ZBX_DBSYNC_UPDATE);
 
 	zbx_dbsync_init(&action_condition_sync, "conditions", mode);
-	zbx_dbsync_init_changelog(&trigger_tag_sync, "trigger_tag", changelog_sync_mode);
-	zbx_dbsync_init_changelog(&item_tag_sync, "item_tag", changelog_sync_mode);
-	zbx_dbsync_init_changelog(&host_tag_sync, "host_tag", changelog_sync_mode);
+	zbx_dbsync_init_changelog(&trigger_tag_sync, "trigger_tag", ZBX_DBSYNC_OBJ_TRIGGER_TAG, changelog_sync_mode);
+	zbx_dbsync_init_changelog(&item_tag_sync, "item_tag", ZBX_DBSYNC_OBJ_ITEM_TAG, changelog_sync_mode);
+	zbx_dbsync_init_changelog(&host_tag_sync, "host_tag", ZBX_DBSYNC_OBJ_HOST_TAG, changelog_sync_mode);
 	zbx_dbsync_init(&correlation_sync, "correlation", mode);
 	zbx_dbsync_init(&corr_condition_sync, "corr_condition", mode);
 	zbx_dbsync_init(&corr_operation_sync, "corr_operation", mode);
 	zbx_dbsync_init(&hgroups_sync, "hstgrp", mode);
 	zbx_dbsync_init(&hgroup_host_sync, "hosts_groups", mode);
-	zbx_dbsync_init_changelog(&itempp_sync, "item_preproc", changelog_sync_mode);
+	zbx_dbsync_init_changelog(&itempp_sync, "item_preproc", ZBX_DBSYNC_OBJ_ITEM_PREPROC, changelog_sync_mode);
 	zbx_dbsync_init(&itemscrp_sync, "item_parameter", mode);
 
 	zbx_dbsync_init(&maintenance_sync, "maintenances", mode);
@@ -7979,29 +8093,84 @@ zbx_uint64_t	zbx_dc_sync_configuration(unsigned char mode, zbx_synced_new_config
 	zbx_dbsync_init(&maintenance_group_sync, "maintenances_groups", mode);
 	zbx_dbsync_init(&maintenance_host_sync, "maintenances_hosts", mode);
 
-	zbx_dbsync_init_changelog(&drules_sync, "drules", changelog_sync_mode);
-	zbx_dbsync_init_changelog(&dchecks_sync, "dchecks", changelog_sync_mode);
-
-	zbx_dbsync_init_changelog(&httptest_sync, "httptest", changelog_sync_mode);
-	zbx_dbsync_init_changelog(&httptest_field_sync, "httptest_field", changelog_sync_mode);
-	zbx_dbsync_init_changelog(&httpstep_sync, "httpstep", changelog_sync_mode);
-	zbx_dbsync_init_changelog(&httpstep_field_sync, "httpstep_field", changelog_sync_mode);
-
-	zbx_dbsync_init_changelog(&connector_sync, "connector", changelog_sync_mode);
-	zbx_dbsync_init_changelog(&connector_tag_sync, "connector_tag", changelog_sync_mode);
-
-	zbx_dbsync_init_changelog(&proxy_sync, "proxy", changelog_sync_mode);
-
-	if (FAIL == zbx_dbsync_compare_config(&config_sync))
+	zbx_dbsync_init_changelog(&drules_sync, "drules", ZBX_DBSYNC_OBJ_DRULE, changelog_sync_mode);
+	zbx_dbsync_init_changelog(&dchecks_sync, "dchecks", ZBX_DBSYNC_OBJ_DCHECK, changelog_sync_mode);
+
+	zbx_dbsync_init_changelog(&httptest_sync, "httptest", ZBX_DBSYNC_OBJ_HTTPTEST, changelog_sync_mode);
+	zbx_dbsync_init_changelog(&httptest_field_sync, "httptest_field", ZBX_DBSYNC_OBJ_HTTPTEST_FIELD,
+			changelog_sync_mode);
+	zbx_dbsync_init_changelog(&httpstep_sync, "httpstep", ZBX_DBSYNC_OBJ_HTTPSTEP, changelog_sync_mode);
+	zbx_dbsync_init_changelog(&httpstep_field_sync, "httpstep_field", ZBX_DBSYNC_OBJ_HTTPSTEP_FIELD,
+			changelog_sync_mode);
+
+	zbx_dbsync_init_changelog(&connector_sync, "connector", ZBX_DBSYNC_OBJ_CONNECTOR, changelog_sync_mode);
+	zbx_dbsync_init_changelog(&connector_tag_sync, "connector_tag", ZBX_DBSYNC_OBJ_CONNECTOR_TAG, changelog_sync_mode);
+
+	zbx_dbsync_init_changelog(&proxy_sync, "proxy", ZBX_DBSYNC_OBJ_PROXY, changelog_sync_mode);
+
+	/* During initial server sync the table queries are executed in parallel by loader threads, */
+	/* while the configuration cache is updated in the same order as before. Tables are        */
+	/* registered in the order they are synced, so earlier phases can be applied while the     */
+	/* rest are still being loaded.                                                             */
+	if (ZBX_DBSYNC_INIT == mode && 0 != (get_program_type_cb() & ZBX_PROGRAM_TYPE_SERVER) &&
+			NULL != (loader = zbx_dbsync_loader_create()))
+	{
+		zbx_dbsync_loader_add(loader, &htmpl_sync, zbx_dbsync_compare_host_templates);
+		zbx_dbsync_loader_add(loader, &gmacro_sync, zbx_dbsync_compare_global_macros);
+		zbx_dbsync_loader_add(loader, &hmacro_sync, zbx_dbsync_compare_host_macros);
+		zbx_dbsync_loader_add(loader, &host_tag_sync, zbx_dbsync_compare_host_tags);
+
+		zbx_dbsync_loader_add(loader, &proxy_sync, zbx_dbsync_compare_proxies);
+		zbx_dbsync_loader_add(loader, &hosts_sync, zbx_dbsync_compare_hosts);
+		zbx_dbsync_loader_add(loader, &hi_sync, zbx_dbsync_compare_host_inventory);
+		zbx_dbsync_loader_add(loader, &hgroups_sync, zbx_dbsync_compare_host_groups);
+		zbx_dbsync_loader_add(loader, &hgroup_host_sync, zbx_dbsync_compare_host_group_hosts);
+		zbx_dbsync_loader_add(loader, &maintenance_sync, zbx_dbsync_compare_maintenances);
+		zbx_dbsync_loader_add(loader, &maintenance_tag_sync, zbx_dbsync_compare_maintenance_tags);
+		zbx_dbsync_loader_add(loader, &maintenance_period_sync, zbx_dbsync_compare_maintenance_periods);
+		zbx_dbsync_loader_add(loader, &maintenance_group_sync, zbx_dbsync_compare_maintenance_groups);
+		zbx_dbsync_loader_add(loader, &maintenance_host_sync, zbx_dbsync_compare_maintenance_hosts);
+		zbx_dbsync_loader_add(loader, &drules_sync, zbx_dbsync_prepare_drules);
+		zbx_dbsync_loader_add(loader, &dchecks_sync, zbx_dbsync_prepare_dchecks);
+		zbx_dbsync_loader_add(loader, &httptest_sync, zbx_dbsync_prepare_httptests);
+		zbx_dbsync_loader_add(loader, &httptest_field_sync, zbx_dbsync_prepare_httptest_fields);
+		zbx_dbsync_loader_add(loader, &httpstep_sync, zbx_dbsync_prepare_httpsteps);
+		zbx_dbsync_loader_add(loader, &httpstep_field_sync, zbx_dbsync_prepare_httpstep_fields);
+		zbx_dbsync_loader_add(loader, &connector_sync, zbx_dbsync_compare_connectors);
+		zbx_dbsync_loader_add(loader, &connector_tag_sync, zbx_dbsync_compare_connector_tags);
+		zbx_dbsync_loader_add(loader, &hp_sync, zbx_dbsync_prepare_host_proxy);
+
+		zbx_dbsync_loader_add(loader, &if_sync, zbx_dbsync_compare_interfaces);
+		zbx_dbsync_loader_add(loader, &items_sync, zbx_dbsync_compare_items);
+		zbx_dbsync_loader_add(loader, &item_discovery_sync, zbx_dbsync_compare_item_discovery);
+		zbx_dbsync_loader_add(loader, &itempp_sync, zbx_dbsync_compare_item_preprocs);
+		zbx_dbsync_loader_add(loader, &itemscrp_sync, zbx_dbsync_compare_item_script_param);
+		zbx_dbsync_loader_add(loader, &func_sync, zbx_dbsync_compare_functions);
+
+		zbx_dbsync_loader_add(loader, &triggers_sync, zbx_dbsync_compare_triggers);
+		zbx_dbsync_loader_add(loader, &tdep_sync, zbx_dbsync_compare_trigger_dependency);
+		zbx_dbsync_loader_add(loader, &expr_sync, zbx_dbsync_compare_expressions);
+		zbx_dbsync_loader_add(loader, &action_sync, zbx_dbsync_compare_actions);
+		zbx_dbsync_loader_add(loader, &action_condition_sync, zbx_dbsync_compare_action_conditions);
+		zbx_dbsync_loader_add(loader, &trigger_tag_sync, zbx_dbsync_compare_trigger_tags);
+		zbx_dbsync_loader_add(loader, &item_tag_sync, zbx_dbsync_compare_item_tags);
+		zbx_dbsync_loader_add(loader, &correlation_sync, zbx_dbsync_compare_correlations);
+		zbx_dbsync_loader_add(loader, &corr_condition_sync, zbx_dbsync_compare_corr_conditions);
+		zbx_dbsync_loader_add(loader, &corr_operation_sync, zbx_dbsync_compare_corr_operations);
+
+		zbx_dbsync_loader_start(loader, ZBX_DBSYNC_LOADER_THREADS_NUM);
+	}
+
+	if (FAIL == zbx_dbsync_load(loader, &config_sync, zbx_dbsync_compare_config))
 		goto out;
 
-	if (FAIL == zbx_dbsync_compare_autoreg_psk(&autoreg_config_sync))
+	if (FAIL == zbx_dbsync_load(loader, &autoreg_config_sync, zbx_dbsync_compare_autoreg_psk))
 		goto out;
 
-	if (FAIL == zbx_dbsync_compare_autoreg_host(&autoreg_host_sync))
+	if (FAIL == zbx_dbsync_load(loader, &autoreg_host_sync, zbx_dbsync_compare_autoreg_host))
 		goto out;
 
-	if (FAIL == zbx_dbsync_prepare_proxy_group(&proxy_group_sync))
+	if (FAIL == zbx_dbsync_load(loader, &proxy_group_sync, zbx_dbsync_prepare_proxy_group))
 		goto out;
 
 	/* sync global configuration settings */
@@ -8020,16 +8189,16 @@ zbx_uint64_t	zbx_dc_sync_configuration(unsigned char mode, zbx_synced_new_config
 
 	/* sync macro related data, to support macro resolving during configuration sync */
 
-	if (FAIL == zbx_dbsync_compare_host_templates(&htmpl_sync))
+	if (FAIL == zbx_dbsync_load(loader, &htmpl_sync, zbx_dbsync_compare_host_templates))
 		goto out;
 
-	if (FAIL == zbx_dbsync_compare_global_macros(&gmacro_sync))
+	if (FAIL == zbx_dbsync_load(loader, &gmacro_sync, zbx_dbsync_compare_global_macros))
 		goto out;
 
-	if (FAIL == zbx_dbsync_compare_host_macros(&hmacro_sync))
+	if (FAIL == zbx_dbsync_load(loader, &hmacro_sync, zbx_dbsync_compare_host_macros))
 		goto out;
 
-	if (FAIL == zbx_dbsync_compare_host_tags(&host_tag_sync))
+	if (FAIL == zbx_dbsync_load(loader, &host_tag_sync, zbx_dbsync_compare_host_tags))
 		goto out;
 
 	START_SYNC;
@@ -8049,51 +8218,51 @@ zbx_uint64_t	zbx_dc_sync_configuration(unsigned char mode, zbx_synced_new_config
 	}
 
 	/* sync host data to support host lookups when resolving macros during configuration sync */
-	if (FAIL == zbx_dbsync_compare_proxies(&proxy_sync))
+	if (FAIL == zbx_dbsync_load(loader, &proxy_sync, zbx_dbsync_compare_proxies))
 		goto out;
 
-	if (FAIL == zbx_dbsync_compare_hosts(&hosts_sync))
+	if (FAIL == zbx_dbsync_load(loader, &hosts_sync, zbx_dbsync_compare_hosts))
 		goto out;
 
-	if (FAIL == zbx_dbsync_compare_host_inventory(&hi_sync))
+	if (FAIL == zbx_dbsync_load(loader, &hi_sync, zbx_dbsync_compare_host_inventory))
 		goto out;
 
-	if (FAIL == zbx_dbsync_compare_host_groups(&hgroups_sync))
+	if (FAIL == zbx_dbsync_load(loader, &hgroups_sync, zbx_dbsync_compare_host_groups))
 		goto out;
-	if (FAIL == zbx_dbsync_compare_host_group_hosts(&hgroup_host_sync))
+	if (FAIL == zbx_dbsync_load(loader, &hgroup_host_sync, zbx_dbsync_compare_host_group_hosts))
 		goto out;
 
-	if (FAIL == zbx_dbsync_compare_maintenances(&maintenance_sync))
+	if (FAIL == zbx_dbsync_load(loader, &maintenance_sync, zbx_dbsync_compare_maintenances))
 		goto out;
-	if (FAIL == zbx_dbsync_compare_maintenance_tags(&maintenance_tag_sync))
+	if (FAIL == zbx_dbsync_load(loader, &maintenance_tag_sync, zbx_dbsync_compare_maintenance_tags))
 		goto out;
-	if (FAIL == zbx_dbsync_compare_maintenance_periods(&maintenance_period_sync))
+	if (FAIL == zbx_dbsync_load(loader, &maintenance_period_sync, zbx_dbsync_compare_maintenance_periods))
 		goto out;
-	if (FAIL == zbx_dbsync_compare_maintenance_groups(&maintenance_group_sync))
+	if (FAIL == zbx_dbsync_load(loader, &maintenance_group_sync, zbx_dbsync_compare_maintenance_groups))
 		goto out;
-	if (FAIL == zbx_dbsync_compare_maintenance_hosts(&maintenance_host_sync))
+	if (FAIL == zbx_dbsync_load(loader, &maintenance_host_sync, zbx_dbsync_compare_maintenance_hosts))
 		goto out;
 
-	if (FAIL == zbx_dbsync_prepare_drules(&drules_sync))
+	if (FAIL == zbx_dbsync_load(loader, &drules_sync, zbx_dbsync_prepare_drules))
 		goto out;
-	if (FAIL == zbx_dbsync_prepare_dchecks(&dchecks_sync))
+	if (FAIL == zbx_dbsync_load(loader, &dchecks_sync, zbx_dbsync_prepare_dchecks))
 		goto out;
 
-	if (FAIL == zbx_dbsync_prepare_httptests(&httptest_sync))
+	if (FAIL == zbx_dbsync_load(loader, &httptest_sync, zbx_dbsync_prepare_httptests))
 		goto out;
-	if (FAIL == zbx_dbsync_prepare_httptest_fields(&httptest_field_sync))
+	if (FAIL == zbx_dbsync_load(loader, &httptest_field_sync, zbx_dbsync_prepare_httptest_fields))
 		goto out;
-	if (FAIL == zbx_dbsync_prepare_httpsteps(&httpstep_sync))
+	if (FAIL == zbx_dbsync_load(loader, &httpstep_sync, zbx_dbsync_prepare_httpsteps))
 		goto out;
-	if (FAIL == zbx_dbsync_prepare_httpstep_fields(&httpstep_field_sync))
+	if (FAIL == zbx_dbsync_load(loader, &httpstep_field_sync, zbx_dbsync_prepare_httpstep_fields))
 		goto out;
 
-	if (FAIL == zbx_dbsync_compare_connectors(&connector_sync))
+	if (FAIL == zbx_dbsync_load(loader, &connector_sync, zbx_dbsync_compare_connectors))
 		goto out;
-	if (FAIL == zbx_dbsync_compare_connector_tags(&connector_tag_sync))
+	if (FAIL == zbx_dbsync_load(loader, &connector_tag_sync, zbx_dbsync_compare_connector_tags))
 		goto out;
 
-	if (FAIL == zbx_dbsync_prepare_host_proxy(&hp_sync))
+	if (FAIL == zbx_dbsync_load(loader, &hp_sync, zbx_dbsync_prepare_host_proxy))
 		goto out;
 
 	zbx_hashset_create(&psk_owners, 0, ZBX_DEFAULT_PTR_HASH_FUNC, ZBX_DEFAULT_PTR_COMPARE_FUNC);
@@ -8145,22 +8314,22 @@ zbx_uint64_t	zbx_dc_sync_configuration(unsigned char mode, zbx_synced_new_config
 
 	/* sync item data to support item lookups when resolving macros during configuration sync */
 
-	if (FAIL == zbx_dbsync_compare_interfaces(&if_sync))
+	if (FAIL == zbx_dbsync_load(loader, &if_sync, zbx_dbsync_compare_interfaces))
 		goto out;
 
-	if (FAIL == zbx_dbsync_compare_items(&items_sync))
+	if (FAIL == zbx_dbsync_load(loader, &items_sync, zbx_dbsync_compare_items))
 		goto out;
 
-	if (FAIL == zbx_dbsync_compare_item_discovery(&item_discovery_sync))
+	if (FAIL == zbx_dbsync_load(loader, &item_discovery_sync, zbx_dbsync_compare_item_discovery))
 		goto out;
 
-	if (FAIL == zbx_dbsync_compare_item_preprocs(&itempp_sync))
+	if (FAIL == zbx_dbsync_load(loader, &itempp_sync, zbx_dbsync_compare_item_preprocs))
 		goto out;
 
-	if (FAIL == zbx_dbsync_compare_item_script_param(&itemscrp_sync))
+	if (FAIL == zbx_dbsync_load(loader, &itemscrp_sync, zbx_dbsync_compare_item_script_param))
 		goto out;
 
-	if (FAIL == zbx_dbsync_compare_functions(&func_sync))
+	if (FAIL == zbx_dbsync_load(loader, &func_sync, zbx_dbsync_compare_functions))
 		goto out;
 
 	START_SYNC;
@@ -8191,38 +8360,38 @@ zbx_uint64_t	zbx_dc_sync_configuration(unsigned char mode, zbx_synced_new_config
 	zbx_dc_flush_history();	/* misconfigured items generate pseudo-historic values to become notsupported */
 
 	/* sync rest of the data */
-	if (FAIL == zbx_dbsync_compare_triggers(&triggers_sync))
+	if (FAIL == zbx_dbsync_load(loader, &triggers_sync, zbx_dbsync_compare_triggers))
 		goto out;
 
-	if (FAIL == zbx_dbsync_compare_trigger_dependency(&tdep_sync))
+	if (FAIL == zbx_dbsync_load(loader, &tdep_sync, zbx_dbsync_compare_trigger_dependency))
 		goto out;
 
-	if (FAIL == zbx_dbsync_compare_expressions(&expr_sync))
+	if (FAIL == zbx_dbsync_load(loader, &expr_sync, zbx_dbsync_compare_expressions))
 		goto out;
 
-	if (FAIL == zbx_dbsync_compare_actions(&action_sync))
+	if (FAIL == zbx_dbsync_load(loader, &action_sync, zbx_dbsync_compare_actions))
 		goto out;
 
-	if (FAIL == zbx_dbsync_compare_action_ops(&action_op_sync))
+	if (FAIL == zbx_dbsync_load(loader, &action_op_sync, zbx_dbsync_compare_action_ops))
 		goto out;
 
-	if (FAIL == zbx_dbsync_compare_action_conditions(&action_condition_sync))
+	if (FAIL == zbx_dbsync_load(loader, &action_condition_sync, zbx_dbsync_compare_action_conditions))
 		goto out;
 
-	if (FAIL == zbx_dbsync_compare_trigger_tags(&trigger_tag_sync))
+	if (FAIL == zbx_dbsync_load(loader, &trigger_tag_sync, zbx_dbsync_compare_trigger_tags))
 		goto out;
 
 	/* relies on items, must be after DCsync_items() */
-	if (FAIL == zbx_dbsync_compare_item_tags(&item_tag_sync))
+	if (FAIL == zbx_dbsync_load(loader, &item_tag_sync, zbx_dbsync_compare_item_tags))
 		goto out;
 
-	if (FAIL == zbx_dbsync_compare_correlations(&correlation_sync))
+	if (FAIL == zbx_dbsync_load(loader, &correlation_sync, zbx_dbsync_compare_correlations))
 		goto out;
 
-	if (FAIL == zbx_dbsync_compare_corr_conditions(&corr_condition_sync))
+	if (FAIL == zbx_dbsync_load(loader, &corr_condition_sync, zbx_dbsync_compare_corr_conditions))
 		goto out;
 
-	if (FAIL == zbx_dbsync_compare_corr_operations(&corr_operation_sync))
+	if (FAIL == zbx_dbsync_load(loader, &corr_operation_sync, zbx_dbsync_compare_corr_operations))
 		goto out;
 
 	START_SYNC;
@@ -8236,6 +8405,14 @@ zbx_uint64_t	zbx_dc_sync_configuration(unsigned char mode, zbx_synced_new_config
 	DCsync_action_ops(&action_op_sync);
 	DCsync_action_conditions(&action_condition_sync);
 
+	/* pre-cache nested groups used in action conditions to allow read lock */
+	/* during action condition evaluation                                   */
+	if (0 != (update_flags & ZBX_DBSYNC_UPDATE_HOST_GROUPS) || 0 != action_condition_sync.add_num +
+			action_condition_sync.update_num + action_condition_sync.remove_num)
+	{
+		dc_action_precache_nested_groups();
+	}
+
 	/* relies on triggers, must be after DCsync_triggers() */
 	DCsync_trigger_tags(&trigger_tag_sync);
 
@@ -8306,6 +8483,10 @@ zbx_uint64_t	zbx_dc_sync_configuration(unsigned char mode, zbx_synced_new_config
 
 	config->revision.config = new_revision;
 
+	/* log per table load timing of the initial sync */
+	if (ZBX_DBSYNC_INIT == mode)
+		zbx_dcsync_stats_dump(__func__, LOG_LEVEL_INFORMATION);
+
 	if (SUCCEED == ZBX_CHECK_LOG_LEVEL(LOG_LEVEL_DEBUG))
 	{
 		zabbix_log(LOG_LEVEL_DEBUG, "%s() changelog  : sql:" ZBX_FS_DBL " sec (%d records)",
@@ -8314,7 +8495,8 @@ zbx_uint64_t	zbx_dc_sync_configuration(unsigned char mode, zbx_synced_new_config
 		zabbix_log(LOG_LEVEL_DEBUG, "%s() reindex    : " ZBX_FS_DBL " sec " ZBX_FS_I64 " bytes.", __func__,
 				update_sec, update_size);
 
-		zbx_dcsync_stats_dump(__func__);
+		if (ZBX_DBSYNC_INIT != mode)
+			zbx_dcsync_stats_dump(__func__, LOG_LEVEL_DEBUG);
 
 		zabbix_log(LOG_LEVEL_DEBUG, "%s() proxies    : %d (%d slots)", __func__,
 				config->proxies.num_data, config->proxies.num_slots);
@@ -8418,12 +8600,12 @@ zbx_uint64_t	zbx_dc_sync_configuration(unsigned char mode, zbx_synced_new_config
 
 		for (i = 0; ZBX_POLLER_TYPE_COUNT > i; i++)
 		{
-			zabbix_log(LOG_LEVEL_DEBUG, "%s() queue[%d]   : %d (%d allocated)", __func__,
-					i, config->queues[i].elems_num, config->queues[i].elems_alloc);
+			zabbix_log(LOG_LEVEL_DEBUG, "%s() queue[%d]   : %d (%d due)", __func__,
+					i, zbx_timer_wheel_size(&config->queues[i]), config->queues[i].due_num);
 		}
 
-		zabbix_log(LOG_LEVEL_DEBUG, "%s() pqueue     : %d (%d allocated)", __func__,
-				config->pqueue.elems_num, config->pqueue.elems_alloc);
+		zabbix_log(LOG_LEVEL_DEBUG, "%s() pqueue     : %d (%d due)", __func__,
+				zbx_timer_wheel_size(&config->pqueue), config->pqueue.due_num);
 
 		zabbix_log(LOG_LEVEL_DEBUG, "%s() timer queue: %d (%d allocated)", __func__,
 				config->trigger_queue.elems_num, config->trigger_queue.elems_alloc);
@@ -8458,6 +8640,10 @@ out:
 			if (ZBX_DBSYNC_INIT != changelog_sync_mode)
 			{
 				zbx_dbsync_env_flush_changelog();
+
+				/* changelog was restored from snapshot */
+				if (ZBX_DBSYNC_INIT == mode)
+					sync_status = ZBX_DBSYNC_STATUS_INITIALIZED;
 			}
 			else
 			{
@@ -8475,6 +8661,8 @@ out:
 				}
 
 			}
+
+			zbx_dbsync_env_commit();
 			break;
 		case ZBX_DB_FAIL:
 			/* non recoverable database error is encountered */
@@ -8506,6 +8694,9 @@ out:
 				" please check \"StartConnectors\" configuration parameter");
 	}
 clean:
+	if (NULL != loader)
+		zbx_dbsync_loader_stop(loader);
+
 	zbx_dbsync_clear(&config_sync);
 	zbx_dbsync_clear(&autoreg_config_sync);
 	zbx_dbsync_clear(&autoreg_host_sync);
@@ -8551,6 +8742,9 @@ clean:
 	zbx_dbsync_clear(&proxy_group_sync);
 	zbx_dbsync_clear(&hp_sync);
 
+	if (NULL != loader)
+		zbx_dbsync_loader_free(loader);
+
 	if (ZBX_DBSYNC_INIT == mode)
 		zbx_hashset_destroy(&trend_queue);
 
@@ -8927,7 +9121,7 @@ size_t	zbx_maintenance_update_flags_num(void)
 int	zbx_init_configuration_cache(zbx_get_program_type_f get_program_type, zbx_get_config_forks_f get_config_forks,
 		zbx_uint64_t conf_cache_size, const char *hostname, char **error)
 {
-	int	i, ret;
+	int	i, ret, lock_stats_num;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s() size:" ZBX_FS_UI64, __func__, conf_cache_size);
 
@@ -8940,6 +9134,12 @@ int	zbx_init_configuration_cache(zbx_get_program_type_f get_program_type, zbx_ge
 	if (SUCCEED != (ret = zbx_rwlock_create(&config_history_lock, ZBX_RWLOCK_CONFIG_HISTORY, error)))
 		goto out;
 
+	for (i = 0; i < ZBX_POLLER_TYPE_COUNT; i++)
+	{
+		if (SUCCEED != (ret = zbx_mutex_create(&queue_locks[i], ZBX_MUTEX_CONFIG_QUEUE + i, error)))
+			goto out;
+	}
+
 	if (SUCCEED != (ret = zbx_shmem_create(&config_mem, conf_cache_size, "configuration cache",
 			"CacheSize", 0, error)))
 	{
@@ -8952,6 +9152,21 @@ int	zbx_init_configuration_cache(zbx_get_program_type_f get_program_type, zbx_ge
 	if (SUCCEED != vps_monitor_create(&config->vps_monitor, error))
 		goto out;
 
+	for (i = 0, lock_stats_num = 0; i < ZBX_PROCESS_TYPE_COUNT; i++)
+	{
+		lock_stats_index[i] = lock_stats_num;
+		lock_stats_num += get_config_forks_cb((unsigned char)i);
+	}
+
+	config->lock_stats = (zbx_dc_lock_stats_t *)__config_shmem_malloc_func(NULL,
+			sizeof(zbx_dc_lock_stats_t) * (size_t)lock_stats_num);
+	memset(config->lock_stats, 0, sizeof(zbx_dc_lock_stats_t) * (size_t)lock_stats_num);
+	config->lock_stats_enabled = 0;
+
+	config->um_memo_stats = (zbx_dc_um_memo_stats_t *)__config_shmem_malloc_func(NULL,
+			sizeof(zbx_dc_um_memo_stats_t) * (size_t)lock_stats_num);
+	memset(config->um_memo_stats, 0, sizeof(zbx_dc_um_memo_stats_t) * (size_t)lock_stats_num);
+
 #define CREATE_HASHSET(hashset, hashset_size)									\
 														\
 	CREATE_HASHSET_EXT(hashset, hashset_size, ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC)
@@ -9032,37 +9247,29 @@ int	zbx_init_configuration_cache(zbx_get_program_type_f get_program_type, zbx_ge
 		switch (i)
 		{
 			case ZBX_POLLER_TYPE_JAVA:
-				zbx_binary_heap_create_ext(&config->queues[i],
+				zbx_timer_wheel_create_ext(&config->queues[i],
 						__config_java_elem_compare,
-						ZBX_BINARY_HEAP_OPTION_DIRECT,
 						__config_shmem_malloc_func,
-						__config_shmem_realloc_func,
 						__config_shmem_free_func);
 				break;
 			case ZBX_POLLER_TYPE_PINGER:
-				zbx_binary_heap_create_ext(&config->queues[i],
+				zbx_timer_wheel_create_ext(&config->queues[i],
 						__config_pinger_elem_compare,
-						ZBX_BINARY_HEAP_OPTION_DIRECT,
 						__config_shmem_malloc_func,
-						__config_shmem_realloc_func,
 						__config_shmem_free_func);
 				break;
 			default:
-				zbx_binary_heap_create_ext(&config->queues[i],
+				zbx_timer_wheel_create_ext(&config->queues[i],
 						__config_heap_elem_compare,
-						ZBX_BINARY_HEAP_OPTION_DIRECT,
 						__config_shmem_malloc_func,
-						__config_shmem_realloc_func,
 						__config_shmem_free_func);
 				break;
 		}
 	}
 
-	zbx_binary_heap_create_ext(&config->pqueue,
+	zbx_timer_wheel_create_ext(&config->pqueue,
 					__config_proxy_compare,
-					ZBX_BINARY_HEAP_OPTION_DIRECT,
 					__config_shmem_malloc_func,
-					__config_shmem_realloc_func,
 					__config_shmem_free_func);
 
 	zbx_binary_heap_create_ext(&config->trigger_queue,
@@ -9072,18 +9279,14 @@ int	zbx_init_configuration_cache(zbx_get_program_type_f get_program_type, zbx_ge
 					__config_shmem_realloc_func,
 					__config_shmem_free_func);
 
-	zbx_binary_heap_create_ext(&config->drule_queue,
+	zbx_timer_wheel_create_ext(&config->drule_queue,
 					__config_drule_compare,
-					ZBX_BINARY_HEAP_OPTION_DIRECT,
 					__config_shmem_malloc_func,
-					__config_shmem_realloc_func,
 					__config_shmem_free_func);
 
-	zbx_binary_heap_create_ext(&config->httptest_queue,
+	zbx_timer_wheel_create_ext(&config->httptest_queue,
 					__config_httptest_compare,
-					ZBX_BINARY_HEAP_OPTION_DIRECT,
 					__config_shmem_malloc_func,
-					__config_shmem_realloc_func,
 					__config_shmem_free_func);
 
 	CREATE_HASHSET(config->drules, 0);
@@ -9170,6 +9373,10 @@ void	zbx_free_configuration_cache(void)
 
 	zbx_shmem_destroy(config_mem);
 	config_mem = NULL;
+
+	for (int i = 0; i < ZBX_POLLER_TYPE_COUNT; i++)
+		zbx_mutex_destroy(&queue_locks[i]);
+
 	zbx_rwlock_destroy(&config_history_lock);
 	zbx_rwlock_destroy(&config_lock);
 
@@ -9945,6 +10152,7 @@ void	DCget_trigger(zbx_dc_trigger_t *dst_trigger, const ZBX_DC_TRIGGER *src_trig
 	int	i;
 
 	dst_trigger->triggerid = src_trigger->triggerid;
+	dst_trigger->revision = src_trigger->revision;
 	dst_trigger->description = zbx_strdup(NULL, src_trigger->description);
 	dst_trigger->error = zbx_strdup(NULL, src_trigger->error);
 	dst_trigger->timespec.sec = 0;
@@ -11411,23 +11619,9 @@ int	zbx_dc_get_interface_value(zbx_uint64_t hostid, zbx_uint64_t itemid, char **
  * Return value: nextcheck or FAIL if no items for the specified queue        *
  *                                                                            *
  ******************************************************************************/
-static int	dc_config_get_queue_nextcheck(zbx_binary_heap_t *queue)
+static int	dc_config_get_queue_nextcheck(const zbx_timer_wheel_t *queue)
 {
-	int				nextcheck;
-	const zbx_binary_heap_elem_t	*min;
-	const ZBX_DC_ITEM		*dc_item;
-
-	if (FAIL == zbx_binary_heap_empty(queue))
-	{
-		min = zbx_binary_heap_find_min(queue);
-		dc_item = (const ZBX_DC_ITEM *)min->data;
-
-		nextcheck = dc_item->nextcheck;
-	}
-	else
-		nextcheck = FAIL;
-
-	return nextcheck;
+	return zbx_timer_wheel_get_nexttime(queue);
 }
 
 /******************************************************************************
@@ -11442,16 +11636,18 @@ static int	dc_config_get_queue_nextcheck(zbx_binary_heap_t *queue)
 int	zbx_dc_config_get_poller_nextcheck(unsigned char poller_type)
 {
 	int			nextcheck;
-	zbx_binary_heap_t	*queue;
+	zbx_timer_wheel_t	*queue;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s() poller_type:%d", __func__, (int)poller_type);
 
 	queue = &config->queues[poller_type];
 
 	RDLOCK_CACHE;
+	LOCK_QUEUE(poller_type);
 
 	nextcheck = dc_config_get_queue_nextcheck(queue);
 
+	UNLOCK_QUEUE(poller_type);
 	UNLOCK_CACHE;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%d", __func__, nextcheck);
@@ -11474,6 +11670,74 @@ static void	dc_requeue_item(ZBX_DC_ITEM *dc_item, const ZBX_DC_HOST *dc_host, co
 	DCupdate_item_queue(dc_item, old_poller_type, old_nextcheck);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: requeues item taken from queue while configuration cache is read  *
+ *          locked                                                            *
+ *                                                                            *
+ * Comments: The item is owned by the caller until it is put back in queue,   *
+ *           so only the target queue must be locked.                         *
+ *                                                                            *
+ ******************************************************************************/
+static void	dc_requeue_item_rdlocked(ZBX_DC_ITEM *dc_item, const ZBX_DC_HOST *dc_host,
+		const ZBX_DC_INTERFACE *dc_interface, int flags, int lastclock)
+{
+	int	old_nextcheck;
+
+	old_nextcheck = dc_item->nextcheck;
+	DCitem_nextcheck_update(dc_item, dc_interface, flags, lastclock, NULL);
+
+	DCitem_poller_type_update(dc_item, dc_host, flags);
+
+	if (ZBX_NO_POLLER == dc_item->poller_type)
+		return;
+
+	LOCK_QUEUE(dc_item->poller_type);
+	DCupdate_item_queue(dc_item, dc_item->poller_type, old_nextcheck);
+	UNLOCK_QUEUE(dc_item->poller_type);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: requeues items that were taken from queue, but not returned to    *
+ *          poller                                                            *
+ *                                                                            *
+ * Parameters: itemids  - [IN] the items to requeue                           *
+ *             flags    - [IN] the requeue flags                              *
+ *             now      - [IN] the current time                               *
+ *             wrlocked - [IN] SUCCEED - configuration cache is write locked  *
+ *                             FAIL    - configuration cache is read locked   *
+ *                                                                            *
+ ******************************************************************************/
+static void	dc_requeue_skipped_items(const zbx_vector_uint64_t *itemids, int flags, int now, int wrlocked)
+{
+	for (int i = 0; i < itemids->values_num; i++)
+	{
+		ZBX_DC_ITEM		*dc_item;
+		ZBX_DC_HOST		*dc_host;
+		ZBX_DC_INTERFACE	*dc_interface;
+
+		if (NULL == (dc_item = (ZBX_DC_ITEM *)zbx_hashset_search(&config->items, &itemids->values[i])))
+			continue;
+
+		if (ITEM_STATUS_ACTIVE != dc_item->status)
+			continue;
+
+		if (NULL == (dc_host = (ZBX_DC_HOST *)zbx_hashset_search(&config->hosts, &dc_item->hostid)))
+			continue;
+
+		if (HOST_STATUS_MONITORED != dc_host->status)
+			continue;
+
+		dc_interface = (ZBX_DC_INTERFACE *)zbx_hashset_search(&config->interfaces, &dc_item->interfaceid);
+
+		if (SUCCEED == wrlocked)
+			dc_requeue_item(dc_item, dc_host, dc_interface, flags, now);
+		else
+			dc_requeue_item_rdlocked(dc_item, dc_host, dc_interface, flags, now);
+	}
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: requeues items at the specified time                              *
@@ -11522,12 +11786,21 @@ static void	dc_requeue_item_at(ZBX_DC_ITEM *dc_item, ZBX_DC_HOST *dc_host, time_
  *           IPMI poller queue are handled by                                 *
  *           zbx_dc_config_get_ipmi_poller_items() function.                  *
  *                                                                            *
+ *           Items are taken from queue with configuration cache read locked  *
+ *           and the poller type queue locked, so pollers of different types  *
+ *           do not block each other. The skipped items are requeued after    *
+ *           the queue is unlocked. Configuration cache is write locked only  *
+ *           when disable until time of unreachable interfaces must be        *
+ *           increased.                                                       *
+ *                                                                            *
  ******************************************************************************/
 int	zbx_dc_config_get_poller_items(unsigned char poller_type, int config_timeout, int processing,
 		int config_max_concurrent_checks, zbx_dc_item_t **items)
 {
 	int			now, num = 0, max_items, items_alloc = 0;
-	zbx_binary_heap_t	*queue;
+	zbx_timer_wheel_t	*queue;
+	ZBX_DC_ITEM		*dc_item;
+	zbx_vector_uint64_t	requeue_itemids, unreachable_itemids, interfaceids;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s() poller_type:%d", __func__, (int)poller_type);
 
@@ -11556,20 +11829,22 @@ int	zbx_dc_config_get_poller_items(unsigned char poller_type, int config_timeout
 			max_items = 1;
 	}
 
-	WRLOCK_CACHE;
+	zbx_vector_uint64_create(&requeue_itemids);
+	zbx_vector_uint64_create(&unreachable_itemids);
+	zbx_vector_uint64_create(&interfaceids);
+
+	RDLOCK_CACHE;
+	LOCK_QUEUE(poller_type);
+
+	zbx_timer_wheel_advance(queue, now);
 
-	while (num < max_items && FAIL == zbx_binary_heap_empty(queue))
+	while (num < max_items && NULL != (dc_item = (ZBX_DC_ITEM *)zbx_timer_wheel_find_min(queue)))
 	{
 		int				disable_until;
-		const zbx_binary_heap_elem_t	*min;
 		ZBX_DC_HOST			*dc_host;
 		ZBX_DC_INTERFACE		*dc_interface;
-		ZBX_DC_ITEM			*dc_item;
 		static const ZBX_DC_ITEM	*dc_item_prev = NULL;
 
-		min = zbx_binary_heap_find_min(queue);
-		dc_item = (ZBX_DC_ITEM *)min->data;
-
 		if (dc_item->nextcheck > now)
 			break;
 
@@ -11590,7 +11865,7 @@ int	zbx_dc_config_get_poller_items(unsigned char poller_type, int config_timeout
 			}
 		}
 
-		zbx_binary_heap_remove_min(queue);
+		zbx_timer_wheel_remove_min(queue);
 		dc_item->location = ZBX_LOC_NOWHERE;
 
 		if (NULL == (dc_host = (ZBX_DC_HOST *)zbx_hashset_search(&config->hosts, &dc_item->hostid)))
@@ -11607,7 +11882,7 @@ int	zbx_dc_config_get_poller_items(unsigned char poller_type, int config_timeout
 
 		if (SUCCEED == DCin_maintenance_without_data_collection(dc_host, dc_item))
 		{
-			dc_requeue_item(dc_item, dc_host, dc_interface, ZBX_ITEM_COLLECTED, now);
+			zbx_vector_uint64_append(&requeue_itemids, dc_item->itemid);
 			continue;
 		}
 
@@ -11620,7 +11895,7 @@ int	zbx_dc_config_get_poller_items(unsigned char poller_type, int config_timeout
 				if (ZBX_POLLER_TYPE_UNREACHABLE == poller_type &&
 						ZBX_QUEUE_PRIORITY_LOW != dc_item->queue_priority)
 				{
-					dc_requeue_item(dc_item, dc_host, dc_interface, ZBX_ITEM_COLLECTED, now);
+					zbx_vector_uint64_append(&requeue_itemids, dc_item->itemid);
 					continue;
 				}
 			}
@@ -11630,14 +11905,16 @@ int	zbx_dc_config_get_poller_items(unsigned char poller_type, int config_timeout
 				/* postpone checks on hosts that have been checked recently and */
 				/* are still unreachable                                        */
 				if (ZBX_POLLER_TYPE_NORMAL == poller_type || ZBX_POLLER_TYPE_JAVA == poller_type ||
-						disable_until > now)
+						disable_until > now || FAIL != zbx_vector_uint64_search(&interfaceids,
+						dc_interface->interfaceid, ZBX_DEFAULT_UINT64_COMPARE_FUNC))
 				{
-					dc_requeue_item(dc_item, dc_host, dc_interface,
-							ZBX_ITEM_COLLECTED | ZBX_HOST_UNREACHABLE, now);
+					zbx_vector_uint64_append(&unreachable_itemids, dc_item->itemid);
 					continue;
 				}
 
-				DCincrease_disable_until(dc_interface, now, config_timeout);
+				/* disable until time is increased later with configuration cache write locked */
+				if (0 != dc_interface->errors_from)
+					zbx_vector_uint64_append(&interfaceids, dc_interface->interfaceid);
 			}
 		}
 
@@ -11664,7 +11941,36 @@ int	zbx_dc_config_get_poller_items(unsigned char poller_type, int config_timeout
 		num++;
 	}
 
-	UNLOCK_CACHE;
+	UNLOCK_QUEUE(poller_type);
+
+	if (0 == interfaceids.values_num)
+	{
+		dc_requeue_skipped_items(&requeue_itemids, ZBX_ITEM_COLLECTED, now, FAIL);
+		dc_requeue_skipped_items(&unreachable_itemids, ZBX_ITEM_COLLECTED | ZBX_HOST_UNREACHABLE, now, FAIL);
+
+		UNLOCK_CACHE;
+	}
+	else
+	{
+		UNLOCK_CACHE;
+		WRLOCK_CACHE;
+
+		for (int i = 0; i < interfaceids.values_num; i++)
+		{
+			DCincrease_disable_until((ZBX_DC_INTERFACE *)zbx_hashset_search(&config->interfaces,
+					&interfaceids.values[i]), now, config_timeout);
+		}
+
+		dc_requeue_skipped_items(&requeue_itemids, ZBX_ITEM_COLLECTED, now, SUCCEED);
+		dc_requeue_skipped_items(&unreachable_itemids, ZBX_ITEM_COLLECTED | ZBX_HOST_UNREACHABLE, now,
+				SUCCEED);
+
+		UNLOCK_CACHE;
+	}
+
+	zbx_vector_uint64_destroy(&interfaceids);
+	zbx_vector_uint64_destroy(&unreachable_itemids);
+	zbx_vector_uint64_destroy(&requeue_itemids);
 out:
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%d", __func__, num);
 
@@ -11693,7 +11999,8 @@ int	zbx_dc_config_get_ipmi_poller_items(int now, int items_num, int config_timeo
 		int *nextcheck)
 {
 	int			num = 0;
-	zbx_binary_heap_t	*queue;
+	zbx_timer_wheel_t	*queue;
+	ZBX_DC_ITEM		*dc_item;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
@@ -11701,21 +12008,18 @@ int	zbx_dc_config_get_ipmi_poller_items(int now, int items_num, int config_timeo
 
 	WRLOCK_CACHE;
 
-	while (num < items_num && FAIL == zbx_binary_heap_empty(queue))
-	{
-		int				disable_until;
-		const zbx_binary_heap_elem_t	*min;
-		ZBX_DC_HOST			*dc_host;
-		ZBX_DC_INTERFACE		*dc_interface;
-		ZBX_DC_ITEM			*dc_item;
+	zbx_timer_wheel_advance(queue, now);
 
-		min = zbx_binary_heap_find_min(queue);
-		dc_item = (ZBX_DC_ITEM *)min->data;
+	while (num < items_num && NULL != (dc_item = (ZBX_DC_ITEM *)zbx_timer_wheel_find_min(queue)))
+	{
+		int			disable_until;
+		ZBX_DC_HOST		*dc_host;
+		ZBX_DC_INTERFACE	*dc_interface;
 
 		if (dc_item->nextcheck > now)
 			break;
 
-		zbx_binary_heap_remove_min(queue);
+		zbx_timer_wheel_remove_min(queue);
 		dc_item->location = ZBX_LOC_NOWHERE;
 
 		if (NULL == (dc_host = (ZBX_DC_HOST *)zbx_hashset_search(&config->hosts, &dc_item->hostid)))
@@ -11877,7 +12181,25 @@ unlock:
 	return items_num;
 }
 
-static void	dc_requeue_items(const zbx_uint64_t *itemids, const int *lastclocks, const int *errcodes, size_t num)
+/******************************************************************************
+ *                                                                            *
+ * Purpose: requeues items after polling                                      *
+ *                                                                            *
+ * Parameters: itemids    - [IN] the items to requeue                         *
+ *             lastclocks - [IN] the last polling times                       *
+ *             errcodes   - [IN] the polling result codes                     *
+ *             num        - [IN] the number of items                          *
+ *             queued     - [OUT] indexes of items that are already in queue, *
+ *                                NULL if configuration cache is write locked *
+ *                                                                            *
+ * Comments: With configuration cache read locked only items taken from queue *
+ *           are requeued, as they are owned by the caller. The items still   *
+ *           in queue are returned in queued vector to be requeued with       *
+ *           configuration cache write locked.                                *
+ *                                                                            *
+ ******************************************************************************/
+static void	dc_requeue_items(const zbx_uint64_t *itemids, const int *lastclocks, const int *errcodes, size_t num,
+		zbx_vector_int32_t *queued)
 {
 	size_t			i;
 	ZBX_DC_ITEM		*dc_item;
@@ -11886,12 +12208,20 @@ static void	dc_requeue_items(const zbx_uint64_t *itemids, const int *lastclocks,
 
 	for (i = 0; i < num; i++)
 	{
+		int	flags, lastclock;
+
 		if (FAIL == errcodes[i])
 			continue;
 
 		if (NULL == (dc_item = (ZBX_DC_ITEM *)zbx_hashset_search(&config->items, &itemids[i])))
 			continue;
 
+		if (NULL != queued && ZBX_LOC_QUEUE == dc_item->location)
+		{
+			zbx_vector_int32_append(queued, (int)i);
+			continue;
+		}
+
 		if (ZBX_LOC_POLLER == dc_item->location)
 			dc_item->location = ZBX_LOC_NOWHERE;
 
@@ -11917,39 +12247,91 @@ static void	dc_requeue_items(const zbx_uint64_t *itemids, const int *lastclocks,
 			case CONFIG_ERROR:
 			case SIG_ERROR:
 				dc_item->queue_priority = ZBX_QUEUE_PRIORITY_NORMAL;
-				dc_requeue_item(dc_item, dc_host, dc_interface, ZBX_ITEM_COLLECTED, lastclocks[i]);
+				flags = ZBX_ITEM_COLLECTED;
+				lastclock = lastclocks[i];
 				break;
 			case NETWORK_ERROR:
 			case GATEWAY_ERROR:
 			case TIMEOUT_ERROR:
 				dc_item->queue_priority = ZBX_QUEUE_PRIORITY_LOW;
-				dc_requeue_item(dc_item, dc_host, dc_interface,
-						ZBX_ITEM_COLLECTED | ZBX_HOST_UNREACHABLE, time(NULL));
+				flags = ZBX_ITEM_COLLECTED | ZBX_HOST_UNREACHABLE;
+				lastclock = (int)time(NULL);
 				break;
 			default:
 				THIS_SHOULD_NEVER_HAPPEN;
+				continue;
 		}
+
+		if (NULL == queued)
+			dc_requeue_item(dc_item, dc_host, dc_interface, flags, lastclock);
+		else
+			dc_requeue_item_rdlocked(dc_item, dc_host, dc_interface, flags, lastclock);
 	}
 }
 
-void	zbx_dc_requeue_items(const zbx_uint64_t *itemids, const int *lastclocks, const int *errcodes, size_t num)
+/******************************************************************************
+ *                                                                            *
+ * Purpose: requeues items after polling and optionally gets the next check   *
+ *          time of poller queue                                              *
+ *                                                                            *
+ * Parameters: itemids     - [IN] the items to requeue                        *
+ *             lastclocks  - [IN] the last polling times                      *
+ *             errcodes    - [IN] the polling result codes                    *
+ *             num         - [IN] the number of items                         *
+ *             poller_type - [IN] the poller type                             *
+ *             nextcheck   - [OUT] the next check time of poller type queue,  *
+ *                                 optional                                   *
+ *                                                                            *
+ ******************************************************************************/
+static void	dc_poller_requeue_items(const zbx_uint64_t *itemids, const int *lastclocks, const int *errcodes,
+		size_t num, unsigned char poller_type, int *nextcheck)
 {
-	WRLOCK_CACHE;
+	zbx_vector_int32_t	queued;
+
+	zbx_vector_int32_create(&queued);
+
+	RDLOCK_CACHE;
 
-	dc_requeue_items(itemids, lastclocks, errcodes, num);
+	dc_requeue_items(itemids, lastclocks, errcodes, num, &queued);
+
+	if (NULL != nextcheck && 0 == queued.values_num)
+	{
+		LOCK_QUEUE(poller_type);
+		*nextcheck = dc_config_get_queue_nextcheck(&config->queues[poller_type]);
+		UNLOCK_QUEUE(poller_type);
+	}
 
 	UNLOCK_CACHE;
+
+	if (0 != queued.values_num)
+	{
+		WRLOCK_CACHE;
+
+		for (int i = 0; i < queued.values_num; i++)
+		{
+			int	index = queued.values[i];
+
+			dc_requeue_items(&itemids[index], &lastclocks[index], &errcodes[index], 1, NULL);
+		}
+
+		if (NULL != nextcheck)
+			*nextcheck = dc_config_get_queue_nextcheck(&config->queues[poller_type]);
+
+		UNLOCK_CACHE;
+	}
+
+	zbx_vector_int32_destroy(&queued);
+}
+
+void	zbx_dc_requeue_items(const zbx_uint64_t *itemids, const int *lastclocks, const int *errcodes, size_t num)
+{
+	dc_poller_requeue_items(itemids, lastclocks, errcodes, num, ZBX_NO_POLLER, NULL);
 }
 
 void	zbx_dc_poller_requeue_items(const zbx_uint64_t *itemids, const int *lastclocks,
 		const int *errcodes, size_t num, unsigned char poller_type, int *nextcheck)
 {
-	WRLOCK_CACHE;
-
-	dc_requeue_items(itemids, lastclocks, errcodes, num);
-	*nextcheck = dc_config_get_queue_nextcheck(&config->queues[poller_type]);
-
-	UNLOCK_CACHE;
+	dc_poller_requeue_items(itemids, lastclocks, errcodes, num, poller_type, nextcheck);
 }
 
 #ifdef HAVE_OPENIPMI
@@ -12635,6 +13017,67 @@ void	*zbx_dc_config_get_stats(int request)
 	}
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get configuration cache lock statistics                           *
+ *                                                                            *
+ * Parameters: stats - [OUT] lock statistics summed by process type, array of *
+ *                           ZBX_PROCESS_TYPE_COUNT elements                  *
+ *                                                                            *
+ * Comments: The statistics are read without locking, as they are updated by  *
+ *           the processes while acquiring the lock. Lock statistics are      *
+ *           collected starting with the first request, so the first returned *
+ *           statistics are zero.                                             *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_dc_config_get_lock_stats(zbx_dc_lock_stats_t *stats)
+{
+	memset(stats, 0, sizeof(zbx_dc_lock_stats_t) * ZBX_PROCESS_TYPE_COUNT);
+	config->lock_stats_enabled = 1;
+
+	for (unsigned char proc_type = 0; ZBX_PROCESS_TYPE_COUNT > proc_type; proc_type++)
+	{
+		int	proc_num = get_config_forks_cb(proc_type);
+
+		for (int i = 0; i < proc_num; i++)
+		{
+			const zbx_dc_lock_stats_t	*proc_stats = &config->lock_stats[lock_stats_index[proc_type] + i];
+
+			stats[proc_type].rdlock_num += proc_stats->rdlock_num;
+			stats[proc_type].wrlock_num += proc_stats->wrlock_num;
+			stats[proc_type].rdlock_wait += proc_stats->rdlock_wait;
+			stats[proc_type].wrlock_wait += proc_stats->wrlock_wait;
+		}
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get user macro resolution cache statistics                        *
+ *                                                                            *
+ * Parameters: stats - [OUT] resolution cache statistics summed by process    *
+ *                           type, array of ZBX_PROCESS_TYPE_COUNT elements   *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_dc_config_get_um_memo_stats(zbx_dc_um_memo_stats_t *stats)
+{
+	memset(stats, 0, sizeof(zbx_dc_um_memo_stats_t) * ZBX_PROCESS_TYPE_COUNT);
+
+	for (unsigned char proc_type = 0; ZBX_PROCESS_TYPE_COUNT > proc_type; proc_type++)
+	{
+		int	proc_num = get_config_forks_cb(proc_type);
+
+		for (int i = 0; i < proc_num; i++)
+		{
+			const zbx_dc_um_memo_stats_t	*proc_stats;
+
+			proc_stats = &config->um_memo_stats[lock_stats_index[proc_type] + i];
+			stats[proc_type].hits += proc_stats->hits;
+			stats[proc_type].misses += proc_stats->misses;
+		}
+	}
+}
+
 static void	DCget_proxy(zbx_dc_proxy_t *dst_proxy, const ZBX_DC_PROXY *src_proxy)
 {
 	dst_proxy->proxyid = src_proxy->proxyid;
@@ -12711,7 +13154,8 @@ int	zbx_dc_config_get_proxypoller_hosts(zbx_dc_proxy_t *proxies, int max_hosts)
 {
 	time_t			now;
 	int			num = 0;
-	zbx_binary_heap_t	*queue;
+	zbx_timer_wheel_t	*queue;
+	ZBX_DC_PROXY		*dc_proxy;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
@@ -12721,18 +13165,14 @@ int	zbx_dc_config_get_proxypoller_hosts(zbx_dc_proxy_t *proxies, int max_hosts)
 
 	WRLOCK_CACHE;
 
-	while (num < max_hosts && FAIL == zbx_binary_heap_empty(queue))
-	{
-		const zbx_binary_heap_elem_t	*min;
-		ZBX_DC_PROXY			*dc_proxy;
-
-		min = zbx_binary_heap_find_min(queue);
-		dc_proxy = (ZBX_DC_PROXY *)min->data;
+	zbx_timer_wheel_advance(queue, (int)now);
 
+	while (num < max_hosts && NULL != (dc_proxy = (ZBX_DC_PROXY *)zbx_timer_wheel_find_min(queue)))
+	{
 		if (dc_proxy->nextcheck > now)
 			break;
 
-		zbx_binary_heap_remove_min(queue);
+		zbx_timer_wheel_remove_min(queue);
 		dc_proxy->location = ZBX_LOC_POLLER;
 
 		DCget_proxy(&proxies[num], dc_proxy);
@@ -12756,7 +13196,7 @@ int	zbx_dc_config_get_proxypoller_hosts(zbx_dc_proxy_t *proxies, int max_hosts)
 int	zbx_dc_config_get_proxypoller_nextcheck(void)
 {
 	int			nextcheck;
-	zbx_binary_heap_t	*queue;
+	zbx_timer_wheel_t	*queue;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
@@ -12764,18 +13204,7 @@ int	zbx_dc_config_get_proxypoller_nextcheck(void)
 
 	RDLOCK_CACHE;
 
-	if (FAIL == zbx_binary_heap_empty(queue))
-	{
-		const zbx_binary_heap_elem_t	*min;
-		const ZBX_DC_PROXY		*dc_proxy;
-
-		min = zbx_binary_heap_find_min(queue);
-		dc_proxy = (const ZBX_DC_PROXY *)min->data;
-
-		nextcheck = dc_proxy->nextcheck;
-	}
-	else
-		nextcheck = FAIL;
+	nextcheck = zbx_timer_wheel_get_nexttime(queue);
 
 	UNLOCK_CACHE;
 
@@ -14453,6 +14882,35 @@ void	zbx_dc_correlation_rules_get(zbx_correlation_rules_t *rules)
 	zbx_vector_correlation_ptr_sort(&rules->correlations, zbx_correlation_compare_func);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: finds nested group identifiers by scanning group name index       *
+ *                                                                            *
+ * Parameter: parent_group    - [IN] parent group                             *
+ *            nested_groupids - [OUT] nested group ids                        *
+ *                                                                            *
+ ******************************************************************************/
+static void	dc_hostgroup_find_nested_groupids(const zbx_dc_hostgroup_t *parent_group,
+		zbx_vector_uint64_t *nested_groupids)
+{
+	const zbx_dc_hostgroup_t	*group;
+	int				index, len;
+
+	index = zbx_vector_ptr_bsearch(&config->hostgroups_name, parent_group, dc_compare_hgroups);
+	len = strlen(parent_group->name);
+
+	while (++index < config->hostgroups_name.values_num)
+	{
+		group = (const zbx_dc_hostgroup_t *)config->hostgroups_name.values[index];
+
+		if (0 != strncmp(group->name, parent_group->name, len))
+			break;
+
+		if ('\0' == group->name[len] || '/' == group->name[len])
+			zbx_vector_uint64_append(nested_groupids, group->groupid);
+	}
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: cache nested group identifiers                                    *
@@ -14460,28 +14918,12 @@ void	zbx_dc_correlation_rules_get(zbx_correlation_rules_t *rules)
  ******************************************************************************/
 void	dc_hostgroup_cache_nested_groupids(zbx_dc_hostgroup_t *parent_group)
 {
-	zbx_dc_hostgroup_t	*group;
-
 	if (0 == (parent_group->flags & ZBX_DC_HOSTGROUP_FLAGS_NESTED_GROUPIDS))
 	{
-		int	index, len;
-
 		zbx_vector_uint64_create_ext(&parent_group->nested_groupids, __config_shmem_malloc_func,
 				__config_shmem_realloc_func, __config_shmem_free_func);
 
-		index = zbx_vector_ptr_bsearch(&config->hostgroups_name, parent_group, dc_compare_hgroups);
-		len = strlen(parent_group->name);
-
-		while (++index < config->hostgroups_name.values_num)
-		{
-			group = (zbx_dc_hostgroup_t *)config->hostgroups_name.values[index];
-
-			if (0 != strncmp(group->name, parent_group->name, len))
-				break;
-
-			if ('\0' == group->name[len] || '/' == group->name[len])
-				zbx_vector_uint64_append(&parent_group->nested_groupids, group->groupid);
-		}
+		dc_hostgroup_find_nested_groupids(parent_group, &parent_group->nested_groupids);
 
 		parent_group->flags |= ZBX_DC_HOSTGROUP_FLAGS_NESTED_GROUPIDS;
 	}
@@ -14529,6 +14971,32 @@ static void	dc_maintenance_precache_nested_groups(void)
 	zbx_vector_uint64_destroy(&groupids);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: pre-caches nested groups for groups used in action conditions     *
+ *                                                                            *
+ ******************************************************************************/
+static void	dc_action_precache_nested_groups(void)
+{
+	zbx_hashset_iter_t		iter;
+	zbx_dc_action_condition_t	*condition;
+	zbx_dc_hostgroup_t		*group;
+	zbx_uint64_t			groupid;
+
+	zbx_hashset_iter_reset(&config->action_conditions, &iter);
+	while (NULL != (condition = (zbx_dc_action_condition_t *)zbx_hashset_iter_next(&iter)))
+	{
+		if (ZBX_CONDITION_TYPE_HOST_GROUP != condition->conditiontype)
+			continue;
+
+		if (SUCCEED != zbx_is_uint64(condition->value, &groupid))
+			continue;
+
+		if (NULL != (group = (zbx_dc_hostgroup_t *)zbx_hashset_search(&config->hostgroups, &groupid)))
+			dc_hostgroup_cache_nested_groupids(group);
+	}
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: gets nested group ids for the specified host group                *
@@ -14643,6 +15111,294 @@ void	zbx_dc_get_hostids_by_group_name(const char *name, zbx_vector_uint64_t *hos
 	zbx_vector_uint64_uniq(hostids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets nested group ids for the specified host group without        *
+ *          updating configuration cache, so read lock is sufficient          *
+ *                                                                            *
+ * Parameter: groupid         - [IN] parent group identifier                  *
+ *            nested_groupids - [OUT] nested + parent group ids               *
+ *                                                                            *
+ ******************************************************************************/
+static void	dc_find_nested_hostgroupids(zbx_uint64_t groupid, zbx_vector_uint64_t *nested_groupids)
+{
+	const zbx_dc_hostgroup_t	*parent_group;
+
+	zbx_vector_uint64_append(nested_groupids, groupid);
+
+	if (NULL == (parent_group = (const zbx_dc_hostgroup_t *)zbx_hashset_search(&config->hostgroups, &groupid)))
+		return;
+
+	/* nested groups of groups used in action conditions are pre-cached during configuration sync */
+	if (0 != (parent_group->flags & ZBX_DC_HOSTGROUP_FLAGS_NESTED_GROUPIDS))
+	{
+		zbx_vector_uint64_append_array(nested_groupids, parent_group->nested_groupids.values,
+				parent_group->nested_groupids.values_num);
+	}
+	else
+		dc_hostgroup_find_nested_groupids(parent_group, nested_groupids);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets triggers having items on hosts in the specified host group   *
+ *          or its nested groups                                              *
+ *                                                                            *
+ * Parameter: triggerids         - [IN] triggers to check                     *
+ *            groupid            - [IN] host group identifier                 *
+ *            matched_triggerids - [OUT] matching triggers                    *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_dc_get_triggers_by_hostgroup(const zbx_vector_uint64_t *triggerids, zbx_uint64_t groupid,
+		zbx_vector_uint64_t *matched_triggerids)
+{
+	zbx_vector_uint64_t	groupids;
+	zbx_vector_ptr_t	groups;
+
+	zbx_vector_uint64_create(&groupids);
+	zbx_vector_ptr_create(&groups);
+
+	RDLOCK_CACHE;
+
+	dc_find_nested_hostgroupids(groupid, &groupids);
+
+	for (int i = 0; i < groupids.values_num; i++)
+	{
+		zbx_dc_hostgroup_t	*group;
+
+		if (NULL != (group = (zbx_dc_hostgroup_t *)zbx_hashset_search(&config->hostgroups,
+				&groupids.values[i])))
+		{
+			zbx_vector_ptr_append(&groups, group);
+		}
+	}
+
+	for (int i = 0; 0 != groups.values_num && i < triggerids->values_num; i++)
+	{
+		const ZBX_DC_TRIGGER	*trigger;
+		const zbx_uint64_t	*itemid;
+		int			found = 0;
+
+		if (NULL == (trigger = (const ZBX_DC_TRIGGER *)zbx_hashset_search(&config->triggers,
+				&triggerids->values[i])) || NULL == trigger->itemids)
+		{
+			continue;
+		}
+
+		for (itemid = trigger->itemids; 0 != *itemid && 0 == found; itemid++)
+		{
+			const ZBX_DC_ITEM	*item;
+
+			if (NULL == (item = (const ZBX_DC_ITEM *)zbx_hashset_search(&config->items, itemid)))
+				continue;
+
+			for (int j = 0; j < groups.values_num; j++)
+			{
+				zbx_dc_hostgroup_t	*group = (zbx_dc_hostgroup_t *)groups.values[j];
+
+				if (NULL != zbx_hashset_search(&group->hostids, &item->hostid))
+				{
+					found = 1;
+					break;
+				}
+			}
+		}
+
+		if (0 != found)
+			zbx_vector_uint64_append(matched_triggerids, trigger->triggerid);
+	}
+
+	UNLOCK_CACHE;
+
+	zbx_vector_ptr_destroy(&groups);
+	zbx_vector_uint64_destroy(&groupids);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets identifier of the item the specified item was inherited from *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_uint64_t	dc_item_get_templateid(zbx_uint64_t itemid)
+{
+	const ZBX_DC_ITEM		*item;
+	const ZBX_DC_TEMPLATE_ITEM	*template_item;
+
+	if (NULL != (item = (const ZBX_DC_ITEM *)zbx_hashset_search(&config->items, &itemid)))
+		return item->templateid;
+
+	if (NULL != (template_item = (const ZBX_DC_TEMPLATE_ITEM *)zbx_hashset_search(&config->template_items,
+			&itemid)))
+	{
+		return template_item->templateid;
+	}
+
+	return 0;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: checks if trigger is inherited from a trigger on the specified    *
+ *          template                                                          *
+ *                                                                            *
+ * Parameter: trigger    - [IN] trigger to check                              *
+ *            templateid - [IN] template identifier                           *
+ *            itemids    - [IN/OUT] work vector                               *
+ *                                                                            *
+ * Return value: SUCCEED - trigger is inherited from the template             *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ * Comments: Template triggers are cached without functions, so template      *
+ *           hosts are resolved by following the inheritance of trigger       *
+ *           items, which is linked in parallel with trigger inheritance.     *
+ *           Discovered triggers are resolved through their prototypes.       *
+ *                                                                            *
+ ******************************************************************************/
+static int	dc_trigger_match_template(const ZBX_DC_TRIGGER *trigger, zbx_uint64_t templateid,
+		zbx_vector_uint64_t *itemids)
+{
+	const zbx_uint64_t	*itemid;
+
+	zbx_vector_uint64_clear(itemids);
+
+	for (itemid = trigger->itemids; 0 != *itemid; itemid++)
+	{
+		const ZBX_DC_ITEM_DISCOVERY	*item_discovery;
+
+		/* discovered trigger prototype references item prototypes instead of discovered items */
+		if (0 != trigger->parent_triggerid && NULL != (item_discovery = (const ZBX_DC_ITEM_DISCOVERY *)
+				zbx_hashset_search(&config->item_discovery, itemid)))
+		{
+			zbx_vector_uint64_append(itemids, item_discovery->parent_itemid);
+		}
+		else
+			zbx_vector_uint64_append(itemids, *itemid);
+	}
+
+	if (0 != trigger->parent_triggerid && NULL == (trigger = (const ZBX_DC_TRIGGER *)zbx_hashset_search(
+			&config->triggers, &trigger->parent_triggerid)))
+	{
+		return FAIL;
+	}
+
+	while (0 != trigger->templateid && 0 != itemids->values_num)
+	{
+		int	i, k;
+
+		if (NULL == (trigger = (const ZBX_DC_TRIGGER *)zbx_hashset_search(&config->triggers,
+				&trigger->templateid)))
+		{
+			break;
+		}
+
+		for (i = 0, k = 0; i < itemids->values_num; i++)
+		{
+			const ZBX_DC_TEMPLATE_ITEM	*template_item;
+			zbx_uint64_t			parent_itemid;
+
+			if (0 == (parent_itemid = dc_item_get_templateid(itemids->values[i])))
+				continue;
+
+			if (NULL == (template_item = (const ZBX_DC_TEMPLATE_ITEM *)zbx_hashset_search(
+					&config->template_items, &parent_itemid)))
+			{
+				continue;
+			}
+
+			if (template_item->hostid == templateid)
+				return SUCCEED;
+
+			itemids->values[k++] = parent_itemid;
+		}
+
+		itemids->values_num = k;
+	}
+
+	return FAIL;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets triggers inherited from triggers on the specified template   *
+ *          at any level of template hierarchy                                *
+ *                                                                            *
+ * Parameter: triggerids         - [IN] triggers to check                     *
+ *            templateid         - [IN] template identifier                   *
+ *            matched_triggerids - [OUT] matching triggers                    *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_dc_get_triggers_by_template(const zbx_vector_uint64_t *triggerids, zbx_uint64_t templateid,
+		zbx_vector_uint64_t *matched_triggerids)
+{
+	zbx_vector_uint64_t	itemids;
+
+	zbx_vector_uint64_create(&itemids);
+
+	RDLOCK_CACHE;
+
+	for (int i = 0; i < triggerids->values_num; i++)
+	{
+		const ZBX_DC_TRIGGER	*trigger;
+
+		if (NULL == (trigger = (const ZBX_DC_TRIGGER *)zbx_hashset_search(&config->triggers,
+				&triggerids->values[i])) || NULL == trigger->itemids)
+		{
+			continue;
+		}
+
+		if (SUCCEED == dc_trigger_match_template(trigger, templateid, &itemids))
+			zbx_vector_uint64_append(matched_triggerids, trigger->triggerid);
+	}
+
+	UNLOCK_CACHE;
+
+	zbx_vector_uint64_destroy(&itemids);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets triggers inherited from the specified template trigger at    *
+ *          any level of template hierarchy                                   *
+ *                                                                            *
+ * Parameter: triggerids         - [IN] triggers to check                     *
+ *            parent_triggerid   - [IN] template trigger identifier           *
+ *            matched_triggerids - [OUT] matching triggers                    *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_dc_get_triggers_by_parent(const zbx_vector_uint64_t *triggerids, zbx_uint64_t parent_triggerid,
+		zbx_vector_uint64_t *matched_triggerids)
+{
+	RDLOCK_CACHE;
+
+	for (int i = 0; i < triggerids->values_num; i++)
+	{
+		const ZBX_DC_TRIGGER	*trigger;
+
+		if (NULL == (trigger = (const ZBX_DC_TRIGGER *)zbx_hashset_search(&config->triggers,
+				&triggerids->values[i])))
+		{
+			continue;
+		}
+
+		while (0 != trigger->templateid)
+		{
+			if (trigger->templateid == parent_triggerid)
+			{
+				zbx_vector_uint64_append(matched_triggerids, triggerids->values[i]);
+				break;
+			}
+
+			if (NULL == (trigger = (const ZBX_DC_TRIGGER *)zbx_hashset_search(&config->triggers,
+					&trigger->templateid)))
+			{
+				break;
+			}
+		}
+	}
+
+	UNLOCK_CACHE;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: gets active proxy data by its name from configuration cache       *
@@ -16370,7 +17126,7 @@ int	zbx_dc_expand_user_and_func_macros(const zbx_dc_um_handle_t *um_handle, char
 		switch(token.type)
 		{
 			case ZBX_TOKEN_USER_FUNC_MACRO:
-				um_cache_resolve_const(dc_um_get_cache(um_handle), hostids, hostids_num, *text +
+				um_cache_resolve_const_memo(dc_um_get_cache(um_handle), hostids, hostids_num, *text +
 						token.loc.l + 1, um_handle->macro_env, &value);
 
 				if (NULL != value)
@@ -16386,7 +17142,7 @@ int	zbx_dc_expand_user_and_func_macros(const zbx_dc_um_handle_t *um_handle, char
 
 				break;
 			case ZBX_TOKEN_USER_MACRO:
-				um_cache_resolve_const(dc_um_get_cache(um_handle), hostids, hostids_num, *text +
+				um_cache_resolve_const_memo(dc_um_get_cache(um_handle), hostids, hostids_num, *text +
 						token.loc.l, um_handle->macro_env, &value);
 				break;
 			default:
@@ -16725,24 +17481,23 @@ static void	dc_reschedule_httptests(zbx_hashset_t *activated_hosts)
  ******************************************************************************/
 void	zbx_dc_drules_get(time_t now, zbx_vector_dc_drule_ptr_t *drules, time_t *nextcheck)
 {
-	zbx_binary_heap_elem_t	*elem;
-	zbx_dc_drule_t		*drule, *drule_out = NULL;
+	zbx_dc_drule_t	*drule, *drule_out = NULL;
+	int		time_next;
 
 	*nextcheck = 0;
 
 	WRLOCK_CACHE;
 
-	while (FAIL == zbx_binary_heap_empty(&config->drule_queue))
-	{
-		elem = zbx_binary_heap_find_min(&config->drule_queue);
-		drule = (zbx_dc_drule_t *)elem->data;
+	zbx_timer_wheel_advance(&config->drule_queue, (int)now);
 
+	while (NULL != (drule = (zbx_dc_drule_t *)zbx_timer_wheel_find_min(&config->drule_queue)))
+	{
 		if (drule->nextcheck <= now)
 		{
 			zbx_hashset_iter_t	iter;
 			zbx_dc_dcheck_t		*dcheck, *dheck_out;
 
-			zbx_binary_heap_remove_min(&config->drule_queue);
+			zbx_timer_wheel_remove_min(&config->drule_queue);
 			drule->location = ZBX_LOC_POLLER;
 
 			drule_out = zbx_malloc(NULL, sizeof(zbx_dc_drule_t));
@@ -16805,6 +17560,9 @@ void	zbx_dc_drules_get(time_t now, zbx_vector_dc_drule_ptr_t *drules, time_t *ne
 		}
 	}
 
+	if (0 == *nextcheck && FAIL != (time_next = zbx_timer_wheel_get_nexttime(&config->drule_queue)))
+		*nextcheck = time_next;
+
 	UNLOCK_CACHE;
 }
 
@@ -16898,23 +17656,21 @@ int	zbx_dc_drule_revisions_get(zbx_uint64_t *rev_last, zbx_vector_uint64_pair_t
  ******************************************************************************/
 int	zbx_dc_httptest_next(time_t now, zbx_uint64_t *httptestid, time_t *nextcheck)
 {
-	zbx_binary_heap_elem_t	*elem;
 	zbx_dc_httptest_t	*httptest;
-	int			ret = FAIL;
+	int			ret = FAIL, time_next;
 	ZBX_DC_HOST		*dc_host;
 
 	*nextcheck = 0;
 
 	WRLOCK_CACHE;
 
-	while (FAIL == zbx_binary_heap_empty(&config->httptest_queue))
-	{
-		elem = zbx_binary_heap_find_min(&config->httptest_queue);
-		httptest = (zbx_dc_httptest_t *)elem->data;
+	zbx_timer_wheel_advance(&config->httptest_queue, (int)now);
 
+	while (NULL != (httptest = (zbx_dc_httptest_t *)zbx_timer_wheel_find_min(&config->httptest_queue)))
+	{
 		if (httptest->nextcheck <= now)
 		{
-			zbx_binary_heap_remove_min(&config->httptest_queue);
+			zbx_timer_wheel_remove_min(&config->httptest_queue);
 			httptest->location = ZBX_LOC_NOWHERE;
 
 			if (NULL == (dc_host = (ZBX_DC_HOST *)zbx_hashset_search(&config->hosts, &httptest->hostid)))
@@ -16943,6 +17699,12 @@ int	zbx_dc_httptest_next(time_t now, zbx_uint64_t *httptestid, time_t *nextcheck
 		break;
 	}
 
+	if (SUCCEED != ret && 0 == *nextcheck &&
+			FAIL != (time_next = zbx_timer_wheel_get_nexttime(&config->httptest_queue)))
+	{
+		*nextcheck = time_next;
+	}
+
 	UNLOCK_CACHE;
 
 	return ret;
@@ -52,6 +52,8 @@ typedef struct
 	int			lastchange;
 	zbx_uint64_t		revision;
 	zbx_uint64_t		timer_revision;
+	zbx_uint64_t		templateid;
+	zbx_uint64_t		parent_triggerid;	/* prototype of discovered trigger */
 	unsigned char		topoindex;
 	unsigned char		priority;
 	unsigned char		type;
@@ -288,6 +290,7 @@ typedef struct
 	ZBX_DC_PREPROCITEM	*preproc_item;
 	ZBX_DC_MASTERITEM	*master_item;
 	zbx_vector_ptr_t	tags;
+	zbx_timer_wheel_node_t	queue_node;
 	int			nextcheck;
 	int			mtime;
 	int			data_expected_from;
@@ -340,13 +343,14 @@ ZBX_PTR_VECTOR_DECL(dc_item_ptr, ZBX_DC_ITEM *)
 
 typedef struct
 {
-	zbx_uint64_t	httptestid;
-	zbx_uint64_t	hostid;
-	time_t		nextcheck;
-	int		delay;
-	unsigned char	status;
-	unsigned char	location;
-	zbx_uint64_t	revision;
+	zbx_uint64_t		httptestid;
+	zbx_uint64_t		hostid;
+	zbx_timer_wheel_node_t	queue_node;
+	time_t			nextcheck;
+	int			delay;
+	unsigned char		status;
+	unsigned char		location;
+	zbx_uint64_t		revision;
 }
 zbx_dc_httptest_t;
 
@@ -464,6 +468,7 @@ typedef struct
 	int				proxy_config_nextcheck;
 	int				proxy_data_nextcheck;
 	int				proxy_tasks_nextcheck;
+	zbx_timer_wheel_node_t		queue_node;
 	int				nextcheck;
 	int				lastaccess;
 	int				proxy_delay;
@@ -1038,11 +1043,13 @@ typedef struct
 	zbx_hashset_t		host_proxy;
 	zbx_hashset_t		host_proxy_index;
 	zbx_hashset_t		sessions[ZBX_SESSION_TYPE_COUNT];
-	zbx_binary_heap_t	queues[ZBX_POLLER_TYPE_COUNT];
-	zbx_binary_heap_t	pqueue;
+	zbx_timer_wheel_t	queues[ZBX_POLLER_TYPE_COUNT];	/* item queues can be updated either with */
+								/* write lock or with read lock and the   */
+								/* queue lock of the poller type          */
+	zbx_timer_wheel_t	pqueue;
 	zbx_binary_heap_t	trigger_queue;
-	zbx_binary_heap_t	drule_queue;
-	zbx_binary_heap_t	httptest_queue;		/* web scenario queue */
+	zbx_timer_wheel_t	drule_queue;
+	zbx_timer_wheel_t	httptest_queue;		/* web scenario queue */
 	zbx_dc_config_table_t	*config;
 	ZBX_DC_STATUS		*status;
 	zbx_hashset_t		strpool;
@@ -1050,6 +1057,9 @@ typedef struct
 	char			autoreg_psk_identity[HOST_TLS_PSK_IDENTITY_LEN_MAX];	/* autoregistration PSK */
 	char			autoreg_psk[HOST_TLS_PSK_LEN_MAX];
 	zbx_vps_monitor_t	vps_monitor;
+	zbx_dc_lock_stats_t	*lock_stats;		/* configuration cache lock statistics per process */
+	int			lock_stats_enabled;	/* lock statistics are collected after first request */
+	zbx_dc_um_memo_stats_t	*um_memo_stats;		/* user macro resolution statistics per process */
 	char			*proxy_hostname;	/* hostname - proxy only */
 	int			proxy_failover_delay;		/* proxy group failover delay - proxy only    */
 	const char		*proxy_failover_delay_raw;	/* raw failover delay value - proxy only      */
@@ -1099,6 +1109,8 @@ const char	*dc_strpool_acquire(const char *str);
 void	dc_strpool_release(const char *str);
 int	dc_strpool_replace(int found, const char **curr, const char *new_str);
 
+zbx_dc_um_memo_stats_t	*dc_get_um_memo_stats_local(void);
+
 /* host groups */
 void	dc_get_nested_hostgroupids(zbx_uint64_t groupid, zbx_vector_uint64_t *nested_groupids);
 void	dc_hostgroup_cache_nested_groupids(zbx_dc_hostgroup_t *parent_group);
@@ -900,8 +900,8 @@ static void	DCdump_triggers(void)
 		trigger = (ZBX_DC_TRIGGER *)index.values[i];
 		if (ZBX_FLAG_DISCOVERY_PROTOTYPE == trigger->flags)
 		{
-			zabbix_log(LOG_LEVEL_TRACE, "triggerid:" ZBX_FS_UI64 " flags:%u", trigger->triggerid,
-					trigger->flags);
+			zabbix_log(LOG_LEVEL_TRACE, "triggerid:" ZBX_FS_UI64 " flags:%u templateid:" ZBX_FS_UI64,
+					trigger->triggerid, trigger->flags, trigger->templateid);
 			continue;
 		}
 
@@ -917,6 +917,8 @@ static void	DCdump_triggers(void)
 		zabbix_log(LOG_LEVEL_TRACE, "  topoindex:%u functional:%u locked:%u", trigger->topoindex,
 				trigger->functional, trigger->locked);
 		zabbix_log(LOG_LEVEL_TRACE, "  opdata:'%s'", trigger->opdata);
+		zabbix_log(LOG_LEVEL_TRACE, "  templateid:" ZBX_FS_UI64 " parent_triggerid:" ZBX_FS_UI64,
+				trigger->templateid, trigger->parent_triggerid);
 
 		if (NULL != trigger->itemids)
 		{
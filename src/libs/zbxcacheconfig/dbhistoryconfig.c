@@ -982,6 +982,8 @@ void	zbx_dc_config_history_sync_get_connectors(zbx_hashset_t *connectors, zbx_ha
 
 				connector->senders = 0;
 				connector->time_flush = 0;
+				connector->queued_values_num = 0;
+				connector->queued_bytes = 0;
 			}
 
 			connector->revision = dc_config->revision.connector;
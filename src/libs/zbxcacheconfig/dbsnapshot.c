@@ -0,0 +1,1107 @@
+/*
+** Copyright (C) 2001-2024 Zabbix SIA
+**
+** This program is free software: you can redistribute it and/or modify it under the terms of
+** the GNU Affero General Public License as published by the Free Software Foundation, version 3.
+**
+** This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+** without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+** See the GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License along with this program.
+** If not, see <https://www.gnu.org/licenses/>.
+**/
+
+#include "dbsnapshot.h"
+
+#include "zbxcacheconfig.h"
+#include "zbxcommon.h"
+#include "zbxalgo.h"
+#include "zbxstr.h"
+#include "zbxtime.h"
+
+/******************************************************************************
+ *                                                                            *
+ * Configuration cache snapshot file contains rows of the tables tracked by   *
+ * changelog together with the processed changelog records. It starts with    *
+ * the rows loaded by full synchronization (snapshot base) followed by rows   *
+ * changed by incremental synchronizations. Every successful synchronization  *
+ * is terminated by commit record, data after the last commit record is       *
+ * discarded when snapshot is loaded.                                         *
+ *                                                                            *
+ * The file is stored in host byte order:                                     *
+ *   header - <magic><format><version length><version>                        *
+ *   record - <type (1 byte)><payload size (4 bytes)><payload>                *
+ *                                                                            *
+ ******************************************************************************/
+
+#define ZBX_DBSNAPSHOT_MAGIC		"ZBXCSNAP"
+#define ZBX_DBSNAPSHOT_FORMAT		2
+#define ZBX_DBSNAPSHOT_VERSION		ZABBIX_VERSION " (revision " ZABBIX_REVISION ")"
+
+/* <object><rowid><columns num>[<column length><column value with terminating zero>]... */
+#define ZBX_DBSNAPSHOT_RECORD_ROW		1
+/* <object><rowid> */
+#define ZBX_DBSNAPSHOT_RECORD_REMOVE		2
+/* <changelogid><clock> */
+#define ZBX_DBSNAPSHOT_RECORD_CHANGELOG		3
+/* <commit clock> */
+#define ZBX_DBSNAPSHOT_RECORD_COMMIT		4
+
+#define ZBX_DBSNAPSHOT_RECORD_HEADER_SIZE	(sizeof(unsigned char) + sizeof(zbx_uint32_t))
+#define ZBX_DBSNAPSHOT_ROW_HEADER_SIZE		(sizeof(unsigned char) + sizeof(zbx_uint64_t))
+#define ZBX_DBSNAPSHOT_CHANGELOG_SIZE		(sizeof(zbx_uint64_t) + sizeof(zbx_uint32_t))
+
+/* column length of NULL values */
+#define ZBX_DBSNAPSHOT_NULL_COLUMN		0xffffffff
+
+#define ZBX_DBSNAPSHOT_STATE_IDLE		0
+#define ZBX_DBSNAPSHOT_STATE_BASE		1
+#define ZBX_DBSNAPSHOT_STATE_DELTA		2
+
+/* snapshot is compacted when the size of incremental changes exceeds */
+/* the size of snapshot base and this limit                            */
+#define ZBX_DBSNAPSHOT_COMPACT_SIZE_MIN		(16 * ZBX_MEBIBYTE)
+
+/* commit record is written at least once per interval even without changes, */
+/* so its clock tells when snapshot was known to be up to date              */
+#define ZBX_DBSNAPSHOT_COMMIT_INTERVAL		SEC_PER_MIN
+
+typedef struct
+{
+	zbx_uint64_t	rowid;
+	zbx_uint64_t	offset;
+	unsigned char	removed;
+}
+zbx_dbsnapshot_index_t;
+
+typedef struct
+{
+	char		*path;
+	char		*path_tmp;
+
+	/* the committed snapshot, used to append incremental changes */
+	FILE		*file;
+
+	/* the new snapshot written by full synchronization or compaction */
+	FILE		*file_tmp;
+
+	zbx_uint64_t	base_size;
+	zbx_uint64_t	commit_size;
+	int		commit_clock;
+
+	unsigned char	state;
+	int		records_num;
+	int		error;
+
+	/* the latest row offsets by changelog objects */
+	zbx_hashset_t	index[ZBX_DBSYNC_OBJ_COUNT];
+	int		index_created;
+
+	unsigned char	*buf;
+	size_t		buf_alloc;
+	char		**row;
+	int		row_alloc;
+}
+zbx_dbsnapshot_t;
+
+static zbx_dbsnapshot_t	dbsnapshot;
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: sets configuration cache snapshot file                            *
+ *                                                                            *
+ * Parameters: path - [IN] the snapshot file path, NULL or empty string       *
+ *                         disables snapshot                                  *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_dc_set_snapshot_file(const char *path)
+{
+	zbx_free(dbsnapshot.path);
+	zbx_free(dbsnapshot.path_tmp);
+
+	if (NULL != path && '\0' != *path)
+	{
+		dbsnapshot.path = zbx_strdup(NULL, path);
+		dbsnapshot.path_tmp = zbx_dsprintf(NULL, "%s.tmp", path);
+	}
+}
+
+static size_t	dbsnapshot_header_size(void)
+{
+	return ZBX_CONST_STRLEN(ZBX_DBSNAPSHOT_MAGIC) + sizeof(zbx_uint32_t) * 2 +
+			ZBX_CONST_STRLEN(ZBX_DBSNAPSHOT_VERSION);
+}
+
+static void	dbsnapshot_reserve(size_t size)
+{
+	if (dbsnapshot.buf_alloc < size)
+	{
+		dbsnapshot.buf_alloc = MAX(size, dbsnapshot.buf_alloc * 2);
+		dbsnapshot.buf = (unsigned char *)zbx_realloc(dbsnapshot.buf, dbsnapshot.buf_alloc);
+	}
+}
+
+static void	dbsnapshot_index_create(void)
+{
+	int	i;
+
+	if (0 != dbsnapshot.index_created)
+		return;
+
+	for (i = 0; i < ZBX_DBSYNC_OBJ_COUNT; i++)
+	{
+		zbx_hashset_create(&dbsnapshot.index[i], 100, ZBX_DEFAULT_UINT64_HASH_FUNC,
+				ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+	}
+
+	dbsnapshot.index_created = 1;
+}
+
+static void	dbsnapshot_index_destroy(void)
+{
+	int	i;
+
+	if (0 == dbsnapshot.index_created)
+		return;
+
+	for (i = 0; i < ZBX_DBSYNC_OBJ_COUNT; i++)
+		zbx_hashset_destroy(&dbsnapshot.index[i]);
+
+	dbsnapshot.index_created = 0;
+}
+
+static void	dbsnapshot_index_update(unsigned char object, zbx_uint64_t rowid, zbx_uint64_t offset,
+		unsigned char removed)
+{
+	zbx_dbsnapshot_index_t	*entry, entry_local = {.rowid = rowid};
+
+	if (NULL == (entry = (zbx_dbsnapshot_index_t *)zbx_hashset_search(&dbsnapshot.index[object - 1],
+			&entry_local)))
+	{
+		entry = (zbx_dbsnapshot_index_t *)zbx_hashset_insert(&dbsnapshot.index[object - 1], &entry_local,
+				sizeof(entry_local));
+	}
+
+	entry->offset = offset;
+	entry->removed = removed;
+}
+
+static int	dbsnapshot_index_compare_offsets(const void *d1, const void *d2)
+{
+	const zbx_dbsnapshot_index_t	*e1 = *(const zbx_dbsnapshot_index_t * const *)d1;
+	const zbx_dbsnapshot_index_t	*e2 = *(const zbx_dbsnapshot_index_t * const *)d2;
+
+	ZBX_RETURN_IF_NOT_EQUAL(e1->offset, e2->offset);
+
+	return 0;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets indexed rows of the specified object in file order           *
+ *                                                                            *
+ ******************************************************************************/
+static void	dbsnapshot_index_get_rows(unsigned char object, zbx_vector_ptr_t *entries)
+{
+	zbx_hashset_iter_t	iter;
+	zbx_dbsnapshot_index_t	*entry;
+
+	zbx_hashset_iter_reset(&dbsnapshot.index[object - 1], &iter);
+	while (NULL != (entry = (zbx_dbsnapshot_index_t *)zbx_hashset_iter_next(&iter)))
+	{
+		if (0 == entry->removed)
+			zbx_vector_ptr_append(entries, entry);
+	}
+
+	zbx_vector_ptr_sort(entries, dbsnapshot_index_compare_offsets);
+}
+
+static int	dbsnapshot_write_record(FILE *file, unsigned char type, const unsigned char *payload,
+		zbx_uint32_t size)
+{
+	unsigned char	header[ZBX_DBSNAPSHOT_RECORD_HEADER_SIZE];
+
+	header[0] = type;
+	memcpy(header + 1, &size, sizeof(size));
+
+	if (sizeof(header) != fwrite(header, 1, sizeof(header), file) || size != fwrite(payload, 1, size, file))
+		return FAIL;
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: reads record at the current file position into record buffer      *
+ *                                                                            *
+ * Parameters: file  - [IN] the snapshot file                                 *
+ *             limit - [IN] the number of bytes available for the record      *
+ *             type  - [OUT] the record type                                  *
+ *             size  - [OUT] the record payload size                          *
+ *                                                                            *
+ * Return value: SUCCEED - the record was read                                *
+ *               FAIL    - the record is truncated or cannot be read          *
+ *                                                                            *
+ ******************************************************************************/
+static int	dbsnapshot_read_record(FILE *file, zbx_uint64_t limit, unsigned char *type, zbx_uint32_t *size)
+{
+	unsigned char	header[ZBX_DBSNAPSHOT_RECORD_HEADER_SIZE];
+
+	if (sizeof(header) > limit || sizeof(header) != fread(header, 1, sizeof(header), file))
+		return FAIL;
+
+	*type = header[0];
+	memcpy(size, header + 1, sizeof(*size));
+
+	if (*size > limit - sizeof(header))
+		return FAIL;
+
+	dbsnapshot_reserve(*size);
+
+	if (*size != fread(dbsnapshot.buf, 1, *size, file))
+		return FAIL;
+
+	return SUCCEED;
+}
+
+static int	dbsnapshot_write_header(FILE *file)
+{
+	zbx_uint32_t	format = ZBX_DBSNAPSHOT_FORMAT, len = ZBX_CONST_STRLEN(ZBX_DBSNAPSHOT_VERSION);
+
+	if (ZBX_CONST_STRLEN(ZBX_DBSNAPSHOT_MAGIC) != fwrite(ZBX_DBSNAPSHOT_MAGIC, 1,
+			ZBX_CONST_STRLEN(ZBX_DBSNAPSHOT_MAGIC), file) ||
+			1 != fwrite(&format, sizeof(format), 1, file) || 1 != fwrite(&len, sizeof(len), 1, file) ||
+			len != fwrite(ZBX_DBSNAPSHOT_VERSION, 1, len, file))
+	{
+		return FAIL;
+	}
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: checks if snapshot was written by the same Zabbix version using   *
+ *          the same file format                                              *
+ *                                                                            *
+ ******************************************************************************/
+static int	dbsnapshot_read_header(FILE *file)
+{
+	char		buf[MAX(ZBX_CONST_STRLEN(ZBX_DBSNAPSHOT_MAGIC), ZBX_CONST_STRLEN(ZBX_DBSNAPSHOT_VERSION))];
+	zbx_uint32_t	format, len;
+
+	if (ZBX_CONST_STRLEN(ZBX_DBSNAPSHOT_MAGIC) != fread(buf, 1, ZBX_CONST_STRLEN(ZBX_DBSNAPSHOT_MAGIC), file) ||
+			0 != memcmp(buf, ZBX_DBSNAPSHOT_MAGIC, ZBX_CONST_STRLEN(ZBX_DBSNAPSHOT_MAGIC)))
+	{
+		return FAIL;
+	}
+
+	if (1 != fread(&format, sizeof(format), 1, file) || ZBX_DBSNAPSHOT_FORMAT != format)
+		return FAIL;
+
+	if (1 != fread(&len, sizeof(len), 1, file) || ZBX_CONST_STRLEN(ZBX_DBSNAPSHOT_VERSION) != len)
+		return FAIL;
+
+	if (len != fread(buf, 1, len, file) || 0 != memcmp(buf, ZBX_DBSNAPSHOT_VERSION, len))
+		return FAIL;
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: parses row record payload                                         *
+ *                                                                            *
+ * Parameters: data        - [IN] the record payload                          *
+ *             size        - [IN] the record payload size                     *
+ *             object      - [OUT] the changelog object                       *
+ *             rowid       - [OUT] the row identifier                         *
+ *             columns_num - [OUT] the number of columns                      *
+ *                                                                            *
+ * Return value: SUCCEED - the row was parsed into row buffer                 *
+ *               FAIL    - invalid record                                     *
+ *                                                                            *
+ * Comments: The row buffer columns point to the record payload.              *
+ *                                                                            *
+ ******************************************************************************/
+static int	dbsnapshot_parse_row(unsigned char *data, zbx_uint32_t size, unsigned char *object, zbx_uint64_t *rowid,
+		int *columns_num)
+{
+	zbx_uint32_t	columns, len, i;
+	size_t		offset = ZBX_DBSNAPSHOT_ROW_HEADER_SIZE + sizeof(columns);
+
+	if (offset > size)
+		return FAIL;
+
+	*object = data[0];
+	memcpy(rowid, data + sizeof(unsigned char), sizeof(*rowid));
+	memcpy(&columns, data + ZBX_DBSNAPSHOT_ROW_HEADER_SIZE, sizeof(columns));
+
+	if (columns > size)
+		return FAIL;
+
+	if (dbsnapshot.row_alloc < (int)columns)
+	{
+		dbsnapshot.row_alloc = (int)columns;
+		dbsnapshot.row = (char **)zbx_realloc(dbsnapshot.row, sizeof(char *) * columns);
+	}
+
+	for (i = 0; i < columns; i++)
+	{
+		if (sizeof(len) > size - offset)
+			return FAIL;
+
+		memcpy(&len, data + offset, sizeof(len));
+		offset += sizeof(len);
+
+		if (ZBX_DBSNAPSHOT_NULL_COLUMN == len)
+		{
+			dbsnapshot.row[i] = NULL;
+			continue;
+		}
+
+		if (len >= size - offset || '\0' != data[offset + len])
+			return FAIL;
+
+		dbsnapshot.row[i] = (char *)data + offset;
+		offset += len + 1;
+	}
+
+	*columns_num = (int)columns;
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: indexes rows in the specified snapshot file range                 *
+ *                                                                            *
+ * Parameters: file      - [IN] the snapshot file                             *
+ *             from      - [IN] the start offset                              *
+ *             to        - [IN] the end offset                                *
+ *             changelog    - [OUT] processed changelog records (optional)    *
+ *             commit_clock - [OUT] the last commit clock (optional)          *
+ *                                                                            *
+ * Return value: SUCCEED - the records were indexed                           *
+ *               FAIL    - invalid record was found                           *
+ *                                                                            *
+ ******************************************************************************/
+static int	dbsnapshot_index_records(FILE *file, zbx_uint64_t from, zbx_uint64_t to, zbx_hashset_t *changelog,
+		int *commit_clock)
+{
+	zbx_uint64_t		offset, rowid;
+	zbx_uint32_t		size;
+	unsigned char		type, object;
+	zbx_dbsync_changelog_t	changelog_local;
+
+	if (0 != fseeko(file, (off_t)from, SEEK_SET))
+		return FAIL;
+
+	for (offset = from; offset < to; offset += ZBX_DBSNAPSHOT_RECORD_HEADER_SIZE + size)
+	{
+		if (SUCCEED != dbsnapshot_read_record(file, to - offset, &type, &size))
+			return FAIL;
+
+		switch (type)
+		{
+			case ZBX_DBSNAPSHOT_RECORD_ROW:
+			case ZBX_DBSNAPSHOT_RECORD_REMOVE:
+				if (ZBX_DBSNAPSHOT_ROW_HEADER_SIZE > size)
+					return FAIL;
+
+				object = dbsnapshot.buf[0];
+				memcpy(&rowid, dbsnapshot.buf + sizeof(unsigned char), sizeof(rowid));
+
+				if (0 == object || ZBX_DBSYNC_OBJ_COUNT < object)
+					return FAIL;
+
+				dbsnapshot_index_update(object, rowid, offset, ZBX_DBSNAPSHOT_RECORD_REMOVE == type);
+				break;
+			case ZBX_DBSNAPSHOT_RECORD_CHANGELOG:
+				if (ZBX_DBSNAPSHOT_CHANGELOG_SIZE != size)
+					return FAIL;
+
+				if (NULL != changelog)
+				{
+					memcpy(&changelog_local.changelogid, dbsnapshot.buf,
+							sizeof(changelog_local.changelogid));
+					memcpy(&changelog_local.clock, dbsnapshot.buf + sizeof(zbx_uint64_t),
+							sizeof(changelog_local.clock));
+					zbx_hashset_insert(changelog, &changelog_local, sizeof(changelog_local));
+				}
+				break;
+			case ZBX_DBSNAPSHOT_RECORD_COMMIT:
+				if (sizeof(zbx_uint32_t) != size)
+					return FAIL;
+
+				if (NULL != commit_clock)
+					memcpy(commit_clock, dbsnapshot.buf, sizeof(*commit_clock));
+				break;
+			default:
+				return FAIL;
+		}
+	}
+
+	return SUCCEED;
+}
+
+static int	dbsnapshot_write_changelog(FILE *file, const zbx_dbsync_changelog_t *changelog)
+{
+	unsigned char	payload[ZBX_DBSNAPSHOT_CHANGELOG_SIZE];
+
+	memcpy(payload, &changelog->changelogid, sizeof(changelog->changelogid));
+	memcpy(payload + sizeof(zbx_uint64_t), &changelog->clock, sizeof(changelog->clock));
+
+	return dbsnapshot_write_record(file, ZBX_DBSNAPSHOT_RECORD_CHANGELOG, payload, sizeof(payload));
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: terminates snapshot with all processed changelog records and      *
+ *          commit record and flushes it to disk                              *
+ *                                                                            *
+ ******************************************************************************/
+static int	dbsnapshot_finish(FILE *file, zbx_hashset_t *changelog, int commit_clock)
+{
+	zbx_hashset_iter_t	iter;
+	zbx_dbsync_changelog_t	*entry;
+
+	zbx_hashset_iter_reset(changelog, &iter);
+	while (NULL != (entry = (zbx_dbsync_changelog_t *)zbx_hashset_iter_next(&iter)))
+	{
+		if (SUCCEED != dbsnapshot_write_changelog(file, entry))
+			return FAIL;
+	}
+
+	if (SUCCEED != dbsnapshot_write_record(file, ZBX_DBSNAPSHOT_RECORD_COMMIT, (unsigned char *)&commit_clock,
+			sizeof(commit_clock)))
+	{
+		return FAIL;
+	}
+
+	if (0 != fflush(file) || 0 != fsync(fileno(file)))
+		return FAIL;
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: removes snapshot file so the next start performs full load        *
+ *                                                                            *
+ ******************************************************************************/
+static void	dbsnapshot_remove(void)
+{
+	if (NULL != dbsnapshot.file)
+	{
+		fclose(dbsnapshot.file);
+		dbsnapshot.file = NULL;
+	}
+
+	if (0 != unlink(dbsnapshot.path) && ENOENT != errno)
+	{
+		zabbix_log(LOG_LEVEL_WARNING, "cannot remove configuration cache snapshot file \"%s\": %s",
+				dbsnapshot.path, zbx_strerror(errno));
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: rewrites snapshot with the latest versions of snapshot rows       *
+ *                                                                            *
+ * Parameters: changelog - [IN] the processed changelog records               *
+ *                                                                            *
+ * Comments: Only rows changed since snapshot base was written are indexed,   *
+ *           the unchanged base rows are copied directly.                     *
+ *                                                                            *
+ ******************************************************************************/
+static void	dbsnapshot_compact(zbx_hashset_t *changelog)
+{
+	FILE			*file;
+	zbx_uint64_t		offset, rowid, size_old = dbsnapshot.commit_size;
+	zbx_uint32_t		size;
+	unsigned char		type, object;
+	int			i, j, ret = FAIL;
+	zbx_vector_ptr_t	entries;
+	double			sec;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
+
+	sec = zbx_time();
+	errno = 0;
+
+	if (NULL == (file = fopen(dbsnapshot.path_tmp, "w+b")))
+	{
+		zabbix_log(LOG_LEVEL_WARNING, "cannot create configuration cache snapshot file \"%s\": %s",
+				dbsnapshot.path_tmp, zbx_strerror(errno));
+		return;
+	}
+
+	zbx_vector_ptr_create(&entries);
+	dbsnapshot_index_create();
+
+	if (SUCCEED != dbsnapshot_index_records(dbsnapshot.file, dbsnapshot.base_size, dbsnapshot.commit_size,
+			NULL, NULL))
+	{
+		goto out;
+	}
+
+	if (SUCCEED != dbsnapshot_write_header(file))
+		goto out;
+
+	/* copy base rows that were not changed */
+
+	if (0 != fseeko(dbsnapshot.file, (off_t)dbsnapshot_header_size(), SEEK_SET))
+		goto out;
+
+	for (offset = dbsnapshot_header_size(); offset < dbsnapshot.base_size;
+			offset += ZBX_DBSNAPSHOT_RECORD_HEADER_SIZE + size)
+	{
+		if (SUCCEED != dbsnapshot_read_record(dbsnapshot.file, dbsnapshot.base_size - offset, &type, &size))
+			goto out;
+
+		if (ZBX_DBSNAPSHOT_RECORD_ROW != type)
+			continue;
+
+		if (ZBX_DBSNAPSHOT_ROW_HEADER_SIZE > size)
+			goto out;
+
+		object = dbsnapshot.buf[0];
+		memcpy(&rowid, dbsnapshot.buf + sizeof(unsigned char), sizeof(rowid));
+
+		if (0 == object || ZBX_DBSYNC_OBJ_COUNT < object)
+			goto out;
+
+		if (NULL != zbx_hashset_search(&dbsnapshot.index[object - 1], &rowid))
+			continue;
+
+		if (SUCCEED != dbsnapshot_write_record(file, type, dbsnapshot.buf, size))
+			goto out;
+	}
+
+	/* copy the latest versions of changed rows */
+
+	for (i = 1; i <= ZBX_DBSYNC_OBJ_COUNT; i++)
+	{
+		dbsnapshot_index_get_rows((unsigned char)i, &entries);
+
+		for (j = 0; j < entries.values_num; j++)
+		{
+			zbx_dbsnapshot_index_t	*entry = (zbx_dbsnapshot_index_t *)entries.values[j];
+
+			if (0 != fseeko(dbsnapshot.file, (off_t)entry->offset, SEEK_SET) ||
+					SUCCEED != dbsnapshot_read_record(dbsnapshot.file,
+					dbsnapshot.commit_size - entry->offset, &type, &size) ||
+					SUCCEED != dbsnapshot_write_record(file, type, dbsnapshot.buf, size))
+			{
+				goto out;
+			}
+		}
+
+		zbx_vector_ptr_clear(&entries);
+	}
+
+	if (SUCCEED != dbsnapshot_finish(file, changelog, dbsnapshot.commit_clock))
+		goto out;
+
+	if (0 != rename(dbsnapshot.path_tmp, dbsnapshot.path))
+		goto out;
+
+	fclose(dbsnapshot.file);
+	dbsnapshot.file = file;
+	dbsnapshot.base_size = dbsnapshot.commit_size = (zbx_uint64_t)ftello(file);
+
+	ret = SUCCEED;
+out:
+	if (SUCCEED != ret)
+	{
+		zabbix_log(LOG_LEVEL_WARNING, "cannot compact configuration cache snapshot file \"%s\": %s",
+				dbsnapshot.path, 0 != errno ? zbx_strerror(errno) : "invalid snapshot data");
+
+		fclose(file);
+		unlink(dbsnapshot.path_tmp);
+
+		if (0 != fseeko(dbsnapshot.file, (off_t)dbsnapshot.commit_size, SEEK_SET))
+			dbsnapshot_remove();
+	}
+	else
+	{
+		zabbix_log(LOG_LEVEL_DEBUG, "compacted configuration cache snapshot from " ZBX_FS_UI64 " to "
+				ZBX_FS_UI64 " bytes in " ZBX_FS_DBL " sec", size_old, dbsnapshot.commit_size,
+				zbx_time() - sec);
+	}
+
+	dbsnapshot_index_destroy();
+	zbx_vector_ptr_destroy(&entries);
+
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: loads configuration cache snapshot                                *
+ *                                                                            *
+ * Parameters: changelog    - [OUT] the processed changelog records           *
+ *             commit_clock - [OUT] the time of the last commit - snapshot    *
+ *                                  contains all changelog records older      *
+ *                                  than that, allowing for the transactions  *
+ *                                  open during synchronization               *
+ *                                                                            *
+ * Return value: SUCCEED - the snapshot was loaded                            *
+ *               FAIL    - snapshot is not configured, does not exist or is   *
+ *                         not valid                                          *
+ *                                                                            *
+ * Comments: Only the snapshot row index is loaded, the rows are read by      *
+ *           zbx_dbsnapshot_read_rows() function. The data written after the  *
+ *           last commit record is discarded.                                 *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_dbsnapshot_load(zbx_hashset_t *changelog, int *commit_clock)
+{
+	FILE		*file;
+	zbx_stat_t	buf;
+	zbx_uint64_t	offset, file_size, base_size = 0, commit_size = 0;
+	zbx_uint32_t	size;
+	unsigned char	type;
+	int		ret = FAIL;
+
+	if (NULL == dbsnapshot.path)
+		return FAIL;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
+
+	if (NULL == (file = fopen(dbsnapshot.path, "r+b")))
+	{
+		if (ENOENT != errno)
+		{
+			zabbix_log(LOG_LEVEL_WARNING, "cannot open configuration cache snapshot file \"%s\": %s",
+					dbsnapshot.path, zbx_strerror(errno));
+		}
+
+		goto out;
+	}
+
+	if (0 != zbx_fstat(fileno(file), &buf))
+	{
+		zabbix_log(LOG_LEVEL_WARNING, "cannot obtain configuration cache snapshot file \"%s\" information:"
+				" %s", dbsnapshot.path, zbx_strerror(errno));
+		goto out;
+	}
+
+	file_size = (zbx_uint64_t)buf.st_size;
+
+	if (SUCCEED != dbsnapshot_read_header(file))
+	{
+		zabbix_log(LOG_LEVEL_WARNING, "ignoring configuration cache snapshot file \"%s\" created by different"
+				" Zabbix version", dbsnapshot.path);
+		goto out;
+	}
+
+	/* find the last commit record, ignoring incomplete records at the end of file */
+	for (offset = dbsnapshot_header_size(); SUCCEED == dbsnapshot_read_record(file, file_size - offset, &type,
+			&size);)
+	{
+		offset += ZBX_DBSNAPSHOT_RECORD_HEADER_SIZE + size;
+
+		if (ZBX_DBSNAPSHOT_RECORD_COMMIT == type)
+		{
+			if (0 == base_size)
+				base_size = offset;
+
+			commit_size = offset;
+		}
+	}
+
+	if (0 == commit_size)
+	{
+		zabbix_log(LOG_LEVEL_WARNING, "ignoring configuration cache snapshot file \"%s\" without committed"
+				" data", dbsnapshot.path);
+		goto out;
+	}
+
+	dbsnapshot_index_create();
+
+	if (SUCCEED != dbsnapshot_index_records(file, dbsnapshot_header_size(), commit_size, changelog, commit_clock))
+	{
+		zabbix_log(LOG_LEVEL_WARNING, "ignoring corrupted configuration cache snapshot file \"%s\"",
+				dbsnapshot.path);
+		goto out;
+	}
+
+	if (commit_size != file_size && 0 != ftruncate(fileno(file), (off_t)commit_size))
+	{
+		zabbix_log(LOG_LEVEL_WARNING, "cannot truncate configuration cache snapshot file \"%s\": %s",
+				dbsnapshot.path, zbx_strerror(errno));
+		goto out;
+	}
+
+	if (0 != fseeko(file, (off_t)commit_size, SEEK_SET))
+		goto out;
+
+	dbsnapshot.file = file;
+	dbsnapshot.base_size = base_size;
+	dbsnapshot.commit_size = commit_size;
+	dbsnapshot.commit_clock = *commit_clock;
+
+	ret = SUCCEED;
+out:
+	if (SUCCEED != ret)
+	{
+		if (NULL != file)
+			fclose(file);
+
+		dbsnapshot_index_destroy();
+	}
+
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s", __func__, zbx_result_string(ret));
+
+	return ret;
+}
+
+int	zbx_dbsnapshot_is_restoring(void)
+{
+	return 0 != dbsnapshot.index_created && NULL != dbsnapshot.file ? SUCCEED : FAIL;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: reads loaded snapshot rows of the specified object                *
+ *                                                                            *
+ * Parameters: object   - [IN] the changelog object                           *
+ *             row_func - [IN] the callback to process rows                   *
+ *             data     - [IN] the callback data                              *
+ *                                                                            *
+ * Return value: SUCCEED - the rows were read                                 *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_dbsnapshot_read_rows(unsigned char object, zbx_dbsnapshot_row_func_t row_func, void *data)
+{
+	zbx_vector_ptr_t	entries;
+	zbx_uint64_t		rowid;
+	zbx_uint32_t		size;
+	unsigned char		type, row_object;
+	int			i, columns_num, ret = FAIL;
+
+	if (0 == dbsnapshot.index_created || NULL == dbsnapshot.file)
+		return SUCCEED;
+
+	zbx_vector_ptr_create(&entries);
+	dbsnapshot_index_get_rows(object, &entries);
+
+	for (i = 0; i < entries.values_num; i++)
+	{
+		zbx_dbsnapshot_index_t	*entry = (zbx_dbsnapshot_index_t *)entries.values[i];
+
+		if (0 != fseeko(dbsnapshot.file, (off_t)entry->offset, SEEK_SET) ||
+				SUCCEED != dbsnapshot_read_record(dbsnapshot.file, dbsnapshot.commit_size - entry->offset,
+				&type, &size) || ZBX_DBSNAPSHOT_RECORD_ROW != type ||
+				SUCCEED != dbsnapshot_parse_row(dbsnapshot.buf, size, &row_object, &rowid, &columns_num) ||
+				row_object != object)
+		{
+			zabbix_log(LOG_LEVEL_WARNING, "cannot read configuration cache snapshot file \"%s\" row",
+					dbsnapshot.path);
+			goto out;
+		}
+
+		if (SUCCEED != row_func(data, rowid, dbsnapshot.row, columns_num))
+			goto out;
+	}
+
+	ret = SUCCEED;
+out:
+	zbx_vector_ptr_destroy(&entries);
+
+	/* the changes are appended to the end of snapshot */
+	if (0 != fseeko(dbsnapshot.file, 0, SEEK_END))
+		ret = FAIL;
+
+	return ret;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: discards loaded snapshot                                          *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_dbsnapshot_discard(void)
+{
+	dbsnapshot_index_destroy();
+
+	if (NULL != dbsnapshot.file)
+	{
+		fclose(dbsnapshot.file);
+		dbsnapshot.file = NULL;
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: starts writing configuration cache synchronization changes        *
+ *                                                                            *
+ * Parameters: mode - [IN] the changelog synchronization mode:                *
+ *                         ZBX_DBSYNC_INIT   - write new snapshot             *
+ *                         ZBX_DBSYNC_UPDATE - append changes to the          *
+ *                                             committed snapshot             *
+ *                                                                            *
+ * Return value: SUCCEED - the changes will be written to snapshot            *
+ *               FAIL    - snapshot is not configured or not available        *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_dbsnapshot_begin(unsigned char mode)
+{
+	dbsnapshot.records_num = 0;
+	dbsnapshot.error = 0;
+
+	if (NULL == dbsnapshot.path)
+		return FAIL;
+
+	if (ZBX_DBSYNC_INIT == mode)
+	{
+		if (NULL == (dbsnapshot.file_tmp = fopen(dbsnapshot.path_tmp, "w+b")))
+		{
+			zabbix_log(LOG_LEVEL_WARNING, "cannot create configuration cache snapshot file \"%s\": %s",
+					dbsnapshot.path_tmp, zbx_strerror(errno));
+			return FAIL;
+		}
+
+		if (SUCCEED != dbsnapshot_write_header(dbsnapshot.file_tmp))
+			dbsnapshot.error = errno;
+
+		dbsnapshot.state = ZBX_DBSNAPSHOT_STATE_BASE;
+	}
+	else
+	{
+		if (NULL == dbsnapshot.file)
+			return FAIL;
+
+		dbsnapshot.state = ZBX_DBSNAPSHOT_STATE_DELTA;
+	}
+
+	return SUCCEED;
+}
+
+int	zbx_dbsnapshot_is_writing(void)
+{
+	return ZBX_DBSNAPSHOT_STATE_IDLE != dbsnapshot.state ? SUCCEED : FAIL;
+}
+
+static void	dbsnapshot_append(unsigned char type, const unsigned char *payload, zbx_uint32_t size)
+{
+	FILE	*file;
+
+	if (0 != dbsnapshot.error)
+		return;
+
+	file = (ZBX_DBSNAPSHOT_STATE_BASE == dbsnapshot.state ? dbsnapshot.file_tmp : dbsnapshot.file);
+
+	if (SUCCEED != dbsnapshot_write_record(file, type, payload, size))
+		dbsnapshot.error = (0 != errno ? errno : EIO);
+	else
+		dbsnapshot.records_num++;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: writes added or updated row to snapshot                           *
+ *                                                                            *
+ * Parameters: object      - [IN] the changelog object                        *
+ *             rowid       - [IN] the row identifier                          *
+ *             row         - [IN] the row columns                             *
+ *             columns_num - [IN] the number of columns                       *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_dbsnapshot_write_row(unsigned char object, zbx_uint64_t rowid, char **row, int columns_num)
+{
+	size_t		size, offset;
+	zbx_uint32_t	len, columns = (zbx_uint32_t)columns_num;
+	int		i;
+
+	if (ZBX_DBSNAPSHOT_STATE_IDLE == dbsnapshot.state || 0 != dbsnapshot.error)
+		return;
+
+	size = ZBX_DBSNAPSHOT_ROW_HEADER_SIZE + sizeof(columns);
+
+	for (i = 0; i < columns_num; i++)
+		size += sizeof(len) + (NULL == row[i] ? 0 : strlen(row[i]) + 1);
+
+	dbsnapshot_reserve(size);
+
+	dbsnapshot.buf[0] = object;
+	memcpy(dbsnapshot.buf + sizeof(unsigned char), &rowid, sizeof(rowid));
+	memcpy(dbsnapshot.buf + ZBX_DBSNAPSHOT_ROW_HEADER_SIZE, &columns, sizeof(columns));
+	offset = ZBX_DBSNAPSHOT_ROW_HEADER_SIZE + sizeof(columns);
+
+	for (i = 0; i < columns_num; i++)
+	{
+		len = (NULL == row[i] ? ZBX_DBSNAPSHOT_NULL_COLUMN : (zbx_uint32_t)strlen(row[i]));
+		memcpy(dbsnapshot.buf + offset, &len, sizeof(len));
+		offset += sizeof(len);
+
+		if (NULL != row[i])
+		{
+			memcpy(dbsnapshot.buf + offset, row[i], len + 1);
+			offset += len + 1;
+		}
+	}
+
+	dbsnapshot_append(ZBX_DBSNAPSHOT_RECORD_ROW, dbsnapshot.buf, (zbx_uint32_t)size);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: writes removed row to snapshot                                    *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_dbsnapshot_write_remove(unsigned char object, zbx_uint64_t rowid)
+{
+	unsigned char	payload[ZBX_DBSNAPSHOT_ROW_HEADER_SIZE];
+
+	if (ZBX_DBSNAPSHOT_STATE_IDLE == dbsnapshot.state)
+		return;
+
+	payload[0] = object;
+	memcpy(payload + sizeof(unsigned char), &rowid, sizeof(rowid));
+
+	dbsnapshot_append(ZBX_DBSNAPSHOT_RECORD_REMOVE, payload, sizeof(payload));
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: writes processed changelog record to snapshot                     *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_dbsnapshot_write_changelog(const zbx_dbsync_changelog_t *changelog)
+{
+	unsigned char	payload[ZBX_DBSNAPSHOT_CHANGELOG_SIZE];
+
+	if (ZBX_DBSNAPSHOT_STATE_IDLE == dbsnapshot.state)
+		return;
+
+	memcpy(payload, &changelog->changelogid, sizeof(changelog->changelogid));
+	memcpy(payload + sizeof(zbx_uint64_t), &changelog->clock, sizeof(changelog->clock));
+
+	dbsnapshot_append(ZBX_DBSNAPSHOT_RECORD_CHANGELOG, payload, sizeof(payload));
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: commits changes written since zbx_dbsnapshot_begin() call         *
+ *                                                                            *
+ * Parameters: changelog - [IN] the processed changelog records               *
+ *                                                                            *
+ * Comments: New snapshot replaces the old snapshot file. Changes appended    *
+ *           to the committed snapshot are compacted when their size exceeds  *
+ *           the snapshot base size. Commit without changes is written only   *
+ *           to refresh the commit clock once per commit interval.            *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_dbsnapshot_commit(zbx_hashset_t *changelog)
+{
+	FILE	*file;
+	int	now;
+
+	if (ZBX_DBSNAPSHOT_STATE_IDLE == dbsnapshot.state)
+		return;
+
+	now = (int)time(NULL);
+
+	dbsnapshot_index_destroy();
+
+	if (ZBX_DBSNAPSHOT_STATE_BASE == dbsnapshot.state)
+	{
+		file = dbsnapshot.file_tmp;
+
+		if (0 == dbsnapshot.error && SUCCEED != dbsnapshot_finish(file, changelog, now))
+			dbsnapshot.error = (0 != errno ? errno : EIO);
+
+		if (0 == dbsnapshot.error && 0 != rename(dbsnapshot.path_tmp, dbsnapshot.path))
+			dbsnapshot.error = errno;
+
+		if (0 != dbsnapshot.error)
+		{
+			zabbix_log(LOG_LEVEL_WARNING, "cannot write configuration cache snapshot file \"%s\": %s",
+					dbsnapshot.path_tmp, zbx_strerror(dbsnapshot.error));
+			zbx_dbsnapshot_rollback();
+			return;
+		}
+
+		if (NULL != dbsnapshot.file)
+			fclose(dbsnapshot.file);
+
+		dbsnapshot.file = file;
+		dbsnapshot.file_tmp = NULL;
+		dbsnapshot.base_size = dbsnapshot.commit_size = (zbx_uint64_t)ftello(file);
+
+		zabbix_log(LOG_LEVEL_DEBUG, "written configuration cache snapshot of " ZBX_FS_UI64 " bytes",
+				dbsnapshot.commit_size);
+	}
+	else
+	{
+		if (0 == dbsnapshot.records_num && now - dbsnapshot.commit_clock < ZBX_DBSNAPSHOT_COMMIT_INTERVAL)
+		{
+			dbsnapshot.state = ZBX_DBSNAPSHOT_STATE_IDLE;
+			return;
+		}
+
+		file = dbsnapshot.file;
+
+		if (0 == dbsnapshot.error && (SUCCEED != dbsnapshot_write_record(file, ZBX_DBSNAPSHOT_RECORD_COMMIT,
+				(unsigned char *)&now, sizeof(now)) || 0 != fflush(file) ||
+				0 != fsync(fileno(file))))
+		{
+			dbsnapshot.error = (0 != errno ? errno : EIO);
+		}
+
+		if (0 != dbsnapshot.error)
+		{
+			/* processed changelog records cannot be synchronized again, */
+			/* so snapshot without the committed changes is not valid     */
+			zabbix_log(LOG_LEVEL_WARNING, "cannot write configuration cache snapshot file \"%s\": %s",
+					dbsnapshot.path, zbx_strerror(dbsnapshot.error));
+			dbsnapshot.state = ZBX_DBSNAPSHOT_STATE_IDLE;
+			dbsnapshot_remove();
+			return;
+		}
+
+		dbsnapshot.commit_size = (zbx_uint64_t)ftello(file);
+	}
+
+	dbsnapshot.commit_clock = now;
+	dbsnapshot.state = ZBX_DBSNAPSHOT_STATE_IDLE;
+
+	if (dbsnapshot.commit_size - dbsnapshot.base_size > MAX(dbsnapshot.base_size, ZBX_DBSNAPSHOT_COMPACT_SIZE_MIN))
+		dbsnapshot_compact(changelog);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: discards changes written since zbx_dbsnapshot_begin() call        *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_dbsnapshot_rollback(void)
+{
+	dbsnapshot_index_destroy();
+
+	if (ZBX_DBSNAPSHOT_STATE_BASE == dbsnapshot.state)
+	{
+		fclose(dbsnapshot.file_tmp);
+		dbsnapshot.file_tmp = NULL;
+		unlink(dbsnapshot.path_tmp);
+	}
+	else if (ZBX_DBSNAPSHOT_STATE_DELTA == dbsnapshot.state)
+	{
+		if (0 != fflush(dbsnapshot.file) || 0 != ftruncate(fileno(dbsnapshot.file),
+				(off_t)dbsnapshot.commit_size) ||
+				0 != fseeko(dbsnapshot.file, (off_t)dbsnapshot.commit_size, SEEK_SET))
+		{
+			/* uncommitted changes are ignored when snapshot is loaded, */
+			/* stop using snapshot until the next start                */
+			fclose(dbsnapshot.file);
+			dbsnapshot.file = NULL;
+		}
+	}
+
+	dbsnapshot.state = ZBX_DBSNAPSHOT_STATE_IDLE;
+}
@@ -0,0 +1,48 @@
+/*
+** Copyright (C) 2001-2024 Zabbix SIA
+**
+** This program is free software: you can redistribute it and/or modify it under the terms of
+** the GNU Affero General Public License as published by the Free Software Foundation, version 3.
+**
+** This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+** without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+** See the GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License along with this program.
+** If not, see <https://www.gnu.org/licenses/>.
+**/
+
+#ifndef ZABBIX_DBSNAPSHOT_H
+#define ZABBIX_DBSNAPSHOT_H
+
+#include "dbsync.h"
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: processes row restored from configuration cache snapshot          *
+ *                                                                            *
+ * Parameters: data        - [IN] caller data                                 *
+ *             rowid       - [IN] row identifier                              *
+ *             row         - [IN] row columns                                 *
+ *             columns_num - [IN] number of columns                           *
+ *                                                                            *
+ * Return value: SUCCEED - row was processed                                  *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ ******************************************************************************/
+typedef int (*zbx_dbsnapshot_row_func_t)(void *data, zbx_uint64_t rowid, char **row, int columns_num);
+
+int	zbx_dbsnapshot_load(zbx_hashset_t *changelog, int *commit_clock);
+int	zbx_dbsnapshot_is_restoring(void);
+int	zbx_dbsnapshot_read_rows(unsigned char object, zbx_dbsnapshot_row_func_t row_func, void *data);
+void	zbx_dbsnapshot_discard(void);
+
+int	zbx_dbsnapshot_begin(unsigned char mode);
+int	zbx_dbsnapshot_is_writing(void);
+void	zbx_dbsnapshot_write_row(unsigned char object, zbx_uint64_t rowid, char **row, int columns_num);
+void	zbx_dbsnapshot_write_remove(unsigned char object, zbx_uint64_t rowid);
+void	zbx_dbsnapshot_write_changelog(const zbx_dbsync_changelog_t *changelog);
+void	zbx_dbsnapshot_commit(zbx_hashset_t *changelog);
+void	zbx_dbsnapshot_rollback(void);
+
+#endif
@@ -15,6 +15,7 @@
 #include "zbxcacheconfig.h"
 #include "zbxcommon.h"
 #include "dbsync.h"
+#include "dbsnapshot.h"
 #include "user_macro.h"
 #include "zbx_host_constants.h"
 #include "zbx_trigger_constants.h"
@@ -27,35 +28,12 @@
 #include "zbxinterface.h"
 #include "zbxip.h"
 #include "zbxtime.h"
+#include "zbxthreads.h"
 
 /* global correlation constants */
 #define ZBX_CORRELATION_ENABLED				0
 /*#define ZBX_CORRELATION_DISABLED			1*/
 
-#define ZBX_DBSYNC_OBJ_HOST		1
-#define ZBX_DBSYNC_OBJ_HOST_TAG		2
-#define ZBX_DBSYNC_OBJ_ITEM		3
-#define ZBX_DBSYNC_OBJ_ITEM_TAG		4
-#define ZBX_DBSYNC_OBJ_TRIGGER		5
-#define ZBX_DBSYNC_OBJ_TRIGGER_TAG	6
-#define ZBX_DBSYNC_OBJ_FUNCTION		7
-#define ZBX_DBSYNC_OBJ_ITEM_PREPROC	8
-#define ZBX_DBSYNC_OBJ_DRULE		9
-#define ZBX_DBSYNC_OBJ_DCHECK		10
-#define ZBX_DBSYNC_OBJ_HTTPTEST		11
-#define ZBX_DBSYNC_OBJ_HTTPTEST_FIELD	12
-#define ZBX_DBSYNC_OBJ_HTTPTEST_ITEM	13
-#define ZBX_DBSYNC_OBJ_HTTPSTEP		14
-#define ZBX_DBSYNC_OBJ_HTTPSTEP_FIELD	15
-#define ZBX_DBSYNC_OBJ_HTTPSTEP_ITEM	16
-#define ZBX_DBSYNC_OBJ_CONNECTOR	17
-#define ZBX_DBSYNC_OBJ_CONNECTOR_TAG	18
-#define ZBX_DBSYNC_OBJ_PROXY		19
-#define ZBX_DBSYNC_OBJ_PROXY_GROUP	20
-#define ZBX_DBSYNC_OBJ_HOST_PROXY	21
-/* number of dbsync objects - keep in sync with above defines */
-#define ZBX_DBSYNC_OBJ_COUNT		21
-
 #define ZBX_DBSYNC_JOURNAL(X)		(X - 1)
 
 #define ZBX_DBSYNC_CHANGELOG_PRUNE_INTERVAL	SEC_PER_MIN * 10
@@ -63,13 +41,6 @@
 
 #define ZBX_DBSYNC_BATCH_SIZE			1000
 
-typedef struct
-{
-	zbx_uint64_t	changelogid;
-	int		clock;
-}
-zbx_dbsync_changelog_t;
-
 ZBX_VECTOR_DECL(dbsync_changelog, zbx_dbsync_changelog_t)
 ZBX_VECTOR_IMPL(dbsync_changelog, zbx_dbsync_changelog_t)
 
@@ -519,6 +490,8 @@ int	zbx_dbsync_env_prepare(unsigned char mode)
 	zbx_vector_dbsync_create(&dbsync_env.changelog_dbsyncs);
 	zbx_vector_dbsync_create(&dbsync_env.dbsyncs);
 
+	zbx_dbsnapshot_begin(mode);
+
 	return changelog_num;
 }
 
@@ -560,6 +533,7 @@ static void	dbsync_env_flush_journal(zbx_dbsync_journal_t *journal)
 		{
 			zbx_hashset_insert(&dbsync_env.changelog, &journal->changelog.values[i].changelog,
 					sizeof(zbx_dbsync_changelog_t));
+			zbx_dbsnapshot_write_changelog(&journal->changelog.values[i].changelog);
 		}
 	}
 
@@ -585,6 +559,10 @@ void	zbx_dbsync_env_clear(void)
 	zbx_vector_dbsync_destroy(&dbsync_env.dbsyncs);
 	zbx_vector_dbsync_destroy(&dbsync_env.changelog_dbsyncs);
 
+	/* changes of failed synchronization are not committed */
+	if (SUCCEED == zbx_dbsnapshot_is_writing())
+		zbx_dbsnapshot_rollback();
+
 	dbsync_prune_changelog();
 
 	zbx_hashset_destroy(&dbsync_env.strpool);
@@ -622,6 +600,109 @@ int	zbx_dbsync_env_changelog_dbsyncs_new_records(void)
 	return FAIL;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: checks if changelog records not processed by configuration cache  *
+ *          snapshot could have been removed                                  *
+ *                                                                            *
+ * Parameters: commit_clock - [IN] the last snapshot commit time              *
+ *             now          - [IN] the current database time                  *
+ *             oldest_clock - [IN] the oldest changelog record clock, 0 if    *
+ *                                 changelog is empty                         *
+ *             error        - [OUT] the reason why snapshot is outdated       *
+ *                                                                            *
+ * Return value: SUCCEED - snapshot is valid                                  *
+ *               FAIL    - snapshot is outdated                               *
+ *                                                                            *
+ * Comments: Records not processed by snapshot were added after its last      *
+ *           commit. Allowing for the transactions open during                *
+ *           synchronization they are not older than the commit time minus    *
+ *           the changelog prune interval. Changelog records are removed by   *
+ *           age, so such records are still in database if pruning could not  *
+ *           reach them yet or if any older record still exists.              *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_dbsync_validate_snapshot(int commit_clock, int now, int oldest_clock, char **error)
+{
+	int	clock_min = commit_clock - ZBX_DBSYNC_CHANGELOG_PRUNE_INTERVAL;
+
+	if (now - ZBX_DBSYNC_CHANGELOG_MAX_AGE <= clock_min)
+		return SUCCEED;
+
+	if (0 != oldest_clock && oldest_clock <= clock_min)
+		return SUCCEED;
+
+	*error = zbx_dsprintf(*error, "snapshot was committed %d seconds ago and newer changelog records might"
+			" have been removed", now - commit_clock);
+
+	return FAIL;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: loads processed changelog records and rows of the tables using    *
+ *          changelog from configuration cache snapshot                       *
+ *                                                                            *
+ * Return value: SUCCEED - the snapshot was loaded, tables using changelog    *
+ *                         must be synchronized incrementally                 *
+ *               FAIL    - the snapshot is not available or is outdated       *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_dbsync_env_restore(void)
+{
+	zbx_db_result_t	result;
+	zbx_db_row_t	row;
+	int		commit_clock, ret = FAIL;
+	char		*error = NULL;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
+
+	if (SUCCEED != zbx_dbsnapshot_load(&dbsync_env.changelog, &commit_clock))
+		goto out;
+
+	result = zbx_db_select("select %s,min(clock) from changelog", ZBX_DB_TIMESTAMP());
+
+	if (NULL != (row = zbx_db_fetch(result)))
+	{
+		ret = zbx_dbsync_validate_snapshot(commit_clock, atoi(row[0]),
+				SUCCEED == zbx_db_is_null(row[1]) ? 0 : atoi(row[1]), &error);
+	}
+	else
+		error = zbx_strdup(NULL, "cannot read changelog");
+
+	zbx_db_free_result(result);
+
+	if (SUCCEED != ret)
+	{
+		zabbix_log(LOG_LEVEL_WARNING, "configuration cache snapshot is outdated (%s), full configuration"
+				" synchronization will be performed", error);
+		zbx_dbsnapshot_discard();
+		zbx_free(error);
+	}
+	else
+		zabbix_log(LOG_LEVEL_INFORMATION, "restoring configuration cache from snapshot");
+out:
+	if (SUCCEED != ret)
+		zbx_hashset_clear(&dbsync_env.changelog);
+
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s", __func__, zbx_result_string(ret));
+
+	return ret;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: commits synchronized changes to configuration cache snapshot      *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_dbsync_env_commit(void)
+{
+	if (SUCCEED != zbx_dbsnapshot_is_writing())
+		return;
+
+	zbx_dbsnapshot_commit(&dbsync_env.changelog);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: get rows changed since last sync                                  *
@@ -672,6 +753,112 @@ static int	dbsync_get_rows(zbx_dbsync_t *sync, char **sql, size_t *sql_alloc, si
 	return SUCCEED;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: adds row restored from configuration cache snapshot to changeset  *
+ *                                                                            *
+ * Comments: Rows changed since snapshot was written are read from database.  *
+ *                                                                            *
+ ******************************************************************************/
+static int	dbsync_restore_row(void *data, zbx_uint64_t rowid, char **row, int columns_num)
+{
+	zbx_dbsync_t		*sync = (zbx_dbsync_t *)data;
+	zbx_dbsync_journal_t	*journal = &dbsync_env.journals[ZBX_DBSYNC_JOURNAL(sync->object)];
+
+	if (columns_num != sync->columns_num)
+	{
+		zabbix_log(LOG_LEVEL_WARNING, "unexpected number of columns in configuration cache snapshot \"%s\""
+				" row", sync->from);
+		return FAIL;
+	}
+
+	if (FAIL != zbx_vector_uint64_bsearch(&journal->inserts, rowid, ZBX_DEFAULT_UINT64_COMPARE_FUNC) ||
+			FAIL != zbx_vector_uint64_bsearch(&journal->updates, rowid, ZBX_DEFAULT_UINT64_COMPARE_FUNC) ||
+			FAIL != zbx_vector_uint64_bsearch(&journal->deletes, rowid, ZBX_DEFAULT_UINT64_COMPARE_FUNC))
+	{
+		return SUCCEED;
+	}
+
+	dbsync_add_row(sync, rowid, ZBX_DBSYNC_ROW_ADD, row);
+
+	return SUCCEED;
+}
+
+static int	dbsync_row_compare_rowid(const void *d1, const void *d2)
+{
+	const zbx_dbsync_row_t	*r1 = *(const zbx_dbsync_row_t * const *)d1;
+	const zbx_dbsync_row_t	*r2 = *(const zbx_dbsync_row_t * const *)d2;
+
+	ZBX_RETURN_IF_NOT_EQUAL(r1->rowid, r2->rowid);
+
+	return 0;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: updates runtime data of rows restored from snapshot               *
+ *                                                                            *
+ * Comments: Runtime data is stored in tables not tracked by changelog, so    *
+ *           the restored values can be outdated.                             *
+ *                                                                            *
+ ******************************************************************************/
+static int	dbsync_restore_rtdata(zbx_dbsync_t *sync)
+{
+	static const int	item_columns[] = {12, 20, 21, 27}, proxy_columns[] = {12};
+
+	const char		*sql;
+	const int		*columns;
+	int			i, index, columns_num;
+	zbx_db_result_t		result;
+	zbx_db_row_t		dbrow;
+	zbx_vector_ptr_t	rows;
+	zbx_dbsync_row_t	row_local, *row;
+
+	switch (sync->object)
+	{
+		case ZBX_DBSYNC_OBJ_ITEM:
+			sql = "select itemid,state,lastlogsize,mtime,error from item_rtdata";
+			columns = item_columns;
+			columns_num = ARRSIZE(item_columns);
+			break;
+		case ZBX_DBSYNC_OBJ_PROXY:
+			sql = "select proxyid,lastaccess from proxy_rtdata";
+			columns = proxy_columns;
+			columns_num = ARRSIZE(proxy_columns);
+			break;
+		default:
+			return SUCCEED;
+	}
+
+	if (NULL == (result = zbx_db_select("%s", sql)))
+		return FAIL;
+
+	zbx_vector_ptr_create(&rows);
+	zbx_vector_ptr_append_array(&rows, sync->rows.values, sync->rows.values_num);
+	zbx_vector_ptr_sort(&rows, dbsync_row_compare_rowid);
+
+	while (NULL != (dbrow = zbx_db_fetch(result)))
+	{
+		ZBX_STR2UINT64(row_local.rowid, dbrow[0]);
+
+		if (FAIL == (index = zbx_vector_ptr_bsearch(&rows, &row_local, dbsync_row_compare_rowid)))
+			continue;
+
+		row = (zbx_dbsync_row_t *)rows.values[index];
+
+		for (i = 0; i < columns_num; i++)
+		{
+			dbsync_strfree(row->row[columns[i]]);
+			row->row[columns[i]] = (NULL == dbrow[i + 1] ? NULL : dbsync_strdup(dbrow[i + 1]));
+		}
+	}
+	zbx_db_free_result(result);
+
+	zbx_vector_ptr_destroy(&rows);
+
+	return SUCCEED;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: read query data based on changelog journal                        *
@@ -680,7 +867,8 @@ static int	dbsync_get_rows(zbx_dbsync_t *sync, char **sql, size_t *sql_alloc, si
 static int	dbsync_read_journal(zbx_dbsync_t *sync, char **sql, size_t *sql_alloc, size_t *sql_offset,
 		const char *field, const char *keyword, const char *order_field, zbx_dbsync_journal_t *journal)
 {
-	int	i, inserts_num, updates_num;
+	int		i, inserts_num, updates_num, restored_num;
+	unsigned char	update_tag = ZBX_DBSYNC_ROW_UPDATE;
 
 	if (ZBX_DBSYNC_TYPE_CHANGELOG != sync->type)
 	{
@@ -694,6 +882,20 @@ static int	dbsync_read_journal(zbx_dbsync_t *sync, char **sql, size_t *sql_alloc
 	inserts_num = journal->inserts.values_num;
 	updates_num = journal->updates.values_num;
 
+	if (SUCCEED == zbx_dbsnapshot_is_restoring())
+	{
+		if (SUCCEED != zbx_dbsnapshot_read_rows(sync->object, dbsync_restore_row, sync))
+			return FAIL;
+
+		/* configuration cache is empty - restored and updated rows are added as new rows */
+		update_tag = ZBX_DBSYNC_ROW_ADD;
+	}
+
+	restored_num = sync->rows.values_num;
+
+	if (0 != restored_num && SUCCEED != dbsync_restore_rtdata(sync))
+		return FAIL;
+
 	if (0 != journal->inserts.values_num || 0 != journal->updates.values_num)
 	{
 		zbx_chrcpy_alloc(sql, sql_alloc, sql_offset, ' ');
@@ -711,7 +913,7 @@ static int	dbsync_read_journal(zbx_dbsync_t *sync, char **sql, size_t *sql_alloc
 		if (0 != journal->updates.values_num)
 		{
 			if (FAIL == dbsync_get_rows(sync, sql, sql_alloc, sql_offset, field, order_field,
-					&journal->updates, ZBX_DBSYNC_ROW_UPDATE))
+					&journal->updates, update_tag))
 			{
 				return FAIL;
 			}
@@ -722,11 +924,27 @@ static int	dbsync_read_journal(zbx_dbsync_t *sync, char **sql, size_t *sql_alloc
 		dbsync_add_row(sync, journal->deletes.values[i], ZBX_DBSYNC_ROW_REMOVE, NULL);
 
 	/* the obtained object identifiers are removed from journal */
-	sync->add_num = (zbx_uint64_t)(inserts_num - journal->inserts.values_num);
+	sync->add_num = (zbx_uint64_t)(restored_num + inserts_num - journal->inserts.values_num);
 	sync->update_num = (zbx_uint64_t)(updates_num - journal->updates.values_num);
 
+	if (ZBX_DBSYNC_ROW_ADD == update_tag)
+	{
+		sync->add_num += sync->update_num;
+		sync->update_num = 0;
+	}
+
 	sync->remove_num = (zbx_uint64_t)journal->deletes.values_num;
 
+	for (i = restored_num; i < sync->rows.values_num; i++)
+	{
+		zbx_dbsync_row_t	*row = (zbx_dbsync_row_t *)sync->rows.values[i];
+
+		if (ZBX_DBSYNC_ROW_REMOVE == row->tag)
+			zbx_dbsnapshot_write_remove(sync->object, row->rowid);
+		else if (NULL != row->row)
+			zbx_dbsnapshot_write_row(sync->object, row->rowid, row->row, sync->columns_num);
+	}
+
 	return SUCCEED;
 }
 
@@ -783,11 +1001,12 @@ void	zbx_dbsync_init(zbx_dbsync_t *sync, const char *name, unsigned char mode)
  * Purpose: initializes changeset for tables using changelog                  *
  *                                                                            *
  ******************************************************************************/
-void	zbx_dbsync_init_changelog(zbx_dbsync_t *sync, const char *name, unsigned char mode)
+void	zbx_dbsync_init_changelog(zbx_dbsync_t *sync, const char *name, unsigned char object, unsigned char mode)
 {
 	dbsync_init(sync, mode);
 	sync->from = name;
 	sync->type = ZBX_DBSYNC_TYPE_CHANGELOG;
+	sync->object = object;
 
 	zbx_vector_dbsync_append(&dbsync_env.changelog_dbsyncs, sync);
 }
@@ -893,6 +1112,14 @@ int	zbx_dbsync_next(zbx_dbsync_t *sync, zbx_uint64_t *rowid, char ***row, unsign
 
 		*row = dbsync_preproc_row(sync, dbrow);
 
+		if (ZBX_DBSYNC_TYPE_CHANGELOG == sync->type && NULL != *row && SUCCEED == zbx_dbsnapshot_is_writing())
+		{
+			zbx_uint64_t	snapshot_rowid;
+
+			ZBX_STR2UINT64(snapshot_rowid, (*row)[0]);
+			zbx_dbsnapshot_write_row(sync->object, snapshot_rowid, *row, sync->columns_num);
+		}
+
 		*rowid = 0;
 		*tag = ZBX_DBSYNC_ROW_ADD;
 
@@ -2096,12 +2323,14 @@ int	zbx_dbsync_compare_triggers(zbx_dbsync_t *sync)
 	zbx_dcsync_sql_start(sync);
 
 	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
-			"select triggerid,description,expression,error,priority,type,value,state,lastchange,status,"
-			"recovery_mode,recovery_expression,correlation_mode,correlation_tag,opdata,event_name,null,"
-			"null,null,flags"
-			" from triggers");
+			"select t.triggerid,t.description,t.expression,t.error,t.priority,t.type,t.value,t.state,"
+				"t.lastchange,t.status,t.recovery_mode,t.recovery_expression,t.correlation_mode,"
+				"t.correlation_tag,t.opdata,t.event_name,null,null,null,t.flags,t.templateid,"
+				"td.parent_triggerid"
+			" from triggers t"
+			" left join trigger_discovery td on t.triggerid=td.triggerid");
 
-	dbsync_prepare(sync, 20, dbsync_trigger_preproc_row);
+	dbsync_prepare(sync, 22, dbsync_trigger_preproc_row);
 
 	if (ZBX_DBSYNC_INIT == sync->mode)
 	{
@@ -2110,7 +2339,7 @@ int	zbx_dbsync_compare_triggers(zbx_dbsync_t *sync)
 		goto out;
 	}
 
-	ret = dbsync_read_journal(sync, &sql, &sql_alloc, &sql_offset, "triggerid", "where", NULL,
+	ret = dbsync_read_journal(sync, &sql, &sql_alloc, &sql_offset, "t.triggerid", "where", NULL,
 			&dbsync_env.journals[ZBX_DBSYNC_JOURNAL(ZBX_DBSYNC_OBJ_TRIGGER)]);
 out:
 	zbx_free(sql);
@@ -4388,14 +4617,14 @@ void	zbx_dcsync_sync_end(zbx_dbsync_t *sync, zbx_uint64_t used_size)
 	sync->sync_size += used_size - sync->used;
 }
 
-static void	dcsync_log_stats(const char *function_name, const zbx_dbsync_t *sync)
+static void	dcsync_log_stats(const char *function_name, const zbx_dbsync_t *sync, int level)
 {
-	zabbix_log(LOG_LEVEL_DEBUG, "%s() %16s: sql:" ZBX_FS_DBL " sync:" ZBX_FS_DBL " sec " ZBX_FS_I64 " bytes ("
+	zabbix_log(level, "%s() %16s: sql:" ZBX_FS_DBL " sync:" ZBX_FS_DBL " sec " ZBX_FS_I64 " bytes ("
 			ZBX_FS_UI64 "/" ZBX_FS_UI64 "/" ZBX_FS_UI64 ").", function_name, sync->from, sync->sql_time,
 			sync->sync_time, sync->sync_size, sync->add_num, sync->update_num, sync->remove_num);
 }
 
-void	zbx_dcsync_stats_dump(const char *function_name)
+void	zbx_dcsync_stats_dump(const char *function_name, int level)
 {
 	double		sync_time_total = 0, sql_time_total = 0;
 	zbx_int64_t	total_used = 0;
@@ -4404,7 +4633,7 @@ void	zbx_dcsync_stats_dump(const char *function_name)
 	{
 		const zbx_dbsync_t *sync = dbsync_env.changelog_dbsyncs.values[i];
 
-		dcsync_log_stats(function_name, sync);
+		dcsync_log_stats(function_name, sync, level);
 		sql_time_total += sync->sql_time;
 		sync_time_total += sync->sync_time;
 		total_used += sync->sync_size;
@@ -4414,13 +4643,384 @@ void	zbx_dcsync_stats_dump(const char *function_name)
 	{
 		const zbx_dbsync_t *sync = dbsync_env.dbsyncs.values[i];
 
-		dcsync_log_stats(function_name, sync);
+		dcsync_log_stats(function_name, sync, level);
 		sql_time_total += sync->sql_time;
 		sync_time_total += sync->sync_time;
 		total_used += sync->sync_size;
 	}
 
-	zabbix_log(LOG_LEVEL_DEBUG, "%s() total sql  : " ZBX_FS_DBL " sec.", function_name, sql_time_total);
-	zabbix_log(LOG_LEVEL_DEBUG, "%s() total sync : " ZBX_FS_DBL " sec.", function_name, sync_time_total);
-	zabbix_log(LOG_LEVEL_DEBUG, "%s() total memory difference: " ZBX_FS_I64 " bytes.", function_name, total_used);
+	zabbix_log(level, "%s() total sql  : " ZBX_FS_DBL " sec.", function_name, sql_time_total);
+	zabbix_log(level, "%s() total sync : " ZBX_FS_DBL " sec.", function_name, sync_time_total);
+	zabbix_log(level, "%s() total memory difference: " ZBX_FS_I64 " bytes.", function_name, total_used);
+}
+
+#define ZBX_DBSYNC_LOAD_PENDING	0
+#define ZBX_DBSYNC_LOAD_RUNNING	1
+#define ZBX_DBSYNC_LOAD_DONE	2
+
+typedef struct
+{
+	zbx_dbsync_t			*sync;
+	zbx_dbsync_compare_func_t	compare_func;
+	int				state;
+	int				ret;
+}
+zbx_dbsync_load_task_t;
+
+ZBX_VECTOR_DECL(dbsync_load_task, zbx_dbsync_load_task_t)
+ZBX_VECTOR_IMPL(dbsync_load_task, zbx_dbsync_load_task_t)
+
+struct zbx_dbsync_loader
+{
+	/* tasks in the order they are required by configuration sync */
+	zbx_vector_dbsync_load_task_t	tasks;
+	int				task_next;
+
+	/* the number of tasks being loaded by worker threads */
+	int				running_num;
+
+	/* stop taking new tasks */
+	int				stop;
+
+	/* result sets are freed, worker threads can close connections and exit */
+	int				release;
+
+	pthread_mutex_t			lock;
+	pthread_cond_t			event;
+
+	pthread_t			*threads;
+	int				threads_num;
+
+	double				start;
+	double				wait_time;
+};
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get next task to be loaded by worker thread                       *
+ *                                                                            *
+ * Return value: the next pending task or NULL if there are no pending tasks  *
+ *                                                                            *
+ * Comments: This function must be called with loader locked.                 *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_dbsync_load_task_t	*dbsync_loader_next_task(zbx_dbsync_loader_t *loader)
+{
+	if (0 != loader->stop)
+		return NULL;
+
+	while (loader->task_next < loader->tasks.values_num)
+	{
+		zbx_dbsync_load_task_t	*task = &loader->tasks.values[loader->task_next++];
+
+		/* tasks can be already taken by configuration sync thread */
+		if (ZBX_DBSYNC_LOAD_PENDING == task->state)
+			return task;
+	}
+
+	return NULL;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: configuration loader worker thread entry                          *
+ *                                                                            *
+ ******************************************************************************/
+static void	*dbsync_loader_entry(void *args)
+{
+	zbx_dbsync_loader_t	*loader = (zbx_dbsync_loader_t *)args;
+	zbx_dbsync_load_task_t	*task;
+	sigset_t		mask;
+	int			err, ret;
+
+	sigemptyset(&mask);
+	sigaddset(&mask, SIGTERM);
+	sigaddset(&mask, SIGUSR1);
+	sigaddset(&mask, SIGUSR2);
+	sigaddset(&mask, SIGHUP);
+	sigaddset(&mask, SIGQUIT);
+	sigaddset(&mask, SIGINT);
+
+	if (0 != (err = pthread_sigmask(SIG_BLOCK, &mask, NULL)))
+		zabbix_log(LOG_LEVEL_WARNING, "cannot block signals: %s", zbx_strerror(err));
+
+	/* tables not loaded by worker threads are loaded by configuration sync itself, */
+	/* so failure to open additional connection is not fatal                        */
+	if (ZBX_DB_OK != zbx_db_connect(ZBX_DB_CONNECT_ONCE))
+	{
+		zabbix_log(LOG_LEVEL_WARNING, "cannot open database connection for configuration cache loading");
+		zbx_db_close();
+
+		return NULL;
+	}
+
+	/* handle connection problems during queries the same way as configuration sync does */
+	zbx_db_set_connect_options(ZBX_DB_CONNECT_NORMAL);
+
+	pthread_mutex_lock(&loader->lock);
+
+	while (NULL != (task = dbsync_loader_next_task(loader)))
+	{
+		task->state = ZBX_DBSYNC_LOAD_RUNNING;
+		loader->running_num++;
+
+		pthread_mutex_unlock(&loader->lock);
+
+		ret = task->compare_func(task->sync);
+
+		pthread_mutex_lock(&loader->lock);
+
+		task->ret = ret;
+		task->state = ZBX_DBSYNC_LOAD_DONE;
+		loader->running_num--;
+
+		pthread_cond_broadcast(&loader->event);
+	}
+
+	/* database results might refer to the connection, keep it open until results are freed */
+	while (0 == loader->release)
+		pthread_cond_wait(&loader->event, &loader->lock);
+
+	pthread_mutex_unlock(&loader->lock);
+
+	zbx_db_close();
+
+	return NULL;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: create configuration loader                                       *
+ *                                                                            *
+ * Return value: the configuration loader or NULL if it cannot be created     *
+ *                                                                            *
+ * Comments: Configuration loader executes initial database queries of the    *
+ *           registered dbsync objects in parallel worker threads with their  *
+ *           own database connections. Configuration cache is still updated   *
+ *           by the calling thread in the usual order.                        *
+ *                                                                            *
+ ******************************************************************************/
+zbx_dbsync_loader_t	*zbx_dbsync_loader_create(void)
+{
+	zbx_dbsync_loader_t	*loader;
+	int			err;
+
+	loader = (zbx_dbsync_loader_t *)zbx_malloc(NULL, sizeof(zbx_dbsync_loader_t));
+	memset(loader, 0, sizeof(zbx_dbsync_loader_t));
+
+	if (0 != (err = pthread_mutex_init(&loader->lock, NULL)))
+	{
+		zabbix_log(LOG_LEVEL_WARNING, "cannot initialize configuration loader mutex: %s", zbx_strerror(err));
+		zbx_free(loader);
+
+		return NULL;
+	}
+
+	if (0 != (err = pthread_cond_init(&loader->event, NULL)))
+	{
+		zabbix_log(LOG_LEVEL_WARNING, "cannot initialize configuration loader condition variable: %s",
+				zbx_strerror(err));
+		pthread_mutex_destroy(&loader->lock);
+		zbx_free(loader);
+
+		return NULL;
+	}
+
+	zbx_vector_dbsync_load_task_create(&loader->tasks);
+
+	return loader;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: register dbsync object to be loaded by worker threads             *
+ *                                                                            *
+ * Parameters: loader       - [IN] configuration loader                       *
+ *             sync         - [IN] dbsync object                              *
+ *             compare_func - [IN] function populating the dbsync object      *
+ *                                                                            *
+ * Comments: Only dbsync objects in initial mode are registered - their       *
+ *           population performs database query without accessing             *
+ *           configuration cache.                                             *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_dbsync_loader_add(zbx_dbsync_loader_t *loader, zbx_dbsync_t *sync, zbx_dbsync_compare_func_t compare_func)
+{
+	zbx_dbsync_load_task_t	task;
+
+	if (ZBX_DBSYNC_INIT != sync->mode || 0 != loader->threads_num)
+		return;
+
+	task.sync = sync;
+	task.compare_func = compare_func;
+	task.state = ZBX_DBSYNC_LOAD_PENDING;
+	task.ret = FAIL;
+
+	zbx_vector_dbsync_load_task_append(&loader->tasks, task);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: start configuration loader worker threads                         *
+ *                                                                            *
+ * Parameters: loader      - [IN] configuration loader                        *
+ *             threads_num - [IN] the number of worker threads                *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_dbsync_loader_start(zbx_dbsync_loader_t *loader, int threads_num)
+{
+	pthread_attr_t	attr;
+	int		err;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s() tables:%d threads:%d", __func__, loader->tasks.values_num, threads_num);
+
+	loader->start = zbx_time();
+
+	if (threads_num > loader->tasks.values_num)
+		threads_num = loader->tasks.values_num;
+
+	if (0 >= threads_num)
+		goto out;
+
+	loader->threads = (pthread_t *)zbx_malloc(NULL, sizeof(pthread_t) * (size_t)threads_num);
+
+	zbx_pthread_init_attr(&attr);
+
+	for (int i = 0; i < threads_num; i++)
+	{
+		if (0 != (err = pthread_create(&loader->threads[i], &attr, dbsync_loader_entry, (void *)loader)))
+		{
+			zabbix_log(LOG_LEVEL_WARNING, "cannot create configuration loader thread: %s",
+					zbx_strerror(err));
+			break;
+		}
+
+		loader->threads_num++;
+	}
+
+	pthread_attr_destroy(&attr);
+out:
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s() threads:%d", __func__, loader->threads_num);
 }
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: populate dbsync object, using results of configuration loader if  *
+ *          the object was registered there                                   *
+ *                                                                            *
+ * Parameters: loader       - [IN] configuration loader (optional)            *
+ *             sync         - [IN/OUT] dbsync object                          *
+ *             compare_func - [IN] function populating the dbsync object      *
+ *                                                                            *
+ * Return value: SUCCEED - the changeset was successfully calculated          *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ * Comments: Tasks not yet taken by worker threads are executed directly.     *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_dbsync_load(zbx_dbsync_loader_t *loader, zbx_dbsync_t *sync, zbx_dbsync_compare_func_t compare_func)
+{
+	zbx_dbsync_load_task_t	*task = NULL;
+	double			sec;
+	int			ret;
+
+	if (NULL == loader)
+		return compare_func(sync);
+
+	for (int i = 0; i < loader->tasks.values_num; i++)
+	{
+		if (loader->tasks.values[i].sync == sync)
+		{
+			task = &loader->tasks.values[i];
+			break;
+		}
+	}
+
+	if (NULL == task)
+		return compare_func(sync);
+
+	pthread_mutex_lock(&loader->lock);
+
+	if (ZBX_DBSYNC_LOAD_PENDING == task->state)
+	{
+		task->state = ZBX_DBSYNC_LOAD_RUNNING;
+		pthread_mutex_unlock(&loader->lock);
+
+		return compare_func(sync);
+	}
+
+	sec = zbx_time();
+
+	while (ZBX_DBSYNC_LOAD_DONE != task->state)
+		pthread_cond_wait(&loader->event, &loader->lock);
+
+	loader->wait_time += zbx_time() - sec;
+	ret = task->ret;
+
+	pthread_mutex_unlock(&loader->lock);
+
+	return ret;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: stop loading new tables and wait for the running queries          *
+ *                                                                            *
+ * Comments: Must be called before clearing registered dbsync objects.        *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_dbsync_loader_stop(zbx_dbsync_loader_t *loader)
+{
+	pthread_mutex_lock(&loader->lock);
+
+	loader->stop = 1;
+
+	while (0 != loader->running_num)
+		pthread_cond_wait(&loader->event, &loader->lock);
+
+	pthread_mutex_unlock(&loader->lock);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: stop configuration loader worker threads and free the loader      *
+ *                                                                            *
+ * Comments: Must be called after registered dbsync objects are cleared.      *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_dbsync_loader_free(zbx_dbsync_loader_t *loader)
+{
+	pthread_mutex_lock(&loader->lock);
+
+	loader->stop = 1;
+	loader->release = 1;
+	pthread_cond_broadcast(&loader->event);
+
+	pthread_mutex_unlock(&loader->lock);
+
+	for (int i = 0; i < loader->threads_num; i++)
+	{
+		void	*retval;
+
+		pthread_join(loader->threads[i], &retval);
+	}
+
+	if (0 != loader->threads_num)
+	{
+		zabbix_log(LOG_LEVEL_INFORMATION, "configuration cache loaded using %d additional database connections"
+				" in " ZBX_FS_DBL " sec, waited for database " ZBX_FS_DBL " sec", loader->threads_num,
+				zbx_time() - loader->start, loader->wait_time);
+	}
+
+	zbx_free(loader->threads);
+	zbx_vector_dbsync_load_task_destroy(&loader->tasks);
+
+	pthread_cond_destroy(&loader->event);
+	pthread_mutex_destroy(&loader->lock);
+
+	zbx_free(loader);
+}
+
+#undef ZBX_DBSYNC_LOAD_PENDING
+#undef ZBX_DBSYNC_LOAD_RUNNING
+#undef ZBX_DBSYNC_LOAD_DONE
@@ -38,12 +38,40 @@
 #define ZBX_DBSYNC_UPDATE_MAINTENANCE_GROUPS	__UINT64_C(0x0040)
 #define ZBX_DBSYNC_UPDATE_MACROS		__UINT64_C(0x0080)
 
+/* the number of worker threads loading configuration tables during initial sync */
+#define ZBX_DBSYNC_LOADER_THREADS_NUM		4
+
 #define ZBX_DBSYNC_TRIGGER_ERROR	0x80
 
 
 #define ZBX_DBSYNC_TYPE_DIFF		0
 #define ZBX_DBSYNC_TYPE_CHANGELOG	1
 
+/* objects tracked by changelog table */
+#define ZBX_DBSYNC_OBJ_HOST		1
+#define ZBX_DBSYNC_OBJ_HOST_TAG		2
+#define ZBX_DBSYNC_OBJ_ITEM		3
+#define ZBX_DBSYNC_OBJ_ITEM_TAG		4
+#define ZBX_DBSYNC_OBJ_TRIGGER		5
+#define ZBX_DBSYNC_OBJ_TRIGGER_TAG	6
+#define ZBX_DBSYNC_OBJ_FUNCTION		7
+#define ZBX_DBSYNC_OBJ_ITEM_PREPROC	8
+#define ZBX_DBSYNC_OBJ_DRULE		9
+#define ZBX_DBSYNC_OBJ_DCHECK		10
+#define ZBX_DBSYNC_OBJ_HTTPTEST		11
+#define ZBX_DBSYNC_OBJ_HTTPTEST_FIELD	12
+#define ZBX_DBSYNC_OBJ_HTTPTEST_ITEM	13
+#define ZBX_DBSYNC_OBJ_HTTPSTEP		14
+#define ZBX_DBSYNC_OBJ_HTTPSTEP_FIELD	15
+#define ZBX_DBSYNC_OBJ_HTTPSTEP_ITEM	16
+#define ZBX_DBSYNC_OBJ_CONNECTOR	17
+#define ZBX_DBSYNC_OBJ_CONNECTOR_TAG	18
+#define ZBX_DBSYNC_OBJ_PROXY		19
+#define ZBX_DBSYNC_OBJ_PROXY_GROUP	20
+#define ZBX_DBSYNC_OBJ_HOST_PROXY	21
+/* number of dbsync objects - keep in sync with above defines */
+#define ZBX_DBSYNC_OBJ_COUNT		21
+
 /******************************************************************************
  *                                                                            *
  * Purpose: applies necessary preprocessing before row is compared/used       *
@@ -71,6 +99,13 @@ typedef struct
 }
 zbx_dbsync_row_t;
 
+typedef struct
+{
+	zbx_uint64_t	changelogid;
+	int		clock;
+}
+zbx_dbsync_changelog_t;
+
 struct zbx_dbsync
 {
 	/* the synchronization mode (see ZBX_DBSYNC_* defines) */
@@ -79,6 +114,9 @@ struct zbx_dbsync
 
 	unsigned char			type;
 
+	/* the changelog object (see ZBX_DBSYNC_OBJ_* defines) for ZBX_DBSYNC_TYPE_CHANGELOG type */
+	unsigned char			object;
+
 	/* the number of columns in diff */
 	int				columns_num;
 
@@ -118,9 +156,12 @@ void	zbx_dbsync_env_flush_changelog(void);
 void	zbx_dbsync_env_clear(void);
 int	zbx_dbsync_env_changelog_num(void);
 int	zbx_dbsync_env_changelog_dbsyncs_new_records(void);
+int	zbx_dbsync_validate_snapshot(int commit_clock, int now, int oldest_clock, char **error);
+int	zbx_dbsync_env_restore(void);
+void	zbx_dbsync_env_commit(void);
 
 void	zbx_dbsync_init(zbx_dbsync_t *sync, const char *name, unsigned char mode);
-void	zbx_dbsync_init_changelog(zbx_dbsync_t *sync, const char *name, unsigned char mode);
+void	zbx_dbsync_init_changelog(zbx_dbsync_t *sync, const char *name, unsigned char object, unsigned char mode);
 void	zbx_dbsync_clear(zbx_dbsync_t *sync);
 int	zbx_dbsync_get_row_num(const zbx_dbsync_t *sync);
 int	zbx_dbsync_next(zbx_dbsync_t *sync, zbx_uint64_t *rowid, char ***row, unsigned char *tag);
@@ -176,10 +217,22 @@ int	zbx_dbsync_compare_proxies(zbx_dbsync_t *sync);
 
 int	zbx_dbsync_prepare_proxy_group(zbx_dbsync_t *sync);
 int	zbx_dbsync_prepare_host_proxy(zbx_dbsync_t *sync);
+
+typedef int	(*zbx_dbsync_compare_func_t)(zbx_dbsync_t *sync);
+
+typedef struct zbx_dbsync_loader	zbx_dbsync_loader_t;
+
+zbx_dbsync_loader_t	*zbx_dbsync_loader_create(void);
+void	zbx_dbsync_loader_add(zbx_dbsync_loader_t *loader, zbx_dbsync_t *sync, zbx_dbsync_compare_func_t compare_func);
+void	zbx_dbsync_loader_start(zbx_dbsync_loader_t *loader, int threads_num);
+int	zbx_dbsync_load(zbx_dbsync_loader_t *loader, zbx_dbsync_t *sync, zbx_dbsync_compare_func_t compare_func);
+void	zbx_dbsync_loader_stop(zbx_dbsync_loader_t *loader);
+void	zbx_dbsync_loader_free(zbx_dbsync_loader_t *loader);
+
 void	zbx_dcsync_sql_start(zbx_dbsync_t *sync);
 void	zbx_dcsync_sql_end(zbx_dbsync_t *sync);
 void	zbx_dcsync_sync_start(zbx_dbsync_t *sync, zbx_uint64_t used_size);
 void	zbx_dcsync_sync_end(zbx_dbsync_t *sync, zbx_uint64_t used_size);
-void	zbx_dcsync_stats_dump(const char *function_name);
+void	zbx_dcsync_stats_dump(const char *function_name, int level);
 
 #endif /* BUILD_SRC_LIBS_ZBXDBCACHE_DBSYNC_H_ */
@@ -880,6 +880,80 @@ zbx_um_cache_t	*um_cache_sync(zbx_um_cache_t *cache, zbx_uint64_t revision, zbx_
 	return cache;
 }
 
+#define ZBX_UM_REGEXP_CACHE_MAX	1000
+
+/* compiled user macro context regular expression */
+typedef struct
+{
+	char		*pattern;
+	zbx_regexp_t	*regexp;
+}
+zbx_um_regexp_t;
+
+static ZBX_THREAD_LOCAL zbx_hashset_t	um_regexps;
+
+static void	um_regexp_clean(void *data)
+{
+	zbx_um_regexp_t	*um_regexp = (zbx_um_regexp_t *)data;
+
+	if (NULL != um_regexp->regexp)
+		zbx_regexp_free(um_regexp->regexp);
+
+	zbx_free(um_regexp->pattern);
+}
+
+/*********************************************************************************
+ *                                                                               *
+ * Purpose: match value against user macro context regular expression            *
+ *                                                                               *
+ * Parameters: value   - [IN] the value to match                                 *
+ *             pattern - [IN] the regular expression                             *
+ *                                                                               *
+ * Return value: SUCCEED - the value matches regular expression                  *
+ *               FAIL    - otherwise                                             *
+ *                                                                               *
+ * Comments: Regular expressions are compiled once and kept in process local     *
+ *           cache, as macros with different regular expression contexts are     *
+ *           usually matched in turns.                                           *
+ *                                                                               *
+ *********************************************************************************/
+static int	um_regexp_match(const char *value, const char *pattern)
+{
+	zbx_um_regexp_t	*um_regexp, um_regexp_local;
+	char		*error = NULL;
+
+	if (0 == um_regexps.num_slots)
+	{
+		zbx_hashset_create_ext(&um_regexps, 0, ZBX_DEFAULT_STRING_PTR_HASH_FUNC,
+				ZBX_DEFAULT_STR_PTR_COMPARE_FUNC, um_regexp_clean, ZBX_DEFAULT_MEM_MALLOC_FUNC,
+				ZBX_DEFAULT_MEM_REALLOC_FUNC, ZBX_DEFAULT_MEM_FREE_FUNC);
+	}
+
+	um_regexp_local.pattern = (char *)pattern;
+
+	if (NULL == (um_regexp = (zbx_um_regexp_t *)zbx_hashset_search(&um_regexps, &um_regexp_local)))
+	{
+		if (ZBX_UM_REGEXP_CACHE_MAX <= um_regexps.num_data)
+			zbx_hashset_clear(&um_regexps);
+
+		um_regexp_local.pattern = zbx_strdup(NULL, pattern);
+
+		if (SUCCEED != zbx_regexp_compile(pattern, &um_regexp_local.regexp, &error))
+		{
+			um_regexp_local.regexp = NULL;
+			zbx_free(error);
+		}
+
+		um_regexp = (zbx_um_regexp_t *)zbx_hashset_insert(&um_regexps, &um_regexp_local,
+				sizeof(um_regexp_local));
+	}
+
+	if (NULL == um_regexp->regexp || 0 != zbx_regexp_match_precompiled(value, um_regexp->regexp))
+		return FAIL;
+
+	return SUCCEED;
+}
+
 #define ZBX_UM_MATCH_FAIL	(-1)
 #define ZBX_UM_MATCH_FULL	0
 #define ZBX_UM_MATCH_NAME	1
@@ -906,7 +980,7 @@ static int	um_macro_match(const zbx_um_macro_t *macro, const char *name, const c
 					return ZBX_UM_MATCH_FULL;
 				break;
 			case ZBX_CONDITION_OPERATOR_REGEXP:
-				if (NULL != zbx_regexp_match(context, macro->context, NULL))
+				if (SUCCEED == um_regexp_match(context, macro->context))
 					return ZBX_UM_MATCH_FULL;
 				break;
 			default:
@@ -1054,6 +1128,263 @@ static void	um_cache_get_macro(const zbx_um_cache_t *cache, const zbx_uint64_t *
 	zbx_free(context);
 }
 
+#define ZBX_UM_MEMO_MAX		100000
+#define ZBX_UM_MEMO_MACRO_LEN	256
+
+/* resolved user macro */
+typedef struct
+{
+	char			*macro;
+	const zbx_um_macro_t	*um_macro;	/* NULL if macro was not found */
+}
+zbx_um_memo_macro_t;
+
+/* user macros resolved for a host */
+typedef struct
+{
+	zbx_uint64_t	hostid;
+	zbx_uint64_t	revision;	/* the highest revision of host, its templates and global macros */
+	int		hosts_num;	/* the number of cached hosts in template chain                  */
+	zbx_uint64_t	cache_revision;	/* user macro cache revision the host revision was checked at    */
+	zbx_hashset_t	macros;
+}
+zbx_um_memo_host_t;
+
+/* process local user macro resolution cache */
+typedef struct
+{
+	zbx_hashset_t	hosts;
+	zbx_uint64_t	revision;
+	int		macros_num;
+}
+zbx_um_memo_t;
+
+static ZBX_THREAD_LOCAL zbx_um_memo_t	um_memo;
+
+static zbx_hash_t	um_memo_macro_hash(const void *d)
+{
+	const zbx_um_memo_macro_t	*macro = (const zbx_um_memo_macro_t *)d;
+
+	return ZBX_DEFAULT_STRING_HASH_FUNC(macro->macro);
+}
+
+static int	um_memo_macro_compare(const void *d1, const void *d2)
+{
+	const zbx_um_memo_macro_t	*macro1 = (const zbx_um_memo_macro_t *)d1;
+	const zbx_um_memo_macro_t	*macro2 = (const zbx_um_memo_macro_t *)d2;
+
+	return strcmp(macro1->macro, macro2->macro);
+}
+
+static void	um_memo_macro_clean(void *data)
+{
+	zbx_um_memo_macro_t	*macro = (zbx_um_memo_macro_t *)data;
+
+	zbx_free(macro->macro);
+}
+
+static void	um_memo_host_clean(void *data)
+{
+	zbx_um_memo_host_t	*host = (zbx_um_memo_host_t *)data;
+
+	zbx_hashset_destroy(&host->macros);
+}
+
+/*********************************************************************************
+ *                                                                               *
+ * Purpose: get the highest macro and template link revision of host and its     *
+ *          templates                                                            *
+ *                                                                               *
+ * Parameters: cache     - [IN] the user macro cache                             *
+ *             hostid    - [IN] the host identifier                              *
+ *             revision  - [IN/OUT] the highest revision                         *
+ *             hosts_num - [IN/OUT] the number of cached hosts in template chain *
+ *                                                                               *
+ * Comments: Hosts are copied with updated revision when their macros or linked  *
+ *           templates change, so unchanged revisions mean that the previously   *
+ *           resolved macros are still valid. The number of hosts detects        *
+ *           templates removed from cache.                                       *
+ *                                                                               *
+ *********************************************************************************/
+static void	um_memo_get_host_revision(const zbx_um_cache_t *cache, zbx_uint64_t hostid, zbx_uint64_t *revision,
+		int *hosts_num)
+{
+	const zbx_um_host_t	* const *phost;
+	zbx_uint64_t		*phostid = &hostid;
+
+	if (NULL == (phost = (const zbx_um_host_t * const *)zbx_hashset_search(&cache->hosts, &phostid)))
+		return;
+
+	(*hosts_num)++;
+
+	if ((*phost)->macro_revision > *revision)
+		*revision = (*phost)->macro_revision;
+
+	if ((*phost)->link_revision > *revision)
+		*revision = (*phost)->link_revision;
+
+	for (int i = 0; i < (*phost)->templateids.values_num; i++)
+		um_memo_get_host_revision(cache, (*phost)->templateids.values[i], revision, hosts_num);
+}
+
+/*********************************************************************************
+ *                                                                               *
+ * Purpose: clear user macro resolution cache                                    *
+ *                                                                               *
+ *********************************************************************************/
+static void	um_memo_reset(void)
+{
+	if (0 == um_memo.hosts.num_slots)
+	{
+		zbx_hashset_create_ext(&um_memo.hosts, 0, ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC,
+				um_memo_host_clean, ZBX_DEFAULT_MEM_MALLOC_FUNC, ZBX_DEFAULT_MEM_REALLOC_FUNC,
+				ZBX_DEFAULT_MEM_FREE_FUNC);
+	}
+	else
+	{
+		zabbix_log(LOG_LEVEL_DEBUG, "%s() revision:" ZBX_FS_UI64 " hosts:%d macros:%d", __func__,
+				um_memo.revision, um_memo.hosts.num_data, um_memo.macros_num);
+
+		zbx_hashset_clear(&um_memo.hosts);
+	}
+
+	um_memo.macros_num = 0;
+}
+
+/*********************************************************************************
+ *                                                                               *
+ * Purpose: get user macros resolved for the specified host                      *
+ *                                                                               *
+ * Parameters: cache  - [IN] the user macro cache                                *
+ *             hostid - [IN] the host identifier                                 *
+ *                                                                               *
+ * Return value: the resolved host macros                                        *
+ *                                                                               *
+ * Comments: Resolved macros of a host are dropped when macros or linked         *
+ *           templates of the host, its templates or global macros change.       *
+ *           Revisions are checked once per user macro cache revision.           *
+ *                                                                               *
+ *********************************************************************************/
+static zbx_um_memo_host_t	*um_memo_get_host(const zbx_um_cache_t *cache, zbx_uint64_t hostid)
+{
+	zbx_um_memo_host_t	*host;
+	zbx_uint64_t		revision = 0;
+	int			hosts_num = 0;
+
+	/* revision going back means a different user macro cache */
+	if (0 == um_memo.hosts.num_slots || cache->revision < um_memo.revision || ZBX_UM_MEMO_MAX <= um_memo.macros_num)
+		um_memo_reset();
+
+	um_memo.revision = cache->revision;
+
+	if (NULL == (host = (zbx_um_memo_host_t *)zbx_hashset_search(&um_memo.hosts, &hostid)))
+	{
+		zbx_um_memo_host_t	host_local = {.hostid = hostid};
+
+		host = (zbx_um_memo_host_t *)zbx_hashset_insert(&um_memo.hosts, &host_local, sizeof(host_local));
+		zbx_hashset_create_ext(&host->macros, 0, um_memo_macro_hash, um_memo_macro_compare,
+				um_memo_macro_clean, ZBX_DEFAULT_MEM_MALLOC_FUNC, ZBX_DEFAULT_MEM_REALLOC_FUNC,
+				ZBX_DEFAULT_MEM_FREE_FUNC);
+	}
+	else if (host->cache_revision == cache->revision)
+		return host;
+
+	um_memo_get_host_revision(cache, hostid, &revision, &hosts_num);
+
+	if (ZBX_UM_CACHE_GLOBAL_MACRO_HOSTID != hostid)
+		um_memo_get_host_revision(cache, ZBX_UM_CACHE_GLOBAL_MACRO_HOSTID, &revision, &hosts_num);
+
+	if (revision != host->revision || hosts_num != host->hosts_num)
+	{
+		um_memo.macros_num -= host->macros.num_data;
+		zbx_hashset_clear(&host->macros);
+
+		host->revision = revision;
+		host->hosts_num = hosts_num;
+	}
+
+	host->cache_revision = cache->revision;
+
+	return host;
+}
+
+/*********************************************************************************
+ *                                                                               *
+ * Purpose: get user macro (host/global) using process local resolution cache    *
+ *                                                                               *
+ * Parameters: cache       - [IN] the user macro cache                           *
+ *             hostids     - [IN] the host identifiers                           *
+ *             hostids_num - [IN] the number of host identifiers                 *
+ *             macro       - [IN] the macro with optional context                *
+ *             um_macro    - [OUT] the cached macro                              *
+ *                                                                               *
+ * Comments: The resolved macros (including not found ones) are cached by host   *
+ *           and macro text until the host, its templates or global macros       *
+ *           change. The user macro cache must be referenced by the caller so it *
+ *           is not changed while being used.                                    *
+ *                                                                               *
+ *********************************************************************************/
+static void	um_cache_get_macro_memo(const zbx_um_cache_t *cache, const zbx_uint64_t *hostids, int hostids_num,
+		const char *macro, const zbx_um_macro_t **um_macro)
+{
+	int			macro_r, context_l, context_r;
+	unsigned char		context_op;
+	char			buf[ZBX_UM_MEMO_MACRO_LEN];
+	zbx_um_memo_host_t	*host;
+	zbx_um_memo_macro_t	*memo_macro, memo_macro_local;
+	zbx_dc_um_memo_stats_t	*stats;
+
+	/* lookups in multiple hosts are not cached */
+	if (1 < hostids_num || SUCCEED != zbx_user_macro_parse(macro, &macro_r, &context_l, &context_r, &context_op) ||
+			ZBX_UM_MEMO_MACRO_LEN <= macro_r + 1)
+	{
+		um_cache_get_macro(cache, hostids, hostids_num, macro, um_macro);
+		return;
+	}
+
+	host = um_memo_get_host(cache, 0 != hostids_num ? hostids[0] : ZBX_UM_CACHE_GLOBAL_MACRO_HOSTID);
+	stats = dc_get_um_memo_stats_local();
+
+	memcpy(buf, macro, (size_t)macro_r + 1);
+	buf[macro_r + 1] = '\0';
+	memo_macro_local.macro = buf;
+
+	if (NULL != (memo_macro = (zbx_um_memo_macro_t *)zbx_hashset_search(&host->macros, &memo_macro_local)))
+	{
+		if (NULL != stats)
+			stats->hits++;
+
+		*um_macro = memo_macro->um_macro;
+		return;
+	}
+
+	if (NULL != stats)
+		stats->misses++;
+
+	um_cache_get_macro(cache, hostids, hostids_num, macro, um_macro);
+
+	memo_macro_local.macro = zbx_strdup(NULL, buf);
+	memo_macro_local.um_macro = *um_macro;
+	zbx_hashset_insert(&host->macros, &memo_macro_local, sizeof(memo_macro_local));
+	um_memo.macros_num++;
+}
+
+/*********************************************************************************
+ *                                                                               *
+ * Purpose: get user macro value according to the environment                    *
+ *                                                                               *
+ *********************************************************************************/
+static void	um_macro_get_value_const(const zbx_um_macro_t *um_macro, int env, const char **value)
+{
+	if (NULL != um_macro)
+	{
+		if (ZBX_MACRO_ENV_NONSECURE == env && ZBX_MACRO_VALUE_TEXT != um_macro->type)
+			*value = ZBX_MACRO_SECRET_MASK;
+		else
+			*value = (NULL != um_macro->value ? um_macro->value : ZBX_MACRO_NO_KVS_VALUE);
+	}
+}
+
 /*********************************************************************************
  *                                                                               *
  * Purpose: resolve user macro (host/global)                                     *
@@ -1075,14 +1406,32 @@ void	um_cache_resolve_const(const zbx_um_cache_t *cache, const zbx_uint64_t *hos
 	const zbx_um_macro_t	*um_macro = NULL;
 
 	um_cache_get_macro(cache, hostids, hostids_num, macro, &um_macro);
+	um_macro_get_value_const(um_macro, env, value);
+}
 
-	if (NULL != um_macro)
-	{
-		if (ZBX_MACRO_ENV_NONSECURE == env && ZBX_MACRO_VALUE_TEXT != um_macro->type)
-			*value = ZBX_MACRO_SECRET_MASK;
-		else
-			*value = (NULL != um_macro->value ? um_macro->value : ZBX_MACRO_NO_KVS_VALUE);
-	}
+/*********************************************************************************
+ *                                                                               *
+ * Purpose: resolve user macro (host/global) using process local resolution      *
+ *          cache                                                                *
+ *                                                                               *
+ * Parameters: cache       - [IN] the user macro cache, referenced by the caller *
+ *             hostids     - [IN] the host identifiers                           *
+ *             hostids_num - [IN] the number of host identifiers                 *
+ *             macro       - [IN] the macro with optional context                *
+ *             env         - [IN] the environment flag:                          *
+ *                                  0 - secure                                   *
+ *                                  1 - non-secure (secure macros are resolved   *
+ *                                                  to ***** )                   *
+ *             value       - [OUT] macro value, must not be freed by the caller  *
+ *                                                                               *
+ *********************************************************************************/
+void	um_cache_resolve_const_memo(const zbx_um_cache_t *cache, const zbx_uint64_t *hostids, int hostids_num,
+		const char *macro, int env, const char **value)
+{
+	const zbx_um_macro_t	*um_macro = NULL;
+
+	um_cache_get_macro_memo(cache, hostids, hostids_num, macro, &um_macro);
+	um_macro_get_value_const(um_macro, env, value);
 }
 
 /*********************************************************************************
@@ -69,6 +69,8 @@ int	um_macro_check_vault_location(const zbx_um_macro_t *macro, const char *locat
 
 void	um_cache_resolve_const(const zbx_um_cache_t *cache, const zbx_uint64_t *hostids, int hostids_num,
 		const char *macro, int env, const char **value);
+void	um_cache_resolve_const_memo(const zbx_um_cache_t *cache, const zbx_uint64_t *hostids, int hostids_num,
+		const char *macro, int env, const char **value);
 void	um_cache_resolve(const zbx_um_cache_t *cache, const zbx_uint64_t *hostids, int hostids_num, const char *macro,
 		int env, char **value);
 int	um_cache_get_host_revision(const zbx_um_cache_t *cache, zbx_uint64_t hostid, zbx_uint64_t *revision);
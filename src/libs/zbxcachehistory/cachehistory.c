@@ -109,6 +109,9 @@ typedef struct
 
 	zbx_hc_proxyqueue_t	proxyqueue;
 	int			processing_num;
+
+	zbx_hc_trigger_stats_t	trigger_stats;
+	double			trigger_stats_start;
 }
 ZBX_DC_CACHE;
 
@@ -573,7 +576,7 @@ static void	dc_trends_fetch_and_update(ZBX_DC_TREND *trends, int trends_num, zbx
 		const char *table_name, int clock)
 {
 
-	int		i, num;
+	int		i, num, pipeline;
 	zbx_db_result_t	result;
 	zbx_db_row_t	row;
 	zbx_uint64_t	itemid;
@@ -592,6 +595,7 @@ static void	dc_trends_fetch_and_update(ZBX_DC_TREND *trends, int trends_num, zbx
 	result = zbx_db_select("%s order by itemid,clock", sql);
 
 	sql_offset = 0;
+	pipeline = zbx_db_pipeline_begin();
 
 	while (NULL != (row = zbx_db_fetch(result)))
 	{
@@ -627,12 +631,15 @@ static void	dc_trends_fetch_and_update(ZBX_DC_TREND *trends, int trends_num, zbx
 
 		--*inserts_num;
 
-		zbx_db_execute_overflowed_sql(&sql, &sql_alloc, &sql_offset);
+		zbx_db_pipeline_execute_sql(&sql, &sql_alloc, &sql_offset);
 	}
 
 	zbx_db_free_result(result);
 
 	(void)zbx_db_flush_overflowed_sql(sql, sql_offset);
+
+	if (SUCCEED == pipeline)
+		(void)zbx_db_pipeline_end();
 }
 
 /******************************************************************************
@@ -1675,7 +1682,7 @@ static void	DCadd_update_inventory_sql(size_t *sql_offset, const zbx_vector_inve
 				"update host_inventory set %s='%s' where hostid=" ZBX_FS_UI64 ";\n",
 				inventory_value->field_name, value_esc, inventory_value->hostid);
 
-		zbx_db_execute_overflowed_sql(&sql, &sql_alloc, sql_offset);
+		zbx_db_pipeline_execute_sql(&sql, &sql_alloc, sql_offset);
 
 		zbx_free(value_esc);
 	}
@@ -1764,6 +1771,10 @@ void	zbx_db_mass_update_items(const zbx_vector_item_diff_ptr_t *item_diff,
 
 	if (i != item_diff->values_num || 0 != inventory_values->values_num)
 	{
+		int	pipeline;
+
+		pipeline = zbx_db_pipeline_begin();
+
 		if (i != item_diff->values_num)
 		{
 			zbx_db_save_item_changes(&sql, &sql_alloc, &sql_offset, item_diff,
@@ -1775,6 +1786,9 @@ void	zbx_db_mass_update_items(const zbx_vector_item_diff_ptr_t *item_diff,
 
 		(void)zbx_db_flush_overflowed_sql(sql, sql_offset);
 
+		if (SUCCEED == pipeline)
+			(void)zbx_db_pipeline_end();
+
 		zbx_dc_config_update_inventory_values(inventory_values);
 	}
 
@@ -3145,6 +3159,7 @@ int	zbx_init_database_cache(zbx_get_program_type_f get_program_type, zbx_history
 
 	cache = (ZBX_DC_CACHE *)__hc_index_shmem_malloc_func(NULL, sizeof(ZBX_DC_CACHE));
 	memset(cache, 0, sizeof(ZBX_DC_CACHE));
+	cache->trigger_stats_start = zbx_time();
 
 	ids = (ZBX_DC_IDS *)__hc_index_shmem_malloc_func(NULL, sizeof(ZBX_DC_IDS));
 	memset(ids, 0, sizeof(ZBX_DC_IDS));
@@ -3350,6 +3365,41 @@ void	zbx_hc_get_diag_stats(zbx_uint64_t *items_num, zbx_uint64_t *values_num)
 	UNLOCK_CACHE;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: add trigger processing statistics of history syncer batch         *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_hc_add_trigger_stats(const zbx_hc_trigger_stats_t *stats)
+{
+	LOCK_CACHE;
+
+	cache->trigger_stats.triggers_num += stats->triggers_num;
+	cache->trigger_stats.deserialized_num += stats->deserialized_num;
+	cache->trigger_stats.cached_num += stats->cached_num;
+	cache->trigger_stats.time += stats->time;
+
+	UNLOCK_CACHE;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get trigger processing statistics                                 *
+ *                                                                            *
+ * Parameters: stats      - [OUT] trigger processing statistics               *
+ *             time_start - [OUT] time when statistics collection started     *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_hc_get_trigger_stats(zbx_hc_trigger_stats_t *stats, double *time_start)
+{
+	LOCK_CACHE;
+
+	*stats = cache->trigger_stats;
+	*time_start = cache->trigger_stats_start;
+
+	UNLOCK_CACHE;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: get shared memory allocator statistics                            *
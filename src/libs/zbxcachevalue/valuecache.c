@@ -180,6 +180,12 @@ typedef struct
 
 	/* the first (oldest) chunk of item history data              */
 	zbx_vc_chunk_t	*tail;
+
+	/* The item history revision, unique across cached items.     */
+	/* Changed when a value is inserted before the newest cached  */
+	/* value, so results calculated from previously returned      */
+	/* values can be detected as outdated.                        */
+	zbx_uint64_t	revision;
 }
 zbx_vc_item_t;
 
@@ -209,6 +215,9 @@ typedef struct
 
 	/* the string pool for str, text and log item values */
 	zbx_hashset_t	strpool;
+
+	/* the last assigned item history revision */
+	zbx_uint64_t	revision;
 }
 zbx_vc_cache_t;
 
@@ -1782,6 +1791,7 @@ static int	vch_item_add_value_at_head(zbx_vc_item_t *item, const zbx_history_rec
 			/* we can't add it to keep cache consistency. Additionally we must make sure no   */
 			/* values with matching timestamp seconds are kept in cache.                      */
 			vch_item_remove_values(item, value->timestamp.sec + 1);
+			item->revision = ++vc_cache->revision;
 
 			/* empty items must be removed to avoid situation when a new value is added to cache */
 			/* while other values with matching timestamp seconds are not cached                 */
@@ -1797,6 +1807,8 @@ static int	vch_item_add_value_at_head(zbx_vc_item_t *item, const zbx_history_rec
 			goto out;
 		}
 
+		item->revision = ++vc_cache->revision;
+
 		sindex = item->head->last_value;
 		schunk = item->head;
 
@@ -1985,7 +1997,8 @@ static int	vch_item_cache_values_by_time(zbx_vc_item_t **item, int range_start)
 
 	if (NULL == (*item = (zbx_vc_item_t *)zbx_hashset_search(&vc_cache->items, &itemid)))
 	{
-		zbx_vc_item_t	new_item = {.itemid = itemid, .value_type = value_type};
+		zbx_vc_item_t	new_item = {.itemid = itemid, .value_type = value_type,
+				.revision = ++vc_cache->revision};
 
 		if (NULL == (*item = (zbx_vc_item_t *)zbx_hashset_insert(&vc_cache->items, &new_item,
 				sizeof(new_item))))
@@ -2098,7 +2111,8 @@ static int	vch_item_cache_values_by_time_and_count(zbx_vc_item_t **item, int ran
 
 	if (NULL == (*item = (zbx_vc_item_t *)zbx_hashset_search(&vc_cache->items, &itemid)))
 	{
-		zbx_vc_item_t	new_item = {.itemid = itemid, .value_type = value_type};
+		zbx_vc_item_t	new_item = {.itemid = itemid, .value_type = value_type,
+				.revision = ++vc_cache->revision};
 
 		if (NULL == (*item = (zbx_vc_item_t *)zbx_hashset_insert(&vc_cache->items, &new_item, sizeof(new_item))))
 		{
@@ -2541,7 +2555,8 @@ int	zbx_vc_add_values(zbx_vector_dc_history_ptr_t *history, int *ret_flush, int
 			zbx_vc_item_t	item_local = {
 					.itemid = h->itemid,
 					.value_type = h->value_type,
-					.last_accessed = (int)time(NULL)
+					.last_accessed = (int)time(NULL),
+					.revision = ++vc_cache->revision
 
 			};
 
@@ -2705,6 +2720,46 @@ out:
 	return ret;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get revision of cached item history                               *
+ *                                                                            *
+ * Parameters: itemid   - [IN] the item id                                    *
+ *             revision - [OUT] the item history revision                     *
+ *                                                                            *
+ * Return Value: SUCCEED - the revision was retrieved                         *
+ *               FAIL    - the item is not cached                             *
+ *                                                                            *
+ * Comments: The revision is changed when values are inserted out of order,   *
+ *           the item is removed from cache and cached again or its value     *
+ *           type is changed. If the revision is not changed, values newer    *
+ *           than the last previously returned value are the only changes in  *
+ *           the item history.                                                *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_vc_get_item_revision(zbx_uint64_t itemid, zbx_uint64_t *revision)
+{
+	zbx_vc_item_t	*item;
+	int		ret = FAIL;
+
+	if (ZBX_VC_DISABLED == vc_state)
+		return FAIL;
+
+	RDLOCK_CACHE;
+
+	if (ZBX_VC_DISABLED != vc_state && ZBX_VC_MODE_NORMAL == vc_cache->mode &&
+			NULL != (item = (zbx_vc_item_t *)zbx_hashset_search(&vc_cache->items, &itemid)) &&
+			0 != item->revision)
+	{
+		*revision = item->revision;
+		ret = SUCCEED;
+	}
+
+	UNLOCK_CACHE;
+
+	return ret;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: retrieves usage cache statistics                                  *
@@ -2912,7 +2967,8 @@ void	zbx_vc_add_new_items(const zbx_vector_uint64_pair_t *items)
 					.itemid = items->values[i].first,
 					.value_type = (unsigned char)items->values[i].second,
 					.status = ZBX_ITEM_STATUS_CACHED_ALL,
-					.last_accessed = (int)time(NULL)
+					.last_accessed = (int)time(NULL),
+					.revision = ++vc_cache->revision
 
 			};
 
@@ -114,12 +114,13 @@ static void	zbx_connector_deserialize_data_point(const unsigned char *data, zbx_
 }
 
 void	zbx_connector_serialize_connector(unsigned char **data, size_t *data_alloc, size_t *data_offset,
-		const zbx_connector_t *connector)
+		zbx_uint64_t taskid, const zbx_connector_t *connector)
 {
 	zbx_uint32_t	data_len = 0, url_len, timeout_len, token_len, http_proxy_len, username_len, password_len,
 			ssl_cert_file_len, ssl_key_file_len, ssl_key_password_len, attempt_interval_len;
 	unsigned char	*ptr;
 
+	zbx_serialize_prepare_value(data_len, taskid);
 	zbx_serialize_prepare_value(data_len, connector->protocol);
 	zbx_serialize_prepare_value(data_len, connector->data_type);
 	zbx_serialize_prepare_str_len(data_len, connector->url, url_len);
@@ -149,6 +150,7 @@ void	zbx_connector_serialize_connector(unsigned char **data, size_t *data_alloc,
 	ptr = *data + *data_offset;
 	*data_offset += data_len;
 
+	ptr += zbx_serialize_value(ptr, taskid);
 	ptr += zbx_serialize_value(ptr, connector->protocol);
 	ptr += zbx_serialize_value(ptr, connector->data_type);
 	ptr += zbx_serialize_str(ptr, connector->url, url_len);
@@ -169,12 +171,14 @@ void	zbx_connector_serialize_connector(unsigned char **data, size_t *data_alloc,
 }
 
 void	zbx_connector_deserialize_connector_and_data_point(const unsigned char *data, zbx_uint32_t size,
-		zbx_connector_t *connector, zbx_vector_connector_data_point_t *connector_data_points)
+		zbx_uint64_t *taskid, zbx_connector_t *connector,
+		zbx_vector_connector_data_point_t *connector_data_points)
 {
 	zbx_uint32_t		url_len, timeout_len, token_len, http_proxy_len, username_len, password_len,
 				ssl_cert_file_len, ssl_key_file_len, ssl_key_password_len, attempt_interval_len;
 	const unsigned char	*start = data;
 
+	data += zbx_deserialize_value(data, taskid);
 	data += zbx_deserialize_value(data, &connector->protocol);
 	data += zbx_deserialize_value(data, &connector->data_type);
 	data += zbx_deserialize_str(data, &connector->url, url_len);
@@ -387,4 +387,46 @@ int	zbx_curl_good_for_elasticsearch(char **error)
 
 	return SUCCEED;
 }
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: enables HTTP/2 multiplexing of requests over shared connections   *
+ *                                                                            *
+ * Comments: This is best effort - HTTP/2 is negotiated with ALPN and         *
+ *           requests fall back to HTTP/1.1 when it is not supported by       *
+ *           either cURL library or remote side.                              *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_curl_setopt_multiplex(CURL *easyhandle)
+{
+	/* CURL_HTTP_VERSION_2TLS was added in 7.47.0 (0x072f00) */
+#if LIBCURL_VERSION_NUM >= 0x072f00
+	if (libcurl_version_num() < 0x072f00)
+		return;
+
+	if (0 == (curl_version_info(CURLVERSION_NOW)->features & CURL_VERSION_HTTP2))
+		return;
+
+	(void)curl_easy_setopt(easyhandle, CURLOPT_HTTP_VERSION, (long)CURL_HTTP_VERSION_2TLS);
+
+	/* wait for connection to be established and check if it can be multiplexed */
+	/* instead of opening new connection for each concurrent request            */
+	(void)curl_easy_setopt(easyhandle, CURLOPT_PIPEWAIT, 1L);
+#else
+	ZBX_UNUSED(easyhandle);
+#endif
+}
+
+void	zbx_curl_multi_setopt_multiplex(CURLM *multi_handle)
+{
+	/* CURLPIPE_MULTIPLEX was added in 7.43.0 (0x072b00) */
+#if LIBCURL_VERSION_NUM >= 0x072b00
+	if (libcurl_version_num() < 0x072b00)
+		return;
+
+	(void)curl_multi_setopt(multi_handle, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+#else
+	ZBX_UNUSED(multi_handle);
+#endif
+}
 #endif /* HAVE_LIBCURL */
@@ -274,6 +274,37 @@ static void	db_get_postgresql_error(char **error, const PGresult *pg_result)
 		zbx_snprintf_alloc(error, &error_alloc, &error_offset, ":%s", result_error_msg);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: logs failed statement result                                      *
+ *                                                                            *
+ * Parameters: db        - [IN] database connection                           *
+ *             pg_result - [IN] failed statement result                       *
+ *             context   - [IN] failed statement                              *
+ *                                                                            *
+ * Return value: ZBX_DB_FAIL (on error) or ZBX_DB_DOWN (on recoverable error) *
+ *                                                                            *
+ ******************************************************************************/
+static int	dbconn_result_errlog(zbx_dbconn_t *db, const PGresult *pg_result, const char *context)
+{
+	zbx_err_codes_t	errcode;
+	char		*error = NULL;
+
+	db_get_postgresql_error(&error, pg_result);
+
+	if (0 == zbx_strcmp_null(PQresultErrorField(pg_result, PG_DIAG_SQLSTATE), ZBX_PG_UNIQUE_VIOLATION))
+		errcode = ERR_Z3008;
+	else if (0 == zbx_strcmp_null(PQresultErrorField(pg_result, PG_DIAG_SQLSTATE), ZBX_PG_READ_ONLY))
+		errcode = ERR_Z3009;
+	else
+		errcode = ERR_Z3005;
+
+	dbconn_errlog(db, errcode, 0, error, context);
+	zbx_free(error);
+
+	return (SUCCEED == dbconn_is_recoverable_error(db, pg_result) ? ZBX_DB_DOWN : ZBX_DB_FAIL);
+}
+
 #endif
 
 /******************************************************************************
@@ -295,6 +326,11 @@ static void	dbconn_close(zbx_dbconn_t *db)
 		PQfinish(db->conn);
 		db->conn = NULL;
 	}
+#	if defined(ZBX_DB_HAVE_PIPELINE)
+	db->pipeline = 0;
+	db->pipeline_queued = 0;
+	db->pipeline_syncs = 0;
+#	endif
 #elif defined(HAVE_SQLITE3)
 	if (NULL != db->conn)
 	{
@@ -718,6 +754,299 @@ int	db_is_escape_sequence(char c)
 	return FAIL;
 }
 
+#if defined(ZBX_DB_HAVE_PIPELINE)
+#define ZBX_DB_PIPELINE_WINDOW	256	/* number of statements queued between synchronization points */
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: reads pipelined statement results up to the oldest pending        *
+ *          synchronization point                                             *
+ *                                                                            *
+ * Return value: ZBX_DB_OK   - all statements were executed successfully      *
+ *               ZBX_DB_FAIL - a statement failed                             *
+ *               ZBX_DB_DOWN - a statement failed with recoverable error or   *
+ *                             the connection was lost                        *
+ *                                                                            *
+ ******************************************************************************/
+static int	dbconn_pipeline_read(zbx_dbconn_t *db)
+{
+	PGresult	*result;
+	int		ret = ZBX_DB_OK, statement = 0, null_num = 0;
+	char		*context;
+
+	while (1)
+	{
+		if (NULL == (result = PQgetResult(db->conn)))
+		{
+			/* results of each statement are terminated by NULL, so two NULLs in a row */
+			/* mean that the synchronization point will not be reached                 */
+			if (0 != null_num++)
+			{
+				dbconn_errlog(db, ERR_Z3005, 0, PQerrorMessage(db->conn), "pipeline synchronization");
+				db->pipeline_syncs = 0;
+
+				return ZBX_DB_DOWN;
+			}
+
+			statement++;
+			continue;
+		}
+
+		null_num = 0;
+
+		switch (PQresultStatus(result))
+		{
+			case PGRES_PIPELINE_SYNC:
+				PQclear(result);
+				db->pipeline_syncs--;
+
+				return ret;
+			case PGRES_COMMAND_OK:
+			case PGRES_TUPLES_OK:
+			case PGRES_PIPELINE_ABORTED:	/* skipped after failure of previous statement */
+				break;
+			default:
+				if (ZBX_DB_OK == ret)
+				{
+					context = zbx_dsprintf(NULL, "pipelined statement #%d", statement + 1);
+					ret = dbconn_result_errlog(db, result, context);
+					zbx_free(context);
+				}
+		}
+
+		PQclear(result);
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: adds synchronization point after queued statements and reads      *
+ *          results up to the previous synchronization point, so database     *
+ *          executes one batch of statements while the next one is queued     *
+ *                                                                            *
+ * Return value: ZBX_DB_OK, ZBX_DB_FAIL or ZBX_DB_DOWN                        *
+ *                                                                            *
+ ******************************************************************************/
+static int	dbconn_pipeline_sync(zbx_dbconn_t *db)
+{
+	int	ret = ZBX_DB_OK, rc;
+
+	if (0 == PQpipelineSync(db->conn))
+	{
+		dbconn_errlog(db, ERR_Z3005, 0, PQerrorMessage(db->conn), "pipeline synchronization");
+		return (CONNECTION_OK == PQstatus(db->conn) ? ZBX_DB_FAIL : ZBX_DB_DOWN);
+	}
+
+	db->pipeline_queued = 0;
+	db->pipeline_syncs++;
+
+	while (1 < db->pipeline_syncs)
+	{
+		if (ZBX_DB_OK != (rc = dbconn_pipeline_read(db)) && ZBX_DB_DOWN != ret)
+			ret = rc;
+	}
+
+	return ret;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: queues statement in pipeline                                      *
+ *                                                                            *
+ * Return value: ZBX_DB_OK, ZBX_DB_FAIL or ZBX_DB_DOWN                        *
+ *                                                                            *
+ * Comments: Errors of previously queued statements can be returned. Queued   *
+ *           statements are lost together with connection, so in this case    *
+ *           the transaction is marked as failed with recoverable error.      *
+ *                                                                            *
+ ******************************************************************************/
+static int	dbconn_pipeline_send(zbx_dbconn_t *db, const char *sql)
+{
+	int	ret = ZBX_DB_OK;
+
+	if (0 == PQsendQueryParams(db->conn, sql, 0, NULL, NULL, NULL, NULL, 0))
+	{
+		dbconn_errlog(db, ERR_Z3005, 0, PQerrorMessage(db->conn), sql);
+		ret = (CONNECTION_OK == PQstatus(db->conn) ? ZBX_DB_FAIL : ZBX_DB_DOWN);
+	}
+	else if (ZBX_DB_PIPELINE_WINDOW <= ++db->pipeline_queued)
+		ret = dbconn_pipeline_sync(db);
+
+	if (ZBX_DB_DOWN == ret)
+		db->txn_error = ZBX_DB_DOWN;
+
+	return ret;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: reads results of all queued statements and leaves pipeline mode   *
+ *                                                                            *
+ * Return value: ZBX_DB_OK, ZBX_DB_FAIL or ZBX_DB_DOWN                        *
+ *                                                                            *
+ ******************************************************************************/
+static int	dbconn_pipeline_end(zbx_dbconn_t *db)
+{
+	int	ret = ZBX_DB_OK, rc;
+
+	if (0 == db->pipeline)
+		return ZBX_DB_OK;
+
+	if (0 != db->pipeline_queued)
+		ret = dbconn_pipeline_sync(db);
+
+	while (0 != db->pipeline_syncs)
+	{
+		if (ZBX_DB_OK != (rc = dbconn_pipeline_read(db)) && ZBX_DB_DOWN != ret)
+			ret = rc;
+	}
+
+	db->pipeline = 0;
+	db->pipeline_queued = 0;
+
+	if (0 == PQexitPipelineMode(db->conn))
+	{
+		/* connection state is unknown, force reconnect */
+		dbconn_errlog(db, ERR_Z3005, 0, PQerrorMessage(db->conn), "pipeline mode exit");
+		dbconn_close(db);
+		ret = ZBX_DB_DOWN;
+	}
+
+	if (ZBX_DB_OK != ret && 0 < db->txn_level)
+		db->txn_error = ret;
+
+	return ret;
+}
+#endif
+
+#if defined(HAVE_POSTGRESQL)
+/******************************************************************************
+ *                                                                            *
+ * Purpose: marks transaction as failed after copy failure                    *
+ *                                                                            *
+ ******************************************************************************/
+static int	dbconn_copy_fail(zbx_dbconn_t *db, int ret)
+{
+	if (0 < db->txn_level)
+	{
+		zabbix_log(LOG_LEVEL_DEBUG, "copy failed, setting transaction as failed");
+		db->txn_error = ret;
+	}
+
+	return ret;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: starts streaming rows to database with COPY FROM STDIN statement  *
+ *                                                                            *
+ * Parameters: db  - [IN] database connection                                 *
+ *             sql - [IN] copy statement                                      *
+ *                                                                            *
+ * Return value: ZBX_DB_OK - database is ready to receive data                *
+ *               ZBX_DB_FAIL (on error) or ZBX_DB_DOWN (on recoverable error) *
+ *                                                                            *
+ ******************************************************************************/
+int	dbconn_copy_begin(zbx_dbconn_t *db, const char *sql)
+{
+	PGresult	*result;
+	int		ret = ZBX_DB_OK;
+
+#if defined(ZBX_DB_HAVE_PIPELINE)
+	(void)dbconn_pipeline_end(db);
+#endif
+	if (ZBX_DB_OK != db->txn_error)
+	{
+		zabbix_log(LOG_LEVEL_DEBUG, "ignoring query [txnlev:%d] [%s] within failed transaction", db->txn_level,
+				sql);
+		return ZBX_DB_FAIL;
+	}
+
+	zabbix_log(LOG_LEVEL_DEBUG, "query [txnlev:%d] [%s]", db->txn_level, sql);
+
+	if (NULL == (result = PQexec(db->conn, sql)))
+	{
+		dbconn_errlog(db, ERR_Z3005, 0, "result is NULL", sql);
+		ret = (CONNECTION_OK == PQstatus(db->conn) ? ZBX_DB_FAIL : ZBX_DB_DOWN);
+	}
+	else
+	{
+		if (PGRES_COPY_IN != PQresultStatus(result))
+			ret = dbconn_result_errlog(db, result, sql);
+
+		PQclear(result);
+	}
+
+	if (ZBX_DB_OK != ret)
+		return dbconn_copy_fail(db, ret);
+
+	return ZBX_DB_OK;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: sends rows in COPY text format                                    *
+ *                                                                            *
+ * Return value: ZBX_DB_OK or ZBX_DB_DOWN                                     *
+ *                                                                            *
+ ******************************************************************************/
+int	dbconn_copy_data(zbx_dbconn_t *db, const char *data, size_t size)
+{
+	if (1 != PQputCopyData(db->conn, data, (int)size))
+	{
+		dbconn_errlog(db, ERR_Z3005, 0, PQerrorMessage(db->conn), "copy data");
+		return ZBX_DB_DOWN;
+	}
+
+	return ZBX_DB_OK;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: finishes or aborts streaming rows started by dbconn_copy_begin()  *
+ *                                                                            *
+ * Parameters: db    - [IN] database connection                               *
+ *             sql   - [IN] copy statement                                    *
+ *             error - [IN] NULL to complete copy or abort reason             *
+ *                                                                            *
+ * Return value: ZBX_DB_OK - all rows were copied                             *
+ *               ZBX_DB_FAIL (on error) or ZBX_DB_DOWN (on recoverable error) *
+ *                                                                            *
+ ******************************************************************************/
+int	dbconn_copy_end(zbx_dbconn_t *db, const char *sql, const char *error)
+{
+	PGresult	*result;
+	int		ret = ZBX_DB_OK;
+
+	if (1 != PQputCopyEnd(db->conn, error))
+	{
+		dbconn_errlog(db, ERR_Z3005, 0, PQerrorMessage(db->conn), sql);
+		return dbconn_copy_fail(db, ZBX_DB_DOWN);
+	}
+
+	while (NULL != (result = PQgetResult(db->conn)))
+	{
+		if (PGRES_COMMAND_OK != PQresultStatus(result) && ZBX_DB_OK == ret)
+		{
+			if (NULL == error)
+				ret = dbconn_result_errlog(db, result, sql);
+			else
+				ret = ZBX_DB_FAIL;
+		}
+
+		PQclear(result);
+	}
+
+	if (ZBX_DB_OK == ret && NULL != error)
+		ret = ZBX_DB_FAIL;
+
+	if (ZBX_DB_OK != ret)
+		return dbconn_copy_fail(db, ret);
+
+	return ZBX_DB_OK;
+}
+#endif
+
 /******************************************************************************
  *                                                                            *
  * Purpose: Execute SQL statement. For non-select statements only.            *
@@ -733,7 +1062,6 @@ static int	dbconn_vexecute(zbx_dbconn_t *db, const char *fmt, va_list args)
 	double		sec = 0;
 #if defined(HAVE_POSTGRESQL)
 	PGresult	*result;
-	char		*error = NULL;
 #elif defined(HAVE_SQLITE3)
 	int		err;
 	char		*error = NULL;
@@ -811,36 +1139,25 @@ static int	dbconn_vexecute(zbx_dbconn_t *db, const char *fmt, va_list args)
 		}
 	}
 #elif defined(HAVE_POSTGRESQL)
-	result = PQexec(db->conn, sql);
-
-	if (NULL == result)
+#	if defined(ZBX_DB_HAVE_PIPELINE)
+	if (0 != db->pipeline)
+		ret = dbconn_pipeline_send(db, sql);
+	else
+#	endif
+	if (NULL == (result = PQexec(db->conn, sql)))
 	{
 		dbconn_errlog(db, ERR_Z3005, 0, "result is NULL", sql);
 		ret = (CONNECTION_OK == PQstatus(db->conn) ? ZBX_DB_FAIL : ZBX_DB_DOWN);
 	}
-	else if (PGRES_COMMAND_OK != PQresultStatus(result))
+	else
 	{
-		zbx_err_codes_t	errcode;
-
-		db_get_postgresql_error(&error, result);
-
-		if (0 == zbx_strcmp_null(PQresultErrorField(result, PG_DIAG_SQLSTATE), ZBX_PG_UNIQUE_VIOLATION))
-			errcode = ERR_Z3008;
-		else if (0 == zbx_strcmp_null(PQresultErrorField(result, PG_DIAG_SQLSTATE), ZBX_PG_READ_ONLY))
-			errcode = ERR_Z3009;
+		if (PGRES_COMMAND_OK != PQresultStatus(result))
+			ret = dbconn_result_errlog(db, result, sql);
 		else
-			errcode = ERR_Z3005;
-
-		dbconn_errlog(db, errcode, 0, error, sql);
-		zbx_free(error);
+			ret = atoi(PQcmdTuples(result));
 
-		ret = (SUCCEED == dbconn_is_recoverable_error(db, result) ? ZBX_DB_DOWN : ZBX_DB_FAIL);
+		PQclear(result);
 	}
-
-	if (ZBX_DB_OK == ret)
-		ret = atoi(PQcmdTuples(result));
-
-	PQclear(result);
 #elif defined(HAVE_SQLITE3)
 	if (0 == db->txn_level)
 		zbx_mutex_lock(*db->sqlite_access);
@@ -979,6 +1296,9 @@ static int	dbconn_commit(zbx_dbconn_t *db)
 		assert(0);
 	}
 
+#if defined(ZBX_DB_HAVE_PIPELINE)
+	(void)dbconn_pipeline_end(db);
+#endif
 	if (ZBX_DB_OK != db->txn_error)
 		return ZBX_DB_FAIL; /* commit called on failed transaction */
 
@@ -1018,6 +1338,9 @@ static int	dbconn_rollback(zbx_dbconn_t *db)
 		assert(0);
 	}
 
+#if defined(ZBX_DB_HAVE_PIPELINE)
+	(void)dbconn_pipeline_end(db);
+#endif
 	last_txn_error = db->txn_error;
 
 	/* allow rollback of failed transaction */
@@ -1065,6 +1388,9 @@ static zbx_db_result_t	dbconn_vselect(zbx_dbconn_t *db, const char *fmt, va_list
 
 	sql = zbx_dvsprintf(sql, fmt, args);
 
+#if defined(ZBX_DB_HAVE_PIPELINE)
+	(void)dbconn_pipeline_end(db);
+#endif
 	if (ZBX_DB_OK != db->txn_error)
 	{
 		zabbix_log(LOG_LEVEL_DEBUG, "ignoring query [txnlev:%d] [%s] within failed transaction", db->txn_level,
@@ -1509,6 +1835,93 @@ int	zbx_dbconn_execute(zbx_dbconn_t *db, const char *fmt, ...)
 	return rc;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: enters pipeline mode                                              *
+ *                                                                            *
+ * Return value: SUCCEED - pipeline mode was entered                          *
+ *               FAIL    - pipelining is not available or pipeline mode is    *
+ *                         already active, statements are executed as usual   *
+ *                                                                            *
+ * Comments: In pipeline mode non-select statements are sent without waiting  *
+ *           for results of the previously sent statements. Each executed SQL *
+ *           must contain single statement, affected row count is not         *
+ *           returned and statement failure can be reported by subsequent     *
+ *           statements or zbx_dbconn_pipeline_end(), failing transaction.    *
+ *           Select, commit and rollback leave pipeline mode automatically.   *
+ *           Pipelining is supported only by PostgreSQL within transaction.   *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_dbconn_pipeline_begin(zbx_dbconn_t *db)
+{
+#if defined(ZBX_DB_HAVE_PIPELINE)
+	if (0 != db->pipeline || 0 == db->txn_level || ZBX_DB_OK != db->txn_error || NULL == db->conn)
+		return FAIL;
+
+	if (0 == PQenterPipelineMode(db->conn))
+	{
+		zabbix_log(LOG_LEVEL_DEBUG, "cannot enter pipeline mode: %s", PQerrorMessage(db->conn));
+		return FAIL;
+	}
+
+	db->pipeline = 1;
+
+	return SUCCEED;
+#else
+	ZBX_UNUSED(db);
+
+	return FAIL;
+#endif
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: waits for results of pipelined statements and leaves pipeline     *
+ *          mode                                                              *
+ *                                                                            *
+ * Return value: ZBX_DB_OK - all pipelined statements were executed           *
+ *               ZBX_DB_FAIL (on error) or ZBX_DB_DOWN (on recoverable error) *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_dbconn_pipeline_end(zbx_dbconn_t *db)
+{
+#if defined(ZBX_DB_HAVE_PIPELINE)
+	return dbconn_pipeline_end(db);
+#else
+	ZBX_UNUSED(db);
+
+	return ZBX_DB_OK;
+#endif
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: executes SQL buffer containing single statement in pipeline mode  *
+ *          or a set of SQL statements IF it is big enough otherwise          *
+ *                                                                            *
+ * Comments: Allows to build statement batches in the same way with and       *
+ *           without pipelining - the remaining statements must be flushed    *
+ *           with zbx_dbconn_flush_overflowed_sql().                          *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_dbconn_pipeline_execute_sql(zbx_dbconn_t *db, char **sql, size_t *sql_alloc, size_t *sql_offset)
+{
+#if defined(ZBX_DB_HAVE_PIPELINE)
+	if (0 != db->pipeline)
+	{
+		int	ret = SUCCEED;
+
+		if (0 != *sql_offset && ZBX_DB_OK > zbx_dbconn_execute(db, "%s", *sql))
+			ret = FAIL;
+
+		*sql_offset = 0;
+
+		return ret;
+	}
+#endif
+	return zbx_dbconn_execute_overflowed_sql(db, sql, sql_alloc, sql_offset);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: execute a select statement                                        *
@@ -2238,7 +2651,7 @@ int	zbx_dbconn_prepare_multiple_query(zbx_dbconn_t *db, const char *query, const
 				MIN(ZBX_MAX_IDS, ids->values_num - i));
 		zbx_strcpy_alloc(sql, sql_alloc, sql_offset, ";\n");
 
-		if (SUCCEED != (ret = zbx_dbconn_execute_overflowed_sql(db, sql, sql_alloc, sql_offset)))
+		if (SUCCEED != (ret = zbx_dbconn_pipeline_execute_sql(db, sql, sql_alloc, sql_offset)))
 			break;
 	}
 
@@ -2258,15 +2671,20 @@ int	zbx_dbconn_execute_multiple_query(zbx_dbconn_t *db, const char *query, const
 {
 	char	*sql = NULL;
 	size_t	sql_alloc = ZBX_KIBIBYTE, sql_offset = 0;
-	int	ret = SUCCEED;
+	int	ret = SUCCEED, pipeline;
 
 	sql = (char *)zbx_malloc(sql, sql_alloc);
 
+	pipeline = zbx_dbconn_pipeline_begin(db);
+
 	ret = zbx_dbconn_prepare_multiple_query(db, query, field_name, ids, &sql, &sql_alloc, &sql_offset);
 
 	if (SUCCEED == ret && ZBX_DB_OK > zbx_dbconn_flush_overflowed_sql(db, sql, sql_offset))
 		ret = FAIL;
 
+	if (SUCCEED == pipeline && ZBX_DB_OK > zbx_dbconn_pipeline_end(db))
+		ret = FAIL;
+
 	zbx_free(sql);
 
 	return ret;
@@ -30,6 +30,9 @@
 #	include "oci.h"
 #elif defined(HAVE_POSTGRESQL)
 #	include <libpq-fe.h>
+#	if defined(LIBPQ_HAS_PIPELINING)
+#		define ZBX_DB_HAVE_PIPELINE
+#	endif
 #elif defined(HAVE_SQLITE3)
 #	include <sqlite3.h>
 #	include <zbxmutexs.h>
@@ -66,6 +69,11 @@ struct zbx_dbconn
 	int			txn_begin;		/* transaction begin statement is executed */
 #elif defined(HAVE_POSTGRESQL)
 	PGconn			*conn;
+#	if defined(ZBX_DB_HAVE_PIPELINE)
+	int			pipeline;		/* pipeline mode is active */
+	int			pipeline_queued;	/* statements queued after the last synchronization point */
+	int			pipeline_syncs;		/* synchronization points with pending results */
+#	endif
 #elif defined(HAVE_SQLITE3)
 	sqlite3			*conn;
 	zbx_mutex_t		*sqlite_access;
@@ -83,5 +91,11 @@ int	db_is_escape_sequence(char c);
 
 zbx_uint32_t	db_get_server_version(void);
 
+#if defined(HAVE_POSTGRESQL)
+int	dbconn_copy_begin(zbx_dbconn_t *db, const char *sql);
+int	dbconn_copy_data(zbx_dbconn_t *db, const char *data, size_t size);
+int	dbconn_copy_end(zbx_dbconn_t *db, const char *sql, const char *error);
+#endif
+
 #endif
 
@@ -18,7 +18,7 @@
 #include "zbxdbschema.h"
 #include "zbxtypes.h"
 
-static zbx_dbconn_t	*dbconn;
+static ZBX_THREAD_LOCAL zbx_dbconn_t	*dbconn;
 static int		db_autoincrement;
 
 void	zbx_db_init_autoincrement_options(void)
@@ -69,6 +69,27 @@ void	zbx_db_close(void)
 	dbconn = NULL;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: change connect options of the database connection                 *
+ *                                                                            *
+ * Parameters: flag - ZBX_DB_CONNECT_ONCE, ZBX_DB_CONNECT_EXIT or             *
+ *                    ZBX_DB_CONNECT_NORMAL                                   *
+ *                                                                            *
+ * Return value: the previous connect options                                 *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_db_set_connect_options(int flag)
+{
+	if (NULL == dbconn)
+	{
+		THIS_SHOULD_NEVER_HAPPEN;
+		return ZBX_DB_CONNECT_NORMAL;
+	}
+
+	return zbx_dbconn_set_connect_options(dbconn, flag);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: start a transaction                                               *
@@ -513,6 +534,55 @@ int	zbx_db_execute_overflowed_sql(char **sql, size_t *sql_alloc, size_t *sql_off
 	return zbx_dbconn_execute_overflowed_sql(dbconn, sql, sql_alloc, sql_offset);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: enter pipeline mode                                               *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_db_pipeline_begin(void)
+{
+	if (NULL == dbconn)
+	{
+		THIS_SHOULD_NEVER_HAPPEN;
+		return FAIL;
+	}
+
+	return zbx_dbconn_pipeline_begin(dbconn);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: wait for pipelined statements and leave pipeline mode             *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_db_pipeline_end(void)
+{
+	if (NULL == dbconn)
+	{
+		THIS_SHOULD_NEVER_HAPPEN;
+		return ZBX_DB_FAIL;
+	}
+
+	return zbx_dbconn_pipeline_end(dbconn);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: execute single SQL statement in pipeline mode or a set of SQL     *
+ *          statements IF it is big enough otherwise                          *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_db_pipeline_execute_sql(char **sql, size_t *sql_alloc, size_t *sql_offset)
+{
+	if (NULL == dbconn)
+	{
+		THIS_SHOULD_NEVER_HAPPEN;
+		return FAIL;
+	}
+
+	return zbx_dbconn_pipeline_execute_sql(dbconn, sql, sql_alloc, sql_offset);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: check if table exists                                             *
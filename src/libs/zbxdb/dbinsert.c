@@ -333,6 +333,223 @@ static void	decode_and_escape_binary_value_for_sql(zbx_dbconn_t *db, char **sql_
 }
 #endif
 
+#if defined(HAVE_POSTGRESQL)
+#define ZBX_DB_COPY_ROWS_MIN	100			/* smaller inserts are not worth extra round trip */
+#define ZBX_DB_COPY_BUFFER_SIZE	(64 * ZBX_KIBIBYTE)
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: checks if rows can be inserted with COPY statement                *
+ *                                                                            *
+ ******************************************************************************/
+static int	db_insert_copy_supported(const zbx_db_insert_t *db_insert)
+{
+	if (ZBX_DB_COPY_ROWS_MIN > db_insert->rows.values_num)
+		return FAIL;
+
+	for (int i = 0; i < db_insert->fields.values_num; i++)
+	{
+		/* upper() function cannot be applied to copied values */
+		if (0 != (db_insert->fields.values[i]->flags & ZBX_UPPER))
+			return FAIL;
+	}
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: appends string value in COPY text format                          *
+ *                                                                            *
+ * Parameters: buf        - [IN/OUT] copy data buffer                         *
+ *             buf_alloc  - [IN/OUT]                                          *
+ *             buf_offset - [IN/OUT]                                          *
+ *             str        - [IN] value escaped for SQL statement              *
+ *                                                                            *
+ * Comments: Values are escaped for SQL when added by doubling escape         *
+ *           sequences, so the doubled characters are skipped here.           *
+ *                                                                            *
+ ******************************************************************************/
+static void	db_copy_str_alloc(char **buf, size_t *buf_alloc, size_t *buf_offset, const char *str)
+{
+	const char	*s = str;
+	size_t		len;
+
+	while ('\0' != *s)
+	{
+		len = strcspn(s, "'\\\n\r\t");
+		zbx_strncpy_alloc(buf, buf_alloc, buf_offset, s, len);
+		s += len;
+
+		switch (*s)
+		{
+			case '\0':
+				return;
+			case '\n':
+				zbx_strcpy_alloc(buf, buf_alloc, buf_offset, "\\n");
+				break;
+			case '\r':
+				zbx_strcpy_alloc(buf, buf_alloc, buf_offset, "\\r");
+				break;
+			case '\t':
+				zbx_strcpy_alloc(buf, buf_alloc, buf_offset, "\\t");
+				break;
+			case '\\':
+				zbx_strcpy_alloc(buf, buf_alloc, buf_offset, "\\\\");
+				break;
+			default:
+				zbx_chrcpy_alloc(buf, buf_alloc, buf_offset, *s);
+		}
+
+		if (SUCCEED == db_is_escape_sequence(*s) && *s == s[1])
+			s++;
+
+		s++;
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: appends base64 encoded binary value in COPY text format           *
+ *                                                                            *
+ ******************************************************************************/
+static void	db_copy_bin_alloc(char **buf, size_t *buf_alloc, size_t *buf_offset, const char *str)
+{
+	size_t	bin_len, bin_alloc = strlen(str) * 3 / 4 + 1, hex_len;
+	char	*bin = (char *)zbx_malloc(NULL, bin_alloc);
+
+	zbx_base64_decode(str, bin, bin_alloc, &bin_len);
+
+	/* bytea hex format with escaped backslash */
+	zbx_strcpy_alloc(buf, buf_alloc, buf_offset, "\\\\x");
+
+	hex_len = bin_len * 2 + 1;
+
+	while (*buf_alloc - *buf_offset < hex_len)
+	{
+		*buf_alloc *= 2;
+		*buf = (char *)zbx_realloc(*buf, *buf_alloc);
+	}
+
+	*buf_offset += (size_t)zbx_bin2hex((const unsigned char *)bin, bin_len, *buf + *buf_offset, hex_len);
+
+	zbx_free(bin);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: inserts rows by streaming them with COPY FROM STDIN statement     *
+ *                                                                            *
+ * Parameters: db_insert - [IN] bulk insert data                              *
+ *                                                                            *
+ * Return value: SUCCEED if the operation completed successfully or           *
+ *               FAIL otherwise.                                              *
+ *                                                                            *
+ * Comments: Copy avoids formatting values into SQL statements and parsing    *
+ *           them back on the database side.                                  *
+ *                                                                            *
+ ******************************************************************************/
+static int	db_insert_copy(zbx_db_insert_t *db_insert)
+{
+	char		*sql = NULL, *buf;
+	size_t		sql_alloc = 0, sql_offset = 0, buf_alloc = ZBX_DB_COPY_BUFFER_SIZE + ZBX_KIBIBYTE,
+			buf_offset = 0;
+	int		ret = SUCCEED;
+	const char	*error = NULL;
+
+	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, "copy %s (", db_insert->table->table);
+
+	for (int i = 0; i < db_insert->fields.values_num; i++)
+	{
+		if (0 != i)
+			zbx_chrcpy_alloc(&sql, &sql_alloc, &sql_offset, ',');
+
+		zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, db_insert->fields.values[i]->name);
+	}
+
+	zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, ") from stdin");
+
+	if (ZBX_DB_OK != dbconn_copy_begin(db_insert->db, sql))
+	{
+		zbx_free(sql);
+		return FAIL;
+	}
+
+	buf = (char *)zbx_malloc(NULL, buf_alloc);
+
+	for (int i = 0; i < db_insert->rows.values_num; i++)
+	{
+		const zbx_db_value_t	*values = db_insert->rows.values[i];
+
+		for (int j = 0; j < db_insert->fields.values_num; j++)
+		{
+			const zbx_db_value_t	*value = &values[j];
+
+			if (0 != j)
+				zbx_chrcpy_alloc(&buf, &buf_alloc, &buf_offset, '\t');
+
+			switch (db_insert->fields.values[j]->type)
+			{
+				case ZBX_TYPE_CHAR:
+				case ZBX_TYPE_TEXT:
+				case ZBX_TYPE_LONGTEXT:
+				case ZBX_TYPE_CUID:
+					db_copy_str_alloc(&buf, &buf_alloc, &buf_offset, value->str);
+					break;
+				case ZBX_TYPE_BLOB:
+					db_copy_bin_alloc(&buf, &buf_alloc, &buf_offset, value->str);
+					break;
+				case ZBX_TYPE_INT:
+					zbx_snprintf_alloc(&buf, &buf_alloc, &buf_offset, "%d", value->i32);
+					break;
+				case ZBX_TYPE_FLOAT:
+					zbx_snprintf_alloc(&buf, &buf_alloc, &buf_offset, ZBX_FS_DBL64_SQL, value->dbl);
+					break;
+				case ZBX_TYPE_UINT:
+					zbx_snprintf_alloc(&buf, &buf_alloc, &buf_offset, ZBX_FS_UI64, value->ui64);
+					break;
+				case ZBX_TYPE_ID:
+					if (0 == value->ui64)
+						zbx_strcpy_alloc(&buf, &buf_alloc, &buf_offset, "\\N");
+					else
+						zbx_snprintf_alloc(&buf, &buf_alloc, &buf_offset, ZBX_FS_UI64, value->ui64);
+					break;
+				default:
+					THIS_SHOULD_NEVER_HAPPEN;
+					exit(EXIT_FAILURE);
+			}
+		}
+
+		zbx_chrcpy_alloc(&buf, &buf_alloc, &buf_offset, '\n');
+
+		if (ZBX_DB_COPY_BUFFER_SIZE <= buf_offset)
+		{
+			if (ZBX_DB_OK != dbconn_copy_data(db_insert->db, buf, buf_offset))
+			{
+				error = "cannot send data";
+				break;
+			}
+
+			buf_offset = 0;
+		}
+	}
+
+	if (NULL == error && 0 != buf_offset && ZBX_DB_OK != dbconn_copy_data(db_insert->db, buf, buf_offset))
+		error = "cannot send data";
+
+	if (ZBX_DB_OK != dbconn_copy_end(db_insert->db, sql, error))
+		ret = FAIL;
+
+	zbx_free(buf);
+	zbx_free(sql);
+
+	return ret;
+}
+
+#undef ZBX_DB_COPY_BUFFER_SIZE
+#undef ZBX_DB_COPY_ROWS_MIN
+#endif
+
 /******************************************************************************
  *                                                                            *
  * Purpose: executes the prepared database bulk insert operation              *
@@ -347,6 +564,8 @@ int	zbx_db_insert_execute(zbx_db_insert_t *db_insert)
 {
 #ifdef HAVE_MULTIROW_INSERT
 #	define ZBX_ROW_DL	","
+/* pipelined inserts are smaller, so database can start executing them while the next ones are built */
+#	define ZBX_PIPELINE_SQL_SIZE	(64 * ZBX_KIBIBYTE)
 #else
 #	define ZBX_ROW_DL	";\n"
 #endif
@@ -360,6 +579,9 @@ int	zbx_db_insert_execute(zbx_db_insert_t *db_insert)
 	char		*sql_values = NULL;
 	size_t		sql_values_alloc = 0, sql_values_offset = 0;
 #endif
+#ifdef HAVE_MULTIROW_INSERT
+	int		pipeline;
+#endif
 
 	if (0 == db_insert->rows.values_num)
 		return SUCCEED;
@@ -388,6 +610,11 @@ int	zbx_db_insert_execute(zbx_db_insert_t *db_insert)
 		db_insert->autoincrement = -1;
 	}
 
+#if defined(HAVE_POSTGRESQL)
+	if (SUCCEED == db_insert_copy_supported(db_insert))
+		return db_insert_copy(db_insert);
+#endif
+
 	sql = (char *)zbx_malloc(NULL, sql_alloc);
 	sql_command = (char *)zbx_malloc(NULL, sql_command_alloc);
 
@@ -429,6 +656,11 @@ int	zbx_db_insert_execute(zbx_db_insert_t *db_insert)
 #endif
 	zbx_strcpy_alloc(&sql_command, &sql_command_alloc, &sql_command_offset, ") values ");
 
+#ifdef HAVE_MULTIROW_INSERT
+	/* each multi-row insert is a single statement and can be queued in pipeline without */
+	/* waiting for the previous one to complete, results are read by pipeline end       */
+	pipeline = zbx_dbconn_pipeline_begin(db_insert->db);
+#endif
 	for (i = 0; i < db_insert->rows.values_num; i++)
 	{
 		zbx_db_value_t	*values = (zbx_db_value_t *)db_insert->rows.values[i];
@@ -501,6 +733,24 @@ int	zbx_db_insert_execute(zbx_db_insert_t *db_insert)
 
 		zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, ")" ZBX_ROW_DL);
 
+#ifdef HAVE_MULTIROW_INSERT
+		if (SUCCEED == pipeline)
+		{
+			if (ZBX_PIPELINE_SQL_SIZE > sql_offset)
+				continue;
+
+			sql_offset--;
+			zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, ";\n");
+
+			if (SUCCEED != (ret = zbx_dbconn_pipeline_execute_sql(db_insert->db, &sql, &sql_alloc,
+					&sql_offset)))
+			{
+				goto out;
+			}
+
+			continue;
+		}
+#endif
 		if (SUCCEED != (ret = zbx_dbconn_execute_overflowed_sql(db_insert->db, &sql, &sql_alloc, &sql_offset)))
 			goto out;
 	}
@@ -515,10 +765,18 @@ int	zbx_db_insert_execute(zbx_db_insert_t *db_insert)
 		}
 #endif
 
+		/* in pipeline mode rows are not flushed until buffer is full, so */
+		/* the result must be set by the last statement as well           */
 		if (ZBX_DB_OK > zbx_dbconn_execute(db_insert->db, "%s", sql))
 			ret = FAIL;
+		else
+			ret = SUCCEED;
 	}
 out:
+#ifdef HAVE_MULTIROW_INSERT
+	if (SUCCEED == pipeline && ZBX_DB_OK > zbx_dbconn_pipeline_end(db_insert->db))
+		ret = FAIL;
+#endif
 	zbx_free(sql_command);
 	zbx_free(sql);
 #ifdef HAVE_MYSQL
@@ -543,6 +543,72 @@ char	*zbx_db_dyn_escape_like_pattern(const char *src)
 	return dst;
 }
 
+static const char	*db_like_next_char(const char *str)
+{
+	/* skip UTF-8 continuation bytes */
+	while (0x80 == (*++str & 0xc0))
+		;
+
+	return str;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: checks if value matches LIKE pattern without escape character     *
+ *                                                                            *
+ * Parameters: value   - [IN] value to check                                  *
+ *             pattern - [IN] pattern where '%' matches any sequence of       *
+ *                            characters and '_' matches single character     *
+ *                                                                            *
+ * Return value: SUCCEED - value matches pattern                              *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ * Comments: Used to evaluate in memory conditions that were evaluated by     *
+ *           database before. The comparison is case sensitive, as LIKE with  *
+ *           the binary collation required for Zabbix database.               *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_db_like_match(const char *value, const char *pattern)
+{
+	const char	*v = value, *p = pattern, *v_wildcard = NULL, *p_wildcard = NULL;
+
+	while ('\0' != *v)
+	{
+		if ('%' == *p)
+		{
+			p_wildcard = ++p;
+			v_wildcard = v;
+			continue;
+		}
+
+		if ('_' == *p)
+		{
+			p++;
+			v = db_like_next_char(v);
+			continue;
+		}
+
+		if ('\0' != *p && *p == *v)
+		{
+			p++;
+			v++;
+			continue;
+		}
+
+		/* extend the sequence matched by the last '%' with the next character and retry */
+		if (NULL == p_wildcard)
+			return FAIL;
+
+		p = p_wildcard;
+		v = v_wildcard = db_like_next_char(v_wildcard);
+	}
+
+	while ('%' == *p)
+		p++;
+
+	return '\0' == *p ? SUCCEED : FAIL;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: return the string length to fit into a database field of the      *
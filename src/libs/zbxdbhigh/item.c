@@ -70,6 +70,6 @@ void	zbx_db_save_item_changes(char **sql, size_t *sql_alloc, size_t *sql_offset,
 
 		zbx_snprintf_alloc(sql, sql_alloc, sql_offset, " where itemid=" ZBX_FS_UI64 ";\n", diff->itemid);
 
-		zbx_db_execute_overflowed_sql(sql, sql_alloc, sql_offset);
+		zbx_db_pipeline_execute_sql(sql, sql_alloc, sql_offset);
 	}
 }
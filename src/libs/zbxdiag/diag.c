@@ -18,6 +18,7 @@
 #include "zbxalgo.h"
 #include "zbxshmem.h"
 #include "zbxcachehistory.h"
+#include "zbxcacheconfig.h"
 #include "zbxconnector.h"
 #include "zbxlog.h"
 #include "zbxmutexs.h"
@@ -32,6 +33,7 @@
 #define ZBX_DIAG_HISTORYCACHE_VALUES		0x00000002
 #define ZBX_DIAG_HISTORYCACHE_MEMORY_DATA	0x00000004
 #define ZBX_DIAG_HISTORYCACHE_MEMORY_INDEX	0x00000008
+#define ZBX_DIAG_HISTORYCACHE_TRIGGERS		0x00000010
 
 #define ZBX_DIAG_HISTORYCACHE_SIMPLE	(ZBX_DIAG_HISTORYCACHE_ITEMS | \
 					ZBX_DIAG_HISTORYCACHE_VALUES)
@@ -260,12 +262,14 @@ int	zbx_diag_add_historycache_info(const struct zbx_json_parse *jp, struct zbx_j
 	zbx_uint64_t			fields;
 	zbx_diag_map_t			field_map[] = {
 							{"", ZBX_DIAG_HISTORYCACHE_SIMPLE |
-								ZBX_DIAG_HISTORYCACHE_MEMORY},
+								ZBX_DIAG_HISTORYCACHE_MEMORY |
+								ZBX_DIAG_HISTORYCACHE_TRIGGERS},
 							{"items", ZBX_DIAG_HISTORYCACHE_ITEMS},
 							{"values", ZBX_DIAG_HISTORYCACHE_VALUES},
 							{"memory", ZBX_DIAG_HISTORYCACHE_MEMORY},
 							{"memory.data", ZBX_DIAG_HISTORYCACHE_MEMORY_DATA},
 							{"memory.index", ZBX_DIAG_HISTORYCACHE_MEMORY_INDEX},
+							{"triggers", ZBX_DIAG_HISTORYCACHE_TRIGGERS},
 							{NULL, 0}
 						};
 
@@ -310,6 +314,31 @@ int	zbx_diag_add_historycache_info(const struct zbx_json_parse *jp, struct zbx_j
 			zbx_json_close(json);
 		}
 
+		if (0 != (fields & ZBX_DIAG_HISTORYCACHE_TRIGGERS))
+		{
+			zbx_hc_trigger_stats_t	stats;
+			double			time_start;
+
+			time1 = zbx_time();
+			zbx_hc_get_trigger_stats(&stats, &time_start);
+			time2 = zbx_time();
+			time_total += time2 - time1;
+
+			/* triggers are processed only by server history syncers */
+			if (0 != stats.triggers_num)
+			{
+				zbx_json_addobject(json, "triggers");
+				zbx_json_adduint64(json, "processed", stats.triggers_num);
+				zbx_json_adduint64(json, "deserialized", stats.deserialized_num);
+				zbx_json_adduint64(json, "cached", stats.cached_num);
+				zbx_json_addfloat(json, "deserialized.rate", (double)stats.deserialized_num /
+						MAX(time2 - time_start, 1.0));
+				zbx_json_addfloat(json, "time", stats.time);
+				zbx_json_addfloat(json, "time.avg", stats.time / (double)stats.triggers_num);
+				zbx_json_close(json);
+			}
+		}
+
 		if (0 != tops.values_num)
 		{
 			zbx_json_addobject(json, "top");
@@ -406,10 +435,16 @@ static void	zbx_json_addhex(struct zbx_json *j, const char *name, zbx_uint64_t v
  *                                                                            *
  * Parameters: json  - [IN/OUT] the json to update                            *
  *                                                                            *
+ * Comments: Configuration cache lock wait time in seconds is reported for    *
+ *           process types that have acquired the lock, together with hits    *
+ *           and misses of user macro resolution cache.                       *
+ *                                                                            *
  ******************************************************************************/
 void	zbx_diag_add_locks_info(struct zbx_json *json)
 {
-	int		i;
+	int			i;
+	zbx_dc_lock_stats_t	lock_stats[ZBX_PROCESS_TYPE_COUNT];
+	zbx_dc_um_memo_stats_t	um_memo_stats[ZBX_PROCESS_TYPE_COUNT];
 #ifdef HAVE_VMINFO_T_UPDATES
 	const char	*names[ZBX_MUTEX_COUNT] = {"ZBX_MUTEX_LOG", "ZBX_MUTEX_CACHE", "ZBX_MUTEX_TRENDS",
 				"ZBX_MUTEX_CACHE_IDS", "ZBX_MUTEX_SELFMON", "ZBX_MUTEX_CPUSTATS", "ZBX_MUTEX_DISKSTATS",
@@ -427,13 +462,24 @@ void	zbx_diag_add_locks_info(struct zbx_json *json)
 #endif
 	zbx_json_addarray(json, ZBX_DIAG_LOCKS);
 
-	for (i = 0; i < ZBX_MUTEX_COUNT; i++)
+	for (i = 0; i < ZBX_MUTEX_CONFIG_QUEUE; i++)
 	{
 		zbx_json_addobject(json, NULL);
 		zbx_json_addhex(json, names[i], (zbx_uint64_t)zbx_mutex_addr_get(i));
 		zbx_json_close(json);
 	}
 
+	for (; i < ZBX_MUTEX_COUNT; i++)
+	{
+		char	name[32];
+
+		zbx_snprintf(name, sizeof(name), "ZBX_MUTEX_CONFIG_QUEUE_%d", i - ZBX_MUTEX_CONFIG_QUEUE);
+
+		zbx_json_addobject(json, NULL);
+		zbx_json_addhex(json, name, (zbx_uint64_t)zbx_mutex_addr_get(i));
+		zbx_json_close(json);
+	}
+
 	zbx_json_addobject(json, NULL);
 	zbx_json_addhex(json, "ZBX_RWLOCK_CONFIG", (zbx_uint64_t)zbx_rwlock_addr_get(ZBX_RWLOCK_CONFIG));
 	zbx_json_close(json);
@@ -446,6 +492,28 @@ void	zbx_diag_add_locks_info(struct zbx_json *json)
 	zbx_json_addhex(json, "ZBX_RWLOCK_VALUECACHE", (zbx_uint64_t)zbx_rwlock_addr_get(ZBX_RWLOCK_VALUECACHE));
 	zbx_json_close(json);
 
+	zbx_dc_config_get_lock_stats(lock_stats);
+	zbx_dc_config_get_um_memo_stats(um_memo_stats);
+
+	for (i = 0; i < ZBX_PROCESS_TYPE_COUNT; i++)
+	{
+		if (0 == lock_stats[i].rdlock_num && 0 == lock_stats[i].wrlock_num && 0 == um_memo_stats[i].hits &&
+				0 == um_memo_stats[i].misses)
+		{
+			continue;
+		}
+
+		zbx_json_addobject(json, NULL);
+		zbx_json_addstring(json, "process", get_process_type_string((unsigned char)i), ZBX_JSON_TYPE_STRING);
+		zbx_json_adduint64(json, "config_rdlocks", lock_stats[i].rdlock_num);
+		zbx_json_addfloat(json, "config_rdlock_wait", lock_stats[i].rdlock_wait);
+		zbx_json_adduint64(json, "config_wrlocks", lock_stats[i].wrlock_num);
+		zbx_json_addfloat(json, "config_wrlock_wait", lock_stats[i].wrlock_wait);
+		zbx_json_adduint64(json, "usermacro_cache_hits", um_memo_stats[i].hits);
+		zbx_json_adduint64(json, "usermacro_cache_misses", um_memo_stats[i].misses);
+		zbx_json_close(json);
+	}
+
 	zbx_json_close(json);
 }
 
@@ -536,7 +604,7 @@ static void	diag_prepare_default_request(struct zbx_json *j, unsigned int flags)
 		diag_add_section_request(j, ZBX_DIAG_VALUECACHE, "values", "request.values", NULL);
 
 	if (0 != (flags & (1 << ZBX_DIAGINFO_PREPROCESSING)))
-		diag_add_section_request(j, ZBX_DIAG_PREPROCESSING, "sequences", NULL);
+		diag_add_section_request(j, ZBX_DIAG_PREPROCESSING, "sequences", "scripts", NULL);
 
 	if (0 != (flags & (1 << ZBX_DIAGINFO_LLD)))
 		diag_add_section_request(j, ZBX_DIAG_LLD, "values", NULL);
@@ -690,7 +758,8 @@ static void	diag_log_top_view(struct zbx_json_parse *jp, const char *field, cons
  ******************************************************************************/
 static void	diag_log_history_cache(struct zbx_json_parse *jp, char **out, size_t *out_alloc, size_t *out_offset)
 {
-	char	*msg = NULL;
+	char			*msg = NULL;
+	struct zbx_json_parse	jp_triggers;
 
 	zbx_strlog_alloc(LOG_LEVEL_INFORMATION, out, out_alloc, out_offset, "== history cache diagnostic information ==");
 
@@ -701,6 +770,13 @@ static void	diag_log_history_cache(struct zbx_json_parse *jp, char **out, size_t
 	diag_log_memory_info(jp, "memory.data", "$.memory.data", out, out_alloc, out_offset);
 	diag_log_memory_info(jp, "memory.index", "$.memory.index", out, out_alloc, out_offset);
 
+	if (SUCCEED == zbx_json_open_path(jp, "$.triggers", &jp_triggers))
+	{
+		diag_get_simple_values(&jp_triggers, &msg);
+		zbx_strlog_alloc(LOG_LEVEL_INFORMATION, out, out_alloc, out_offset, "triggers: %s", msg);
+		zbx_free(msg);
+	}
+
 	diag_log_top_view(jp, "top.values", "$.top.values", out, out_alloc, out_offset);
 
 	zbx_strlog_alloc(LOG_LEVEL_INFORMATION, out, out_alloc, out_offset, "==");
@@ -745,6 +821,7 @@ static void	diag_log_preprocessing(struct zbx_json_parse *jp, char **out, size_t
 	zbx_free(msg);
 
 	diag_log_top_view(jp, "top.sequences", "$.top.sequences", out, out_alloc, out_offset);
+	diag_log_top_view(jp, "top.scripts", "$.top.scripts", out, out_alloc, out_offset);
 
 	zbx_strlog_alloc(LOG_LEVEL_INFORMATION, out, out_alloc, out_offset, "==");
 }
@@ -785,6 +862,7 @@ static void	diag_log_alerting(struct zbx_json_parse *jp, char **out, size_t *out
 	zbx_strlog_alloc(LOG_LEVEL_INFORMATION, out, out_alloc, out_offset, "%s", msg);
 	zbx_free(msg);
 
+	diag_log_top_view(jp, "latency", "$.latency", out, out_alloc, out_offset);
 	diag_log_top_view(jp, "media.alerts", "$.top['media.alerts']", out, out_alloc, out_offset);
 	diag_log_top_view(jp, "source.alerts", "$.top['source.alerts']", out, out_alloc, out_offset);
 
@@ -36,6 +36,14 @@
 #define ZBX_ES_SCRIPT_HEADER	"function(value){"
 #define ZBX_ES_SCRIPT_FOOTER	"\n}"
 
+/* maximum number of loaded functions kept in environment */
+#define ZBX_ES_FUNC_CACHE_MAX	256
+#define ZBX_ES_FUNC_STASH	"\xff""\xff""zbx_funcs"
+#define ZBX_ES_GLOBALS_STASH	"\xff""\xff""zbx_globals"
+
+/* maximum size of free heap blocks kept for reuse */
+#define ZBX_ES_POOL_LIMIT	(ZBX_MEBIBYTE * 8)
+
 typedef struct
 {
 	const void		*heapptr;	/* js object heap ptr */
@@ -44,6 +52,36 @@ typedef struct
 }
 zbx_es_obj_data_t;
 
+typedef struct
+{
+	zbx_hash_t	hash;
+	int		size;
+	char		*code;		/* bytecode the function was loaded from */
+	void		*heapptr;	/* loaded function heap ptr */
+}
+zbx_es_func_t;
+
+static zbx_hash_t	es_func_hash(const void *d)
+{
+	return ((const zbx_es_func_t *)d)->hash;
+}
+
+static int	es_func_compare(const void *d1, const void *d2)
+{
+	const zbx_es_func_t	*f1 = (const zbx_es_func_t *)d1;
+	const zbx_es_func_t	*f2 = (const zbx_es_func_t *)d2;
+
+	ZBX_RETURN_IF_NOT_EQUAL(f1->hash, f2->hash);
+	ZBX_RETURN_IF_NOT_EQUAL(f1->size, f2->size);
+
+	return memcmp(f1->code, f2->code, (size_t)f1->size);
+}
+
+static void	es_func_clean(void *d)
+{
+	zbx_free(((zbx_es_func_t *)d)->code);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: fatal error handler                                               *
@@ -62,12 +100,87 @@ static void	es_handle_error(void *udata, const char *msg)
 
 /*
  * Memory allocation routines to track and limit script memory usage.
+ *
+ * Small blocks freed by Duktape are kept in environment free lists and reused by the next
+ * allocations of the same size class, so repeated script executions do not go through the
+ * system allocator for every object and string they create.
  */
 
+static int	es_pool_class(size_t size)
+{
+	int	index;
+	size_t	block_size = ZBX_ES_POOL_BLOCK_MIN;
+
+	for (index = 0; block_size < size; index++)
+	{
+		if (ZBX_ES_POOL_CLASS_NUM == index + 1)
+			return FAIL;
+
+		block_size <<= 1;
+	}
+
+	return index;
+}
+
+static uint64_t	*es_pool_alloc(zbx_es_env_t *env, int index)
+{
+	uint64_t	*uptr;
+	size_t		block_size = (size_t)ZBX_ES_POOL_BLOCK_MIN << index;
+
+	if (NULL == (uptr = (uint64_t *)env->pool[index]))
+		return (uint64_t *)zbx_malloc(NULL, block_size + 8);
+
+	memcpy(&env->pool[index], uptr + 1, sizeof(void *));
+	env->pool_size -= block_size + 8;
+
+	return uptr;
+}
+
+static void	es_pool_free(zbx_es_env_t *env, uint64_t *uptr)
+{
+	int	index;
+	size_t	block_size;
+
+	if (FAIL == (index = es_pool_class(*uptr)))
+	{
+		zbx_free(uptr);
+		return;
+	}
+
+	block_size = (size_t)ZBX_ES_POOL_BLOCK_MIN << index;
+
+	if (env->pool_size + block_size + 8 > ZBX_ES_POOL_LIMIT)
+	{
+		zbx_free(uptr);
+		return;
+	}
+
+	memcpy(uptr + 1, &env->pool[index], sizeof(void *));
+	env->pool[index] = uptr;
+	env->pool_size += block_size + 8;
+}
+
+static void	es_pool_clear(zbx_es_env_t *env)
+{
+	for (int i = 0; i < ZBX_ES_POOL_CLASS_NUM; i++)
+	{
+		while (NULL != env->pool[i])
+		{
+			void	*block = env->pool[i];
+
+			memcpy(&env->pool[i], (uint64_t *)block + 1, sizeof(void *));
+			zbx_free(block);
+		}
+	}
+
+	env->pool_size = 0;
+}
+
 static void	*es_malloc(void *udata, duk_size_t size)
 {
 	zbx_es_env_t	*env = (zbx_es_env_t *)udata;
 	uint64_t	*uptr;
+	int		index;
 
 	if (env->total_alloc + size + 8 > env->max_total_alloc)
 		env->max_total_alloc = env->total_alloc + size + 8;
@@ -81,7 +194,12 @@ static void	*es_malloc(void *udata, duk_size_t size)
 	}
 
 	env->total_alloc += (size + 8);
-	uptr = zbx_malloc(NULL, size + 8);
+
+	if (FAIL != (index = es_pool_class(size)))
+		uptr = es_pool_alloc(env, index);
+	else
+		uptr = zbx_malloc(NULL, size + 8);
+
 	*uptr++ = size;
 
 	return uptr;
@@ -92,6 +210,7 @@ static void	*es_realloc(void *udata, void *ptr, duk_size_t size)
 	zbx_es_env_t	*env = (zbx_es_env_t *)udata;
 	uint64_t	*uptr = ptr;
 	size_t		old_size;
+	int		index, old_index;
 
 	if (NULL != uptr)
 	{
@@ -113,7 +232,32 @@ static void	*es_realloc(void *udata, void *ptr, duk_size_t size)
 	}
 
 	env->total_alloc += size + 8 - old_size;
-	uptr = zbx_realloc(uptr, size + 8);
+
+	index = es_pool_class(size);
+	old_index = (NULL != uptr ? es_pool_class(*uptr) : FAIL);
+
+	if (FAIL == index && FAIL == old_index)
+	{
+		uptr = zbx_realloc(uptr, size + 8);
+	}
+	else if (index != old_index || NULL == uptr)
+	{
+		uint64_t	*new_uptr;
+
+		if (FAIL != index)
+			new_uptr = es_pool_alloc(env, index);
+		else
+			new_uptr = zbx_malloc(NULL, size + 8);
+
+		if (NULL != uptr)
+		{
+			memcpy(new_uptr + 1, uptr + 1, MIN(size, *uptr));
+			es_pool_free(env, uptr);
+		}
+
+		uptr = new_uptr;
+	}
+
 	*uptr++ = size;
 
 	return uptr;
@@ -127,7 +271,7 @@ static void	es_free(void *udata, void *ptr)
 	if (NULL != ptr)
 	{
 		env->total_alloc -= (*(--uptr) + 8);
-		zbx_free(uptr);
+		es_pool_free(env, uptr);
 	}
 }
 
@@ -381,6 +525,12 @@ int	zbx_es_init_env(zbx_es_t *es, const char *config_source_ip, char **error)
 
 	duk_pop(es->env->ctx);
 
+	/* loaded functions are referenced from stash to keep them alive between executions */
+	duk_push_global_stash(es->env->ctx);
+	duk_push_object(es->env->ctx);
+	duk_put_prop_string(es->env->ctx, -2, ZBX_ES_FUNC_STASH);
+	duk_pop(es->env->ctx);
+
 	/* initialize HttpRequest prototype */
 	if (FAIL == zbx_es_init_httprequest(es, error))
 		goto out;
@@ -391,12 +541,15 @@ int	zbx_es_init_env(zbx_es_t *es, const char *config_source_ip, char **error)
 	es->env->timeout = ZBX_ES_TIMEOUT;
 
 	zbx_hashset_create(&es->env->objmap, 0, ZBX_DEFAULT_PTR_HASH_FUNC, ZBX_DEFAULT_PTR_COMPARE_FUNC);
+	zbx_hashset_create_ext(&es->env->funcs, 0, es_func_hash, es_func_compare, es_func_clean,
+			ZBX_DEFAULT_MEM_MALLOC_FUNC, ZBX_DEFAULT_MEM_REALLOC_FUNC, ZBX_DEFAULT_MEM_FREE_FUNC);
 
 	ret = SUCCEED;
 out:
 	if (SUCCEED != ret)
 	{
 		zbx_es_debug_disable(es);
+		es_pool_clear(es->env);
 		zbx_free(es->env->error);
 		zbx_free(es->env);
 	}
@@ -462,7 +615,9 @@ int	zbx_es_destroy_env(zbx_es_t *es, char **error)
 	}
 
 	duk_destroy_heap(es->env->ctx);
+	es_pool_clear(es->env);
 	es_objmap_destroy(&es->env->objmap);
+	zbx_hashset_destroy(&es->env->funcs);
 
 	zbx_es_debug_disable(es);
 
@@ -598,6 +753,146 @@ out:
 	return ret;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets function loaded from bytecode                                *
+ *                                                                            *
+ * Parameters: env  - [IN] the scripting engine environment                   *
+ *             code - [IN] the precompiled bytecode                           *
+ *             size - [IN] the size of precompiled bytecode                   *
+ *                                                                            *
+ * Return value: heap pointer of the loaded function                          *
+ *                                                                            *
+ * Comments: Loaded functions are cached in environment, so the bytecode is   *
+ *           loaded only once per environment.                                *
+ *                                                                            *
+ ******************************************************************************/
+static void	*es_get_function(zbx_es_env_t *env, const char *code, int size)
+{
+	zbx_es_func_t	func_local, *func;
+	void		*buffer;
+
+	func_local.hash = ZBX_DEFAULT_HASH_ALGO(code, (size_t)size, ZBX_DEFAULT_HASH_SEED);
+	func_local.size = size;
+	func_local.code = (char *)code;
+
+	if (NULL != (func = (zbx_es_func_t *)zbx_hashset_search(&env->funcs, &func_local)))
+		return func->heapptr;
+
+	if (ZBX_ES_FUNC_CACHE_MAX <= env->funcs.num_data)
+	{
+		zabbix_log(LOG_LEVEL_DEBUG, "%s() function cache is full, dropping %d cached functions", __func__,
+				env->funcs.num_data);
+
+		zbx_hashset_clear(&env->funcs);
+
+		duk_push_global_stash(env->ctx);
+		duk_push_object(env->ctx);
+		duk_put_prop_string(env->ctx, -2, ZBX_ES_FUNC_STASH);
+		duk_pop(env->ctx);
+	}
+
+	buffer = duk_push_fixed_buffer(env->ctx, (duk_size_t)size);
+	memcpy(buffer, code, (size_t)size);
+	duk_load_function(env->ctx);					/* [func] */
+
+	duk_push_global_stash(env->ctx);				/* [func,stash] */
+	duk_get_prop_string(env->ctx, -1, ZBX_ES_FUNC_STASH);		/* [func,stash,funcs] */
+	duk_dup(env->ctx, -3);						/* [func,stash,funcs,func] */
+	duk_put_prop_index(env->ctx, -2, (duk_uarridx_t)env->funcs.num_data);	/* [func,stash,funcs] */
+	duk_pop_2(env->ctx);						/* [func] */
+
+	func_local.heapptr = duk_get_heapptr(env->ctx, -1);
+	duk_pop(env->ctx);
+
+	func_local.code = (char *)zbx_malloc(NULL, (size_t)size);
+	memcpy(func_local.code, code, (size_t)size);
+	zbx_hashset_insert(&env->funcs, &func_local, sizeof(func_local));
+
+	return func_local.heapptr;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: saves global object properties of initialized environment         *
+ *                                                                            *
+ * Parameters: env - [IN] the scripting engine environment                    *
+ *                                                                            *
+ * Comments: The properties are saved before the first execution, so objects  *
+ *           added by environment specific initialization (browser) are kept. *
+ *                                                                            *
+ ******************************************************************************/
+static void	es_globals_save(zbx_es_env_t *env)
+{
+	duk_push_global_stash(env->ctx);				/* [stash] */
+	duk_push_object(env->ctx);					/* [stash,saved] */
+	duk_push_global_object(env->ctx);				/* [stash,saved,global] */
+	duk_enum(env->ctx, -1, DUK_ENUM_OWN_PROPERTIES_ONLY | DUK_ENUM_INCLUDE_NONENUMERABLE);
+
+	while (0 != duk_next(env->ctx, -1, 1))				/* [stash,saved,global,enum,key,value] */
+		duk_put_prop(env->ctx, -5);				/* [stash,saved,global,enum] */
+
+	duk_pop_2(env->ctx);						/* [stash,saved] */
+	duk_put_prop_string(env->ctx, -2, ZBX_ES_GLOBALS_STASH);	/* [stash] */
+	duk_pop(env->ctx);
+
+	env->globals_saved = 1;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: resets global object to the saved state                           *
+ *                                                                            *
+ * Comments: Global variables created by script are removed and overwritten   *
+ *           or deleted global properties are restored, so the next script    *
+ *           starts with a clean environment. This function is called with    *
+ *           duk_safe_call() as script can define properties that cannot be   *
+ *           changed.                                                         *
+ *                                                                            *
+ ******************************************************************************/
+static duk_ret_t	es_globals_reset(duk_context *ctx, void *udata)
+{
+	ZBX_UNUSED(udata);
+
+	duk_push_global_object(ctx);					/* [global] */
+	duk_push_global_stash(ctx);					/* [global,stash] */
+	duk_get_prop_string(ctx, -1, ZBX_ES_GLOBALS_STASH);		/* [global,stash,saved] */
+
+	duk_enum(ctx, -3, DUK_ENUM_OWN_PROPERTIES_ONLY);		/* [global,stash,saved,enum] */
+
+	while (0 != duk_next(ctx, -1, 0))				/* [global,stash,saved,enum,key] */
+	{
+		duk_dup(ctx, -1);					/* [global,stash,saved,enum,key,key] */
+
+		if (0 == duk_has_prop(ctx, -4))				/* [global,stash,saved,enum,key] */
+			duk_del_prop(ctx, -5);				/* [global,stash,saved,enum] */
+		else
+			duk_pop(ctx);					/* [global,stash,saved,enum] */
+	}
+
+	duk_pop(ctx);							/* [global,stash,saved] */
+	duk_enum(ctx, -1, DUK_ENUM_OWN_PROPERTIES_ONLY);		/* [global,stash,saved,enum] */
+
+	while (0 != duk_next(ctx, -1, 1))				/* [global,stash,saved,enum,key,value] */
+	{
+		/* [global,stash,saved,enum,key,value,key] -> [global,stash,saved,enum,key,value,current] */
+		duk_dup(ctx, -2);
+		duk_get_prop(ctx, -7);
+
+		if (0 == duk_samevalue(ctx, -1, -2))
+		{
+			duk_pop(ctx);					/* [global,stash,saved,enum,key,value] */
+			duk_put_prop(ctx, -6);				/* [global,stash,saved,enum] */
+		}
+		else
+			duk_pop_3(ctx);					/* [global,stash,saved,enum] */
+	}
+
+	duk_pop_n(ctx, 4);
+
+	return 0;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: executes script                                                   *
@@ -622,12 +917,12 @@ out:
 int	zbx_es_execute(zbx_es_t *es, const char *script, const char *code, int size, const char *param,
 	char **script_ret, char **error)
 {
-	void		*buffer;
 	volatile int	ret = FAIL;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s() param:%s", __func__, param);
 
 	zbx_timespec(&es->env->start_time);
+	es->env->max_total_alloc = es->env->total_alloc;
 	es->env->http_req_objects = 0;
 	es->env->logged_msgs = 0;
 
@@ -651,9 +946,10 @@ int	zbx_es_execute(zbx_es_t *es, const char *script, const char *code, int size,
 		goto out;
 	}
 
-	buffer = duk_push_fixed_buffer(es->env->ctx, size);
-	memcpy(buffer, code, size);
-	duk_load_function(es->env->ctx);
+	if (0 == es->env->globals_saved)
+		es_globals_save(es->env);
+
+	duk_push_heapptr(es->env->ctx, es_get_function(es->env, code, size));
 	duk_push_string(es->env->ctx, param);
 
 	if (DUK_EXEC_SUCCESS != duk_pcall(es->env->ctx, 1))
@@ -745,6 +1041,20 @@ out:
 		zbx_json_adduint64(es->env->json, "ms", zbx_get_duration_ms(&es->env->start_time));
 	}
 
+	if (0 == es->env->fatal_error && 0 != es->env->globals_saved)
+	{
+		/* restart execution timer, so reset is not interrupted after script timeout */
+		zbx_timespec(&es->env->start_time);
+
+		if (DUK_EXEC_SUCCESS != duk_safe_call(es->env->ctx, es_globals_reset, NULL, 0, 1))
+		{
+			zabbix_log(LOG_LEVEL_DEBUG, "%s() cannot reset global object: %s", __func__,
+					duk_safe_to_string(es->env->ctx, -1));
+		}
+
+		duk_pop(es->env->ctx);
+	}
+
 	/* Duktape documentation recommends calling duk_gc() twice, see https://duktape.org/api#duk_gc */
 	duk_gc(es->env->ctx, 0);
 	duk_gc(es->env->ctx, 0);
@@ -754,7 +1064,6 @@ out:
 			__func__, zbx_result_string(ret),
 			ZBX_NULL2EMPTY_STR(*error), (zbx_fs_size_t)es->env->total_alloc,
 			(zbx_fs_size_t)es->env->max_total_alloc, ZBX_ES_MEMORY_LIMIT);
-	es->env->max_total_alloc = 0;
 
 	return ret;
 }
@@ -772,6 +1081,22 @@ void	zbx_es_set_timeout(zbx_es_t *es, int timeout)
 	es->env->timeout = timeout;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets scripting engine heap statistics                             *
+ *                                                                            *
+ * Parameters: es   - [IN] the embedded scripting engine                      *
+ *             used - [OUT] the currently allocated heap memory               *
+ *             peak - [OUT] the maximum heap memory allocated or requested    *
+ *                          during the last script execution                  *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_es_get_heap_stats(const zbx_es_t *es, zbx_uint64_t *used, zbx_uint64_t *peak)
+{
+	*used = (zbx_uint64_t)es->env->total_alloc;
+	*peak = (zbx_uint64_t)es->env->max_total_alloc;
+}
+
 void	zbx_es_debug_enable(zbx_es_t *es)
 {
 	if (NULL == es->env->json)
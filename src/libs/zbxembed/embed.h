@@ -36,6 +36,10 @@
 	}												\
 	while (0)
 
+/* freed heap blocks of up to 2KB are kept in environment by power of two size classes */
+#define ZBX_ES_POOL_BLOCK_MIN	16
+#define ZBX_ES_POOL_CLASS_NUM	8
+
 struct zbx_es_env
 {
 	duk_context	*ctx;
@@ -66,6 +70,15 @@ struct zbx_es_env
 	void		*json_stringify;
 
 	zbx_hashset_t	objmap;
+
+	/* loaded script functions cached by bytecode, referenced from global stash */
+	zbx_hashset_t	funcs;
+
+	/* 1 if global object properties are saved to reset global object after executions */
+	int		globals_saved;
+
+	void		*pool[ZBX_ES_POOL_CLASS_NUM];	/* free heap block lists */
+	size_t		pool_size;			/* size of free heap blocks */
 };
 
 zbx_es_env_t	*zbx_es_get_env(duk_context *ctx);
@@ -3202,9 +3202,403 @@ static void	eval_throw_exception(zbx_vector_var_t *output, char **error)
 	zbx_variant_set_none(arg);
 }
 
+/* the maximum number of tokens in expressions evaluated by numeric path */
+#define ZBX_EVAL_NUMERIC_TOKENS_MAX	64
+
+#define ZBX_EVAL_NUMERIC_DBL	0
+#define ZBX_EVAL_NUMERIC_UI64	1
+#define ZBX_EVAL_NUMERIC_ERR	2
+
+/* numeric value, errors reference token values and are not copied */
+typedef struct
+{
+	union
+	{
+		double		dbl;
+		zbx_uint64_t	ui64;
+		const char	*err;
+	}
+	data;
+	unsigned char	type;
+}
+zbx_eval_numeric_t;
+
+/* numeric instruction - operator token or value to push */
+typedef struct
+{
+	const zbx_eval_token_t	*token;
+	zbx_eval_numeric_t	value;
+}
+zbx_eval_numeric_op_t;
+
+static double	eval_numeric_to_dbl(const zbx_eval_numeric_t *value)
+{
+	return ZBX_EVAL_NUMERIC_UI64 == value->type ? (double)value->data.ui64 : value->data.dbl;
+}
+
 /******************************************************************************
  *                                                                            *
- * Purpose: evaluates pre-parsed expression                                   *
+ * Purpose: compares two numeric values the same way as variants are compared *
+ *                                                                            *
+ ******************************************************************************/
+static int	eval_numeric_compare(const zbx_eval_numeric_t *left, const zbx_eval_numeric_t *right)
+{
+	double	left_dbl, right_dbl;
+
+	if (ZBX_EVAL_NUMERIC_UI64 == left->type && ZBX_EVAL_NUMERIC_UI64 == right->type)
+	{
+		ZBX_RETURN_IF_NOT_EQUAL(left->data.ui64, right->data.ui64);
+		return 0;
+	}
+
+	left_dbl = eval_numeric_to_dbl(left);
+	right_dbl = eval_numeric_to_dbl(right);
+
+	if (SUCCEED == zbx_double_compare(left_dbl, right_dbl))
+		return 0;
+
+	return left_dbl < right_dbl ? -1 : 1;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: lowers operand token into numeric value                           *
+ *                                                                            *
+ * Parameters: ctx   - [IN] evaluation context                                *
+ *             token - [IN] operand token                                     *
+ *             value - [OUT]                                                  *
+ *                                                                            *
+ * Return value: SUCCEED - token has numeric value                            *
+ *               FAIL    - token value must be processed by interpreter       *
+ *                                                                            *
+ ******************************************************************************/
+static int	eval_compile_numeric_operand(const zbx_eval_context_t *ctx, const zbx_eval_token_t *token,
+		zbx_eval_numeric_t *value)
+{
+	zbx_variant_t	value_num;
+
+	switch (token->value.type)
+	{
+		case ZBX_VARIANT_NONE:
+			if (ZBX_EVAL_TOKEN_VAR_NUM != token->type)
+				return FAIL;
+
+			if (SUCCEED == zbx_is_uint64_n(ctx->expression + token->loc.l, token->loc.r - token->loc.l + 1,
+					&value->data.ui64))
+			{
+				value->type = ZBX_EVAL_NUMERIC_UI64;
+				return SUCCEED;
+			}
+
+			value->data.dbl = atof(ctx->expression + token->loc.l) *
+					suffix2factor(ctx->expression[token->loc.r]);
+			value->type = ZBX_EVAL_NUMERIC_DBL;
+			break;
+		case ZBX_VARIANT_UI64:
+			value->data.ui64 = token->value.data.ui64;
+			value->type = ZBX_EVAL_NUMERIC_UI64;
+			return SUCCEED;
+		case ZBX_VARIANT_DBL:
+			value->data.dbl = token->value.data.dbl;
+			value->type = ZBX_EVAL_NUMERIC_DBL;
+			break;
+		case ZBX_VARIANT_ERR:
+			if (0 == (ctx->rules & ZBX_EVAL_PROCESS_ERROR))
+				return FAIL;
+
+			value->data.err = token->value.data.err;
+			value->type = ZBX_EVAL_NUMERIC_ERR;
+			return SUCCEED;
+		case ZBX_VARIANT_STR:
+			if (ZBX_EVAL_TOKEN_VAR_USERMACRO != token->type ||
+					SUCCEED != variant_convert_suffixed_num(&value_num, &token->value))
+			{
+				return FAIL;
+			}
+
+			value->data.dbl = value_num.data.dbl;
+			value->type = ZBX_EVAL_NUMERIC_DBL;
+			break;
+		default:
+			return FAIL;
+	}
+
+	/* leave infinite and NaN values to interpreter variant comparison */
+	if (0 == isfinite(value->data.dbl))
+		return FAIL;
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: lowers expression into numeric instructions if it consists only   *
+ *          of numeric operands and operators                                 *
+ *                                                                            *
+ * Parameters: ctx    - [IN] evaluation context                               *
+ *             ops    - [OUT] numeric instructions                            *
+ *             ops_num - [OUT] number of numeric instructions                 *
+ *                                                                            *
+ * Return value: SUCCEED - expression was lowered                             *
+ *               FAIL    - expression must be evaluated by interpreter        *
+ *                                                                            *
+ * Comments: Expressions with invalid token order and expressions returning   *
+ *           operand value as is are left to interpreter.                     *
+ *                                                                            *
+ ******************************************************************************/
+static int	eval_compile_numeric(const zbx_eval_context_t *ctx, zbx_eval_numeric_op_t *ops, int *ops_num)
+{
+	int	i, depth = 0, last_op = 0;
+
+	if (ZBX_EVAL_NUMERIC_TOKENS_MAX < ctx->stack.values_num)
+		return FAIL;
+
+	*ops_num = 0;
+
+	for (i = 0; i < ctx->stack.values_num; i++)
+	{
+		const zbx_eval_token_t	*token = &ctx->stack.values[i];
+		zbx_eval_numeric_op_t	*op = &ops[*ops_num];
+
+		if (0 != (token->type & ZBX_EVAL_CLASS_OPERATOR1))
+		{
+			if (1 > depth)
+				return FAIL;
+
+			last_op = 1;
+		}
+		else if (0 != (token->type & ZBX_EVAL_CLASS_OPERATOR2))
+		{
+			if (2 > depth--)
+				return FAIL;
+
+			last_op = 1;
+		}
+		else
+		{
+			switch (token->type)
+			{
+				case ZBX_EVAL_TOKEN_NOP:
+					continue;
+				case ZBX_EVAL_TOKEN_VAR_NUM:
+				case ZBX_EVAL_TOKEN_VAR_MACRO:
+				case ZBX_EVAL_TOKEN_VAR_USERMACRO:
+				case ZBX_EVAL_TOKEN_FUNCTIONID:
+					if (SUCCEED != eval_compile_numeric_operand(ctx, token, &op->value))
+						return FAIL;
+					break;
+				default:
+					return FAIL;
+			}
+
+			depth++;
+			last_op = 0;
+		}
+
+		op->token = token;
+		(*ops_num)++;
+	}
+
+	if (1 != depth || 0 == last_op)
+		return FAIL;
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: evaluates logical or/and operator with one numeric operand being  *
+ *          error                                                             *
+ *                                                                            *
+ ******************************************************************************/
+static int	eval_execute_numeric_logic_err(const zbx_eval_token_t *token, const zbx_eval_numeric_t *value,
+		double *result)
+{
+	if (ZBX_EVAL_NUMERIC_ERR == value->type)
+		return FAIL;
+
+	switch (token->type)
+	{
+		case ZBX_EVAL_TOKEN_OP_AND:
+			if (SUCCEED == zbx_double_compare(eval_numeric_to_dbl(value), 0))
+			{
+				*result = 0;
+				return SUCCEED;
+			}
+			break;
+		case ZBX_EVAL_TOKEN_OP_OR:
+			if (SUCCEED != zbx_double_compare(eval_numeric_to_dbl(value), 0))
+			{
+				*result = 1;
+				return SUCCEED;
+			}
+			break;
+	}
+
+	return FAIL;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: evaluates binary operator on numeric values                       *
+ *                                                                            *
+ * Parameters: ctx   - [IN] evaluation context                                *
+ *             token - [IN] operator token                                    *
+ *             left  - [IN/OUT] left operand, replaced by result              *
+ *             right - [IN] right operand                                     *
+ *             error - [OUT] error message in the case of failure             *
+ *                                                                            *
+ * Return value: SUCCEED - operator was evaluated successfully                *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ * Comments: This is eval_execute_op_binary() for numeric operands.           *
+ *                                                                            *
+ ******************************************************************************/
+static int	eval_execute_numeric_binary(const zbx_eval_context_t *ctx, const zbx_eval_token_t *token,
+		zbx_eval_numeric_t *left, const zbx_eval_numeric_t *right, char **error)
+{
+	double	value, left_dbl, right_dbl;
+
+	if (ZBX_EVAL_NUMERIC_ERR == left->type)
+	{
+		if (SUCCEED == eval_execute_numeric_logic_err(token, right, &value))
+			goto finish;
+
+		return SUCCEED;
+	}
+	else if (ZBX_EVAL_NUMERIC_ERR == right->type)
+	{
+		if (SUCCEED == eval_execute_numeric_logic_err(token, left, &value))
+			goto finish;
+
+		*left = *right;
+
+		return SUCCEED;
+	}
+
+	switch (token->type)
+	{
+		case ZBX_EVAL_TOKEN_OP_EQ:
+			value = (0 == eval_numeric_compare(left, right) ? 1 : 0);
+			goto finish;
+		case ZBX_EVAL_TOKEN_OP_NE:
+			value = (0 == eval_numeric_compare(left, right) ? 0 : 1);
+			goto finish;
+	}
+
+	left_dbl = eval_numeric_to_dbl(left);
+	right_dbl = eval_numeric_to_dbl(right);
+
+	switch (token->type)
+	{
+		case ZBX_EVAL_TOKEN_OP_AND:
+			if (SUCCEED == zbx_double_compare(left_dbl, 0) || SUCCEED == zbx_double_compare(right_dbl, 0))
+				value = 0;
+			else
+				value = 1;
+			goto finish;
+		case ZBX_EVAL_TOKEN_OP_OR:
+			if (SUCCEED != zbx_double_compare(left_dbl, 0) || SUCCEED != zbx_double_compare(right_dbl, 0))
+				value = 1;
+			else
+				value = 0;
+			goto finish;
+		case ZBX_EVAL_TOKEN_OP_LT:
+			value = (SUCCEED != zbx_double_compare(left_dbl, right_dbl) && left_dbl < right_dbl ? 1 : 0);
+			break;
+		case ZBX_EVAL_TOKEN_OP_LE:
+			value = (SUCCEED == zbx_double_compare(left_dbl, right_dbl) || left_dbl < right_dbl ? 1 : 0);
+			break;
+		case ZBX_EVAL_TOKEN_OP_GT:
+			value = (SUCCEED != zbx_double_compare(left_dbl, right_dbl) && left_dbl > right_dbl ? 1 : 0);
+			break;
+		case ZBX_EVAL_TOKEN_OP_GE:
+			value = (SUCCEED == zbx_double_compare(left_dbl, right_dbl) || left_dbl > right_dbl ? 1 : 0);
+			break;
+		case ZBX_EVAL_TOKEN_OP_ADD:
+			value = left_dbl + right_dbl;
+			break;
+		case ZBX_EVAL_TOKEN_OP_SUB:
+			value = left_dbl - right_dbl;
+			break;
+		case ZBX_EVAL_TOKEN_OP_MUL:
+			value = left_dbl * right_dbl;
+			break;
+		case ZBX_EVAL_TOKEN_OP_DIV:
+			if (SUCCEED == zbx_double_compare(right_dbl, 0))
+			{
+				*error = zbx_dsprintf(*error, "division by zero at \"%s\"",
+						ctx->expression + token->loc.l);
+				return FAIL;
+			}
+			value = left_dbl / right_dbl;
+			break;
+		default:
+			THIS_SHOULD_NEVER_HAPPEN;
+			*error = zbx_dsprintf(*error, "unknown binary operator at \"%s\"",
+					ctx->expression + token->loc.l);
+			return FAIL;
+	}
+
+	if (FP_ZERO != fpclassify(value) && FP_NORMAL != fpclassify(value))
+	{
+		*error = zbx_dsprintf(*error, "calculation resulted in NaN or Infinity at \"%s\"",
+				ctx->expression + token->loc.l);
+		return FAIL;
+	}
+finish:
+	left->data.dbl = value;
+	left->type = ZBX_EVAL_NUMERIC_DBL;
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: evaluates unary operator on numeric value                         *
+ *                                                                            *
+ * Comments: This is eval_execute_op_unary() for numeric operand.             *
+ *                                                                            *
+ ******************************************************************************/
+static int	eval_execute_numeric_unary(const zbx_eval_context_t *ctx, const zbx_eval_token_t *token,
+		zbx_eval_numeric_t *right, char **error)
+{
+	double	value;
+
+	if (ZBX_EVAL_NUMERIC_ERR == right->type)
+		return SUCCEED;
+
+	switch (token->type)
+	{
+		case ZBX_EVAL_TOKEN_OP_MINUS:
+			value = -eval_numeric_to_dbl(right);
+			break;
+		case ZBX_EVAL_TOKEN_OP_NOT:
+			value = (SUCCEED == zbx_double_compare(eval_numeric_to_dbl(right), 0) ? 1 : 0);
+			break;
+		default:
+			THIS_SHOULD_NEVER_HAPPEN;
+			*error = zbx_dsprintf(*error, "unknown unary operator at \"%s\"",
+					ctx->expression + token->loc.l);
+			return FAIL;
+	}
+
+	if (FP_ZERO != fpclassify(value) && FP_NORMAL != fpclassify(value))
+	{
+		*error = zbx_dsprintf(*error, "calculation resulted in NaN or Infinity at \"%s\"",
+				ctx->expression + token->loc.l);
+		return FAIL;
+	}
+
+	right->data.dbl = value;
+	right->type = ZBX_EVAL_NUMERIC_DBL;
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: evaluates purely numeric expression without variant stack         *
  *                                                                            *
  * Parameters: ctx   - [IN] evaluation context                                *
  *             value - [OUT] resulting value                                  *
@@ -3212,9 +3606,71 @@ static void	eval_throw_exception(zbx_vector_var_t *output, char **error)
  *                                                                            *
  * Return value: SUCCEED - expression was evaluated successfully              *
  *               FAIL    - otherwise                                          *
+ *               UNKNOWN - expression is not numeric and must be evaluated by *
+ *                         interpreter                                        *
+ *                                                                            *
+ * Comments: Most trigger expressions compare numeric function results with   *
+ *           constants. They are lowered into instructions on doubles and     *
+ *           unsigned integers, giving the same results and errors as         *
+ *           eval_execute_tokens().                                           *
  *                                                                            *
  ******************************************************************************/
-static int	eval_execute(const zbx_eval_context_t *ctx, zbx_variant_t *value, char **error)
+static int	eval_execute_numeric(const zbx_eval_context_t *ctx, zbx_variant_t *value, char **error)
+{
+	zbx_eval_numeric_op_t	ops[ZBX_EVAL_NUMERIC_TOKENS_MAX];
+	zbx_eval_numeric_t	output[ZBX_EVAL_NUMERIC_TOKENS_MAX];
+	int			i, ops_num, output_num = 0;
+
+	if (SUCCEED != eval_compile_numeric(ctx, ops, &ops_num))
+		return UNKNOWN;
+
+	for (i = 0; i < ops_num; i++)
+	{
+		const zbx_eval_token_t	*token = ops[i].token;
+
+		if (0 != (token->type & ZBX_EVAL_CLASS_OPERATOR1))
+		{
+			if (SUCCEED != eval_execute_numeric_unary(ctx, token, &output[output_num - 1], error))
+				return FAIL;
+		}
+		else if (0 != (token->type & ZBX_EVAL_CLASS_OPERATOR2))
+		{
+			if (SUCCEED != eval_execute_numeric_binary(ctx, token, &output[output_num - 2],
+					&output[output_num - 1], error))
+			{
+				return FAIL;
+			}
+
+			output_num--;
+		}
+		else
+			output[output_num++] = ops[i].value;
+	}
+
+	if (ZBX_EVAL_NUMERIC_ERR == output[0].type)
+	{
+		*error = zbx_strdup(*error, output[0].data.err);
+		return FAIL;
+	}
+
+	zbx_variant_set_dbl(value, output[0].data.dbl);
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: evaluates pre-parsed expression token by token                    *
+ *                                                                            *
+ * Parameters: ctx   - [IN] evaluation context                                *
+ *             value - [OUT] resulting value                                  *
+ *             error - [OUT] error message in case of failure                 *
+ *                                                                            *
+ * Return value: SUCCEED - expression was evaluated successfully              *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ ******************************************************************************/
+static int	eval_execute_tokens(const zbx_eval_context_t *ctx, zbx_variant_t *value, char **error)
 {
 	zbx_vector_var_t	output;
 	int			i, ret = FAIL;
@@ -3303,6 +3759,37 @@ static int	eval_execute(const zbx_eval_context_t *ctx, zbx_variant_t *value, cha
 
 	ret = SUCCEED;
 out:
+	if (SUCCEED != ret)
+		*error = errmsg;
+
+	for (i = 0; i < output.values_num; i++)
+		zbx_variant_clear(&output.values[i]);
+
+	zbx_vector_var_destroy(&output);
+
+	return ret;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: evaluates pre-parsed expression                                   *
+ *                                                                            *
+ * Parameters: ctx   - [IN] evaluation context                                *
+ *             value - [OUT] resulting value                                  *
+ *             error - [OUT] error message in case of failure                 *
+ *                                                                            *
+ * Return value: SUCCEED - expression was evaluated successfully              *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ ******************************************************************************/
+static int	eval_execute(const zbx_eval_context_t *ctx, zbx_variant_t *value, char **error)
+{
+	int	ret;
+	char	*errmsg = NULL;
+
+	if (UNKNOWN == (ret = eval_execute_numeric(ctx, value, &errmsg)))
+		ret = eval_execute_tokens(ctx, value, &errmsg);
+
 	if (SUCCEED != ret)
 	{
 		if (0 != islower(*errmsg))
@@ -3314,11 +3801,6 @@ out:
 			*error = errmsg;
 	}
 
-	for (i = 0; i < output.values_num; i++)
-		zbx_variant_clear(&output.values[i]);
-
-	zbx_vector_var_destroy(&output);
-
 	return ret;
 }
 
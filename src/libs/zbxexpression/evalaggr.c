@@ -0,0 +1,490 @@
+/*
+** Copyright (C) 2001-2024 Zabbix SIA
+**
+** This program is free software: you can redistribute it and/or modify it under the terms of
+** the GNU Affero General Public License as published by the Free Software Foundation, version 3.
+**
+** This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+** without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+** See the GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License along with this program.
+** If not, see <https://www.gnu.org/licenses/>.
+**/
+
+#include "evalaggr.h"
+
+#include "zbxcachevalue.h"
+#include "zbxalgo.h"
+
+/*
+ * Running aggregates of time based history windows.
+ *
+ * The aggregate state is kept per item, function and window length in process memory. When
+ * the window moves forward only the values that entered and left the window are read from
+ * value cache, so evaluating function over long window of frequently updated item does not
+ * need to process all window values each time.
+ *
+ * The state is calculated again from all window values when:
+ *   - the value cache item history revision changes (values were inserted out of order or
+ *     the item was dropped from value cache),
+ *   - the window moves backwards,
+ *   - the window has moved by its length since the last full calculation, limiting the
+ *     floating point error accumulated by adding and subtracting values.
+ */
+
+/* the period of removing unused aggregate states */
+#define ZBX_AGGR_PURGE_PERIOD	(10 * SEC_PER_MIN)
+
+/* compact min/max candidate vector when this many removed values are at its beginning */
+#define ZBX_AGGR_DEQUE_COMPACT	64
+
+typedef struct
+{
+	zbx_uint64_t			itemid;
+	int				func;
+	int				seconds;
+
+	unsigned char			value_type;
+
+	/* the value cache item history revision, 0 if the state must be calculated again */
+	zbx_uint64_t			revision;
+
+	/* the window end of last evaluation */
+	zbx_timespec_t			end;
+
+	/* all window values with timestamp up to this are included in state */
+	zbx_timespec_t			last;
+
+	/* the window end of last full state calculation */
+	int				built;
+
+	int				lastaccess;
+
+	int				values_num;
+
+	/* the value sum, double for avg() function and for floating point items */
+	zbx_history_value_t		sum;
+
+	/* min() or max() candidate values in ascending timestamp order, starting at deque_first */
+	zbx_vector_history_record_t	deque;
+	int				deque_first;
+}
+zbx_aggr_state_t;
+
+static zbx_hashset_t	aggr_states;
+static int		aggr_last_purge;
+
+static zbx_hash_t	aggr_state_hash_func(const void *data)
+{
+	const zbx_aggr_state_t	*state = (const zbx_aggr_state_t *)data;
+	zbx_hash_t		hash;
+
+	hash = ZBX_DEFAULT_UINT64_HASH_FUNC(&state->itemid);
+	hash = ZBX_DEFAULT_HASH_ALGO(&state->func, sizeof(state->func), hash);
+	hash = ZBX_DEFAULT_HASH_ALGO(&state->seconds, sizeof(state->seconds), hash);
+
+	return hash;
+}
+
+static int	aggr_state_compare_func(const void *d1, const void *d2)
+{
+	const zbx_aggr_state_t	*state1 = (const zbx_aggr_state_t *)d1;
+	const zbx_aggr_state_t	*state2 = (const zbx_aggr_state_t *)d2;
+
+	ZBX_RETURN_IF_NOT_EQUAL(state1->itemid, state2->itemid);
+	ZBX_RETURN_IF_NOT_EQUAL(state1->func, state2->func);
+	ZBX_RETURN_IF_NOT_EQUAL(state1->seconds, state2->seconds);
+
+	return 0;
+}
+
+static int	aggr_state_sum_dbl(const zbx_aggr_state_t *state)
+{
+	return ITEM_VALUE_TYPE_FLOAT == state->value_type || ZBX_AGGR_FUNC_AVG == state->func;
+}
+
+static double	aggr_value_dbl(const zbx_aggr_state_t *state, const zbx_history_record_t *record)
+{
+	return ITEM_VALUE_TYPE_FLOAT == state->value_type ? record->value.dbl : (double)record->value.ui64;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: checks if first value must be removed from min/max candidates     *
+ *          when second value is added                                        *
+ *                                                                            *
+ ******************************************************************************/
+static int	aggr_value_dominates(const zbx_aggr_state_t *state, const zbx_history_record_t *old,
+		const zbx_history_record_t *new)
+{
+	if (ITEM_VALUE_TYPE_FLOAT == state->value_type)
+	{
+		if (ZBX_AGGR_FUNC_MAX == state->func)
+			return old->value.dbl <= new->value.dbl;
+
+		return old->value.dbl >= new->value.dbl;
+	}
+
+	if (ZBX_AGGR_FUNC_MAX == state->func)
+		return old->value.ui64 <= new->value.ui64;
+
+	return old->value.ui64 >= new->value.ui64;
+}
+
+static void	aggr_state_reset(zbx_aggr_state_t *state)
+{
+	state->values_num = 0;
+	memset(&state->sum, 0, sizeof(state->sum));
+	zbx_vector_history_record_clear(&state->deque);
+	state->deque_first = 0;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: adds value entering the window to aggregate state                 *
+ *                                                                            *
+ * Comments: Values must be added in ascending timestamp order.               *
+ *                                                                            *
+ ******************************************************************************/
+static void	aggr_state_add_value(zbx_aggr_state_t *state, const zbx_history_record_t *record)
+{
+	zbx_vector_history_record_t	*deque = &state->deque;
+
+	switch (state->func)
+	{
+		case ZBX_AGGR_FUNC_MIN:
+		case ZBX_AGGR_FUNC_MAX:
+			while (state->deque_first < deque->values_num &&
+					0 != aggr_value_dominates(state, &deque->values[deque->values_num - 1], record))
+			{
+				deque->values_num--;
+			}
+
+			zbx_vector_history_record_append_ptr(deque, (zbx_history_record_t *)record);
+
+			/* min/max state counts only candidates, window has values as long as there are candidates */
+			state->values_num = deque->values_num - state->deque_first;
+			break;
+		default:
+			if (0 != aggr_state_sum_dbl(state))
+				state->sum.dbl += aggr_value_dbl(state, record);
+			else
+				state->sum.ui64 += record->value.ui64;
+
+			state->values_num++;
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: removes value leaving the window from sum and count aggregates    *
+ *                                                                            *
+ ******************************************************************************/
+static void	aggr_state_remove_value(zbx_aggr_state_t *state, const zbx_history_record_t *record)
+{
+	if (0 != aggr_state_sum_dbl(state))
+		state->sum.dbl -= aggr_value_dbl(state, record);
+	else
+		state->sum.ui64 -= record->value.ui64;
+
+	state->values_num--;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: removes min/max candidates leaving the window                     *
+ *                                                                            *
+ * Parameters: state - [IN/OUT]                                               *
+ *             start - [IN] the new window start (exclusive)                  *
+ *                                                                            *
+ ******************************************************************************/
+static void	aggr_state_expire_candidates(zbx_aggr_state_t *state, const zbx_timespec_t *start)
+{
+	zbx_vector_history_record_t	*deque = &state->deque;
+
+	while (state->deque_first < deque->values_num &&
+			0 >= zbx_timespec_compare(&deque->values[state->deque_first].timestamp, start))
+	{
+		state->deque_first++;
+	}
+
+	if (ZBX_AGGR_DEQUE_COMPACT <= state->deque_first)
+	{
+		deque->values_num -= state->deque_first;
+		memmove(deque->values, deque->values + state->deque_first,
+				sizeof(zbx_history_record_t) * (size_t)deque->values_num);
+		state->deque_first = 0;
+	}
+
+	state->values_num = deque->values_num - state->deque_first;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: calculates aggregate state from all window values                 *
+ *                                                                            *
+ * Parameters: state - [IN/OUT]                                               *
+ *             ts    - [IN] the window end                                    *
+ *                                                                            *
+ * Return value: SUCCEED - the state was calculated                           *
+ *               FAIL    - failed to get values from value cache              *
+ *                                                                            *
+ ******************************************************************************/
+static int	aggr_state_build(zbx_aggr_state_t *state, const zbx_timespec_t *ts)
+{
+	zbx_vector_history_record_t	values;
+	int				i, ret = FAIL;
+
+	zbx_history_record_vector_create(&values);
+
+	aggr_state_reset(state);
+
+	if (FAIL == zbx_vc_get_values(state->itemid, state->value_type, &values, state->seconds, 0, ts))
+		goto out;
+
+	for (i = values.values_num - 1; 0 <= i; i--)
+		aggr_state_add_value(state, &values.values[i]);
+
+	if (0 != values.values_num)
+	{
+		state->last = values.values[0].timestamp;
+	}
+	else
+	{
+		state->last.sec = ts->sec - state->seconds;
+		state->last.ns = ts->ns;
+	}
+
+	state->end = *ts;
+	state->built = ts->sec;
+
+	ret = SUCCEED;
+out:
+	zbx_history_record_vector_destroy(&values, state->value_type);
+
+	return ret;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: moves aggregate state window forward                              *
+ *                                                                            *
+ * Parameters: state - [IN/OUT]                                               *
+ *             ts    - [IN] the new window end, not before the current one    *
+ *                                                                            *
+ * Return value: SUCCEED - the state was updated                              *
+ *               FAIL    - failed to get values from value cache              *
+ *                                                                            *
+ * Comments: Reads from value cache values leaving the window (only for sum,  *
+ *           avg and count functions) and values newer than the last value    *
+ *           included in state.                                               *
+ *                                                                            *
+ ******************************************************************************/
+static int	aggr_state_update(zbx_aggr_state_t *state, const zbx_timespec_t *ts)
+{
+	zbx_vector_history_record_t	values;
+	zbx_timespec_t			start, start_new, from;
+	int				i, ret = FAIL;
+
+	zbx_history_record_vector_create(&values);
+
+	start.sec = state->end.sec - state->seconds;
+	start.ns = state->end.ns;
+	start_new.sec = ts->sec - state->seconds;
+	start_new.ns = ts->ns;
+
+	if (ZBX_AGGR_FUNC_MIN == state->func || ZBX_AGGR_FUNC_MAX == state->func)
+	{
+		aggr_state_expire_candidates(state, &start_new);
+	}
+	else
+	{
+		zbx_timespec_t	to;
+
+		/* values included in state and leaving the window are in (start, min(start_new, last)] range */
+		to = (0 > zbx_timespec_compare(&start_new, &state->last) ? start_new : state->last);
+
+		if (0 < zbx_timespec_compare(&to, &start))
+		{
+			if (FAIL == zbx_vc_get_values(state->itemid, state->value_type, &values,
+					to.sec - start.sec + 1, 0, &to))
+			{
+				goto out;
+			}
+
+			for (i = 0; i < values.values_num; i++)
+			{
+				if (0 < zbx_timespec_compare(&values.values[i].timestamp, &start))
+					aggr_state_remove_value(state, &values.values[i]);
+			}
+
+			zbx_history_record_vector_clean(&values, state->value_type);
+		}
+	}
+
+	/* values entering the window are in (max(start_new, last), ts] range */
+	from = (0 < zbx_timespec_compare(&start_new, &state->last) ? start_new : state->last);
+
+	if (0 < zbx_timespec_compare(ts, &from))
+	{
+		if (FAIL == zbx_vc_get_values(state->itemid, state->value_type, &values, ts->sec - from.sec + 1, 0,
+				ts))
+		{
+			goto out;
+		}
+
+		for (i = values.values_num - 1; 0 <= i; i--)
+		{
+			if (0 < zbx_timespec_compare(&values.values[i].timestamp, &from))
+				aggr_state_add_value(state, &values.values[i]);
+		}
+
+		if (0 != values.values_num && 0 < zbx_timespec_compare(&values.values[0].timestamp, &from))
+			from = values.values[0].timestamp;
+	}
+
+	state->last = from;
+	state->end = *ts;
+
+	ret = SUCCEED;
+out:
+	zbx_history_record_vector_destroy(&values, state->value_type);
+
+	return ret;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: removes aggregate states not used during their window length      *
+ *                                                                            *
+ ******************************************************************************/
+static void	aggr_states_purge(int now)
+{
+	zbx_hashset_iter_t	iter;
+	zbx_aggr_state_t	*state;
+
+	zbx_hashset_iter_reset(&aggr_states, &iter);
+	while (NULL != (state = (zbx_aggr_state_t *)zbx_hashset_iter_next(&iter)))
+	{
+		if (state->lastaccess + MAX(state->seconds, ZBX_AGGR_PURGE_PERIOD) >= now)
+			continue;
+
+		zbx_vector_history_record_destroy(&state->deque);
+		zbx_hashset_iter_remove(&iter);
+	}
+
+	aggr_last_purge = now;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets aggregate of time based item history window                  *
+ *                                                                            *
+ * Parameters: itemid     - [IN]                                              *
+ *             value_type - [IN] ITEM_VALUE_TYPE_FLOAT or                     *
+ *                               ITEM_VALUE_TYPE_UINT64                       *
+ *             func       - [IN] ZBX_AGGR_FUNC_* function                     *
+ *             seconds    - [IN] the window length                            *
+ *             ts         - [IN] the window end                               *
+ *             result     - [OUT] sum (value type for sum, double for avg),   *
+ *                                min or max value                            *
+ *             values_num - [OUT] the number of window values, for min and    *
+ *                                max functions only zero is meaningful       *
+ *             error      - [OUT]                                             *
+ *                                                                            *
+ * Return value: SUCCEED - the aggregate was calculated                       *
+ *               FAIL    - failed to get values from value cache              *
+ *                                                                            *
+ ******************************************************************************/
+int	evalaggr_get_value(zbx_uint64_t itemid, unsigned char value_type, int func, int seconds,
+		const zbx_timespec_t *ts, zbx_history_value_t *result, int *values_num, char **error)
+{
+	zbx_aggr_state_t	*state, state_local;
+	zbx_uint64_t		revision, revision_new;
+	int			now, ret = FAIL;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s() itemid:" ZBX_FS_UI64 " func:%d seconds:%d", __func__, itemid, func,
+			seconds);
+
+	if (NULL == aggr_states.slots)
+	{
+		zbx_hashset_create(&aggr_states, 100, aggr_state_hash_func, aggr_state_compare_func);
+		aggr_last_purge = (int)time(NULL);
+	}
+
+	now = (int)time(NULL);
+
+	if (now - aggr_last_purge >= ZBX_AGGR_PURGE_PERIOD)
+		aggr_states_purge(now);
+
+	state_local.itemid = itemid;
+	state_local.func = func;
+	state_local.seconds = seconds;
+
+	if (NULL == (state = (zbx_aggr_state_t *)zbx_hashset_search(&aggr_states, &state_local)))
+	{
+		state = (zbx_aggr_state_t *)zbx_hashset_insert(&aggr_states, &state_local, sizeof(state_local));
+		state->value_type = value_type;
+		state->revision = 0;
+		zbx_vector_history_record_create(&state->deque);
+		aggr_state_reset(state);
+	}
+	else if (state->value_type != value_type)
+	{
+		state->value_type = value_type;
+		state->revision = 0;
+	}
+
+	state->lastaccess = now;
+
+	/* the state can be updated only if item history was not changed since the last calculation, */
+	/* except for new values, and is checked again after reading the changed window values       */
+	if (0 == state->revision || SUCCEED != zbx_vc_get_item_revision(itemid, &revision) ||
+			revision != state->revision || 0 > zbx_timespec_compare(ts, &state->end) ||
+			ts->sec - state->built >= seconds || SUCCEED != aggr_state_update(state, ts) ||
+			SUCCEED != zbx_vc_get_item_revision(itemid, &revision_new) || revision_new != revision)
+	{
+		int	rc;
+
+		rc = zbx_vc_get_item_revision(itemid, &revision);
+
+		if (SUCCEED != aggr_state_build(state, ts))
+		{
+			state->revision = 0;
+			*error = zbx_strdup(*error, "cannot get values from value cache");
+			goto out;
+		}
+
+		if (SUCCEED == rc && SUCCEED == zbx_vc_get_item_revision(itemid, &revision_new) &&
+				revision_new == revision)
+		{
+			state->revision = revision;
+		}
+		else
+			state->revision = 0;
+	}
+
+	*values_num = state->values_num;
+
+	switch (func)
+	{
+		case ZBX_AGGR_FUNC_AVG:
+			if (0 != state->values_num)
+				result->dbl = state->sum.dbl / state->values_num;
+			break;
+		case ZBX_AGGR_FUNC_MIN:
+		case ZBX_AGGR_FUNC_MAX:
+			if (0 != state->values_num)
+				*result = state->deque.values[state->deque_first].value;
+			break;
+		default:
+			*result = state->sum;
+	}
+
+	ret = SUCCEED;
+out:
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s", __func__, zbx_result_string(ret));
+
+	return ret;
+}
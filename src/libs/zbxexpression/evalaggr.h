@@ -0,0 +1,33 @@
+/*
+** Copyright (C) 2001-2024 Zabbix SIA
+**
+** This program is free software: you can redistribute it and/or modify it under the terms of
+** the GNU Affero General Public License as published by the Free Software Foundation, version 3.
+**
+** This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+** without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+** See the GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License along with this program.
+** If not, see <https://www.gnu.org/licenses/>.
+**/
+
+#ifndef ZABBIX_EVALAGGR_H
+#define ZABBIX_EVALAGGR_H
+
+#include "zbxhistory.h"
+
+/* functions supported by running aggregates */
+#define ZBX_AGGR_FUNC_SUM	0
+#define ZBX_AGGR_FUNC_AVG	1
+#define ZBX_AGGR_FUNC_COUNT	2
+#define ZBX_AGGR_FUNC_MIN	3
+#define ZBX_AGGR_FUNC_MAX	4
+
+/* the minimum time based window for which running aggregates are kept */
+#define ZBX_AGGR_PERIOD_MIN	(10 * SEC_PER_MIN)
+
+int	evalaggr_get_value(zbx_uint64_t itemid, unsigned char value_type, int func, int seconds,
+		const zbx_timespec_t *ts, zbx_history_value_t *result, int *values_num, char **error);
+
+#endif
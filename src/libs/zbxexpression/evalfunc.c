@@ -20,6 +20,7 @@
 #include "zbxcachevalue.h"
 #include "zbxtrends.h"
 #include "anomalystl.h"
+#include "evalaggr.h"
 #include "zbxnum.h"
 #include "zbxstr.h"
 #include "zbxexpr.h"
@@ -1110,6 +1111,27 @@ static int	evaluate_COUNT(zbx_variant_t *value, const zbx_dc_evaluate_item_t *it
 			THIS_SHOULD_NEVER_HAPPEN;
 	}
 
+	/* plain count of numeric values over long window can be taken from running aggregate */
+	if (ZBX_AGGR_PERIOD_MIN <= seconds && COUNT_ALL == unique && OP_ANY == pdata.op &&
+			(ITEM_VALUE_TYPE_FLOAT == item->value_type || ITEM_VALUE_TYPE_UINT64 == item->value_type))
+	{
+		zbx_history_value_t	result;
+
+		if (SUCCEED != evalaggr_get_value(item->itemid, item->value_type, ZBX_AGGR_FUNC_COUNT, seconds,
+				&ts_end, &result, &count, error))
+		{
+			goto clean;
+		}
+
+		if (count > limit)
+			count = limit;
+
+		zbx_variant_set_dbl(value, count);
+
+		ret = SUCCEED;
+		goto clean;
+	}
+
 	if (FAIL == zbx_vc_get_values(item->itemid, item->value_type, &values, seconds, nvalues, &ts_end))
 	{
 		*error = zbx_strdup(*error, "cannot get values from value cache");
@@ -1177,6 +1199,39 @@ out:
 	return ret;
 }
 
+/* number of independent accumulators used by aggregate loops, allowing them to be vectorized */
+#define ZBX_AGGR_LANES	4
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: calculates sum of unsigned integer history values                 *
+ *                                                                            *
+ * Parameters: v - [IN] history records                                       *
+ *             n - [IN] number of history records                             *
+ *                                                                            *
+ * Return value: sum of values (with unsigned integer wraparound)             *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_uint64_t	history_sum_ui64(const zbx_history_record_t *v, int n)
+{
+	zbx_uint64_t	sum[ZBX_AGGR_LANES] = {0};
+	int		i, j;
+
+	for (i = 0; i + ZBX_AGGR_LANES <= n; i += ZBX_AGGR_LANES)
+	{
+		for (j = 0; j < ZBX_AGGR_LANES; j++)
+			sum[j] += v[i + j].value.ui64;
+	}
+
+	for (; i < n; i++)
+		sum[0] += v[i].value.ui64;
+
+	for (j = 1; j < ZBX_AGGR_LANES; j++)
+		sum[0] += sum[j];
+
+	return sum[0];
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: evaluate function 'sum' for the item.                             *
@@ -1238,26 +1293,31 @@ static int	evaluate_SUM(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item
 			THIS_SHOULD_NEVER_HAPPEN;
 	}
 
-	if (FAIL == zbx_vc_get_values(item->itemid, item->value_type, &values, seconds, nvalues, &ts_end))
+	if (ZBX_AGGR_PERIOD_MIN <= seconds)
+	{
+		int	values_num;
+
+		if (SUCCEED != evalaggr_get_value(item->itemid, item->value_type, ZBX_AGGR_FUNC_SUM, seconds, &ts_end,
+				&result, &values_num, error))
+		{
+			goto out;
+		}
+	}
+	else if (FAIL == zbx_vc_get_values(item->itemid, item->value_type, &values, seconds, nvalues, &ts_end))
 	{
 		*error = zbx_strdup(*error, "cannot get values from value cache");
 		goto out;
 	}
-
-	if (ITEM_VALUE_TYPE_FLOAT == item->value_type)
+	else if (ITEM_VALUE_TYPE_FLOAT == item->value_type)
 	{
 		result.dbl = 0;
 
+		/* floating point values are summed in history order to keep the result reproducible */
 		for (i = 0; i < values.values_num; i++)
 			result.dbl += values.values[i].value.dbl;
 	}
 	else
-	{
-		result.ui64 = 0;
-
-		for (i = 0; i < values.values_num; i++)
-			result.ui64 += values.values[i].value.ui64;
-	}
+		result.ui64 = history_sum_ui64(values.values, values.values_num);
 
 	zbx_history_value2variant(&result, item->value_type, value);
 	ret = SUCCEED;
@@ -1329,6 +1389,28 @@ static int	evaluate_AVG(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item
 			THIS_SHOULD_NEVER_HAPPEN;
 	}
 
+	if (ZBX_AGGR_PERIOD_MIN <= seconds)
+	{
+		zbx_history_value_t	result;
+		int			values_num;
+
+		if (SUCCEED != evalaggr_get_value(item->itemid, item->value_type, ZBX_AGGR_FUNC_AVG, seconds, &ts_end,
+				&result, &values_num, error))
+		{
+			goto out;
+		}
+
+		if (0 != values_num)
+		{
+			zbx_variant_set_dbl(value, result.dbl);
+			ret = SUCCEED;
+		}
+		else
+			*error = zbx_strdup(*error, "not enough data");
+
+		goto out;
+	}
+
 	if (FAIL == zbx_vc_get_values(item->itemid, item->value_type, &values, seconds, nvalues, &ts_end))
 	{
 		*error = zbx_strdup(*error, "cannot get values from value cache");
@@ -1405,15 +1487,39 @@ static int	evaluate_LAST(zbx_variant_t *value, const zbx_dc_evaluate_item_t *ite
 #define EVALUATE_MIN	0
 #define EVALUATE_MAX	1
 
-#define LOOP_FIND_MIN_OR_MAX(type, mode_op)							\
-	do											\
-	{											\
-		for (i = 1; i < values.values_num; i++)							\
-		{											\
-			if (values.values[i].value.type mode_op values.values[index].value.type)	\
-				index = i;								\
-		}											\
-	}												\
+/* finds minimum or maximum value, comparing each of ZBX_AGGR_LANES interleaved value subsets separately */
+#define LOOP_FIND_MIN_OR_MAX(ctype, type, mode_op, result)							\
+	do													\
+	{													\
+		ctype	lane[ZBX_AGGR_LANES];									\
+		int	j;											\
+														\
+		for (j = 0; j < ZBX_AGGR_LANES; j++)								\
+			lane[j] = values.values[0].value.type;							\
+														\
+		for (i = 1; i + ZBX_AGGR_LANES <= values.values_num; i += ZBX_AGGR_LANES)			\
+		{												\
+			for (j = 0; j < ZBX_AGGR_LANES; j++)							\
+			{											\
+				if (values.values[i + j].value.type mode_op lane[j])				\
+					lane[j] = values.values[i + j].value.type;				\
+			}											\
+		}												\
+														\
+		for (; i < values.values_num; i++)								\
+		{												\
+			if (values.values[i].value.type mode_op lane[0])					\
+				lane[0] = values.values[i].value.type;						\
+		}												\
+														\
+		result = lane[0];										\
+														\
+		for (j = 1; j < ZBX_AGGR_LANES; j++)								\
+		{												\
+			if (lane[j] mode_op result)								\
+				result = lane[j];								\
+		}												\
+	}													\
 	while(0)
 
 /******************************************************************************
@@ -1477,6 +1583,29 @@ static int	evaluate_MIN_or_MAX(zbx_variant_t *value, const zbx_dc_evaluate_item_
 			THIS_SHOULD_NEVER_HAPPEN;
 	}
 
+	if (ZBX_AGGR_PERIOD_MIN <= seconds)
+	{
+		zbx_history_value_t	result;
+		int			values_num;
+
+		if (SUCCEED != evalaggr_get_value(item->itemid, item->value_type,
+				EVALUATE_MIN == min_or_max ? ZBX_AGGR_FUNC_MIN : ZBX_AGGR_FUNC_MAX, seconds, &ts_end,
+				&result, &values_num, error))
+		{
+			goto out;
+		}
+
+		if (0 != values_num)
+		{
+			zbx_history_value2variant(&result, item->value_type, value);
+			ret = SUCCEED;
+		}
+		else
+			*error = zbx_strdup(*error, "not enough data");
+
+		goto out;
+	}
+
 	if (FAIL == zbx_vc_get_values(item->itemid, item->value_type, &values, seconds, nvalues, &ts_end))
 	{
 		*error = zbx_strdup(*error, "cannot get values from value cache");
@@ -1485,32 +1614,32 @@ static int	evaluate_MIN_or_MAX(zbx_variant_t *value, const zbx_dc_evaluate_item_
 
 	if (0 < values.values_num)
 	{
-		int	index = 0;
+		zbx_history_value_t	result;
 
 		if (ITEM_VALUE_TYPE_UINT64 == item->value_type)
 		{
 			if (EVALUATE_MIN == min_or_max)
 			{
-				LOOP_FIND_MIN_OR_MAX(ui64, <);
+				LOOP_FIND_MIN_OR_MAX(zbx_uint64_t, ui64, <, result.ui64);
 			}
 			else
 			{
-				LOOP_FIND_MIN_OR_MAX(ui64, >);
+				LOOP_FIND_MIN_OR_MAX(zbx_uint64_t, ui64, >, result.ui64);
 			}
 		}
 		else
 		{
 			if (EVALUATE_MIN == min_or_max)
 			{
-				LOOP_FIND_MIN_OR_MAX(dbl, <);
+				LOOP_FIND_MIN_OR_MAX(double, dbl, <, result.dbl);
 			}
 			else
 			{
-				LOOP_FIND_MIN_OR_MAX(dbl, >);
+				LOOP_FIND_MIN_OR_MAX(double, dbl, >, result.dbl);
 			}
 		}
 
-		zbx_history_value2variant(&values.values[index].value, item->value_type, value);
+		zbx_history_value2variant(&result, item->value_type, value);
 		ret = SUCCEED;
 	}
 	else
@@ -1526,6 +1655,110 @@ out:
 	return ret;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: extracts numeric history values into contiguous value vector      *
+ *                                                                            *
+ * Parameters: v          - [IN] history records                              *
+ *             n          - [IN] number of history records                    *
+ *             value_type - [IN] ITEM_VALUE_TYPE_FLOAT or                     *
+ *                               ITEM_VALUE_TYPE_UINT64                       *
+ *             values     - [OUT] extracted values                            *
+ *                                                                            *
+ ******************************************************************************/
+static void	history_to_dbl_vector(const zbx_history_record_t *v, int n, unsigned char value_type,
+		zbx_vector_dbl_t *values)
+{
+	int	i;
+	double	*out;
+
+	zbx_vector_dbl_reserve(values, (size_t)(values->values_num + n));
+	out = values->values + values->values_num;
+
+	if (ITEM_VALUE_TYPE_FLOAT == value_type)
+	{
+		for (i = 0; i < n; i++)
+			out[i] = v[i].value.dbl;
+	}
+	else
+	{
+		for (i = 0; i < n; i++)
+			out[i] = (double)v[i].value.ui64;
+	}
+
+	values->values_num += n;
+}
+
+static void	history_to_uint64_vector(const zbx_history_record_t *v, int n, zbx_vector_uint64_t *values)
+{
+	int		i;
+	zbx_uint64_t	*out;
+
+	zbx_vector_uint64_reserve(values, (size_t)(values->values_num + n));
+	out = values->values + values->values_num;
+
+	for (i = 0; i < n; i++)
+		out[i] = v[i].value.ui64;
+
+	values->values_num += n;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: finds k-th smallest value without sorting all values              *
+ *                                                                            *
+ * Parameters: v - [IN/OUT] values, reordered during search                   *
+ *             n - [IN] number of values                                      *
+ *             k - [IN] zero based index of value in sorted order             *
+ *                                                                            *
+ * Return value: value that would be at index k if values were sorted.        *
+ *                                                                            *
+ * Comments: Hoare's selection algorithm, with average linear complexity.     *
+ *                                                                            *
+ ******************************************************************************/
+#define VALUE_SELECT_IMPL(__id, __type)										\
+														\
+static __type	__id##_select(__type *v, int n, int k)								\
+{														\
+	int	left = 0, right = n - 1;									\
+														\
+	while (left < right)											\
+	{													\
+		__type	pivot = v[left + (right - left) / 2], tmp;						\
+		int	i = left, j = right;									\
+														\
+		while (i <= j)											\
+		{												\
+			while (v[i] < pivot)									\
+				i++;										\
+														\
+			while (v[j] > pivot)									\
+				j--;										\
+														\
+			if (i <= j)										\
+			{											\
+				tmp = v[i];									\
+				v[i++] = v[j];									\
+				v[j--] = tmp;									\
+			}											\
+		}												\
+														\
+		if (k <= j)											\
+			right = j;										\
+		else if (k >= i)										\
+			left = i;										\
+		else												\
+			break;											\
+	}													\
+														\
+	return v[k];												\
+}
+
+VALUE_SELECT_IMPL(dbl, double)
+VALUE_SELECT_IMPL(uint64, zbx_uint64_t)
+
+#undef VALUE_SELECT_IMPL
+
 /******************************************************************************
  *                                                                            *
  * Purpose: evaluate function 'percentile' for the item.                      *
@@ -1603,19 +1836,34 @@ static int	evaluate_PERCENTILE(zbx_variant_t  *value, const zbx_dc_evaluate_item
 
 	if (0 < values.values_num)
 	{
-		int	index;
-
-		if (ITEM_VALUE_TYPE_FLOAT == item->value_type)
-			zbx_vector_history_record_sort(&values, (zbx_compare_func_t)zbx_history_record_float_compare);
-		else
-			zbx_vector_history_record_sort(&values, (zbx_compare_func_t)history_record_uint64_compare);
+		int			index;
+		zbx_history_value_t	result;
 
 		if (0 == percentage)
 			index = 1;
 		else
 			index = (int)ceil(values.values_num * (percentage / 100));
 
-		zbx_history_value2variant(&values.values[index - 1].value, item->value_type, value);
+		if (ITEM_VALUE_TYPE_FLOAT == item->value_type)
+		{
+			zbx_vector_dbl_t	values_dbl;
+
+			zbx_vector_dbl_create(&values_dbl);
+			history_to_dbl_vector(values.values, values.values_num, item->value_type, &values_dbl);
+			result.dbl = dbl_select(values_dbl.values, values_dbl.values_num, index - 1);
+			zbx_vector_dbl_destroy(&values_dbl);
+		}
+		else
+		{
+			zbx_vector_uint64_t	values_ui64;
+
+			zbx_vector_uint64_create(&values_ui64);
+			history_to_uint64_vector(values.values, values.values_num, &values_ui64);
+			result.ui64 = uint64_select(values_ui64.values, values_ui64.values_num, index - 1);
+			zbx_vector_uint64_destroy(&values_ui64);
+		}
+
+		zbx_history_value2variant(&result, item->value_type, value);
 
 		ret = SUCCEED;
 	}
@@ -3334,25 +3582,6 @@ out:
 	return ret;
 }
 
-static void	history_to_dbl_vector(const zbx_history_record_t *v, int n, unsigned char value_type,
-		zbx_vector_dbl_t *values)
-{
-	int	i;
-
-	zbx_vector_dbl_reserve(values, (size_t)n);
-
-	if (ITEM_VALUE_TYPE_FLOAT == value_type)
-	{
-		for (i = 0; i < n; i++)
-			zbx_vector_dbl_append(values, v[i].value.dbl);
-	}
-	else
-	{
-		for (i = 0; i < n; i++)
-			zbx_vector_dbl_append(values, (double)v[i].value.ui64);
-	}
-}
-
 /******************************************************************************
  *                                                                            *
  * Purpose: common operations for aggregate function calculation.             *
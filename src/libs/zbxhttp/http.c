@@ -567,50 +567,66 @@ static void	http_output_json(unsigned char retrieve_mode, char **buffer, zbx_htt
 	zbx_json_free(&json);
 }
 
-CURLcode	zbx_http_request_sync_perform(CURL *easyhandle, zbx_http_context_t *context, int attempt_interval,
+/******************************************************************************
+ *                                                                            *
+ * Purpose: checks result of a single request attempt                         *
+ *                                                                            *
+ * Parameters: easyhandle          - [IN] cURL handle of the performed request*
+ *             context             - [IN/OUT] HTTP request context            *
+ *             err                 - [IN/OUT] cURL result of the attempt      *
+ *             check_response_code - [IN] ZBX_HTTP_CHECK_RESPONSE_CODE to     *
+ *                                        retry on unexpected response codes  *
+ *                                                                            *
+ * Return value: SUCCEED - the attempt is final                               *
+ *               FAIL    - the request must be repeated if there are          *
+ *                         attempts left, response buffers were reset         *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_http_request_check_attempt(CURL *easyhandle, zbx_http_context_t *context, CURLcode *err,
 		int check_response_code)
 {
-	CURLcode	err;
 	char	status_codes[] = "200,201,202,203,204,400,401,403,404,405,415,422";
 	long	response_code;
 
-	/* try to retrieve page several times depending on number of retries */
-	do
+	if (CURLE_OK == *err)
 	{
-		*context->errbuf = '\0';
+		if (ZBX_HTTP_CHECK_RESPONSE_CODE != check_response_code)
+			return SUCCEED;
 
-		if (CURLE_OK == (err = curl_easy_perform(easyhandle)))
+		if (CURLE_OK != (*err = curl_easy_getinfo(easyhandle, CURLINFO_RESPONSE_CODE, &response_code)))
 		{
-			if (ZBX_HTTP_CHECK_RESPONSE_CODE == check_response_code)
-			{
-				if (CURLE_OK != (err = curl_easy_getinfo(easyhandle, CURLINFO_RESPONSE_CODE,
-						&response_code)))
-				{
-					zabbix_log(LOG_LEVEL_INFORMATION, "cannot get the response code: %s",
-							curl_easy_strerror(err));
+			zabbix_log(LOG_LEVEL_INFORMATION, "cannot get the response code: %s",
+					curl_easy_strerror(*err));
+		}
+		else if (SUCCEED == zbx_int_in_list(status_codes, (int)response_code))
+			return SUCCEED;
+	}
+	else if (1 != context->max_attempts)
+	{
+		zabbix_log(LOG_LEVEL_INFORMATION, "cannot perform request: %s",
+				'\0' == *context->errbuf ? curl_easy_strerror(*err) : context->errbuf);
+	}
 
-					goto next_attempt;
-				}
-				else if (FAIL == zbx_int_in_list(status_codes, (int)response_code))
-					goto next_attempt;
+	context->header.offset = 0;
+	context->body.offset = 0;
 
-				return err;
-			}
+	return FAIL;
+}
 
-			return err;
-		}
-		else
-		{
-			if (1 != context->max_attempts)
-			{
-				zabbix_log(LOG_LEVEL_INFORMATION, "cannot perform request: %s",
-						'\0' == *context->errbuf ? curl_easy_strerror(err) : context->errbuf);
-			}
-		}
+CURLcode	zbx_http_request_sync_perform(CURL *easyhandle, zbx_http_context_t *context, int attempt_interval,
+		int check_response_code)
+{
+	CURLcode	err;
+
+	/* try to retrieve page several times depending on number of retries */
+	do
+	{
+		*context->errbuf = '\0';
 
-next_attempt:
-		context->header.offset = 0;
-		context->body.offset = 0;
+		err = curl_easy_perform(easyhandle);
+
+		if (SUCCEED == zbx_http_request_check_attempt(easyhandle, context, &err, check_response_code))
+			return err;
 
 		if (0 != attempt_interval && 1 < context->max_attempts)
 			zbx_sleep((unsigned int)attempt_interval);
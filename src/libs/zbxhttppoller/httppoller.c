@@ -42,6 +42,10 @@ ZBX_THREAD_ENTRY(zbx_httppoller_thread, args)
 
 	const zbx_thread_httppoller_args	*httppoller_args_in = (const zbx_thread_httppoller_args *)
 						(((zbx_thread_args_t *)args)->args);
+#if defined(HAVE_LIBCURL) && defined(HAVE_LIBEVENT)
+	zbx_httptest_async_t			httptest_async;
+	char					*error = NULL;
+#endif
 
 	zabbix_log(LOG_LEVEL_INFORMATION, "%s #%d started [%s #%d]", get_program_type_string(info->program_type),
 			server_num, get_process_type_string(process_type), process_num);
@@ -56,6 +60,19 @@ ZBX_THREAD_ENTRY(zbx_httppoller_thread, args)
 
 	zbx_db_connect(ZBX_DB_CONNECT_NORMAL);
 
+#if defined(HAVE_LIBCURL) && defined(HAVE_LIBEVENT)
+	zbx_async_httpagent_init();
+
+	if (SUCCEED != httptest_async_init(&httptest_async, httppoller_args_in->config_source_ip,
+			httppoller_args_in->config_ssl_ca_location, httppoller_args_in->config_ssl_cert_location,
+			httppoller_args_in->config_ssl_key_location, &error))
+	{
+		zabbix_log(LOG_LEVEL_ERR, "cannot initialize asynchronous web scenario processing: %s", error);
+		zbx_free(error);
+		exit(EXIT_FAILURE);
+	}
+#endif
+
 	while (ZBX_IS_RUNNING())
 	{
 		double	sec = zbx_time();
@@ -73,10 +90,14 @@ ZBX_THREAD_ENTRY(zbx_httppoller_thread, args)
 		{
 			time_t	now;
 
+#if defined(HAVE_LIBCURL) && defined(HAVE_LIBEVENT)
+			httptests_count += process_httptests_async(&httptest_async, (int)sec, &nextcheck);
+#else
 			httptests_count += process_httptests((int)sec, httppoller_args_in->config_source_ip,
 					httppoller_args_in->config_ssl_ca_location,
 					httppoller_args_in->config_ssl_cert_location,
 					httppoller_args_in->config_ssl_key_location, &nextcheck);
+#endif
 			total_sec += zbx_time() - sec;
 
 			now = time(NULL);
@@ -111,6 +132,9 @@ ZBX_THREAD_ENTRY(zbx_httppoller_thread, args)
 		zbx_sleep_loop(info, sleeptime);
 	}
 
+#if defined(HAVE_LIBCURL) && defined(HAVE_LIBEVENT)
+	httptest_async_destroy(&httptest_async);
+#endif
 	zbx_setproctitle("%s #%d [terminated]", get_process_type_string(process_type), process_num);
 
 	while (1)
@@ -670,32 +670,63 @@ out:
 	return ret;
 }
 
+/* web scenario step as loaded from database */
+typedef struct
+{
+	zbx_uint64_t	httpstepid;
+	char		*name;
+	char		*url;
+	char		*timeout;
+	char		*posts;
+	char		*required;
+	char		*status_codes;
+	int		no;
+	int		post_type;
+	int		follow_redirects;
+	int		retrieve_mode;
+}
+zbx_httpstep_row_t;
+
+ZBX_VECTOR_DECL(httpstep_row, zbx_httpstep_row_t)
+ZBX_VECTOR_IMPL(httpstep_row, zbx_httpstep_row_t)
+
+/* web scenario execution state, kept between the steps so that the scenario */
+/* can be suspended while waiting for the step response                      */
+typedef struct
+{
+	zbx_dc_host_t			host;
+	zbx_httptest_t			httptest;
+	zbx_vector_httpstep_row_t	steps;
+	int				step_index;
+	int				delay;
+	int				lastfailedstep;
+	int				speed_download_num;
+	double				speed_download;
+	char				*err_str;
+	zbx_db_httpstep			db_httpstep;
+#ifdef HAVE_LIBCURL
+	zbx_httpstep_t			httpstep;
+	zbx_httpstat_t			stat;
+	struct curl_slist		*headers_slist;
+	zbx_http_response_t		body;
+	zbx_http_response_t		header;
+	char				errbuf[CURL_ERROR_SIZE];
+	CURL				*easyhandle;
+#endif
+}
+zbx_httptest_session_t;
+
 /******************************************************************************
  *                                                                            *
- * Purpose: processes single scenario of HTTP test                            *
+ * Purpose: loads web scenario steps                                          *
+ *                                                                            *
+ * Parameters: session - [IN/OUT] web scenario execution state                *
  *                                                                            *
  ******************************************************************************/
-static void	process_httptest(zbx_dc_host_t *host, zbx_httptest_t *httptest, int *delay,
-		const char *config_source_ip, const char *config_ssl_ca_location, const char *config_ssl_cert_location,
-		const char *config_ssl_key_location)
+static void	httptest_session_load_steps(zbx_httptest_session_t *session)
 {
-	zbx_db_result_t		result;
-	zbx_db_httpstep		db_httpstep;
-	char			*err_str = NULL, *buffer = NULL;
-	zbx_timespec_t		ts;
-	double			speed_download = 0;
-	int			speed_download_num = 0, lastfailedstep = 0;
-#ifdef HAVE_LIBCURL
-	zbx_db_row_t		row;
-	zbx_httpstat_t		stat;
-	char			errbuf[CURL_ERROR_SIZE];
-	CURL			*easyhandle = NULL;
-	CURLcode		err;
-	zbx_httpstep_t		httpstep;
-	zbx_http_response_t	body = {0}, header = {0};
-#endif
-	zabbix_log(LOG_LEVEL_DEBUG, "In %s() httptestid:" ZBX_FS_UI64 " name:'%s'",
-			__func__, httptest->httptest.httptestid, httptest->httptest.name);
+	zbx_db_result_t	result;
+	zbx_db_row_t	row;
 
 	result = zbx_db_select(
 			"select httpstepid,no,name,url,timeout,posts,required,status_codes,post_type,follow_redirects,"
@@ -703,411 +734,737 @@ static void	process_httptest(zbx_dc_host_t *host, zbx_httptest_t *httptest, int
 			" from httpstep"
 			" where httptestid=" ZBX_FS_UI64
 			" order by no",
-			httptest->httptest.httptestid);
+			session->httptest.httptest.httptestid);
+
+	while (NULL != (row = zbx_db_fetch(result)))
+	{
+		zbx_httpstep_row_t	step;
+
+		ZBX_STR2UINT64(step.httpstepid, row[0]);
+		step.no = atoi(row[1]);
+		step.name = zbx_strdup(NULL, row[2]);
+		step.url = zbx_strdup(NULL, row[3]);
+		step.timeout = zbx_strdup(NULL, row[4]);
+		step.posts = zbx_strdup(NULL, row[5]);
+		step.required = zbx_strdup(NULL, row[6]);
+		step.status_codes = zbx_strdup(NULL, row[7]);
+		step.post_type = atoi(row[8]);
+		step.follow_redirects = atoi(row[9]);
+		step.retrieve_mode = atoi(row[10]);
+
+		zbx_vector_httpstep_row_append(&session->steps, step);
+	}
+
+	zbx_db_free_result(result);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: loads web scenario and its steps                                  *
+ *                                                                            *
+ * Parameters: httptestid - [IN] web scenario identifier                      *
+ *             session    - [OUT] web scenario execution state                *
+ *                                                                            *
+ * Return value: SUCCEED - web scenario was loaded and must be processed      *
+ *               FAIL    - web scenario was not found or its data could not   *
+ *                         be loaded                                          *
+ *                                                                            *
+ * Comments: Invalid update interval does not fail the loading, instead the   *
+ *           error is stored in session so it is reported when the web        *
+ *           scenario is finished.                                            *
+ *                                                                            *
+ ******************************************************************************/
+static int	httptest_session_load(zbx_uint64_t httptestid, zbx_httptest_session_t *session)
+{
+	zbx_db_result_t		result;
+	zbx_db_row_t		row;
+	zbx_dc_um_handle_t	*um_handle;
+	zbx_httptest_t		*httptest = &session->httptest;
+	char			*buffer;
+	int			ret = FAIL;
+
+	memset(session, 0, sizeof(zbx_httptest_session_t));
+
+	result = zbx_db_select(
+			"select h.hostid,h.host,h.name,t.httptestid,t.name,t.agent,"
+				"t.authentication,t.http_user,t.http_password,t.http_proxy,t.retries,"
+				"t.ssl_cert_file,t.ssl_key_file,t.ssl_key_password,t.verify_peer,"
+				"t.verify_host,t.delay"
+			" from httptest t,hosts h"
+			" where t.hostid=h.hostid"
+				" and t.httptestid=" ZBX_FS_UI64,
+			httptestid);
+
+	if (NULL == (row = zbx_db_fetch(result)))
+		goto out;
+
+	ZBX_STR2UINT64(session->host.hostid, row[0]);
+	zbx_strscpy(session->host.host, row[1]);
+	zbx_strlcpy_utf8(session->host.name, row[2], sizeof(session->host.name));
+
+	ZBX_STR2UINT64(httptest->httptest.httptestid, row[3]);
+
+	if (SUCCEED != httptest_load_pairs(&session->host, httptest))
+	{
+		zabbix_log(LOG_LEVEL_WARNING, "cannot process web scenario \"%s\" on host \"%s\": "
+				"cannot load web scenario data", row[4], session->host.name);
+		httppairs_free(&httptest->variables);
+		THIS_SHOULD_NEVER_HAPPEN;
+		goto out;
+	}
+
+	httptest->httptest.name = zbx_strdup(NULL, row[4]);
+
+	httptest->httptest.agent = zbx_strdup(NULL, row[5]);
+	zbx_substitute_simple_macros(NULL, NULL, NULL, NULL, &session->host.hostid, NULL, NULL, NULL, NULL, NULL,
+			NULL, NULL, &httptest->httptest.agent, ZBX_MACRO_TYPE_COMMON, NULL, 0);
+
+	if (HTTPTEST_AUTH_NONE != (httptest->httptest.authentication = atoi(row[6])))
+	{
+		httptest->httptest.http_user = zbx_strdup(NULL, row[7]);
+		zbx_substitute_simple_macros_unmasked(NULL, NULL, NULL, NULL, &session->host.hostid, NULL, NULL,
+				NULL, NULL, NULL, NULL, NULL, &httptest->httptest.http_user, ZBX_MACRO_TYPE_COMMON,
+				NULL, 0);
+
+		httptest->httptest.http_password = zbx_strdup(NULL, row[8]);
+		zbx_substitute_simple_macros_unmasked(NULL, NULL, NULL, NULL, &session->host.hostid, NULL, NULL,
+				NULL, NULL, NULL, NULL, NULL, &httptest->httptest.http_password, ZBX_MACRO_TYPE_COMMON,
+				NULL, 0);
+	}
+
+	if ('\0' != *row[9])
+	{
+		httptest->httptest.http_proxy = zbx_strdup(NULL, row[9]);
+		zbx_substitute_simple_macros(NULL, NULL, NULL, NULL, &session->host.hostid, NULL, NULL, NULL,
+				NULL, NULL, NULL, NULL, &httptest->httptest.http_proxy, ZBX_MACRO_TYPE_COMMON, NULL,
+				0);
+	}
+
+	httptest->httptest.retries = atoi(row[10]);
+
+	httptest->httptest.ssl_cert_file = zbx_strdup(NULL, row[11]);
+	httptest->httptest.ssl_key_file = zbx_strdup(NULL, row[12]);
+
+	um_handle = zbx_dc_open_user_macros();
+	zbx_substitute_macros(&httptest->httptest.ssl_cert_file, NULL, 0, &macro_httptest_field_resolv, um_handle,
+			&session->host);
+	zbx_substitute_macros(&httptest->httptest.ssl_key_file, NULL, 0, &macro_httptest_field_resolv, um_handle,
+			&session->host);
+	zbx_dc_close_user_macros(um_handle);
+
+	httptest->httptest.ssl_key_password = zbx_strdup(NULL, row[13]);
+	zbx_substitute_simple_macros_unmasked(NULL, NULL, NULL, NULL, &session->host.hostid, NULL, NULL, NULL,
+			NULL, NULL, NULL, NULL, &httptest->httptest.ssl_key_password, ZBX_MACRO_TYPE_COMMON, NULL, 0);
+
+	httptest->httptest.verify_peer = atoi(row[14]);
+	httptest->httptest.verify_host = atoi(row[15]);
+
+	/* create macro cache to use in this HTTP test and add httptest variables to it */
+	zbx_vector_ptr_pair_create(&httptest->macros);
+	http_process_variables(httptest, &httptest->variables, NULL, NULL);
+
+	buffer = zbx_strdup(NULL, row[16]);
+	zbx_substitute_simple_macros(NULL, NULL, NULL, NULL, &session->host.hostid, NULL, NULL, NULL, NULL, NULL,
+			NULL, NULL, &buffer, ZBX_MACRO_TYPE_COMMON, NULL, 0);
+
+	if (SUCCEED != zbx_is_time_suffix(buffer, &session->delay, ZBX_LENGTH_UNLIMITED))
+	{
+		session->err_str = zbx_dsprintf(session->err_str, "update interval \"%s\" is invalid", buffer);
+		session->lastfailedstep = -1;
+		session->delay = ZBX_DEFAULT_INTERVAL;
+	}
+
+	zbx_free(buffer);
+
+	zbx_vector_httpstep_row_create(&session->steps);
+	httptest_session_load_steps(session);
+
+	ret = SUCCEED;
+out:
+	zbx_db_free_result(result);
+
+	return ret;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: frees resources allocated for web scenario execution              *
+ *                                                                            *
+ * Parameters: session - [IN] web scenario execution state                    *
+ *                                                                            *
+ ******************************************************************************/
+static void	httptest_session_clean(zbx_httptest_session_t *session)
+{
+	zbx_httptest_t	*httptest = &session->httptest;
+
+	for (int i = 0; i < session->steps.values_num; i++)
+	{
+		zbx_httpstep_row_t	*step = &session->steps.values[i];
+
+		zbx_free(step->name);
+		zbx_free(step->url);
+		zbx_free(step->timeout);
+		zbx_free(step->posts);
+		zbx_free(step->required);
+		zbx_free(step->status_codes);
+	}
 
-	buffer = zbx_strdup(buffer, httptest->httptest.delay);
-	zbx_substitute_simple_macros(NULL, NULL, NULL, NULL, &host->hostid, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
-				&buffer, ZBX_MACRO_TYPE_COMMON, NULL, 0);
+	zbx_vector_httpstep_row_destroy(&session->steps);
 
-	/* Avoid the potential usage of uninitialized values when: */
-	/* 1) compile without libCURL support */
-	/* 2) update interval is invalid */
-	db_httpstep.name = NULL;
+#ifdef HAVE_LIBCURL
+	if (NULL != session->easyhandle)
+		curl_easy_cleanup(session->easyhandle);
+#endif
+	zbx_free(httptest->httptest.ssl_key_password);
+	zbx_free(httptest->httptest.ssl_key_file);
+	zbx_free(httptest->httptest.ssl_cert_file);
+	zbx_free(httptest->httptest.http_proxy);
+	zbx_free(httptest->httptest.http_password);
+	zbx_free(httptest->httptest.http_user);
+	zbx_free(httptest->httptest.agent);
+	zbx_free(httptest->httptest.name);
+	zbx_free(httptest->headers);
+	httppairs_free(&httptest->variables);
+
+	/* destroy the macro cache used in this HTTP test */
+	httptest_remove_macros(httptest);
+	zbx_vector_ptr_pair_destroy(&httptest->macros);
+
+	zbx_free(session->err_str);
+}
 
-	if (SUCCEED != zbx_is_time_suffix(buffer, delay, ZBX_LENGTH_UNLIMITED))
+/******************************************************************************
+ *                                                                            *
+ * Purpose: stores web scenario results and schedules its next check          *
+ *                                                                            *
+ * Parameters: session - [IN/OUT] web scenario execution state                *
+ *             now     - [IN] time the web scenario was taken for processing  *
+ *                                                                            *
+ ******************************************************************************/
+static void	httptest_session_finish(zbx_httptest_session_t *session, int now)
+{
+	zbx_timespec_t	ts;
+
+	zbx_timespec(&ts);
+
+	if (NULL != session->err_str)
 	{
-		err_str = zbx_dsprintf(err_str, "update interval \"%s\" is invalid", buffer);
-		lastfailedstep = -1;
-		*delay = ZBX_DEFAULT_INTERVAL;
-		goto httptest_error;
+		if (0 >= session->lastfailedstep)
+		{
+			/* we are here because web scenario update interval is invalid, */
+			/* cURL initialization failed or we have been compiled without cURL library */
+
+			session->lastfailedstep = 1;
+		}
+
+		if (NULL != session->db_httpstep.name)
+		{
+			zabbix_log(LOG_LEVEL_DEBUG, "cannot process step \"%s\" of web scenario \"%s\" on host \"%s\": "
+					"%s", session->db_httpstep.name, session->httptest.httptest.name,
+					session->host.name, session->err_str);
+		}
 	}
 
+	if (0 != session->speed_download_num)
+		session->speed_download /= session->speed_download_num;
+
+	process_test_data(session->httptest.httptest.httptestid, session->lastfailedstep, session->speed_download,
+			session->err_str, &ts);
+
+	zbx_preprocessor_flush();
+
+	zbx_dc_httptest_queue(now, session->httptest.httptest.httptestid, session->delay);
+}
+
 #ifdef HAVE_LIBCURL
-	if (NULL == (easyhandle = curl_easy_init()))
+/******************************************************************************
+ *                                                                            *
+ * Purpose: creates cURL handle shared by all steps of web scenario           *
+ *                                                                            *
+ * Parameters: session                  - [IN/OUT] web scenario execution     *
+ *                                                 state                      *
+ *             config_source_ip         - [IN]                                *
+ *             config_ssl_ca_location   - [IN]                                *
+ *             config_ssl_cert_location - [IN]                                *
+ *             config_ssl_key_location  - [IN]                                *
+ *                                                                            *
+ * Return value: SUCCEED - cURL handle was created                            *
+ *               FAIL    - otherwise, error is stored in session              *
+ *                                                                            *
+ ******************************************************************************/
+static int	httptest_session_init_curl(zbx_httptest_session_t *session, const char *config_source_ip,
+		const char *config_ssl_ca_location, const char *config_ssl_cert_location,
+		const char *config_ssl_key_location)
+{
+	zbx_httptest_t	*httptest = &session->httptest;
+	CURLcode	err;
+
+	if (NULL == (session->easyhandle = curl_easy_init()))
 	{
-		err_str = zbx_strdup(err_str, "cannot initialize cURL library");
-		goto clean;
+		session->err_str = zbx_strdup(session->err_str, "cannot initialize cURL library");
+		return FAIL;
 	}
 
-	if (CURLE_OK != (err = curl_easy_setopt(easyhandle, CURLOPT_PROXY, httptest->httptest.http_proxy)) ||
-			CURLE_OK != (err = curl_easy_setopt(easyhandle, CURLOPT_COOKIEFILE, "")) ||
-			CURLE_OK != (err = curl_easy_setopt(easyhandle, CURLOPT_USERAGENT, httptest->httptest.agent)) ||
-			CURLE_OK != (err = curl_easy_setopt(easyhandle, CURLOPT_ACCEPT_ENCODING, "")))
+	if (CURLE_OK != (err = curl_easy_setopt(session->easyhandle, CURLOPT_PROXY,
+					httptest->httptest.http_proxy)) ||
+			CURLE_OK != (err = curl_easy_setopt(session->easyhandle, CURLOPT_COOKIEFILE, "")) ||
+			CURLE_OK != (err = curl_easy_setopt(session->easyhandle, CURLOPT_USERAGENT,
+					httptest->httptest.agent)) ||
+			CURLE_OK != (err = curl_easy_setopt(session->easyhandle, CURLOPT_ACCEPT_ENCODING, "")))
 	{
-		err_str = zbx_strdup(err_str, curl_easy_strerror(err));
-		goto clean;
+		session->err_str = zbx_strdup(session->err_str, curl_easy_strerror(err));
+		return FAIL;
 	}
 
-	if (SUCCEED != zbx_curl_setopt_https(easyhandle, &err_str))
-		goto clean;
+	if (SUCCEED != zbx_curl_setopt_https(session->easyhandle, &session->err_str))
+		return FAIL;
 
-	if (SUCCEED != zbx_http_prepare_ssl(easyhandle, httptest->httptest.ssl_cert_file,
+	if (SUCCEED != zbx_http_prepare_ssl(session->easyhandle, httptest->httptest.ssl_cert_file,
 			httptest->httptest.ssl_key_file, httptest->httptest.ssl_key_password,
 			httptest->httptest.verify_peer, httptest->httptest.verify_host, config_source_ip,
-			config_ssl_ca_location, config_ssl_cert_location, config_ssl_key_location, &err_str))
+			config_ssl_ca_location, config_ssl_cert_location, config_ssl_key_location, &session->err_str))
 	{
-		goto clean;
+		return FAIL;
 	}
 
-	httpstep.httptest = httptest;
-	httpstep.httpstep = &db_httpstep;
+	return SUCCEED;
+}
 
-	while (NULL != (row = zbx_db_fetch(result)) && ZBX_IS_RUNNING())
-	{
-		struct curl_slist	*headers_slist = NULL;
-		char			*header_cookie = NULL;
-		zbx_curl_cb_t		curl_body_cb, curl_header_cb;
+/******************************************************************************
+ *                                                                            *
+ * Purpose: prepares current web scenario step and sets up cURL handle to     *
+ *          perform it                                                        *
+ *                                                                            *
+ * Parameters: session - [IN/OUT] web scenario execution state                *
+ *                                                                            *
+ * Return value: SUCCEED - step is ready to be performed                      *
+ *               FAIL    - otherwise, error is stored in session              *
+ *                                                                            *
+ * Comments: httpstep_clean() must be called after this function regardless   *
+ *           of the result.                                                   *
+ *                                                                            *
+ ******************************************************************************/
+static int	httpstep_prepare(zbx_httptest_session_t *session)
+{
+	zbx_httpstep_row_t	*row = &session->steps.values[session->step_index];
+	zbx_db_httpstep		*db_httpstep = &session->db_httpstep;
+	zbx_httpstep_t		*httpstep = &session->httpstep;
+	zbx_httptest_t		*httptest = &session->httptest;
+	zbx_dc_host_t		*host = &session->host;
+	CURL			*easyhandle = session->easyhandle;
+	char			*header_cookie = NULL, *buffer = NULL;
+	zbx_curl_cb_t		curl_body_cb, curl_header_cb;
+	zbx_dc_um_handle_t	*um_handle;
+	CURLcode		err;
+	int			ret = FAIL;
 
-		/* NOTE: do not break or return from this block! */
-		/*       process_step_data() call is required! */
+	httpstep->httptest = httptest;
+	httpstep->httpstep = db_httpstep;
+	session->headers_slist = NULL;
 
-		ZBX_STR2UINT64(db_httpstep.httpstepid, row[0]);
-		db_httpstep.httptestid = httptest->httptest.httptestid;
-		db_httpstep.no = atoi(row[1]);
-		db_httpstep.name = row[2];
+	db_httpstep->httpstepid = row->httpstepid;
+	db_httpstep->httptestid = httptest->httptest.httptestid;
+	db_httpstep->no = row->no;
+	db_httpstep->name = row->name;
 
-		db_httpstep.url = zbx_strdup(NULL, row[3]);
+	db_httpstep->url = zbx_strdup(NULL, row->url);
 
-		zbx_dc_um_handle_t	*um_handle = zbx_dc_open_user_macros_secure();
-		zbx_substitute_macros(&db_httpstep.url, NULL, 0, &macro_httptest_field_resolv, um_handle, host);
-		zbx_dc_close_user_macros(um_handle);
+	um_handle = zbx_dc_open_user_macros_secure();
+	zbx_substitute_macros(&db_httpstep->url, NULL, 0, &macro_httptest_field_resolv, um_handle, host);
+	zbx_dc_close_user_macros(um_handle);
+
+	http_substitute_variables(httptest, &db_httpstep->url);
+
+	db_httpstep->required = zbx_strdup(NULL, row->required);
 
-		http_substitute_variables(httptest, &db_httpstep.url);
+	um_handle = zbx_dc_open_user_macros();
+	zbx_substitute_macros(&db_httpstep->required, NULL, 0, &macro_httptest_field_resolv, um_handle, host);
+	zbx_dc_close_user_macros(um_handle);
 
-		db_httpstep.required = zbx_strdup(NULL, row[6]);
+	db_httpstep->status_codes = zbx_strdup(NULL, row->status_codes);
+	zbx_substitute_simple_macros(NULL, NULL, NULL, NULL, &host->hostid, NULL, NULL, NULL, NULL, NULL, NULL,
+			NULL, &db_httpstep->status_codes, ZBX_MACRO_TYPE_COMMON, NULL, 0);
 
-		um_handle = zbx_dc_open_user_macros();
-		zbx_substitute_macros(&db_httpstep.required, NULL, 0, &macro_httptest_field_resolv, um_handle, host);
+	db_httpstep->post_type = row->post_type;
+
+	if (ZBX_POSTTYPE_RAW == db_httpstep->post_type)
+	{
+		db_httpstep->posts = zbx_strdup(NULL, row->posts);
+
+		um_handle = zbx_dc_open_user_macros_secure();
+		zbx_substitute_macros(&db_httpstep->posts, NULL, 0, &macro_httptest_field_resolv, um_handle, host);
 		zbx_dc_close_user_macros(um_handle);
 
-		db_httpstep.status_codes = zbx_strdup(NULL, row[7]);
-		zbx_substitute_simple_macros(NULL, NULL, NULL, NULL, &host->hostid, NULL, NULL, NULL, NULL, NULL, NULL,
-				NULL, &db_httpstep.status_codes, ZBX_MACRO_TYPE_COMMON, NULL, 0);
+		http_substitute_variables(httptest, &db_httpstep->posts);
+	}
+	else
+		db_httpstep->posts = NULL;
 
-		db_httpstep.post_type = atoi(row[8]);
+	if (SUCCEED != httpstep_load_pairs(host, httpstep))
+	{
+		session->err_str = zbx_strdup(session->err_str, "cannot load web scenario step data");
+		goto out;
+	}
 
-		if (ZBX_POSTTYPE_RAW == db_httpstep.post_type)
-		{
-			db_httpstep.posts = zbx_strdup(NULL, row[5]);
+	buffer = zbx_strdup(buffer, row->timeout);
+	zbx_substitute_simple_macros(NULL, NULL, NULL, NULL, &host->hostid, NULL, NULL, NULL, NULL, NULL, NULL,
+			NULL, &buffer, ZBX_MACRO_TYPE_COMMON, NULL, 0);
 
-			um_handle = zbx_dc_open_user_macros_secure();
-			zbx_substitute_macros(&db_httpstep.posts, NULL, 0, &macro_httptest_field_resolv, um_handle,
-					host);
-			zbx_dc_close_user_macros(um_handle);
+	if (SUCCEED != zbx_is_time_suffix(buffer, &db_httpstep->timeout, ZBX_LENGTH_UNLIMITED))
+	{
+		session->err_str = zbx_dsprintf(session->err_str, "timeout \"%s\" is invalid", buffer);
+		goto out;
+	}
+	else if (db_httpstep->timeout < 1 || SEC_PER_HOUR < db_httpstep->timeout)
+	{
+		session->err_str = zbx_dsprintf(session->err_str, "timeout \"%s\" is out of 1-3600 seconds bounds",
+				buffer);
+		goto out;
+	}
 
-			http_substitute_variables(httptest, &db_httpstep.posts);
-		}
-		else
-			db_httpstep.posts = NULL;
+	db_httpstep->follow_redirects = row->follow_redirects;
+	db_httpstep->retrieve_mode = row->retrieve_mode;
 
-		if (SUCCEED != httpstep_load_pairs(host, &httpstep))
-		{
-			err_str = zbx_strdup(err_str, "cannot load web scenario step data");
-			goto httpstep_error;
-		}
+	memset(&session->stat, 0, sizeof(session->stat));
 
-		buffer = zbx_strdup(buffer, row[4]);
-		zbx_substitute_simple_macros(NULL, NULL, NULL, NULL, &host->hostid, NULL, NULL, NULL, NULL, NULL, NULL,
-				NULL, &buffer, ZBX_MACRO_TYPE_COMMON, NULL, 0);
+	zabbix_log(LOG_LEVEL_DEBUG, "%s() use step \"%s\"", __func__, db_httpstep->name);
+	zabbix_log(LOG_LEVEL_DEBUG, "%s() use post \"%s\"", __func__, ZBX_NULL2EMPTY_STR(httpstep->posts));
 
-		if (SUCCEED != zbx_is_time_suffix(buffer, &db_httpstep.timeout, ZBX_LENGTH_UNLIMITED))
-		{
-			err_str = zbx_dsprintf(err_str, "timeout \"%s\" is invalid", buffer);
-			goto httpstep_error;
-		}
-		else if (db_httpstep.timeout < 1 || SEC_PER_HOUR < db_httpstep.timeout)
+	if (CURLE_OK != (err = curl_easy_setopt(easyhandle, CURLOPT_POSTFIELDS, httpstep->posts)))
+	{
+		session->err_str = zbx_strdup(session->err_str, curl_easy_strerror(err));
+		goto out;
+	}
+
+	if (CURLE_OK != (err = curl_easy_setopt(easyhandle, CURLOPT_POST, (NULL != httpstep->posts &&
+			'\0' != *httpstep->posts) ? 1L : 0L)))
+	{
+		session->err_str = zbx_strdup(session->err_str, curl_easy_strerror(err));
+		goto out;
+	}
+
+	if (CURLE_OK != (err = curl_easy_setopt(easyhandle, CURLOPT_FOLLOWLOCATION,
+			0 == db_httpstep->follow_redirects ? 0L : 1L)))
+	{
+		session->err_str = zbx_strdup(session->err_str, curl_easy_strerror(err));
+		goto out;
+	}
+
+	if (0 != db_httpstep->follow_redirects)
+	{
+		if (CURLE_OK != (err = curl_easy_setopt(easyhandle, CURLOPT_MAXREDIRS, ZBX_CURLOPT_MAXREDIRS)))
 		{
-			err_str = zbx_dsprintf(err_str, "timeout \"%s\" is out of 1-3600 seconds bounds", buffer);
-			goto httpstep_error;
+			session->err_str = zbx_strdup(session->err_str, curl_easy_strerror(err));
+			goto out;
 		}
+	}
 
-		db_httpstep.follow_redirects = atoi(row[9]);
-		db_httpstep.retrieve_mode = atoi(row[10]);
+	/* headers defined in a step overwrite headers defined in scenario */
+	if (NULL != httpstep->headers && '\0' != *httpstep->headers)
+		add_http_headers(httpstep->headers, &session->headers_slist, &header_cookie);
+	else if (NULL != httptest->headers && '\0' != *httptest->headers)
+		add_http_headers(httptest->headers, &session->headers_slist, &header_cookie);
 
-		memset(&stat, 0, sizeof(stat));
+	err = curl_easy_setopt(easyhandle, CURLOPT_COOKIE, header_cookie);
+	zbx_free(header_cookie);
 
-		zabbix_log(LOG_LEVEL_DEBUG, "%s() use step \"%s\"", __func__, db_httpstep.name);
-		zabbix_log(LOG_LEVEL_DEBUG, "%s() use post \"%s\"", __func__, ZBX_NULL2EMPTY_STR(httpstep.posts));
+	if (CURLE_OK != err)
+	{
+		session->err_str = zbx_strdup(session->err_str, curl_easy_strerror(err));
+		goto out;
+	}
 
-		if (CURLE_OK != (err = curl_easy_setopt(easyhandle, CURLOPT_POSTFIELDS, httpstep.posts)))
-		{
-			err_str = zbx_strdup(err_str, curl_easy_strerror(err));
-			goto httpstep_error;
-		}
+	if (CURLE_OK != (err = curl_easy_setopt(easyhandle, CURLOPT_HTTPHEADER, session->headers_slist)))
+	{
+		session->err_str = zbx_strdup(session->err_str, curl_easy_strerror(err));
+		goto out;
+	}
 
-		if (CURLE_OK != (err = curl_easy_setopt(easyhandle, CURLOPT_POST, (NULL != httpstep.posts &&
-				'\0' != *httpstep.posts) ? 1L : 0L)))
-		{
-			err_str = zbx_strdup(err_str, curl_easy_strerror(err));
-			goto httpstep_error;
-		}
+	switch (db_httpstep->retrieve_mode)
+	{
+		case ZBX_RETRIEVE_MODE_CONTENT:
+			curl_header_cb = zbx_curl_ignore_cb;
+			curl_body_cb = zbx_curl_write_cb;
+			break;
+		case ZBX_RETRIEVE_MODE_BOTH:
+			curl_header_cb = curl_body_cb = zbx_curl_write_cb;
+			break;
+		case ZBX_RETRIEVE_MODE_HEADERS:
+			curl_header_cb = zbx_curl_write_cb;
+			curl_body_cb = zbx_curl_ignore_cb;
+			break;
+		default:
+			THIS_SHOULD_NEVER_HAPPEN;
+			session->err_str = zbx_strdup(session->err_str, "invalid retrieve mode");
+			goto out;
+	}
+
+	if (SUCCEED != zbx_http_prepare_callbacks(easyhandle, &session->header, &session->body, curl_header_cb,
+			curl_body_cb, session->errbuf, &session->err_str))
+	{
+		goto out;
+	}
 
-		if (CURLE_OK != (err = curl_easy_setopt(easyhandle, CURLOPT_FOLLOWLOCATION,
-				0 == db_httpstep.follow_redirects ? 0L : 1L)))
+	/* enable/disable fetching the body */
+	if (CURLE_OK != (err = curl_easy_setopt(easyhandle, CURLOPT_NOBODY,
+			ZBX_RETRIEVE_MODE_HEADERS == db_httpstep->retrieve_mode ? 1L : 0L)))
+	{
+		session->err_str = zbx_strdup(session->err_str, curl_easy_strerror(err));
+		goto out;
+	}
+
+	if (SUCCEED != zbx_http_prepare_auth(easyhandle, httptest->httptest.authentication,
+			httptest->httptest.http_user, httptest->httptest.http_password, NULL, &session->err_str))
+	{
+		goto out;
+	}
+
+	zabbix_log(LOG_LEVEL_DEBUG, "%s() go to URL \"%s\"", __func__, httpstep->url);
+
+	if (CURLE_OK != (err = curl_easy_setopt(easyhandle, CURLOPT_TIMEOUT, (long)db_httpstep->timeout)) ||
+			CURLE_OK != (err = curl_easy_setopt(easyhandle, CURLOPT_URL, httpstep->url)))
+	{
+		session->err_str = zbx_strdup(session->err_str, curl_easy_strerror(err));
+		goto out;
+	}
+
+	ret = SUCCEED;
+out:
+	zbx_free(buffer);
+
+	return ret;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: resets response buffers before (re)trying web scenario step       *
+ *                                                                            *
+ ******************************************************************************/
+static void	httpstep_reset_response(zbx_httptest_session_t *session)
+{
+	memset(&session->header, 0, sizeof(session->header));
+	memset(&session->body, 0, sizeof(session->body));
+	session->errbuf[0] = '\0';
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: checks response of performed web scenario step and stores step    *
+ *          results                                                           *
+ *                                                                            *
+ * Parameters: session - [IN/OUT] web scenario execution state                *
+ *             err     - [IN] cURL transfer result                            *
+ *                                                                            *
+ ******************************************************************************/
+static void	httpstep_process_response(zbx_httptest_session_t *session, CURLcode err)
+{
+	zbx_db_httpstep	*db_httpstep = &session->db_httpstep;
+	zbx_httpstep_t	*httpstep = &session->httpstep;
+	zbx_httptest_t	*httptest = &session->httptest;
+	zbx_httpstat_t	*stat = &session->stat;
+	CURL		*easyhandle = session->easyhandle;
+
+	if (CURLE_OK == err)
+	{
+		char		*var_err_str = NULL, *data = NULL;
+		zbx_timespec_t	ts;
+
+		if (NULL != session->body.data)
 		{
-			err_str = zbx_strdup(err_str, curl_easy_strerror(err));
-			goto httpstep_error;
+			zbx_http_convert_to_utf8(easyhandle, &session->body.data, &session->body.offset,
+					&session->body.allocated);
+			data = session->body.data;
 		}
 
-		if (0 != db_httpstep.follow_redirects)
+		if (NULL != session->header.data)
 		{
-			if (CURLE_OK != (err = curl_easy_setopt(easyhandle, CURLOPT_MAXREDIRS, ZBX_CURLOPT_MAXREDIRS)))
+			if (NULL != session->body.data)
 			{
-				err_str = zbx_strdup(err_str, curl_easy_strerror(err));
-				goto httpstep_error;
+				zbx_strncpy_alloc(&session->header.data, &session->header.allocated,
+						&session->header.offset, session->body.data, session->body.offset);
 			}
+
+			data = session->header.data;
 		}
 
-		/* headers defined in a step overwrite headers defined in scenario */
-		if (NULL != httpstep.headers && '\0' != *httpstep.headers)
-			add_http_headers(httpstep.headers, &headers_slist, &header_cookie);
-		else if (NULL != httptest->headers && '\0' != *httptest->headers)
-			add_http_headers(httptest->headers, &headers_slist, &header_cookie);
+		if (NULL == data)
+			data = "";
 
-		err = curl_easy_setopt(easyhandle, CURLOPT_COOKIE, header_cookie);
-		zbx_free(header_cookie);
+		zabbix_log(LOG_LEVEL_TRACE, "%s() page.data from %s:'%s'", __func__, httpstep->url, data);
 
-		if (CURLE_OK != err)
+		/* first get the data that is needed even if step fails */
+		if (CURLE_OK != (err = curl_easy_getinfo(easyhandle, CURLINFO_RESPONSE_CODE, &stat->rspcode)))
 		{
-			err_str = zbx_strdup(err_str, curl_easy_strerror(err));
-			goto httpstep_error;
+			session->err_str = zbx_strdup(session->err_str, curl_easy_strerror(err));
 		}
-
-		if (CURLE_OK != (err = curl_easy_setopt(easyhandle, CURLOPT_HTTPHEADER, headers_slist)))
+		else if ('\0' != *db_httpstep->status_codes &&
+				FAIL == zbx_int_in_list(db_httpstep->status_codes, stat->rspcode))
 		{
-			err_str = zbx_strdup(err_str, curl_easy_strerror(err));
-			goto httpstep_error;
+			session->err_str = zbx_dsprintf(session->err_str, "response code \"%ld\" did not match any of"
+					" the required status codes \"%s\"", stat->rspcode, db_httpstep->status_codes);
 		}
 
-		switch (db_httpstep.retrieve_mode)
+		if (CURLE_OK != (err = curl_easy_getinfo(easyhandle, CURLINFO_TOTAL_TIME, &stat->total_time)) &&
+				NULL == session->err_str)
 		{
-			case ZBX_RETRIEVE_MODE_CONTENT:
-				curl_header_cb = zbx_curl_ignore_cb;
-				curl_body_cb = zbx_curl_write_cb;
-				break;
-			case ZBX_RETRIEVE_MODE_BOTH:
-				curl_header_cb = curl_body_cb = zbx_curl_write_cb;
-				break;
-			case ZBX_RETRIEVE_MODE_HEADERS:
-				curl_header_cb = zbx_curl_write_cb;
-				curl_body_cb = zbx_curl_ignore_cb;
-				break;
-			default:
-				THIS_SHOULD_NEVER_HAPPEN;
-				err_str = zbx_strdup(err_str, "invalid retrieve mode");
-				goto httpstep_error;
+			session->err_str = zbx_strdup(session->err_str, curl_easy_strerror(err));
 		}
 
-		if (SUCCEED != zbx_http_prepare_callbacks(easyhandle, &header, &body, curl_header_cb, curl_body_cb,
-				errbuf, &err_str))
+		if (CURLE_OK != (err = curl_easy_getinfo(easyhandle, CURLINFO_SPEED_DOWNLOAD_T,
+				&stat->speed_download)) && NULL == session->err_str)
 		{
-			goto httpstep_error;
+			session->err_str = zbx_strdup(session->err_str, curl_easy_strerror(err));
 		}
-
-		/* enable/disable fetching the body */
-		if (CURLE_OK != (err = curl_easy_setopt(easyhandle, CURLOPT_NOBODY,
-				ZBX_RETRIEVE_MODE_HEADERS == db_httpstep.retrieve_mode ? 1L : 0L)))
+		else
 		{
-			err_str = zbx_strdup(err_str, curl_easy_strerror(err));
-			goto httpstep_error;
+			session->speed_download += (double)stat->speed_download;
+			session->speed_download_num++;
 		}
 
-		if (SUCCEED != zbx_http_prepare_auth(easyhandle, httptest->httptest.authentication,
-				httptest->httptest.http_user, httptest->httptest.http_password, NULL, &err_str))
+		/* required pattern */
+		if (NULL == session->err_str && '\0' != *db_httpstep->required &&
+				NULL == zbx_regexp_match(data, db_httpstep->required, NULL))
 		{
-			goto httpstep_error;
+			session->err_str = zbx_dsprintf(session->err_str, "required pattern \"%s\" was not found on %s",
+					db_httpstep->required, httpstep->url);
 		}
 
-		zabbix_log(LOG_LEVEL_DEBUG, "%s() go to URL \"%s\"", __func__, httpstep.url);
-
-		if (CURLE_OK != (err = curl_easy_setopt(easyhandle, CURLOPT_TIMEOUT, (long)db_httpstep.timeout)) ||
-				CURLE_OK != (err = curl_easy_setopt(easyhandle, CURLOPT_URL, httpstep.url)))
+		/* variables defined in scenario */
+		if (NULL == session->err_str && FAIL == http_process_variables(httptest, &httptest->variables, data,
+				&var_err_str))
 		{
-			err_str = zbx_strdup(err_str, curl_easy_strerror(err));
-			goto httpstep_error;
-		}
+			char	*variables = NULL;
+			size_t	alloc_len = 0, offset;
 
-		/* try to retrieve page several times depending on number of retries */
-		do
-		{
-			memset(&header, 0, sizeof(header));
-			memset(&body, 0, sizeof(body));
-			errbuf[0] = '\0';
+			httpstep_pairs_join(&variables, &alloc_len, &offset, "=", " ", &httptest->variables);
 
-			if (CURLE_OK == (err = curl_easy_perform(easyhandle)))
-				break;
+			session->err_str = zbx_dsprintf(session->err_str, "error in scenario variables \"%s\": %s",
+					variables, var_err_str);
 
-			zbx_free(body.data);
-			zbx_free(header.data);
+			zbx_free(variables);
 		}
-		while (0 < --httptest->httptest.retries);
 
-		if (CURLE_OK == err)
+		/* variables defined in a step */
+		if (NULL == session->err_str && FAIL == http_process_variables(httptest, &httpstep->variables, data,
+				&var_err_str))
 		{
-			char	*var_err_str = NULL, *data = NULL;
-
-			if (NULL != body.data)
-			{
-				zbx_http_convert_to_utf8(easyhandle, &body.data, &body.offset, &body.allocated);
-				data = body.data;
-			}
+			char	*variables = NULL;
+			size_t	alloc_len = 0, offset;
 
-			if (NULL != header.data)
-			{
-				if (NULL != body.data)
-				{
-					zbx_strncpy_alloc(&header.data, &header.allocated, &header.offset, body.data,
-							body.offset);
-				}
+			httpstep_pairs_join(&variables, &alloc_len, &offset, "=", " ", &httpstep->variables);
 
-				data = header.data;
-			}
+			session->err_str = zbx_dsprintf(session->err_str, "error in step variables \"%s\": %s",
+					variables, var_err_str);
 
-			if (NULL == data)
-				data = "";
+			zbx_free(variables);
+		}
 
-			zabbix_log(LOG_LEVEL_TRACE, "%s() page.data from %s:'%s'", __func__, httpstep.url, data);
+		zbx_free(var_err_str);
 
-			/* first get the data that is needed even if step fails */
-			if (CURLE_OK != (err = curl_easy_getinfo(easyhandle, CURLINFO_RESPONSE_CODE, &stat.rspcode)))
-			{
-				err_str = zbx_strdup(err_str, curl_easy_strerror(err));
-			}
-			else if ('\0' != *db_httpstep.status_codes &&
-					FAIL == zbx_int_in_list(db_httpstep.status_codes, stat.rspcode))
-			{
-				err_str = zbx_dsprintf(err_str, "response code \"%ld\" did not match any of the"
-						" required status codes \"%s\"", stat.rspcode,
-						db_httpstep.status_codes);
-			}
+		zbx_timespec(&ts);
+		process_step_data(db_httpstep->httpstepid, stat, &ts);
 
-			if (CURLE_OK != (err = curl_easy_getinfo(easyhandle, CURLINFO_TOTAL_TIME, &stat.total_time)) &&
-					NULL == err_str)
-			{
-				err_str = zbx_strdup(err_str, curl_easy_strerror(err));
-			}
+		zbx_free(session->header.data);
+		zbx_free(session->body.data);
+	}
+	else
+	{
+		session->err_str = zbx_dsprintf(session->err_str, "%s", 0 < strlen(session->errbuf) ? session->errbuf :
+				curl_easy_strerror(err));
+	}
+}
 
-			if (CURLE_OK != (err = curl_easy_getinfo(easyhandle, CURLINFO_SPEED_DOWNLOAD_T,
-					&stat.speed_download)) && NULL == err_str)
-			{
-				err_str = zbx_strdup(err_str, curl_easy_strerror(err));
-			}
-			else
-			{
-				speed_download += (double)stat.speed_download;
-				speed_download_num++;
-			}
+/******************************************************************************
+ *                                                                            *
+ * Purpose: frees resources allocated for web scenario step                   *
+ *                                                                            *
+ * Parameters: session - [IN/OUT] web scenario execution state                *
+ *                                                                            *
+ ******************************************************************************/
+static void	httpstep_clean(zbx_httptest_session_t *session)
+{
+	zbx_db_httpstep	*db_httpstep = &session->db_httpstep;
+	zbx_httpstep_t	*httpstep = &session->httpstep;
 
-			/* required pattern */
-			if (NULL == err_str && '\0' != *db_httpstep.required &&
-					NULL == zbx_regexp_match(data, db_httpstep.required, NULL))
-			{
-				err_str = zbx_dsprintf(err_str, "required pattern \"%s\" was not found on %s",
-						db_httpstep.required, httpstep.url);
-			}
+	curl_slist_free_all(session->headers_slist);
+	session->headers_slist = NULL;
 
-			/* variables defined in scenario */
-			if (NULL == err_str && FAIL == http_process_variables(httptest, &httptest->variables,
-					data, &var_err_str))
-			{
-				char	*variables = NULL;
-				size_t	alloc_len = 0, offset;
+	zbx_free(db_httpstep->status_codes);
+	zbx_free(db_httpstep->required);
+	zbx_free(db_httpstep->posts);
+	zbx_free(db_httpstep->url);
 
-				httpstep_pairs_join(&variables, &alloc_len, &offset, "=", " ", &httptest->variables);
+	httppairs_free(&httpstep->variables);
 
-				err_str = zbx_dsprintf(err_str, "error in scenario variables \"%s\": %s", variables,
-						var_err_str);
+	if (ZBX_POSTTYPE_FORM == db_httpstep->post_type)
+		zbx_free(httpstep->posts);
 
-				zbx_free(variables);
-			}
+	zbx_free(httpstep->url);
+	zbx_free(httpstep->headers);
 
-			/* variables defined in a step */
-			if (NULL == err_str && FAIL == http_process_variables(httptest, &httpstep.variables, data,
-					&var_err_str))
-			{
-				char	*variables = NULL;
-				size_t	alloc_len = 0, offset;
+	if (NULL != session->err_str)
+		session->lastfailedstep = db_httpstep->no;
+}
+#endif	/* HAVE_LIBCURL */
 
-				httpstep_pairs_join(&variables, &alloc_len, &offset, "=", " ", &httpstep.variables);
+/******************************************************************************
+ *                                                                            *
+ * Purpose: processes single scenario of HTTP test                            *
+ *                                                                            *
+ ******************************************************************************/
+static void	process_httptest(zbx_httptest_session_t *session, const char *config_source_ip,
+		const char *config_ssl_ca_location, const char *config_ssl_cert_location,
+		const char *config_ssl_key_location)
+{
+#ifdef HAVE_LIBCURL
+	CURLcode	err;
+#endif
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s() httptestid:" ZBX_FS_UI64 " name:'%s'",
+			__func__, session->httptest.httptest.httptestid, session->httptest.httptest.name);
 
-				err_str = zbx_dsprintf(err_str, "error in step variables \"%s\": %s", variables,
-						var_err_str);
+	if (NULL != session->err_str)
+		goto out;
+#ifdef HAVE_LIBCURL
+	if (SUCCEED != httptest_session_init_curl(session, config_source_ip, config_ssl_ca_location,
+			config_ssl_cert_location, config_ssl_key_location))
+	{
+		goto out;
+	}
 
-				zbx_free(variables);
-			}
+	for (; session->step_index < session->steps.values_num && ZBX_IS_RUNNING(); session->step_index++)
+	{
+		if (SUCCEED == httpstep_prepare(session))
+		{
+			/* try to retrieve page several times depending on number of retries */
+			do
+			{
+				httpstep_reset_response(session);
 
-			zbx_free(var_err_str);
+				if (CURLE_OK == (err = curl_easy_perform(session->easyhandle)))
+					break;
 
-			zbx_timespec(&ts);
-			process_step_data(db_httpstep.httpstepid, &stat, &ts);
+				zbx_free(session->body.data);
+				zbx_free(session->header.data);
+			}
+			while (0 < --session->httptest.httptest.retries);
 
-			zbx_free(header.data);
-			zbx_free(body.data);
+			httpstep_process_response(session, err);
 		}
-		else
-			err_str = zbx_dsprintf(err_str, "%s", 0 < strlen(errbuf) ? errbuf : curl_easy_strerror(err));
-httpstep_error:
-		curl_slist_free_all(headers_slist);
-		zbx_free(db_httpstep.status_codes);
-		zbx_free(db_httpstep.required);
-		zbx_free(db_httpstep.posts);
-		zbx_free(db_httpstep.url);
-
-		httppairs_free(&httpstep.variables);
 
-		if (ZBX_POSTTYPE_FORM == httpstep.httpstep->post_type)
-			zbx_free(httpstep.posts);
+		httpstep_clean(session);
 
-		zbx_free(httpstep.url);
-		zbx_free(httpstep.headers);
-
-		if (NULL != err_str)
-		{
-			lastfailedstep = db_httpstep.no;
+		if (NULL != session->err_str)
 			break;
-		}
 	}
-clean:
-	curl_easy_cleanup(easyhandle);
 #else
 	ZBX_UNUSED(config_source_ip);
 	ZBX_UNUSED(config_ssl_ca_location);
 	ZBX_UNUSED(config_ssl_cert_location);
 	ZBX_UNUSED(config_ssl_key_location);
 
-	err_str = zbx_strdup(err_str, "cURL library is required for Web monitoring support");
+	session->err_str = zbx_strdup(session->err_str, "cURL library is required for Web monitoring support");
 #endif	/* HAVE_LIBCURL */
-
-httptest_error:
-	zbx_timespec(&ts);
-
-	if (NULL != err_str)
-	{
-		if (0 >= lastfailedstep)
-		{
-			/* we are here because web scenario update interval is invalid, */
-			/* cURL initialization failed or we have been compiled without cURL library */
-
-			lastfailedstep = 1;
-		}
-
-		if (NULL != db_httpstep.name)
-		{
-			zabbix_log(LOG_LEVEL_DEBUG, "cannot process step \"%s\" of web scenario \"%s\" on host \"%s\": "
-					"%s", db_httpstep.name, httptest->httptest.name, host->name, err_str);
-		}
-	}
-	zbx_db_free_result(result);
-
-	if (0 != speed_download_num)
-		speed_download /= speed_download_num;
-
-	process_test_data(httptest->httptest.httptestid, lastfailedstep, speed_download, err_str, &ts);
-
-	zbx_free(buffer);
-	zbx_free(err_str);
-	zbx_preprocessor_flush();
-
+out:
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
 
@@ -1128,137 +1485,275 @@ httptest_error:
 int	process_httptests(int now, const char *config_source_ip, const char *config_ssl_ca_location,
 		const char *config_ssl_cert_location, const char *config_ssl_key_location, time_t *nextcheck)
 {
-	zbx_db_result_t		result;
-	zbx_db_row_t		row;
 	zbx_uint64_t		httptestid;
-	zbx_httptest_t		httptest;
-	zbx_dc_host_t		host;
+	zbx_httptest_session_t	session;
 	int			httptests_count = 0;
-	zbx_dc_um_handle_t	*um_handle;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
 	if (SUCCEED != zbx_dc_httptest_next(now, &httptestid, nextcheck))
 		goto out;
 
-	/* create macro cache to use in HTTP tests */
-	zbx_vector_ptr_pair_create(&httptest.macros);
-
 	do
 	{
-		int	delay = 0;
-
-		result = zbx_db_select(
-				"select h.hostid,h.host,h.name,t.httptestid,t.name,t.agent,"
-					"t.authentication,t.http_user,t.http_password,t.http_proxy,t.retries,"
-					"t.ssl_cert_file,t.ssl_key_file,t.ssl_key_password,t.verify_peer,"
-					"t.verify_host,t.delay"
-				" from httptest t,hosts h"
-				" where t.hostid=h.hostid"
-					" and t.httptestid=" ZBX_FS_UI64,
-				httptestid);
-
-		if (NULL != (row = zbx_db_fetch(result)))
-		{
-			ZBX_STR2UINT64(host.hostid, row[0]);
-			zbx_strscpy(host.host, row[1]);
-			zbx_strlcpy_utf8(host.name, row[2], sizeof(host.name));
+		if (SUCCEED != httptest_session_load(httptestid, &session))
+			continue;
 
-			ZBX_STR2UINT64(httptest.httptest.httptestid, row[3]);
-			httptest.httptest.name = row[4];
+		process_httptest(&session, config_source_ip, config_ssl_ca_location, config_ssl_cert_location,
+				config_ssl_key_location);
+		httptest_session_finish(&session, now);
+		httptest_session_clean(&session);
 
-			if (SUCCEED != httptest_load_pairs(&host, &httptest))
-			{
-				zabbix_log(LOG_LEVEL_WARNING, "cannot process web scenario \"%s\" on host \"%s\": "
-						"cannot load web scenario data", httptest.httptest.name, host.name);
-				zbx_db_free_result(result);
-				THIS_SHOULD_NEVER_HAPPEN;
-				continue;
-			}
+		httptests_count++;	/* performance metric */
+	}
+	while (ZBX_IS_RUNNING() && SUCCEED == zbx_dc_httptest_next(now, &httptestid, nextcheck));
+out:
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 
-			httptest.httptest.agent = zbx_strdup(NULL, row[5]);
-			zbx_substitute_simple_macros(NULL, NULL, NULL, NULL, &host.hostid, NULL, NULL, NULL, NULL, NULL,
-					NULL, NULL, &httptest.httptest.agent, ZBX_MACRO_TYPE_COMMON, NULL, 0);
+	return httptests_count;
+}
 
-			if (HTTPTEST_AUTH_NONE != (httptest.httptest.authentication = atoi(row[6])))
-			{
-				httptest.httptest.http_user = zbx_strdup(NULL, row[7]);
-				zbx_substitute_simple_macros_unmasked(NULL, NULL, NULL, NULL, &host.hostid, NULL, NULL,
-						NULL, NULL, NULL, NULL, NULL, &httptest.httptest.http_user,
-						ZBX_MACRO_TYPE_COMMON, NULL, 0);
-
-				httptest.httptest.http_password = zbx_strdup(NULL, row[8]);
-				zbx_substitute_simple_macros_unmasked(NULL, NULL, NULL, NULL, &host.hostid, NULL, NULL,
-						NULL, NULL, NULL, NULL, NULL, &httptest.httptest.http_password,
-						ZBX_MACRO_TYPE_COMMON, NULL, 0);
-			}
+#if defined(HAVE_LIBCURL) && defined(HAVE_LIBEVENT)
+/* maximum number of web scenarios processed concurrently by one HTTP poller */
+#define ZBX_HTTPTEST_MAX_CONCURRENT	100
 
-			if ('\0' != *row[9])
-			{
-				httptest.httptest.http_proxy = zbx_strdup(NULL, row[9]);
-				zbx_substitute_simple_macros(NULL, NULL, NULL, NULL, &host.hostid, NULL, NULL, NULL,
-						NULL, NULL, NULL, NULL, &httptest.httptest.http_proxy,
-						ZBX_MACRO_TYPE_COMMON, NULL, 0);
-			}
-			else
-				httptest.httptest.http_proxy = NULL;
+/******************************************************************************
+ *                                                                            *
+ * Purpose: finishes asynchronously processed web scenario                    *
+ *                                                                            *
+ ******************************************************************************/
+static void	httptest_async_finish(zbx_httptest_async_t *async, zbx_httptest_session_t *session)
+{
+	httptest_session_finish(session, async->now);
+	httptest_session_clean(session);
+	zbx_free(session);
 
-			httptest.httptest.retries = atoi(row[10]);
+	async->processing--;
+}
 
-			httptest.httptest.ssl_cert_file = zbx_strdup(NULL, row[11]);
-			httptest.httptest.ssl_key_file = zbx_strdup(NULL, row[12]);
+/******************************************************************************
+ *                                                                            *
+ * Purpose: prepares current web scenario step and adds it to cURL multi      *
+ *          handle                                                            *
+ *                                                                            *
+ * Parameters: async   - [IN] asynchronous web scenario processing data       *
+ *             session - [IN/OUT] web scenario execution state                *
+ *                                                                            *
+ * Return value: SUCCEED - step is being performed                            *
+ *               FAIL    - there are no more steps to perform or step failed, *
+ *                         web scenario must be finished                      *
+ *                                                                            *
+ ******************************************************************************/
+static int	httptest_async_step_start(zbx_httptest_async_t *async, zbx_httptest_session_t *session)
+{
+	CURLMcode	merr;
 
-			um_handle = zbx_dc_open_user_macros();
-			zbx_substitute_macros(&httptest.httptest.ssl_cert_file, NULL, 0, &macro_httptest_field_resolv,
-					um_handle, &host);
-			zbx_substitute_macros(&httptest.httptest.ssl_key_file, NULL, 0, &macro_httptest_field_resolv,
-					um_handle, &host);
-			zbx_dc_close_user_macros(um_handle);
+	if (session->steps.values_num == session->step_index || !ZBX_IS_RUNNING())
+		return FAIL;
+
+	if (SUCCEED != httpstep_prepare(session))
+	{
+		httpstep_clean(session);
+		return FAIL;
+	}
 
-			httptest.httptest.ssl_key_password = zbx_strdup(NULL, row[13]);
-			zbx_substitute_simple_macros_unmasked(NULL, NULL, NULL, NULL, &host.hostid, NULL, NULL, NULL,
-					NULL, NULL, NULL, NULL, &httptest.httptest.ssl_key_password,
-					ZBX_MACRO_TYPE_COMMON, NULL, 0);
+	httpstep_reset_response(session);
+
+	if (CURLM_OK != (merr = curl_multi_add_handle(async->asynchttppoller_config->curl_handle,
+			session->easyhandle)))
+	{
+		session->err_str = zbx_dsprintf(session->err_str, "Cannot add a standard curl handle to the multi"
+				" stack: %s", curl_multi_strerror(merr));
+		httpstep_clean(session);
+		return FAIL;
+	}
+
+	return SUCCEED;
+}
 
-			httptest.httptest.verify_peer = atoi(row[14]);
-			httptest.httptest.verify_host = atoi(row[15]);
+/******************************************************************************
+ *                                                                            *
+ * Purpose: takes due web scenarios from queue and starts their first steps   *
+ *          until concurrency limit is reached                                *
+ *                                                                            *
+ ******************************************************************************/
+static void	httptest_async_start(zbx_httptest_async_t *async)
+{
+	zbx_uint64_t	httptestid;
+	CURLcode	err;
 
-			httptest.httptest.delay = row[16];
+	while (ZBX_HTTPTEST_MAX_CONCURRENT > async->processing && ZBX_IS_RUNNING() &&
+			SUCCEED == zbx_dc_httptest_next(async->now, &httptestid, async->nextcheck))
+	{
+		zbx_httptest_session_t	*session;
 
-			/* add httptest variables to the current test macro cache */
-			http_process_variables(&httptest, &httptest.variables, NULL, NULL);
+		session = (zbx_httptest_session_t *)zbx_malloc(NULL, sizeof(zbx_httptest_session_t));
 
-			process_httptest(&host, &httptest, &delay, config_source_ip, config_ssl_ca_location,
-					config_ssl_cert_location, config_ssl_key_location);
-			zbx_dc_httptest_queue(now, httptestid, delay);
+		if (SUCCEED != httptest_session_load(httptestid, session))
+		{
+			zbx_free(session);
+			continue;
+		}
 
-			zbx_free(httptest.httptest.ssl_key_password);
-			zbx_free(httptest.httptest.ssl_key_file);
-			zbx_free(httptest.httptest.ssl_cert_file);
-			zbx_free(httptest.httptest.http_proxy);
+		zabbix_log(LOG_LEVEL_DEBUG, "%s() httptestid:" ZBX_FS_UI64 " name:'%s'", __func__, httptestid,
+				session->httptest.httptest.name);
 
-			if (HTTPTEST_AUTH_NONE != httptest.httptest.authentication)
-			{
-				zbx_free(httptest.httptest.http_password);
-				zbx_free(httptest.httptest.http_user);
-			}
-			zbx_free(httptest.httptest.agent);
-			zbx_free(httptest.headers);
-			httppairs_free(&httptest.variables);
+		async->processing++;
+		async->processed++;
 
-			/* clear the macro cache used in this HTTP test */
-			httptest_remove_macros(&httptest);
+		if (NULL != session->err_str || SUCCEED != httptest_session_init_curl(session,
+				async->config_source_ip, async->config_ssl_ca_location,
+				async->config_ssl_cert_location, async->config_ssl_key_location))
+		{
+			httptest_async_finish(async, session);
+			continue;
+		}
 
-			httptests_count++;	/* performance metric */
+		if (CURLE_OK != (err = curl_easy_setopt(session->easyhandle, CURLOPT_PRIVATE, session)))
+		{
+			session->err_str = zbx_dsprintf(session->err_str, "Cannot set pointer to private data: %s",
+					curl_easy_strerror(err));
+			httptest_async_finish(async, session);
+			continue;
 		}
-		zbx_db_free_result(result);
+
+		if (SUCCEED != httptest_async_step_start(async, session))
+			httptest_async_finish(async, session);
 	}
-	while (ZBX_IS_RUNNING() && SUCCEED == zbx_dc_httptest_next(now, &httptestid, nextcheck));
+}
 
-	/* destroy the macro cache used in HTTP tests */
-	zbx_vector_ptr_pair_destroy(&httptest.macros);
-out:
-	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
+/******************************************************************************
+ *                                                                            *
+ * Purpose: processes result of web scenario step and continues with the      *
+ *          next step                                                         *
+ *                                                                            *
+ * Parameters: easyhandle - [IN] cURL handle of the web scenario              *
+ *             err        - [IN] cURL transfer result                         *
+ *             arg        - [IN] asynchronous web scenario processing data    *
+ *                                                                            *
+ ******************************************************************************/
+static void	httptest_async_result(CURL *easyhandle, CURLcode err, void *arg)
+{
+	zbx_httptest_async_t	*async = (zbx_httptest_async_t *)arg;
+	zbx_httptest_session_t	*session;
+	CURLcode		err_info;
 
-	return httptests_count;
+	if (CURLE_OK != (err_info = curl_easy_getinfo(easyhandle, CURLINFO_PRIVATE, &session)))
+	{
+		THIS_SHOULD_NEVER_HAPPEN;
+		zabbix_log(LOG_LEVEL_CRIT, "Cannot get pointer to private data: %s", curl_easy_strerror(err_info));
+		return;
+	}
+
+	curl_multi_remove_handle(async->asynchttppoller_config->curl_handle, easyhandle);
+
+	if (CURLE_OK != err)
+	{
+		zbx_free(session->body.data);
+		zbx_free(session->header.data);
+
+		/* try to retrieve page several times depending on number of retries */
+		if (0 < --session->httptest.httptest.retries && ZBX_IS_RUNNING())
+		{
+			httpstep_reset_response(session);
+
+			if (CURLM_OK == curl_multi_add_handle(async->asynchttppoller_config->curl_handle, easyhandle))
+				return;
+		}
+	}
+
+	httpstep_process_response(session, err);
+	httpstep_clean(session);
+
+	if (NULL == session->err_str)
+	{
+		session->step_index++;
+
+		if (SUCCEED == httptest_async_step_start(async, session))
+			return;
+	}
+
+	httptest_async_finish(async, session);
+	httptest_async_start(async);
 }
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: initializes asynchronous web scenario processing                  *
+ *                                                                            *
+ * Parameters: async                    - [OUT]                               *
+ *             config_source_ip         - [IN]                                *
+ *             config_ssl_ca_location   - [IN]                                *
+ *             config_ssl_cert_location - [IN]                                *
+ *             config_ssl_key_location  - [IN]                                *
+ *             error                    - [OUT]                               *
+ *                                                                            *
+ * Return value: SUCCEED - initialized successfully                           *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ ******************************************************************************/
+int	httptest_async_init(zbx_httptest_async_t *async, const char *config_source_ip,
+		const char *config_ssl_ca_location, const char *config_ssl_cert_location,
+		const char *config_ssl_key_location, char **error)
+{
+	memset(async, 0, sizeof(zbx_httptest_async_t));
+
+	async->config_source_ip = config_source_ip;
+	async->config_ssl_ca_location = config_ssl_ca_location;
+	async->config_ssl_cert_location = config_ssl_cert_location;
+	async->config_ssl_key_location = config_ssl_key_location;
+
+	if (NULL == (async->base = event_base_new()))
+	{
+		*error = zbx_strdup(*error, "cannot initialize event base");
+		return FAIL;
+	}
+
+	if (NULL == (async->asynchttppoller_config = zbx_async_httpagent_create(async->base, httptest_async_result,
+			NULL, async, error)))
+	{
+		event_base_free(async->base);
+		return FAIL;
+	}
+
+	return SUCCEED;
+}
+
+void	httptest_async_destroy(zbx_httptest_async_t *async)
+{
+	zbx_async_httpagent_clean(async->asynchttppoller_config);
+	zbx_free(async->asynchttppoller_config);
+	event_base_free(async->base);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: processes due web scenarios concurrently, each scenario steps     *
+ *          are performed one after another                                   *
+ *                                                                            *
+ * Parameters: async     - [IN] asynchronous web scenario processing data     *
+ *             now       - [IN] current timestamp                             *
+ *             nextcheck - [OUT]                                              *
+ *                                                                            *
+ * Return value: number of processed httptests                                *
+ *                                                                            *
+ ******************************************************************************/
+int	process_httptests_async(zbx_httptest_async_t *async, int now, time_t *nextcheck)
+{
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
+
+	async->now = now;
+	async->nextcheck = nextcheck;
+	async->processed = 0;
+
+	httptest_async_start(async);
+
+	while (0 != async->processing)
+		event_base_loop(async->base, EVLOOP_ONCE);
+
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s() processed:%d", __func__, async->processed);
+
+	return async->processed;
+}
+#undef ZBX_HTTPTEST_MAX_CONCURRENT
+#endif
@@ -20,4 +20,29 @@
 int	process_httptests(int now, const char *config_source_ip, const char *config_ssl_ca_location,
 		const char *config_ssl_cert_location, const char *config_ssl_key_location, time_t *nextcheck);
 
+#if defined(HAVE_LIBCURL) && defined(HAVE_LIBEVENT)
+#include "zbxasynchttppoller.h"
+
+typedef struct
+{
+	struct event_base		*base;
+	zbx_asynchttppoller_config	*asynchttppoller_config;
+	const char			*config_source_ip;
+	const char			*config_ssl_ca_location;
+	const char			*config_ssl_cert_location;
+	const char			*config_ssl_key_location;
+	time_t				*nextcheck;
+	int				now;
+	int				processing;
+	int				processed;
+}
+zbx_httptest_async_t;
+
+int	httptest_async_init(zbx_httptest_async_t *async, const char *config_source_ip,
+		const char *config_ssl_ca_location, const char *config_ssl_cert_location,
+		const char *config_ssl_key_location, char **error);
+void	httptest_async_destroy(zbx_httptest_async_t *async);
+int	process_httptests_async(zbx_httptest_async_t *async, int now, time_t *nextcheck);
+#endif
+
 #endif
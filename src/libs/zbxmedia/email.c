@@ -707,82 +707,150 @@ out:
 #define SMTP_SECURITY_STARTTLS	1
 #define SMTP_SECURITY_SSL	2
 
-static int	send_email_curl(const char *smtp_server, unsigned short smtp_port, const char *smtp_helo,
-		zbx_vector_ptr_t *from_mails, zbx_vector_ptr_t *to_mails, const char *inreplyto,
-		const char *mailsubject, const char *mailbody, unsigned char smtp_security, unsigned char
-		smtp_verify_peer, unsigned char smtp_verify_host, unsigned char smtp_authentication,
-		const char *username, const char *password, unsigned char message_format, int timeout,
-		const char *config_source_ip, const char *config_ssl_ca_location, char **error)
-{
 #ifdef HAVE_LIBCURL
-	int			ret = FAIL, i;
-	CURL			*easyhandle;
-	CURLcode		err;
-	char			url[MAX_STRING_LEN], errbuf[CURL_ERROR_SIZE] = "";
-	size_t			url_offset= 0;
-	struct curl_slist	*recipients = NULL;
-	smtp_payload_status_t	payload_status;
+/* idle time after which cached SMTP session is not reused, as server could have closed it */
+#define ZBX_SMTP_SESSION_IDLE_MAX	SEC_PER_MIN
 
-	if (SMTP_SECURITY_NONE != smtp_security && SUCCEED != zbx_curl_has_ssl(error))
-		goto out;
+/* maximum number of SMTP sessions cached by process */
+#define ZBX_SMTP_SESSIONS_MAX		16
 
-	if (SMTP_AUTHENTICATION_NONE != smtp_authentication && SUCCEED != zbx_curl_has_smtp_auth(error))
-		goto out;
+/* SMTP session, keeping the cURL handle with its open connection to SMTP server between sent emails */
+typedef struct
+{
+	char	*key;
+	CURL	*easyhandle;
+	time_t	lastused;
+}
+zbx_smtp_session_t;
 
-	if (NULL == (easyhandle = curl_easy_init()))
-	{
-		*error = zbx_strdup(*error, "cannot initialize cURL library");
-		goto out;
-	}
+ZBX_PTR_VECTOR_DECL(smtp_session_ptr, zbx_smtp_session_t *)
+ZBX_PTR_VECTOR_IMPL(smtp_session_ptr, zbx_smtp_session_t *)
 
-	memset(&payload_status, 0, sizeof(payload_status));
+static zbx_vector_smtp_session_ptr_t	*smtp_sessions = NULL;
 
-	if (SMTP_SECURITY_SSL == smtp_security)
-	{
-		if (SUCCEED != zbx_curl_protocol("smtps", error))
-			goto clean;
+static void	smtp_session_free(zbx_smtp_session_t *session)
+{
+	curl_easy_cleanup(session->easyhandle);
+	zbx_free(session->key);
+	zbx_free(session);
+}
 
-		url_offset += zbx_snprintf(url + url_offset, sizeof(url) - url_offset, "smtps://");
-	}
-	else
-		url_offset += zbx_snprintf(url + url_offset, sizeof(url) - url_offset, "smtp://");
+/******************************************************************************
+ *                                                                            *
+ * Purpose: closes cached SMTP session                                        *
+ *                                                                            *
+ * Parameters: session - [IN]                                                 *
+ *                                                                            *
+ ******************************************************************************/
+static void	smtp_session_close(zbx_smtp_session_t *session)
+{
+	int	i;
 
-	url_offset += zbx_snprintf(url + url_offset, sizeof(url) - url_offset, "%s:%hu", smtp_server, smtp_port);
+	if (FAIL != (i = zbx_vector_smtp_session_ptr_search(smtp_sessions, session, ZBX_DEFAULT_PTR_COMPARE_FUNC)))
+		zbx_vector_smtp_session_ptr_remove_noorder(smtp_sessions, i);
 
-	if ('\0' != *smtp_helo)
+	smtp_session_free(session);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets cached SMTP session or creates new one                       *
+ *                                                                            *
+ * Parameters: key    - [IN] session key, identifying SMTP server and         *
+ *                           connection settings                              *
+ *             now    - [IN] current timestamp                                *
+ *             reused - [OUT] SUCCEED - cached session is returned            *
+ *                            FAIL    - new session was created               *
+ *                                                                            *
+ * Return value: SMTP session or NULL if cURL handle cannot be initialized.   *
+ *                                                                            *
+ * Comments: Sessions idle for more than ZBX_SMTP_SESSION_IDLE_MAX seconds    *
+ *           are closed. When session cache is full the least recently used   *
+ *           session is closed.                                               *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_smtp_session_t	*smtp_session_get(const char *key, time_t now, int *reused)
+{
+	zbx_smtp_session_t	*session;
+	CURL			*easyhandle;
+	int			oldest = -1;
+
+	if (NULL == smtp_sessions)
 	{
-		zbx_snprintf(url + url_offset, sizeof(url) - url_offset, "/%s", smtp_helo);
+		smtp_sessions = (zbx_vector_smtp_session_ptr_t *)zbx_malloc(NULL, sizeof(zbx_vector_smtp_session_ptr_t));
+		zbx_vector_smtp_session_ptr_create(smtp_sessions);
 	}
-	else
+
+	for (int i = 0; i < smtp_sessions->values_num;)
 	{
-		char	*helo_domain = NULL;
+		session = smtp_sessions->values[i];
 
-		if (0 != from_mails->values_num)
+		if (session->lastused + ZBX_SMTP_SESSION_IDLE_MAX < now)
 		{
-			if (NULL == (helo_domain =
-					smtp_get_helo_from_addr(((zbx_mailaddr_t *)from_mails->values[0])->addr)))
-			{
-				zabbix_log(LOG_LEVEL_DEBUG, "%s() HELO is not specified and failed to parse HELO "
-						"from email address, trying to form HELO command using system's "
-						"hostname", __func__);
-			}
+			zbx_vector_smtp_session_ptr_remove_noorder(smtp_sessions, i);
+			smtp_session_free(session);
+			continue;
 		}
 
-		if (NULL == helo_domain)
+		if (0 == strcmp(session->key, key))
 		{
-			if (NULL == (helo_domain = smtp_get_helo_from_system()))
-			{
-				*error = zbx_strdup(*error, "failed to retrieve domain name for HELO command");
-				goto clean;
-			}
+			*reused = SUCCEED;
+			return session;
 		}
 
-		zbx_snprintf(url + url_offset, sizeof(url) - url_offset, "/%s", helo_domain);
-		zbx_free(helo_domain);
+		if (-1 == oldest || session->lastused < smtp_sessions->values[oldest]->lastused)
+			oldest = i;
+
+		i++;
+	}
+
+	if (NULL == (easyhandle = curl_easy_init()))
+		return NULL;
+
+	if (ZBX_SMTP_SESSIONS_MAX <= smtp_sessions->values_num)
+	{
+		smtp_session_free(smtp_sessions->values[oldest]);
+		zbx_vector_smtp_session_ptr_remove_noorder(smtp_sessions, oldest);
 	}
 
+	session = (zbx_smtp_session_t *)zbx_malloc(NULL, sizeof(zbx_smtp_session_t));
+	session->key = zbx_strdup(NULL, key);
+	session->easyhandle = easyhandle;
+	session->lastused = now;
+	zbx_vector_smtp_session_ptr_append(smtp_sessions, session);
+
+	*reused = FAIL;
+
+	return session;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: sets cURL options to send email                                   *
+ *                                                                            *
+ * Parameters: easyhandle     - [IN] cURL handle                              *
+ *             url            - [IN] SMTP server url                          *
+ *             ...            - [IN] SMTP and email settings                  *
+ *             recipients     - [IN] list of recipient addresses              *
+ *             payload_status - [IN] email payload                            *
+ *             fresh_connect  - [IN] 1 - use new connection to SMTP server    *
+ *             errbuf         - [IN] cURL error buffer                        *
+ *             error          - [OUT] error message in case of failure        *
+ *                                                                            *
+ * Return value: SUCCEED - the options were set successfully                  *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ ******************************************************************************/
+static int	smtp_session_setopt(CURL *easyhandle, const char *url, zbx_vector_ptr_t *from_mails,
+		unsigned char smtp_security, unsigned char smtp_verify_peer, unsigned char smtp_verify_host,
+		unsigned char smtp_authentication, const char *username, const char *password, int timeout,
+		const char *config_source_ip, const char *config_ssl_ca_location, struct curl_slist *recipients,
+		smtp_payload_status_t *payload_status, int fresh_connect, char *errbuf, char **error)
+{
+	CURLcode	err;
+
 	if (SUCCEED != zbx_curl_setopt_smtps(easyhandle, error))
-		goto clean;
+		return FAIL;
 
 	if (CURLE_OK != (err = curl_easy_setopt(easyhandle, CURLOPT_URL, url)))
 		goto error;
@@ -839,21 +907,15 @@ static int	send_email_curl(const char *smtp_server, unsigned short smtp_port, co
 	if (CURLE_OK != (err = curl_easy_setopt(easyhandle, CURLOPT_ACCEPT_ENCODING, "")))
 		goto error;
 
-	for (i = 0; i < to_mails->values_num; i++)
-		recipients = curl_slist_append(recipients, ((zbx_mailaddr_t *)to_mails->values[i])->addr);
-
 	if (CURLE_OK != (err = curl_easy_setopt(easyhandle, CURLOPT_MAIL_RCPT, recipients)))
 		goto error;
 
-	payload_status.payload = smtp_prepare_payload(from_mails, to_mails, inreplyto, mailsubject, mailbody,
-			message_format);
-	payload_status.payload_len = strlen(payload_status.payload);
-
 	if (CURLE_OK != (err = curl_easy_setopt(easyhandle, CURLOPT_UPLOAD, 1L)) ||
 			CURLE_OK != (err = curl_easy_setopt(easyhandle, CURLOPT_READFUNCTION, smtp_provide_payload)) ||
-			CURLE_OK != (err = curl_easy_setopt(easyhandle, CURLOPT_READDATA, &payload_status)) ||
+			CURLE_OK != (err = curl_easy_setopt(easyhandle, CURLOPT_READDATA, payload_status)) ||
 			CURLE_OK != (err = curl_easy_setopt(easyhandle, CURLOPT_TIMEOUT, (long)timeout)) ||
-			CURLE_OK != (err = curl_easy_setopt(easyhandle, CURLOPT_ERRORBUFFER, errbuf)))
+			CURLE_OK != (err = curl_easy_setopt(easyhandle, CURLOPT_ERRORBUFFER, errbuf)) ||
+			CURLE_OK != (err = curl_easy_setopt(easyhandle, CURLOPT_FRESH_CONNECT, (long)fresh_connect)))
 	{
 		goto error;
 	}
@@ -873,24 +935,159 @@ static int	send_email_curl(const char *smtp_server, unsigned short smtp_port, co
 			goto error;
 	}
 
-	if (CURLE_OK != (err = curl_easy_perform(easyhandle)))
+	return SUCCEED;
+error:
+	*error = zbx_strdup(*error, curl_easy_strerror(err));
+
+	return FAIL;
+}
+#endif
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: sends email with cURL                                             *
+ *                                                                            *
+ * Comments: The cURL handle is cached with open connection to SMTP server,   *
+ *           so subsequent emails sent through the same server with the same  *
+ *           settings skip connecting, EHLO, STARTTLS and authentication.     *
+ *           If a cached connection fails before message data was sent, the   *
+ *           email is sent again through a new connection.                    *
+ *                                                                            *
+ ******************************************************************************/
+static int	send_email_curl(const char *smtp_server, unsigned short smtp_port, const char *smtp_helo,
+		zbx_vector_ptr_t *from_mails, zbx_vector_ptr_t *to_mails, const char *inreplyto,
+		const char *mailsubject, const char *mailbody, unsigned char smtp_security, unsigned char
+		smtp_verify_peer, unsigned char smtp_verify_host, unsigned char smtp_authentication,
+		const char *username, const char *password, unsigned char message_format, int timeout,
+		const char *config_source_ip, const char *config_ssl_ca_location, char **error)
+{
+#ifdef HAVE_LIBCURL
+	int			ret = FAIL, reused, fresh_connect = 0;
+	CURLcode		err;
+	char			url[MAX_STRING_LEN], errbuf[CURL_ERROR_SIZE] = "", *key;
+	size_t			url_offset= 0;
+	struct curl_slist	*recipients = NULL;
+	smtp_payload_status_t	payload_status;
+	zbx_smtp_session_t	*session;
+
+	if (SMTP_SECURITY_NONE != smtp_security && SUCCEED != zbx_curl_has_ssl(error))
+		goto out;
+
+	if (SMTP_AUTHENTICATION_NONE != smtp_authentication && SUCCEED != zbx_curl_has_smtp_auth(error))
+		goto out;
+
+	if (SMTP_SECURITY_SSL == smtp_security)
 	{
+		if (SUCCEED != zbx_curl_protocol("smtps", error))
+			goto out;
+
+		url_offset += zbx_snprintf(url + url_offset, sizeof(url) - url_offset, "smtps://");
+	}
+	else
+		url_offset += zbx_snprintf(url + url_offset, sizeof(url) - url_offset, "smtp://");
+
+	url_offset += zbx_snprintf(url + url_offset, sizeof(url) - url_offset, "%s:%hu", smtp_server, smtp_port);
+
+	if ('\0' != *smtp_helo)
+	{
+		zbx_snprintf(url + url_offset, sizeof(url) - url_offset, "/%s", smtp_helo);
+	}
+	else
+	{
+		char	*helo_domain = NULL;
+
+		if (0 != from_mails->values_num)
+		{
+			if (NULL == (helo_domain =
+					smtp_get_helo_from_addr(((zbx_mailaddr_t *)from_mails->values[0])->addr)))
+			{
+				zabbix_log(LOG_LEVEL_DEBUG, "%s() HELO is not specified and failed to parse HELO "
+						"from email address, trying to form HELO command using system's "
+						"hostname", __func__);
+			}
+		}
+
+		if (NULL == helo_domain)
+		{
+			if (NULL == (helo_domain = smtp_get_helo_from_system()))
+			{
+				*error = zbx_strdup(*error, "failed to retrieve domain name for HELO command");
+				goto out;
+			}
+		}
+
+		zbx_snprintf(url + url_offset, sizeof(url) - url_offset, "/%s", helo_domain);
+		zbx_free(helo_domain);
+	}
+
+	key = zbx_dsprintf(NULL, "%s\n%d\n%d\n%d\n%d\n%s\n%s", url, (int)smtp_security, (int)smtp_verify_peer,
+			(int)smtp_verify_host, (int)smtp_authentication, ZBX_NULL2EMPTY_STR(username),
+			ZBX_NULL2EMPTY_STR(password));
+	session = smtp_session_get(key, time(NULL), &reused);
+	zbx_free(key);
+
+	if (NULL == session)
+	{
+		*error = zbx_strdup(*error, "cannot initialize cURL library");
+		goto out;
+	}
+
+	for (int i = 0; i < to_mails->values_num; i++)
+		recipients = curl_slist_append(recipients, ((zbx_mailaddr_t *)to_mails->values[i])->addr);
+
+	memset(&payload_status, 0, sizeof(payload_status));
+	payload_status.payload = smtp_prepare_payload(from_mails, to_mails, inreplyto, mailsubject, mailbody,
+			message_format);
+	payload_status.payload_len = strlen(payload_status.payload);
+
+	while (1)
+	{
+		curl_easy_reset(session->easyhandle);
+		payload_status.provided_len = 0;
+		*errbuf = '\0';
+
+		if (SUCCEED != smtp_session_setopt(session->easyhandle, url, from_mails, smtp_security,
+				smtp_verify_peer, smtp_verify_host, smtp_authentication, username, password, timeout,
+				config_source_ip, config_ssl_ca_location, recipients, &payload_status, fresh_connect,
+				errbuf, error))
+		{
+			break;
+		}
+
+		if (CURLE_OK == (err = curl_easy_perform(session->easyhandle)))
+		{
+			ret = SUCCEED;
+			break;
+		}
+
+		/* the cached connection could have been closed by server, retry with new connection */
+		if (SUCCEED == reused && 0 == fresh_connect && 0 == payload_status.provided_len)
+		{
+			zabbix_log(LOG_LEVEL_DEBUG, "%s() cannot send email through cached connection: %s%s%s",
+					__func__, curl_easy_strerror(err), ('\0' != *errbuf ? ": " : ""), errbuf);
+			fresh_connect = 1;
+			continue;
+		}
+
 		*error = zbx_dsprintf(*error, "%s%s%s", curl_easy_strerror(err), ('\0' != *errbuf ? ": " : ""),
 				errbuf);
-		goto clean;
+		break;
 	}
 
-	ret = SUCCEED;
-	goto clean;
-error:
-	*error = zbx_strdup(*error, curl_easy_strerror(err));
-clean:
-	zbx_free(payload_status.payload);
+	if (SUCCEED == ret)
+	{
+		/* reset options referring to the freed email data, the connection is kept open */
+		curl_easy_reset(session->easyhandle);
+		session->lastused = time(NULL);
+	}
+	else
+		smtp_session_close(session);
 
+	zbx_free(payload_status.payload);
 	curl_slist_free_all(recipients);
-	curl_easy_cleanup(easyhandle);
 out:
 	return ret;
+
 #else
 	ZBX_UNUSED(smtp_server);
 	ZBX_UNUSED(smtp_port);
@@ -43,6 +43,7 @@
 #include "zbxtime.h"
 #include "zbxtypes.h"
 #include "zbxasyncpoller.h"
+#include "zbxstr.h"
 
 #include <event2/dns.h>
 
@@ -136,11 +137,140 @@ static void	process_snmp_result(void *data)
 {
 	zbx_snmp_context_t	*snmp_context = (zbx_snmp_context_t *)data;
 	zbx_poller_config_t	*poller_config = (zbx_poller_config_t *)zbx_async_check_snmp_get_arg(snmp_context);
+	zbx_dc_item_context_t	*shared_items;
+	int			shared_items_num;
+
+	zbx_async_check_snmp_fan_out(snmp_context, &shared_items, &shared_items_num);
+
+	for (int i = 0; i < shared_items_num; i++)
+		process_async_result(&shared_items[i], poller_config);
 
 	process_async_result(zbx_async_check_snmp_get_item_context(snmp_context), poller_config);
 
 	zbx_async_check_snmp_clean(snmp_context);
 }
+
+typedef struct
+{
+	const zbx_dc_item_t	*item;
+	int			index;
+	int			last;
+	int			num;
+}
+zbx_snmp_request_t;
+
+/* OIDs of GET items are coalesced into single PDU, other requests can be shared only if OIDs are identical */
+static int	snmp_request_is_get(const zbx_dc_item_t *item)
+{
+	return 0 == strncmp(item->snmp_oid, "get[", ZBX_CONST_STRLEN("get[")) ? SUCCEED : FAIL;
+}
+
+static zbx_hash_t	snmp_request_hash(const void *data)
+{
+	const zbx_snmp_request_t	*request = (const zbx_snmp_request_t *)data;
+	zbx_hash_t			hash;
+
+	hash = ZBX_DEFAULT_UINT64_HASH_FUNC(&request->item->interface.interfaceid);
+
+	if (SUCCEED == snmp_request_is_get(request->item))
+		return hash;
+
+	return ZBX_DEFAULT_STRING_HASH_ALGO(request->item->snmp_oid, strlen(request->item->snmp_oid), hash);
+}
+
+static int	snmp_request_compare(const void *d1, const void *d2)
+{
+	const zbx_dc_item_t	*item1 = ((const zbx_snmp_request_t *)d1)->item;
+	const zbx_dc_item_t	*item2 = ((const zbx_snmp_request_t *)d2)->item;
+	int			ret, is_get;
+
+	ZBX_RETURN_IF_NOT_EQUAL(item1->interface.interfaceid, item2->interface.interfaceid);
+
+	is_get = snmp_request_is_get(item1);
+	ZBX_RETURN_IF_NOT_EQUAL(is_get, snmp_request_is_get(item2));
+	ZBX_RETURN_IF_NOT_EQUAL(item1->snmp_version, item2->snmp_version);
+	ZBX_RETURN_IF_NOT_EQUAL(item1->snmp_max_repetitions, item2->snmp_max_repetitions);
+	ZBX_RETURN_IF_NOT_EQUAL(item1->timeout, item2->timeout);
+	ZBX_RETURN_IF_NOT_EQUAL(item1->snmpv3_securitylevel, item2->snmpv3_securitylevel);
+	ZBX_RETURN_IF_NOT_EQUAL(item1->snmpv3_authprotocol, item2->snmpv3_authprotocol);
+	ZBX_RETURN_IF_NOT_EQUAL(item1->snmpv3_privprotocol, item2->snmpv3_privprotocol);
+
+	if (SUCCEED != is_get && 0 != (ret = strcmp(item1->snmp_oid, item2->snmp_oid)))
+		return ret;
+
+	if (0 != (ret = zbx_strcmp_null(item1->snmp_community, item2->snmp_community)))
+		return ret;
+
+	if (0 != (ret = zbx_strcmp_null(item1->snmpv3_securityname, item2->snmpv3_securityname)))
+		return ret;
+
+	if (0 != (ret = zbx_strcmp_null(item1->snmpv3_contextname, item2->snmpv3_contextname)))
+		return ret;
+
+	if (0 != (ret = zbx_strcmp_null(item1->snmpv3_authpassphrase, item2->snmpv3_authpassphrase)))
+		return ret;
+
+	return zbx_strcmp_null(item1->snmpv3_privpassphrase, item2->snmpv3_privpassphrase);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: groups SNMP items of the batch sending identical requests or GET  *
+ *          requests with the same credentials to the same interface          *
+ *                                                                            *
+ * Parameters: items    - [IN] batch items                                    *
+ *             errcodes - [IN] item error codes                               *
+ *             num      - [IN] number of items in batch                       *
+ *             leaders  - [OUT] index of the item performing request for the  *
+ *                              item                                          *
+ *             next     - [OUT] index of the next item sharing request of the *
+ *                              leader item or -1                             *
+ *                                                                            *
+ * Comments: Only the leader item performs the request, its result is fanned  *
+ *           out to the rest of the group. Items are due in the same poller   *
+ *           window, so walking the same subtree once for all of them is      *
+ *           enough. OIDs of GET items are requested in the same PDU, so the  *
+ *           group size is limited by maximum number of PDU variables.        *
+ *                                                                            *
+ ******************************************************************************/
+static void	snmp_requests_group(const zbx_dc_item_t *items, const int *errcodes, int num, int *leaders,
+		int *next)
+{
+	zbx_hashset_t	requests;
+
+	zbx_hashset_create(&requests, (size_t)num, snmp_request_hash, snmp_request_compare);
+
+	for (int i = 0; i < num; i++)
+	{
+		zbx_snmp_request_t	*request, request_local = {.item = &items[i], .index = i, .last = i, .num = 1};
+
+		leaders[i] = i;
+		next[i] = -1;
+
+		if (SUCCEED != errcodes[i] || ITEM_TYPE_SNMP != items[i].type || NULL == items[i].snmp_oid)
+			continue;
+
+		if (NULL == (request = (zbx_snmp_request_t *)zbx_hashset_search(&requests, &request_local)))
+		{
+			zbx_hashset_insert(&requests, &request_local, sizeof(request_local));
+			continue;
+		}
+
+		/* start new group, the item becomes leader of the following items */
+		if (ZBX_MAX_SNMP_ITEMS <= request->num)
+		{
+			*request = request_local;
+			continue;
+		}
+
+		leaders[i] = request->index;
+		next[request->last] = i;
+		request->last = i;
+		request->num++;
+	}
+
+	zbx_hashset_destroy(&requests);
+}
 #endif
 #ifdef HAVE_LIBCURL
 static void	process_httpagent_result(CURL *easy_handle, CURLcode err, void *arg)
@@ -226,6 +356,10 @@ static void	async_initiate_queued_checks(zbx_poller_config_t *poller_config, con
 	int				*errcodes, total = 0;
 	zbx_timespec_t			timespec;
 	zbx_vector_poller_item_t	poller_items;
+#ifdef HAVE_NETSNMP
+	int				*leaders = NULL, *next = NULL, items_alloc = 0;
+	zbx_dc_item_t			**shared_items = NULL;
+#endif
 
 	zbx_vector_poller_item_create(&poller_items);
 #ifdef HAVE_NETSNMP
@@ -262,7 +396,18 @@ static void	async_initiate_queued_checks(zbx_poller_config_t *poller_config, con
 		num = poller_items.values[j]->num;
 
 		total += num;
+#ifdef HAVE_NETSNMP
+		if (items_alloc < num)
+		{
+			items_alloc = num;
+			leaders = (int *)zbx_realloc(leaders, sizeof(int) * (size_t)items_alloc);
+			next = (int *)zbx_realloc(next, sizeof(int) * (size_t)items_alloc);
+			shared_items = (zbx_dc_item_t **)zbx_realloc(shared_items,
+					sizeof(zbx_dc_item_t *) * (size_t)items_alloc);
+		}
 
+		snmp_requests_group(items, errcodes, num, leaders, next);
+#endif
 		for (int i = 0; i < num; i++)
 		{
 			if (SUCCEED != errcodes[i])
@@ -291,12 +436,59 @@ static void	async_initiate_queued_checks(zbx_poller_config_t *poller_config, con
 			else
 			{
 	#ifdef HAVE_NETSNMP
-				zbx_set_snmp_bulkwalk_options(zbx_progname);
+				int	shared_items_num = 0;
 
-				errcodes[i] = zbx_async_check_snmp(&items[i], &results[i], process_snmp_result,
-						poller_config, poller_config, poller_config->base,
-						poller_config->dnsbase, poller_config->config_source_ip,
-						ZABBIX_ASYNC_RESOLVE_REVERSE_DNS_NO, ZBX_SNMP_DEFAULT_NUMBER_OF_RETRIES);
+				/* GET item with other OID than the failed leader cannot share its error, */
+				/* so it becomes the leader of the remaining items with different OIDs     */
+				if (i != leaders[i] && SUCCEED != errcodes[leaders[i]] &&
+						0 != strcmp(items[i].snmp_oid, items[leaders[i]].snmp_oid))
+				{
+					int	leader = leaders[i];
+
+					for (int k = next[i]; -1 != k; k = next[k])
+					{
+						if (leader == leaders[k] && 0 != strcmp(items[k].snmp_oid,
+								items[leader].snmp_oid))
+						{
+							leaders[k] = i;
+						}
+					}
+
+					leaders[i] = i;
+				}
+
+				/* item result will be provided by the leader item of the same request */
+				if (i != leaders[i])
+				{
+					/* shared items are counted as processing when leader request is started */
+					if (SUCCEED == (errcodes[i] = errcodes[leaders[i]]))
+						continue;
+
+					SET_MSG_RESULT(&results[i], zbx_strdup(NULL,
+							ZBX_NULL2EMPTY_STR(results[leaders[i]].msg)));
+				}
+				else
+				{
+					for (int k = next[i]; -1 != k; k = next[k])
+					{
+						if (i == leaders[k])
+							shared_items[shared_items_num++] = &items[k];
+					}
+
+					zbx_set_snmp_bulkwalk_options(zbx_progname);
+
+					/* each shared item result is processed separately by process_snmp_result() */
+					if (SUCCEED == (errcodes[i] = zbx_async_check_snmp(&items[i], &results[i],
+							process_snmp_result, poller_config, poller_config,
+							poller_config->base, poller_config->dnsbase,
+							poller_config->config_source_ip,
+							ZABBIX_ASYNC_RESOLVE_REVERSE_DNS_NO,
+							ZBX_SNMP_DEFAULT_NUMBER_OF_RETRIES, shared_items,
+							shared_items_num)))
+					{
+						poller_config->processing += shared_items_num;
+					}
+				}
 	#else
 				errcodes[i] = NOTSUPPORTED;
 				SET_MSG_RESULT(&results[i], zbx_strdup(NULL, "Support for SNMP checks was not compiled"
@@ -330,6 +522,9 @@ static void	async_initiate_queued_checks(zbx_poller_config_t *poller_config, con
 		zbx_poller_item_free(poller_items.values[j]);
 	}
 #ifdef HAVE_NETSNMP
+	zbx_free(shared_items);
+	zbx_free(next);
+	zbx_free(leaders);
 exit:
 #endif
 	if (0 != total)
@@ -150,6 +150,8 @@ typedef struct
 	void			*arg;
 	char			*error;
 	netsnmp_large_fd_set	fdset;
+	zbx_dc_item_context_t	*item_context;	/* shared item receiving value of coalesced GET, */
+						/* NULL for OIDs of the leader item              */
 }
 zbx_bulkwalk_context_t;
 
@@ -161,8 +163,17 @@ struct zbx_snmp_context
 	void				*arg;
 	void				*arg_action;
 	zbx_dc_item_context_t		item;
+	zbx_dc_item_context_t		*shared_items;
+	int				*shared_items_source;	/* index of shared item providing result, */
+								/* -1 for leader item                     */
+	int				shared_items_num;
+	int				get_coalesced;
+	int				get_vars_max;
+	int				pdu_vars_num;
+	char				*get_error;
 	zbx_snmp_sess_t			ssp;
 	int				snmp_max_repetitions;
+	int				snmp_max_repetitions_conf;
 	int				retries;
 	char				*results;
 	size_t				results_alloc;
@@ -205,6 +216,17 @@ static char				snmp_rwlock_init_done;
 static zbx_hashset_t	engineid_cache;
 static int		engineid_cache_initialized = 0;
 
+typedef struct
+{
+	zbx_uint64_t	interfaceid;
+	int		max_repetitions;
+	time_t		lastaccess;
+}
+zbx_snmp_repetitions_t;
+
+static ZBX_THREAD_LOCAL zbx_hashset_t	snmp_repetitions;	/* max-repetitions learned from tooBig errors */
+static ZBX_THREAD_LOCAL int		snmp_repetitions_init_done;
+
 #define ZBX_SNMP_GET	0
 #define ZBX_SNMP_WALK	1
 
@@ -2450,6 +2472,97 @@ static int	snmp_native_quote_string_value(char *buffer, size_t buffer_size, char
 	return SUCCEED;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets max-repetitions value for GETBULK requests to the interface  *
+ *                                                                            *
+ * Parameters: interfaceid     - [IN]                                         *
+ *             max_repetitions - [IN] configured max-repetitions value        *
+ *                                                                            *
+ * Return value: The configured value or lower value learned from previous    *
+ *               tooBig responses of the interface.                           *
+ *                                                                            *
+ ******************************************************************************/
+static int	snmp_repetitions_get(zbx_uint64_t interfaceid, int max_repetitions)
+{
+#define ZBX_SNMP_REPETITIONS_HK_PERIOD		SEC_PER_HOUR
+#define ZBX_SNMP_REPETITIONS_RETENTION_PERIOD	SEC_PER_DAY
+	static ZBX_THREAD_LOCAL time_t	lastcheck;
+	zbx_snmp_repetitions_t		*repetitions;
+	time_t				now;
+
+	if (0 == snmp_repetitions_init_done)
+		return max_repetitions;
+
+	now = time(NULL);
+
+	if (lastcheck + ZBX_SNMP_REPETITIONS_HK_PERIOD <= now)
+	{
+		zbx_hashset_iter_t	iter;
+
+		zbx_hashset_iter_reset(&snmp_repetitions, &iter);
+		while (NULL != (repetitions = (zbx_snmp_repetitions_t *)zbx_hashset_iter_next(&iter)))
+		{
+			if (repetitions->lastaccess + ZBX_SNMP_REPETITIONS_RETENTION_PERIOD <= now)
+				zbx_hashset_iter_remove(&iter);
+		}
+
+		lastcheck = now;
+	}
+
+	if (NULL == (repetitions = (zbx_snmp_repetitions_t *)zbx_hashset_search(&snmp_repetitions, &interfaceid)))
+		return max_repetitions;
+
+	repetitions->lastaccess = now;
+
+	return MIN(repetitions->max_repetitions, max_repetitions);
+#undef ZBX_SNMP_REPETITIONS_HK_PERIOD
+#undef ZBX_SNMP_REPETITIONS_RETENTION_PERIOD
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: remembers max-repetitions value accepted by the interface         *
+ *                                                                            *
+ * Parameters: interfaceid          - [IN]                                    *
+ *             max_repetitions      - [IN] accepted max-repetitions value     *
+ *             max_repetitions_conf - [IN] configured max-repetitions value   *
+ *                                                                            *
+ ******************************************************************************/
+static void	snmp_repetitions_set(zbx_uint64_t interfaceid, int max_repetitions, int max_repetitions_conf)
+{
+	zbx_snmp_repetitions_t	*repetitions;
+
+	if (0 == interfaceid)
+		return;
+
+	if (max_repetitions >= max_repetitions_conf)
+	{
+		if (0 != snmp_repetitions_init_done)
+			zbx_hashset_remove(&snmp_repetitions, &interfaceid);
+
+		return;
+	}
+
+	if (0 == snmp_repetitions_init_done)
+	{
+		zbx_hashset_create(&snmp_repetitions, 100, ZBX_DEFAULT_UINT64_HASH_FUNC,
+				ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+		snmp_repetitions_init_done = 1;
+	}
+
+	if (NULL == (repetitions = (zbx_snmp_repetitions_t *)zbx_hashset_search(&snmp_repetitions, &interfaceid)))
+	{
+		zbx_snmp_repetitions_t	repetitions_local = {.interfaceid = interfaceid};
+
+		repetitions = (zbx_snmp_repetitions_t *)zbx_hashset_insert(&snmp_repetitions, &repetitions_local,
+				sizeof(repetitions_local));
+	}
+
+	repetitions->max_repetitions = max_repetitions;
+	repetitions->lastaccess = time(NULL);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: quotes string value if Net-SNMP library hasn't quoted it          *
@@ -2685,6 +2798,127 @@ out:
 	return ret;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: sets value or error of coalesced GET variable for the item        *
+ *          requesting it                                                     *
+ *                                                                            *
+ * Parameters: snmp_context     - [IN/OUT]                                    *
+ *             bulkwalk_context - [IN] context of the requested variable      *
+ *             value            - [IN] variable value, NULL on error          *
+ *             error            - [IN] error message                          *
+ *                                                                            *
+ * Comments: Values of items with several OIDs are concatenated in the same   *
+ *           way as for not coalesced requests, the first error is kept.      *
+ *                                                                            *
+ ******************************************************************************/
+static void	snmp_get_set_result(zbx_snmp_context_t *snmp_context, const zbx_bulkwalk_context_t *bulkwalk_context,
+		const char *value, const char *error)
+{
+	zbx_dc_item_context_t	*item_context = bulkwalk_context->item_context;
+
+	if (NULL == item_context)
+	{
+		if (NULL != snmp_context->get_error)
+			return;
+
+		if (NULL == value)
+			snmp_context->get_error = zbx_strdup(NULL, error);
+		else
+			zbx_strcpy_alloc(&snmp_context->results, &snmp_context->results_alloc,
+					&snmp_context->results_offset, value);
+
+		return;
+	}
+
+	if (SUCCEED != item_context->ret)
+		return;
+
+	if (NULL == value)
+	{
+		zbx_free_agent_result(&item_context->result);
+		item_context->ret = NOTSUPPORTED;
+		SET_MSG_RESULT(&item_context->result, zbx_strdup(NULL, error));
+	}
+	else if (ZBX_ISSET_TEXT(&item_context->result))
+		item_context->result.text = zbx_strdcat(item_context->result.text, value);
+	else
+		SET_TEXT_RESULT(&item_context->result, zbx_strdup(NULL, value));
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: processes response to GET request coalescing OIDs of several      *
+ *          items                                                             *
+ *                                                                            *
+ * Parameters: status        - [IN] response status                           *
+ *             response      - [IN]                                           *
+ *             snmp_context  - [IN/OUT]                                       *
+ *             error         - [OUT] error message if request failed          *
+ *             max_error_len - [IN]                                           *
+ *                                                                            *
+ * Return value: SUCCEED - variables were processed, errors of single         *
+ *                         variables are set only for the requesting items    *
+ *               NOTSUPPORTED, NETWORK_ERROR - request failed                 *
+ *                                                                            *
+ ******************************************************************************/
+static int	snmp_get_handle_response(int status, struct snmp_pdu *response, zbx_snmp_context_t *snmp_context,
+		char *error, size_t max_error_len)
+{
+	struct variable_list	*var = NULL;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s() vars:%d", __func__, snmp_context->pdu_vars_num);
+
+	if (STAT_SUCCESS != status)
+	{
+		return zbx_get_snmp_response_error(snmp_context->ssp, &snmp_context->item.interface, status,
+				response, error, max_error_len);
+	}
+
+	if (SNMP_ERR_NOERROR == response->errstat)
+		var = response->variables;
+
+	for (int j = 0; j < snmp_context->pdu_vars_num; j++)
+	{
+		zbx_bulkwalk_context_t	*bulkwalk_context = snmp_context->bulkwalk_contexts.values[snmp_context->i + j];
+		char			var_error[MAX_STRING_LEN], *value = NULL;
+		size_t			value_alloc = 0, value_offset = 0;
+
+		bulkwalk_context->running = 0;
+
+		if (SNMP_ERR_NOERROR != response->errstat)
+		{
+			(void)zbx_get_snmp_response_error(snmp_context->ssp, &snmp_context->item.interface, status,
+					response, var_error, sizeof(var_error));
+		}
+		else if (NULL == var)
+		{
+			zbx_strlcpy(var_error, "No variables", sizeof(var_error));
+		}
+		else if (var->name_length < bulkwalk_context->p_oid->root_oid_len ||
+				0 != memcmp(bulkwalk_context->p_oid->root_oid, var->name,
+				bulkwalk_context->p_oid->root_oid_len * sizeof(oid)))
+		{
+			zbx_strlcpy(var_error, "OID mismatched", sizeof(var_error));
+		}
+		else
+		{
+			(void)snmp_get_value_from_var(var, &value, &value_alloc, &value_offset, var_error,
+					sizeof(var_error));
+		}
+
+		snmp_get_set_result(snmp_context, bulkwalk_context, value, var_error);
+		zbx_free(value);
+
+		if (NULL != var)
+			var = var->next_variable;
+	}
+
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
+
+	return SUCCEED;
+}
+
 static int	asynch_response(int operation, struct snmp_session *sp, int reqid, struct snmp_pdu *pdu, void *magic)
 {
 	zbx_bulkwalk_context_t	*bulkwalk_context;
@@ -2745,12 +2979,73 @@ static int	asynch_response(int operation, struct snmp_session *sp, int reqid, st
 	{
 		char	error[MAX_STRING_LEN];
 
-		if (SUCCEED != (ret = snmp_bulkwalk_handle_response(stat, pdu, bulkwalk_context, &snmp_context->results,
-				&snmp_context->results_alloc, &snmp_context->results_offset, snmp_context->ssp,
-				&snmp_context->item.interface, snmp_context->snmp_oid_type, error, sizeof(error))))
+		if (STAT_SUCCESS == stat && SNMP_ERR_TOOBIG == pdu->errstat &&
+				SNMP_MSG_GETBULK == bulkwalk_context->pdu_type &&
+				1 < snmp_context->snmp_max_repetitions)
+		{
+			/* response does not fit into agent message size, repeat request with less repetitions */
+			snmp_context->snmp_max_repetitions /= 2;
+			snmp_repetitions_set(snmp_context->item.interface.interfaceid,
+					snmp_context->snmp_max_repetitions, snmp_context->snmp_max_repetitions_conf);
+
+			zabbix_log(LOG_LEVEL_DEBUG, "response too big, reduced max repetitions to %d",
+					snmp_context->snmp_max_repetitions);
+			ret = SUCCEED;
+			goto out;
+		}
+
+		if (STAT_SUCCESS == stat && SNMP_ERR_NOERROR != pdu->errstat && 1 < snmp_context->pdu_vars_num)
+		{
+			/* response of coalesced GET does not fit into agent message size or one of the */
+			/* variables failed, repeat request with less variables to find the failing one */
+			if (SNMP_ERR_TOOBIG == pdu->errstat)
+				snmp_context->get_vars_max = snmp_context->pdu_vars_num / 2;
+			else
+				snmp_context->get_vars_max = 1;
+
+			zabbix_log(LOG_LEVEL_DEBUG, "coalesced GET failed with error %ld, reduced variables to %d",
+					pdu->errstat, snmp_context->get_vars_max);
+			ret = SUCCEED;
+			goto out;
+		}
+
+		if (1 == snmp_context->get_coalesced)
+		{
+			ret = snmp_get_handle_response(stat, pdu, snmp_context, error, sizeof(error));
+		}
+		else
+		{
+			ret = snmp_bulkwalk_handle_response(stat, pdu, bulkwalk_context, &snmp_context->results,
+					&snmp_context->results_alloc, &snmp_context->results_offset,
+					snmp_context->ssp, &snmp_context->item.interface, snmp_context->snmp_oid_type,
+					error, sizeof(error));
+		}
+
+		if (SUCCEED != ret)
 		{
 			bulkwalk_context->error = zbx_strdup(bulkwalk_context->error, error);
 		}
+		else if (SNMP_MSG_GETBULK == bulkwalk_context->pdu_type && 1 == bulkwalk_context->running &&
+				snmp_context->snmp_max_repetitions < snmp_context->snmp_max_repetitions_conf)
+		{
+			struct variable_list	*var;
+			int			vars_num = 0;
+
+			for (var = pdu->variables; NULL != var; var = var->next_variable)
+				vars_num++;
+
+			/* probe for a larger response only if all requested repetitions were returned */
+			if (vars_num < snmp_context->snmp_max_repetitions)
+				goto out;
+
+			snmp_context->snmp_max_repetitions += MAX(1, snmp_context->snmp_max_repetitions / 4);
+
+			if (snmp_context->snmp_max_repetitions > snmp_context->snmp_max_repetitions_conf)
+				snmp_context->snmp_max_repetitions = snmp_context->snmp_max_repetitions_conf;
+
+			snmp_repetitions_set(snmp_context->item.interface.interfaceid,
+					snmp_context->snmp_max_repetitions, snmp_context->snmp_max_repetitions_conf);
+		}
 	}
 	else
 	{
@@ -2794,6 +3089,7 @@ static zbx_bulkwalk_context_t	*snmp_bulkwalk_context_create(zbx_snmp_context_t *
 	bulkwalk_context->vars_num = 0;
 	bulkwalk_context->arg = snmp_context;
 	bulkwalk_context->error = NULL;
+	bulkwalk_context->item_context = NULL;
 
 	netsnmp_large_fd_set_init(&bulkwalk_context->fdset, FD_SETSIZE);
 
@@ -2812,7 +3108,7 @@ static int	snmp_bulkwalk_add(zbx_snmp_context_t *snmp_context, int *fd, char *er
 	struct snmp_pdu			*pdu;
 	zbx_bulkwalk_context_t		*bulkwalk_context = snmp_context->bulkwalk_contexts.values[snmp_context->i];
 	struct netsnmp_transport_s	*transport;
-	int				ret, numfds = 0, block = 0;
+	int				ret, numfds = 0, block = 0, vars_max;
 	struct timeval			timeout = {0};
 	fd_set				fdset;
 
@@ -2854,12 +3150,23 @@ static int	snmp_bulkwalk_add(zbx_snmp_context_t *snmp_context, int *fd, char *er
 			pdu->max_repetitions = snmp_context->snmp_max_repetitions;
 		}
 
-		if (NULL == snmp_add_null_var(pdu, bulkwalk_context->name, bulkwalk_context->name_length))
+		/* coalesced GET requests OIDs of several items in one PDU */
+		vars_max = (1 == snmp_context->get_coalesced ? snmp_context->get_vars_max : 1);
+
+		for (snmp_context->pdu_vars_num = 0; snmp_context->pdu_vars_num < vars_max &&
+				snmp_context->i + snmp_context->pdu_vars_num <
+				snmp_context->bulkwalk_contexts.values_num; snmp_context->pdu_vars_num++)
 		{
-			zbx_strlcpy(error, "snmp_add_null_var(): cannot add null variable.", max_error_len);
-			ret = CONFIG_ERROR;
-			snmp_free_pdu(pdu);
-			goto out;
+			zbx_bulkwalk_context_t	*var_context = snmp_context->bulkwalk_contexts.values[snmp_context->i +
+					snmp_context->pdu_vars_num];
+
+			if (NULL == snmp_add_null_var(pdu, var_context->name, var_context->name_length))
+			{
+				zbx_strlcpy(error, "snmp_add_null_var(): cannot add null variable.", max_error_len);
+				ret = CONFIG_ERROR;
+				snmp_free_pdu(pdu);
+				goto out;
+			}
 		}
 	}
 
@@ -3112,10 +3419,18 @@ static int	snmp_task_process(short event, void *data, int *fd, const char *addr,
 			}
 			else
 			{
-				snmp_context->i++;
+				snmp_context->i += snmp_context->pdu_vars_num;
 
 				if (snmp_context->i >= snmp_context->bulkwalk_contexts.values_num)
 				{
+					if (NULL != snmp_context->get_error)
+					{
+						snmp_context->item.ret = NOTSUPPORTED;
+						SET_MSG_RESULT(&snmp_context->item.result, snmp_context->get_error);
+						snmp_context->get_error = NULL;
+						goto stop;
+					}
+
 					if (NULL == snmp_context->results)
 						SET_TEXT_RESULT(&snmp_context->item.result, zbx_strdup(NULL, ""));
 					else
@@ -3191,22 +3506,111 @@ void	*zbx_async_check_snmp_get_arg(zbx_snmp_context_t *snmp_context)
 	return snmp_context->arg;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: copies result of finished SNMP check to the items sharing its     *
+ *          request                                                           *
+ *                                                                            *
+ * Parameters: snmp_context - [IN]                                            *
+ *             items        - [OUT] contexts of the sharing items             *
+ *             items_num    - [OUT] number of the sharing items               *
+ *                                                                            *
+ * Comments: Items with OIDs coalesced into GET request already have their    *
+ *           own results, unless the request failed before their variables    *
+ *           were received.                                                   *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_async_check_snmp_fan_out(zbx_snmp_context_t *snmp_context, zbx_dc_item_context_t **items,
+		int *items_num)
+{
+	for (int i = 0; i < snmp_context->shared_items_num; i++)
+	{
+		zbx_dc_item_context_t	*item = &snmp_context->shared_items[i], *source;
+		int			index = snmp_context->shared_items_source[i];
+
+		if (i == index)
+		{
+			if (SUCCEED != item->ret || ZBX_ISSET_TEXT(&item->result))
+				continue;
+
+			if (SUCCEED == snmp_context->item.ret)
+			{
+				SET_TEXT_RESULT(&item->result, zbx_strdup(NULL, ""));
+				continue;
+			}
+
+			source = &snmp_context->item;
+		}
+		else
+			source = (-1 == index ? &snmp_context->item : &snmp_context->shared_items[index]);
+
+		item->ret = source->ret;
+
+		if (ZBX_ISSET_TEXT(&source->result))
+			SET_TEXT_RESULT(&item->result, zbx_strdup(NULL, source->result.text));
+
+		if (ZBX_ISSET_MSG(&source->result))
+			SET_MSG_RESULT(&item->result, zbx_strdup(NULL, source->result.msg));
+	}
+
+	*items = snmp_context->shared_items;
+	*items_num = snmp_context->shared_items_num;
+}
+
+static void	snmp_item_context_init(zbx_dc_item_context_t *item_context, zbx_dc_item_t *item)
+{
+	item_context->interface = item->interface;
+	item_context->interface.addr = (item->interface.addr == item->interface.dns_orig ?
+			item_context->interface.dns_orig : item_context->interface.ip_orig);
+	zbx_strlcpy(item_context->host, item->host.host, sizeof(item_context->host));
+	item_context->itemid = item->itemid;
+	item_context->hostid = item->host.hostid;
+	item_context->value_type = item->value_type;
+	item_context->flags = item->flags;
+	item_context->key_orig = zbx_strdup(NULL, item->key_orig);
+
+	if (item->key != item->key_orig)
+	{
+		item_context->key = item->key;
+		item->key = NULL;
+	}
+	else
+		item_context->key = zbx_strdup(NULL, item->key);
+
+	item_context->version = item->interface.version;
+	item_context->ret = SUCCEED;
+
+	zbx_init_agent_result(&item_context->result);
+}
+
+static void	snmp_item_context_clean(zbx_dc_item_context_t *item_context)
+{
+	zbx_free(item_context->key);
+	zbx_free(item_context->key_orig);
+	zbx_free_agent_result(&item_context->result);
+}
+
 void	zbx_async_check_snmp_clean(zbx_snmp_context_t *snmp_context)
 {
 	if (NULL != snmp_context->ssp)
 		zbx_snmp_close_session(snmp_context->ssp);
 
+	for (int i = 0; i < snmp_context->shared_items_num; i++)
+		snmp_item_context_clean(&snmp_context->shared_items[i]);
+
+	zbx_free(snmp_context->shared_items);
+	zbx_free(snmp_context->shared_items_source);
+	zbx_free(snmp_context->get_error);
+
 	zbx_free(snmp_context->snmp_community);
 	zbx_free(snmp_context->snmpv3_securityname);
 	zbx_free(snmp_context->snmpv3_contextname);
 	zbx_free(snmp_context->snmpv3_authpassphrase);
 	zbx_free(snmp_context->snmpv3_privpassphrase);
 
-	zbx_free(snmp_context->item.key);
-	zbx_free(snmp_context->item.key_orig);
+	snmp_item_context_clean(&snmp_context->item);
 	zbx_free(snmp_context->results);
 	zbx_free(snmp_context->reverse_dns);
-	zbx_free_agent_result(&snmp_context->item.result);
 
 	zbx_vector_bulkwalk_context_clear_ext(&snmp_context->bulkwalk_contexts, snmp_bulkwalk_context_free);
 	zbx_vector_bulkwalk_context_destroy(&snmp_context->bulkwalk_contexts);
@@ -3215,9 +3619,142 @@ void	zbx_async_check_snmp_clean(zbx_snmp_context_t *snmp_context)
 	zbx_free(snmp_context);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: parses OIDs of GET item                                           *
+ *                                                                            *
+ * Parameters: snmp_oid      - [IN] item SNMP OID key                         *
+ *             oids          - [OUT] parsed OIDs                              *
+ *             error         - [OUT] error message on failure                 *
+ *             max_error_len - [IN]                                           *
+ *                                                                            *
+ * Return value: SUCCEED - OIDs were parsed                                   *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ ******************************************************************************/
+static int	snmp_get_parse_oids(const char *snmp_oid, zbx_vector_snmp_oid_t *oids, char *error,
+		size_t max_error_len)
+{
+	AGENT_REQUEST	request;
+	int		ret;
+
+	zbx_init_agent_request(&request);
+
+	if (SUCCEED != zbx_parse_item_key(snmp_oid, &request))
+	{
+		zbx_strlcpy(error, "Invalid SNMP OID: cannot parse parameter.", max_error_len);
+		ret = FAIL;
+	}
+	else if (0 == request.nparam || (1 == request.nparam && '\0' == *(request.params[0])))
+		ret = snmp_bulkwalk_parse_param(snmp_oid, oids, error, max_error_len);
+	else
+		ret = snmp_bulkwalk_parse_params(&request, oids, error, max_error_len);
+
+	zbx_free_agent_request(&request);
+
+	return ret;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: adds OIDs of shared GET items to the request of leader item, so   *
+ *          that variables of all items are requested in the same PDU         *
+ *                                                                            *
+ * Parameters: snmp_context - [IN/OUT]                                        *
+ *             snmp_oid     - [IN] SNMP OID key of the leader item            *
+ *             shared_items - [IN] items sharing the request                  *
+ *                                                                            *
+ * Comments: Items with the same OID key as the leader item or one of the     *
+ *           previous shared items receive copy of that item result.          *
+ *                                                                            *
+ ******************************************************************************/
+static void	snmp_get_coalesce(zbx_snmp_context_t *snmp_context, const char *snmp_oid,
+		zbx_dc_item_t **shared_items)
+{
+	int			leader_vars_num = snmp_context->bulkwalk_contexts.values_num;
+	zbx_vector_snmp_oid_t	oids;
+
+	zbx_vector_snmp_oid_create(&oids);
+
+	for (int i = 0; i < snmp_context->shared_items_num; i++)
+	{
+		zbx_dc_item_context_t	*item_context = &snmp_context->shared_items[i];
+		char			error[MAX_STRING_LEN];
+		int			j;
+
+		if (0 == strcmp(snmp_oid, shared_items[i]->snmp_oid))
+			continue;
+
+		for (j = 0; j < i; j++)
+		{
+			if (0 == strcmp(shared_items[j]->snmp_oid, shared_items[i]->snmp_oid))
+				break;
+		}
+
+		snmp_context->shared_items_source[i] = j;
+
+		if (j != i)
+			continue;
+
+		if (SUCCEED != snmp_get_parse_oids(shared_items[i]->snmp_oid, &oids, error, sizeof(error)))
+		{
+			zbx_vector_snmp_oid_clear_ext(&oids, vector_snmp_oid_free);
+			item_context->ret = CONFIG_ERROR;
+			SET_MSG_RESULT(&item_context->result, zbx_strdup(NULL, error));
+			continue;
+		}
+
+		for (j = 0; j < oids.values_num; j++)
+		{
+			zbx_bulkwalk_context_t	*bulkwalk_context;
+
+			zbx_vector_snmp_oid_append(&snmp_context->param_oids, oids.values[j]);
+
+			bulkwalk_context = snmp_bulkwalk_context_create(snmp_context, SNMP_MSG_GET, oids.values[j]);
+			bulkwalk_context->item_context = item_context;
+			zbx_vector_bulkwalk_context_append(&snmp_context->bulkwalk_contexts, bulkwalk_context);
+		}
+
+		zbx_vector_snmp_oid_clear(&oids);
+	}
+
+	zbx_vector_snmp_oid_destroy(&oids);
+
+	if (leader_vars_num != snmp_context->bulkwalk_contexts.values_num)
+		snmp_context->get_coalesced = 1;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: starts asynchronous SNMP check                                    *
+ *                                                                            *
+ * Parameters: item                - [IN] item performing the request         *
+ *             result              - [OUT] error message on failure           *
+ *             clear_cb            - [IN] callback to process check result    *
+ *             arg                 - [IN] callback argument                   *
+ *             arg_action          - [IN] poller configuration (optional)     *
+ *             base                - [IN] event base                          *
+ *             dnsbase             - [IN] DNS event base                      *
+ *             config_source_ip    - [IN]                                     *
+ *             resolve_reverse_dns - [IN]                                     *
+ *             retries             - [IN] number of retries on timeout        *
+ *             shared_items        - [IN] items sharing request to the same   *
+ *                                        interface (optional)                *
+ *             shared_items_num    - [IN] number of shared items              *
+ *                                                                            *
+ * Return value: SUCCEED - check was started                                  *
+ *               CONFIG_ERROR - otherwise                                     *
+ *                                                                            *
+ * Comments: Shared items receive the result of the check without issuing     *
+ *           their own requests, see zbx_async_check_snmp_fan_out(). OIDs of  *
+ *           shared GET items are requested in the same PDU as the OID of     *
+ *           the leader item.                                                 *
+ *                                                                            *
+ ******************************************************************************/
 int	zbx_async_check_snmp(zbx_dc_item_t *item, AGENT_RESULT *result, zbx_async_task_clear_cb_t clear_cb,
 		void *arg, void *arg_action, struct event_base *base, struct evdns_base *dnsbase,
-		const char *config_source_ip, zbx_async_resolve_reverse_dns_t resolve_reverse_dns, int retries)
+		const char *config_source_ip, zbx_async_resolve_reverse_dns_t resolve_reverse_dns, int retries,
+		zbx_dc_item_t **shared_items, int shared_items_num)
 {
 	int			ret = SUCCEED, pdu_type, is_oid_plain = 0;
 	AGENT_REQUEST		request;
@@ -3234,31 +3771,21 @@ int	zbx_async_check_snmp(zbx_dc_item_t *item, AGENT_RESULT *result, zbx_async_ta
 	snmp_context->reverse_dns = NULL;
 
 	snmp_context->ssp = NULL;
-	snmp_context->item.interface = item->interface;
-	snmp_context->item.interface.addr = (item->interface.addr == item->interface.dns_orig ?
-			snmp_context->item.interface.dns_orig : snmp_context->item.interface.ip_orig);
-	zbx_strlcpy(snmp_context->item.host, item->host.host, sizeof(snmp_context->item.host));
-	snmp_context->item.itemid = item->itemid;
-	snmp_context->item.hostid = item->host.hostid;
-	snmp_context->item.value_type = item->value_type;
-	snmp_context->item.flags = item->flags;
-	snmp_context->item.key_orig = zbx_strdup(NULL, item->key_orig);
+	snmp_context->shared_items = NULL;
+	snmp_context->shared_items_source = NULL;
+	snmp_context->shared_items_num = 0;
+	snmp_context->get_coalesced = 0;
+	snmp_context->get_vars_max = ZBX_MAX_SNMP_ITEMS;
+	snmp_context->pdu_vars_num = 1;
+	snmp_context->get_error = NULL;
 
-	if (item->key != item->key_orig)
-	{
-		snmp_context->item.key = item->key;
-		item->key = NULL;
-	}
-	else
-		snmp_context->item.key = zbx_strdup(NULL, item->key);
-
-	snmp_context->item.version = item->interface.version;
-
-	zbx_init_agent_result(&snmp_context->item.result);
+	snmp_item_context_init(&snmp_context->item, item);
 
 	snmp_context->config_timeout = item->timeout;
 
-	snmp_context->snmp_max_repetitions = item->snmp_max_repetitions;
+	snmp_context->snmp_max_repetitions = snmp_repetitions_get(item->interface.interfaceid,
+			item->snmp_max_repetitions);
+	snmp_context->snmp_max_repetitions_conf = item->snmp_max_repetitions;
 	snmp_context->retries = retries;
 	snmp_context->arg = arg;
 	snmp_context->arg_action = arg_action;
@@ -3362,6 +3889,25 @@ int	zbx_async_check_snmp(zbx_dc_item_t *item, AGENT_RESULT *result, zbx_async_ta
 		zbx_vector_bulkwalk_context_append(&snmp_context->bulkwalk_contexts, bulkwalk_context);
 	}
 
+	/* shared items must be attached before adding task as it can be completed right away */
+	if (0 != shared_items_num)
+	{
+		snmp_context->shared_items = (zbx_dc_item_context_t *)zbx_malloc(NULL,
+				sizeof(zbx_dc_item_context_t) * (size_t)shared_items_num);
+		snmp_context->shared_items_source = (int *)zbx_malloc(NULL, sizeof(int) * (size_t)shared_items_num);
+
+		for (int i = 0; i < shared_items_num; i++)
+		{
+			snmp_item_context_init(&snmp_context->shared_items[i], shared_items[i]);
+			snmp_context->shared_items_source[i] = -1;
+		}
+
+		snmp_context->shared_items_num = shared_items_num;
+
+		if (ZBX_SNMP_GET == snmp_context->snmp_oid_type)
+			snmp_get_coalesce(snmp_context, item->snmp_oid, shared_items);
+	}
+
 	zbx_async_poller_add_task(base, dnsbase, snmp_context->item.interface.addr, snmp_context, item->timeout,
 			snmp_task_process, clear_cb);
 
@@ -3777,7 +4323,7 @@ void	get_values_snmp(zbx_dc_item_t *items, AGENT_RESULT *results, int *errcodes,
 
 		if (SUCCEED == (errcodes[j] = zbx_async_check_snmp(&items[j], &results[j], process_snmp_result,
 				&snmp_result, NULL, snmp_result.base, dnsbase, config_source_ip,
-				ZABBIX_ASYNC_RESOLVE_REVERSE_DNS_NO, ZBX_SNMP_DEFAULT_NUMBER_OF_RETRIES)))
+				ZABBIX_ASYNC_RESOLVE_REVERSE_DNS_NO, ZBX_SNMP_DEFAULT_NUMBER_OF_RETRIES, NULL, 0)))
 		{
 			if (1 == snmp_result.finished || -1 != event_base_dispatch(snmp_result.base))
 			{
@@ -3917,6 +4463,9 @@ void	zbx_clear_cache_snmp(unsigned char process_type, int process_num)
 	if (ZBX_PROCESS_TYPE_SNMP_POLLER == process_type)
 		zbx_clear_snmp_engineid_cache();
 
+	if (0 != snmp_repetitions_init_done)
+		zbx_hashset_clear(&snmp_repetitions);
+
 	SNMP_MT_UNLOCK;
 }
 
@@ -45,6 +45,34 @@ static void	diag_add_preproc_sequences(struct zbx_json *json, const char *field,
 	zbx_json_close(json);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: add script top list to output json                                *
+ *                                                                            *
+ * Parameters: json    - [OUT] the output json                                *
+ *             field   - [IN] the field name                                  *
+ *             scripts - [IN] a top script list                               *
+ *                                                                            *
+ ******************************************************************************/
+static void	diag_add_preproc_scripts(struct zbx_json *json, const char *field,
+		const zbx_vector_pp_script_stats_ptr_t *scripts)
+{
+	zbx_json_addarray(json, field);
+
+	for (int i = 0; i < scripts->values_num; i++)
+	{
+		zbx_json_addobject(json, NULL);
+		zbx_json_adduint64(json, "itemid", scripts->values[i]->itemid);
+		zbx_json_adduint64(json, "executions", scripts->values[i]->executions);
+		zbx_json_adduint64(json, "failures", scripts->values[i]->failures);
+		zbx_json_addfloat(json, "time", scripts->values[i]->time);
+		zbx_json_adduint64(json, "heap peak", scripts->values[i]->heap_peak);
+		zbx_json_close(json);
+	}
+
+	zbx_json_close(json);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: add requested preprocessing diagnostic information to json data   *
@@ -130,6 +158,29 @@ int	zbx_diag_add_preproc_info(const struct zbx_json_parse *jp, struct zbx_json *
 							(zbx_pp_sequence_stats_ptr_free_func_t)(zbx_ptr_free));
 					zbx_vector_pp_sequence_stats_ptr_destroy(&sequences);
 				}
+				else if (0 == strcmp(map->name, "scripts"))
+				{
+					zbx_vector_pp_script_stats_ptr_t	scripts;
+
+					zbx_vector_pp_script_stats_ptr_create(&scripts);
+					time1 = zbx_time();
+
+					if (SUCCEED != (ret = zbx_preprocessor_get_top_scripts((int)map->value, &scripts,
+							error)))
+					{
+						zbx_vector_pp_script_stats_ptr_destroy(&scripts);
+						goto out;
+					}
+
+					time2 = zbx_time();
+					time_total += time2 - time1;
+
+					diag_add_preproc_scripts(json, map->name, &scripts);
+
+					zbx_vector_pp_script_stats_ptr_clear_ext(&scripts,
+							(zbx_pp_script_stats_ptr_free_func_t)(zbx_ptr_free));
+					zbx_vector_pp_script_stats_ptr_destroy(&scripts);
+				}
 				else
 				{
 					*error = zbx_dsprintf(*error, "Unsupported top field: %s", map->name);
@@ -34,6 +34,11 @@
 
 #define PP_VALUE_LOG_LIMIT	4096
 
+/* script statistics of scripts not executed for this period are dropped */
+#define PP_SCRIPT_STATS_TTL	SEC_PER_DAY
+
+ZBX_VECTOR_IMPL(pp_script_run, zbx_pp_script_run_t)
+
 /******************************************************************************
  *                                                                            *
  * Purpose: execute 'multiply by' step                                        *
@@ -656,13 +661,31 @@ static int	pp_throttle_timed_value(zbx_variant_t *value, zbx_timespec_t ts, cons
 static int	pp_execute_script(zbx_pp_context_t *ctx, zbx_variant_t *value, const char *params,
 		zbx_variant_t *history_value, const char *config_source_ip)
 {
-	char	*errmsg = NULL;
+	char			*errmsg = NULL;
+	int			ret;
+	double			time_start;
+	zbx_es_t		*es = pp_context_es_engine(ctx);
+	zbx_pp_script_run_t	run;
+	zbx_uint64_t		heap_used;
+
+	time_start = zbx_time();
+	ret = item_preproc_script(es, value, params, history_value, config_source_ip, &errmsg);
+
+	run.time = zbx_time() - time_start;
+	run.hash = ZBX_DEFAULT_STRING_HASH_ALGO(params, strlen(params), ZBX_DEFAULT_HASH_SEED);
+	run.itemid = ctx->itemid;
+	run.failed = (SUCCEED == ret ? 0 : 1);
+
+	/* the environment is destroyed after fatal errors */
+	if (SUCCEED == zbx_es_is_env_initialized(es))
+		zbx_es_get_heap_stats(es, &heap_used, &run.heap_peak);
+	else
+		run.heap_peak = 0;
 
-	if (SUCCEED == item_preproc_script(pp_context_es_engine(ctx), value, params, history_value, config_source_ip,
-			&errmsg))
-	{
+	zbx_vector_pp_script_run_append(&ctx->script_runs, run);
+
+	if (SUCCEED == ret)
 		return SUCCEED;
-	}
 
 	zbx_variant_clear(value);
 	zbx_variant_set_error(value, errmsg);
@@ -1307,15 +1330,147 @@ out:
 			zbx_variant_value_desc(value_out), zbx_variant_type_desc(value_out));
 }
 
+static zbx_hash_t	pp_script_entry_hash(const void *d)
+{
+	return ((const zbx_pp_script_entry_t *)d)->hash;
+}
+
+static int	pp_script_entry_compare(const void *d1, const void *d2)
+{
+	const zbx_pp_script_entry_t	*e1 = (const zbx_pp_script_entry_t *)d1;
+	const zbx_pp_script_entry_t	*e2 = (const zbx_pp_script_entry_t *)d2;
+
+	ZBX_RETURN_IF_NOT_EQUAL(e1->hash, e2->hash);
+
+	return 0;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: create script statistics hashset                                  *
+ *                                                                            *
+ ******************************************************************************/
+void	pp_script_stats_create(zbx_hashset_t *stats)
+{
+	zbx_hashset_create(stats, 0, pp_script_entry_hash, pp_script_entry_compare);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get script statistics entry, create new if not found              *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_pp_script_entry_t	*pp_script_stats_get(zbx_hashset_t *stats, zbx_hash_t hash)
+{
+	zbx_pp_script_entry_t	*entry, entry_local;
+
+	entry_local.hash = hash;
+
+	if (NULL == (entry = (zbx_pp_script_entry_t *)zbx_hashset_search(stats, &entry_local)))
+	{
+		memset(&entry_local.stats, 0, sizeof(entry_local.stats));
+		entry_local.lastaccess = 0;
+		entry = (zbx_pp_script_entry_t *)zbx_hashset_insert(stats, &entry_local, sizeof(entry_local));
+	}
+
+	return entry;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: merge script statistics                                           *
+ *                                                                            *
+ * Parameters: dst - [IN/OUT] destination statistics                          *
+ *             src - [IN] source statistics                                   *
+ *                                                                            *
+ ******************************************************************************/
+void	pp_script_stats_merge(zbx_hashset_t *dst, zbx_hashset_t *src)
+{
+	zbx_hashset_iter_t	iter;
+	zbx_pp_script_entry_t	*entry_src, *entry;
+
+	zbx_hashset_iter_reset(src, &iter);
+	while (NULL != (entry_src = (zbx_pp_script_entry_t *)zbx_hashset_iter_next(&iter)))
+	{
+		entry = pp_script_stats_get(dst, entry_src->hash);
+
+		if (entry_src->lastaccess >= entry->lastaccess)
+		{
+			entry->lastaccess = entry_src->lastaccess;
+			entry->stats.itemid = entry_src->stats.itemid;
+		}
+
+		entry->stats.executions += entry_src->stats.executions;
+		entry->stats.failures += entry_src->stats.failures;
+		entry->stats.time += entry_src->stats.time;
+
+		if (entry_src->stats.heap_peak > entry->stats.heap_peak)
+			entry->stats.heap_peak = entry_src->stats.heap_peak;
+	}
+}
+
 void	pp_context_init(zbx_pp_context_t *ctx)
 {
 	memset(ctx, 0, sizeof(zbx_pp_context_t));
+
+	zbx_vector_pp_script_run_create(&ctx->script_runs);
+	pp_script_stats_create(&ctx->script_stats);
 }
 
 void	pp_context_destroy(zbx_pp_context_t *ctx)
 {
 	if (0 != ctx->es_initialized)
 		zbx_es_destroy(&ctx->es_engine);
+
+	zbx_hashset_destroy(&ctx->script_stats);
+	zbx_vector_pp_script_run_destroy(&ctx->script_runs);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: add pending script executions to context script statistics        *
+ *                                                                            *
+ * Parameters: ctx - [IN] worker specific execution context                   *
+ *             now - [IN] current time                                        *
+ *                                                                            *
+ * Comments: Script statistics are read by preprocessing manager, so this     *
+ *           function must be called while holding task queue lock.           *
+ *                                                                            *
+ ******************************************************************************/
+void	pp_context_flush_script_stats(zbx_pp_context_t *ctx, time_t now)
+{
+	for (int i = 0; i < ctx->script_runs.values_num; i++)
+	{
+		zbx_pp_script_run_t	*run = &ctx->script_runs.values[i];
+		zbx_pp_script_entry_t	*entry;
+
+		entry = pp_script_stats_get(&ctx->script_stats, run->hash);
+		entry->lastaccess = now;
+		entry->stats.itemid = run->itemid;
+		entry->stats.executions++;
+		entry->stats.failures += (zbx_uint64_t)run->failed;
+		entry->stats.time += run->time;
+
+		if (run->heap_peak > entry->stats.heap_peak)
+			entry->stats.heap_peak = run->heap_peak;
+	}
+
+	zbx_vector_pp_script_run_clear(&ctx->script_runs);
+
+	if (now - ctx->script_stats_clean >= SEC_PER_HOUR)
+	{
+		zbx_hashset_iter_t	iter;
+		zbx_pp_script_entry_t	*entry;
+
+		zbx_hashset_iter_reset(&ctx->script_stats, &iter);
+		while (NULL != (entry = (zbx_pp_script_entry_t *)zbx_hashset_iter_next(&iter)))
+		{
+			if (now - entry->lastaccess >= PP_SCRIPT_STATS_TTL)
+				zbx_hashset_iter_remove(&iter);
+		}
+
+		ctx->script_stats_clean = now;
+	}
 }
 
 zbx_es_t	*pp_context_es_engine(zbx_pp_context_t *ctx)
@@ -1326,5 +1481,51 @@ zbx_es_t	*pp_context_es_engine(zbx_pp_context_t *ctx)
 		ctx->es_initialized = 1;
 	}
 
+	ctx->es_prewarm_failed = 0;
+
 	return &ctx->es_engine;
 }
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: check if scripting environment was destroyed after fatal error    *
+ *          and must be recreated                                             *
+ *                                                                            *
+ * Parameters: ctx - [IN] worker specific execution context                   *
+ *                                                                            *
+ * Return value: SUCCEED - the environment must be recreated                  *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ ******************************************************************************/
+int	pp_context_es_destroyed(zbx_pp_context_t *ctx)
+{
+	if (0 == ctx->es_initialized || 0 != ctx->es_prewarm_failed)
+		return FAIL;
+
+	return (SUCCEED == zbx_es_is_env_initialized(&ctx->es_engine) ? FAIL : SUCCEED);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: recreate scripting environment destroyed after fatal error        *
+ *                                                                            *
+ * Parameters: ctx              - [IN] worker specific execution context      *
+ *             config_source_ip - [IN]                                        *
+ *                                                                            *
+ * Comments: This function is called by idle worker, so the next script does  *
+ *           not wait for the environment and its bindings to be initialized. *
+ *           Failed recreation is not repeated until the next script is       *
+ *           executed, which will initialize the environment itself.          *
+ *                                                                            *
+ ******************************************************************************/
+void	pp_context_es_prewarm(zbx_pp_context_t *ctx, const char *config_source_ip)
+{
+	char	*error = NULL;
+
+	if (SUCCEED != zbx_es_init_env(&ctx->es_engine, config_source_ip, &error))
+	{
+		zabbix_log(LOG_LEVEL_DEBUG, "cannot initialize embedded scripting engine environment: %s", error);
+		zbx_free(error);
+		ctx->es_prewarm_failed = 1;
+	}
+}
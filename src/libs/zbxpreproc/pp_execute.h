@@ -22,16 +22,50 @@
 #include "zbxcacheconfig.h"
 #include "zbxpreprocbase.h"
 
+/* single script execution, not yet added to script statistics */
 typedef struct
 {
-	int		es_initialized;
-	zbx_es_t	es_engine;
+	zbx_hash_t	hash;
+	zbx_uint64_t	itemid;
+	zbx_uint64_t	heap_peak;
+	double		time;
+	int		failed;
+}
+zbx_pp_script_run_t;
+
+ZBX_VECTOR_DECL(pp_script_run, zbx_pp_script_run_t)
+
+typedef struct
+{
+	zbx_hash_t		hash;		/* script hash */
+	time_t			lastaccess;
+	zbx_pp_script_stats_t	stats;
+}
+zbx_pp_script_entry_t;
+
+typedef struct
+{
+	int				es_initialized;
+	zbx_es_t			es_engine;
+	int				es_prewarm_failed;	/* 1 if environment recreation failed */
+
+	zbx_uint64_t			itemid;		/* the item being processed */
+
+	zbx_vector_pp_script_run_t	script_runs;
+	zbx_hashset_t			script_stats;	/* protected by task queue lock when used by worker */
+	time_t				script_stats_clean;
 }
 zbx_pp_context_t;
 
 void		pp_context_init(zbx_pp_context_t *ctx);
 void		pp_context_destroy(zbx_pp_context_t *ctx);
 zbx_es_t	*pp_context_es_engine(zbx_pp_context_t *ctx);
+int		pp_context_es_destroyed(zbx_pp_context_t *ctx);
+void		pp_context_es_prewarm(zbx_pp_context_t *ctx, const char *config_source_ip);
+void		pp_context_flush_script_stats(zbx_pp_context_t *ctx, time_t now);
+
+void	pp_script_stats_create(zbx_hashset_t *stats);
+void	pp_script_stats_merge(zbx_hashset_t *dst, zbx_hashset_t *src);
 
 void	pp_execute(zbx_pp_context_t *ctx, zbx_pp_item_preproc_t *preproc, zbx_pp_cache_t *cache,
 		zbx_dc_um_shared_handle_t *um_handle, zbx_variant_t *value_in, zbx_timespec_t ts,
@@ -1088,6 +1088,68 @@ static void	preprocessor_reply_top_sequences(zbx_pp_manager_t *manager, zbx_ipc_
 	zbx_vector_pp_sequence_stats_ptr_destroy(&sequences);
 }
 
+static int	preprocessor_compare_script_stats(const void *d1, const void *d2)
+{
+	const zbx_pp_script_stats_t *s1 = *(const zbx_pp_script_stats_t * const *)d1;
+	const zbx_pp_script_stats_t *s2 = *(const zbx_pp_script_stats_t * const *)d2;
+
+	ZBX_RETURN_IF_NOT_EQUAL(s2->time, s1->time);
+
+	return 0;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: respond to top scripts request                                    *
+ *                                                                            *
+ * Parameters: manager - [IN] preprocessing manager                           *
+ *             client  - [IN] request source                                  *
+ *             message - [IN] request message                                 *
+ *                                                                            *
+ ******************************************************************************/
+static void	preprocessor_reply_top_scripts(zbx_pp_manager_t *manager, zbx_ipc_client_t *client,
+		zbx_ipc_message_t *message)
+{
+	int					limit;
+	zbx_vector_pp_script_stats_ptr_t	scripts;
+	zbx_hashset_t				stats;
+	zbx_hashset_iter_t			iter;
+	zbx_pp_script_entry_t			*entry;
+	unsigned char				*data;
+	zbx_uint32_t				data_len;
+
+	zbx_vector_pp_script_stats_ptr_create(&scripts);
+	pp_script_stats_create(&stats);
+
+	zbx_preprocessor_unpack_top_request(&limit, message->data);
+
+	pp_task_queue_lock(&manager->queue);
+
+	for (int i = 0; i < manager->workers_num; i++)
+		pp_script_stats_merge(&stats, &manager->workers[i].execute_ctx.script_stats);
+
+	pp_task_queue_unlock(&manager->queue);
+
+	zbx_vector_pp_script_stats_ptr_reserve(&scripts, (size_t)stats.num_data);
+
+	zbx_hashset_iter_reset(&stats, &iter);
+	while (NULL != (entry = (zbx_pp_script_entry_t *)zbx_hashset_iter_next(&iter)))
+		zbx_vector_pp_script_stats_ptr_append(&scripts, &entry->stats);
+
+	if (limit > scripts.values_num)
+		limit = scripts.values_num;
+
+	zbx_vector_pp_script_stats_ptr_sort(&scripts, preprocessor_compare_script_stats);
+
+	data_len = zbx_preprocessor_pack_top_scripts_result(&data, &scripts, limit);
+
+	zbx_ipc_client_send(client, ZBX_IPC_PREPROCESSOR_TOP_SCRIPTS_RESULT, data, data_len);
+
+	zbx_free(data);
+	zbx_vector_pp_script_stats_ptr_destroy(&scripts);
+	zbx_hashset_destroy(&stats);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: respond to worker usage statistics request                        *
@@ -1289,6 +1351,9 @@ ZBX_THREAD_ENTRY(zbx_pp_manager_thread, args)
 				case ZBX_IPC_PREPROCESSOR_TOP_SEQUENCES:
 					preprocessor_reply_top_sequences(manager, client, message);
 					break;
+				case ZBX_IPC_PREPROCESSOR_TOP_SCRIPTS:
+					preprocessor_reply_top_scripts(manager, client, message);
+					break;
 				case ZBX_IPC_PREPROCESSOR_USAGE_STATS:
 					preprocessor_reply_usage_stats(manager, pp_args->workers_num, client);
 					break;
@@ -31,6 +31,7 @@ static zbx_ipc_message_t	cached_message;
 static int			cached_values;
 
 ZBX_PTR_VECTOR_IMPL(ipcmsg, zbx_ipc_message_t *)
+ZBX_PTR_VECTOR_IMPL(pp_script_stats_ptr, zbx_pp_script_stats_t *)
 
 static zbx_uint32_t	fields_calc_size(zbx_packed_field_t *fields, int fields_num)
 {
@@ -586,6 +587,50 @@ zbx_uint32_t	zbx_preprocessor_pack_top_sequences_result(unsigned char **data,
 	return data_len;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: pack top scripts result data into a single buffer that can be     *
+ *          used in IPC                                                       *
+ *                                                                            *
+ * Parameters: data        - [OUT] memory buffer for packed data              *
+ *             scripts     - [IN] list of script statistics                   *
+ *             scripts_num - [IN] number of scripts to pack                   *
+ *                                                                            *
+ ******************************************************************************/
+zbx_uint32_t	zbx_preprocessor_pack_top_scripts_result(unsigned char **data,
+		const zbx_vector_pp_script_stats_ptr_t *scripts, int scripts_num)
+{
+	unsigned char	*ptr;
+	zbx_uint32_t	data_len = 0, script_len = 0;
+
+	if (0 != scripts_num)
+	{
+		zbx_serialize_prepare_value(script_len, scripts->values[0]->itemid);
+		zbx_serialize_prepare_value(script_len, scripts->values[0]->executions);
+		zbx_serialize_prepare_value(script_len, scripts->values[0]->failures);
+		zbx_serialize_prepare_value(script_len, scripts->values[0]->heap_peak);
+		zbx_serialize_prepare_value(script_len, scripts->values[0]->time);
+	}
+
+	zbx_serialize_prepare_value(data_len, scripts_num);
+	data_len += script_len * (zbx_uint32_t)scripts_num;
+	*data = (unsigned char *)zbx_malloc(NULL, data_len);
+
+	ptr = *data;
+	ptr += zbx_serialize_value(ptr, scripts_num);
+
+	for (int i = 0; i < scripts_num; i++)
+	{
+		ptr += zbx_serialize_value(ptr, scripts->values[i]->itemid);
+		ptr += zbx_serialize_value(ptr, scripts->values[i]->executions);
+		ptr += zbx_serialize_value(ptr, scripts->values[i]->failures);
+		ptr += zbx_serialize_value(ptr, scripts->values[i]->heap_peak);
+		ptr += zbx_serialize_value(ptr, scripts->values[i]->time);
+	}
+
+	return data_len;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: unpack item value data from IPC data buffer                       *
@@ -785,6 +830,40 @@ void	zbx_preprocessor_unpack_top_sequences_result(zbx_vector_pp_sequence_stats_p
 	}
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: unpack top scripts result data from IPC data buffer               *
+ *                                                                            *
+ * Parameters: scripts - [OUT] script statistics                              *
+ *             data    - [IN] memory buffer for packed data                   *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_preprocessor_unpack_top_scripts_result(zbx_vector_pp_script_stats_ptr_t *scripts,
+		const unsigned char *data)
+{
+	int	scripts_num;
+
+	data += zbx_deserialize_value(data, &scripts_num);
+
+	if (0 != scripts_num)
+	{
+		zbx_vector_pp_script_stats_ptr_reserve(scripts, (size_t)scripts_num);
+
+		for (int i = 0; i < scripts_num; i++)
+		{
+			zbx_pp_script_stats_t	*stat;
+
+			stat = (zbx_pp_script_stats_t *)zbx_malloc(NULL, sizeof(zbx_pp_script_stats_t));
+			data += zbx_deserialize_value(data, &stat->itemid);
+			data += zbx_deserialize_value(data, &stat->executions);
+			data += zbx_deserialize_value(data, &stat->failures);
+			data += zbx_deserialize_value(data, &stat->heap_peak);
+			data += zbx_deserialize_value(data, &stat->time);
+			zbx_vector_pp_script_stats_ptr_append(scripts, stat);
+		}
+	}
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: sends command to preprocessor manager                             *
@@ -1110,6 +1189,33 @@ int	zbx_preprocessor_get_top_sequences(int limit, zbx_vector_pp_sequence_stats_p
 	return preprocessor_get_top_view(limit, sequences, error, ZBX_IPC_PREPROCESSOR_TOP_SEQUENCES);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get the top N scripts by total execution time                     *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_preprocessor_get_top_scripts(int limit, zbx_vector_pp_script_stats_ptr_t *scripts, char **error)
+{
+	int		ret;
+	unsigned char	*data, *result;
+	zbx_uint32_t	data_len;
+
+	data_len = zbx_preprocessor_pack_top_sequences_request(&data, limit);
+
+	if (SUCCEED != (ret = zbx_ipc_async_exchange(ZBX_IPC_SERVICE_PREPROCESSING, ZBX_IPC_PREPROCESSOR_TOP_SCRIPTS,
+			SEC_PER_MIN, data, data_len, &result, error)))
+	{
+		goto out;
+	}
+
+	zbx_preprocessor_unpack_top_scripts_result(scripts, result);
+	zbx_free(result);
+out:
+	zbx_free(data);
+
+	return ret;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: get preprocessing manager diagnostic statistics                   *
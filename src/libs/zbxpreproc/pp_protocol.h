@@ -33,6 +33,8 @@
 #define ZBX_IPC_PREPROCESSOR_TOP_SEQUENCES		10007
 #define ZBX_IPC_PREPROCESSOR_TOP_SEQUENCES_RESULT	10008
 #define ZBX_IPC_PREPROCESSOR_USAGE_STATS		10009
+#define ZBX_IPC_PREPROCESSOR_TOP_SCRIPTS		10010
+#define ZBX_IPC_PREPROCESSOR_TOP_SCRIPTS_RESULT		10011
 
 /* item value data used in preprocessing manager */
 typedef struct
@@ -86,6 +88,12 @@ zbx_uint32_t	zbx_preprocessor_pack_top_sequences_result(unsigned char **data,
 void	zbx_preprocessor_unpack_top_sequences_result(zbx_vector_pp_sequence_stats_ptr_t *sequences,
 		const unsigned char *data);
 
+zbx_uint32_t	zbx_preprocessor_pack_top_scripts_result(unsigned char **data,
+		const zbx_vector_pp_script_stats_ptr_t *scripts, int scripts_num);
+
+void	zbx_preprocessor_unpack_top_scripts_result(zbx_vector_pp_script_stats_ptr_t *scripts,
+		const unsigned char *data);
+
 zbx_uint32_t	zbx_preprocessor_pack_usage_stats(unsigned char **data, const zbx_vector_dbl_t *usage, int count);
 
 #endif
@@ -127,7 +127,6 @@ static void	*pp_worker_entry(void *args)
 
 	worker->stop = 0;
 
-	pp_context_init(&worker->execute_ctx);
 	pp_task_queue_lock(queue);
 	pp_task_queue_register_worker(queue);
 
@@ -142,6 +141,8 @@ static void	*pp_worker_entry(void *args)
 			zabbix_log(LOG_LEVEL_TRACE, "%s() process task type:%u itemid:" ZBX_FS_UI64, __func__,
 					in->type, in->itemid);
 
+			worker->execute_ctx.itemid = in->itemid;
+
 			switch (in->type)
 			{
 				case ZBX_PP_TASK_TEST:
@@ -164,12 +165,25 @@ static void	*pp_worker_entry(void *args)
 			pp_task_queue_lock(queue);
 			pp_task_queue_push_finished(queue, in);
 
+			if (0 != worker->execute_ctx.script_runs.values_num)
+				pp_context_flush_script_stats(&worker->execute_ctx, time(NULL));
+
 			if (NULL != worker->finished_cb)
 				worker->finished_cb(worker->finished_data);
 
 			continue;
 		}
 
+		/* recreate destroyed scripting environment while there are no tasks */
+		if (SUCCEED == pp_context_es_destroyed(&worker->execute_ctx))
+		{
+			pp_task_queue_unlock(queue);
+			pp_context_es_prewarm(&worker->execute_ctx, worker->config_source_ip);
+			pp_task_queue_lock(queue);
+
+			continue;
+		}
+
 		if (SUCCEED != pp_task_queue_wait(queue, &error))
 		{
 			zabbix_log(LOG_LEVEL_WARNING, "[%d] %s", worker->id, error);
@@ -217,6 +231,10 @@ int	pp_worker_init(zbx_pp_worker_t *worker, int id, zbx_pp_queue_t *queue, zbx_t
 	worker->timekeeper = timekeeper;
 	worker->config_source_ip = config_source_ip;
 
+	/* execution context is initialized before starting thread because */
+	/* its script statistics are accessed also by manager               */
+	pp_context_init(&worker->execute_ctx);
+
 	zbx_pthread_init_attr(&attr);
 	if (0 != (err = pthread_create(&worker->thread, &attr, pp_worker_entry, (void *)worker)))
 	{
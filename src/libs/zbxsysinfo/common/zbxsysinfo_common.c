@@ -106,6 +106,18 @@ void	zbx_set_user_parameter_dir(const char *path)
 	user_parameter_dir = path;
 }
 
+static int	proc_snapshot_ttl = ZBX_PROC_SNAPSHOT_TTL_DEFAULT;
+
+void	zbx_set_proc_snapshot_ttl(int ttl)
+{
+	proc_snapshot_ttl = ttl;
+}
+
+int	sysinfo_get_proc_snapshot_ttl(void)
+{
+	return proc_snapshot_ttl;
+}
+
 static int	only_active(AGENT_REQUEST *request, AGENT_RESULT *result)
 {
 	ZBX_UNUSED(request);
@@ -281,128 +281,455 @@ static int	get_cmdline(FILE *f_cmd, char **line, size_t *line_offset)
 	return FAIL;
 }
 
-static int	cmp_status(FILE *f_stat, const char *procname)
+static int	check_procstate(char state, int zbx_proc_stat)
 {
-	char	tmp[MAX_STRING_LEN];
+	switch (zbx_proc_stat)
+	{
+		case ZBX_PROC_STAT_ALL:
+			return SUCCEED;
+		case ZBX_PROC_STAT_RUN:
+			return ('R' == state) ? SUCCEED : FAIL;
+		case ZBX_PROC_STAT_SLEEP:
+			return ('S' == state) ? SUCCEED : FAIL;
+		case ZBX_PROC_STAT_ZOMB:
+			return ('Z' == state) ? SUCCEED : FAIL;
+		case ZBX_PROC_STAT_DISK:
+			return ('D' == state) ? SUCCEED : FAIL;
+		case ZBX_PROC_STAT_TRACE:
+			return ('T' == state) ? SUCCEED : FAIL;
+		default:
+			return FAIL;
+	}
+}
 
-	rewind(f_stat);
+#define PROC_SNAPSHOT_MEM_NUM		ARRSIZE(proc_snapshot_mem_labels)
 
-	while (NULL != fgets(tmp, (int)sizeof(tmp), f_stat))
-	{
-		if (0 != strncmp(tmp, "Name:\t", 6))
-			continue;
+#define PROC_SNAPSHOT_FLAG_UID		0x01
+#define PROC_SNAPSHOT_FLAG_CMDLINE	0x02
 
-		zbx_rtrim(tmp + 6, "\n");
-		if (0 == strcmp(tmp + 6, procname))
-			return SUCCEED;
-		break;
+/* memory counters of /proc/<pid>/status file kept in process table snapshot */
+static const char	*proc_snapshot_mem_labels[] = {"VmSize:\t", "VmRSS:\t", "VmPeak:\t", "VmSwap:\t", "VmLib:\t",
+		"VmLck:\t", "VmPin:\t", "VmHWM:\t", "VmData:\t", "VmStk:\t", "VmExe:\t", "VmPTE:\t"};
+
+/* process table snapshot, process attributes are kept in separate arrays indexed by process */
+typedef struct
+{
+	int		num;
+	int		alloc;
+	time_t		time;
+
+	/* Name field of status file, NULL if missing */
+	const char	**name;
+
+	/* base name of the 0th argument */
+	const char	**arg0;
+
+	/* command line with arguments separated by spaces */
+	const char	**cmdline;
+
+	uid_t		*uid;
+	char		*state;
+	unsigned char	*flags;
+
+	/* PROC_SNAPSHOT_MEM_NUM memory counters per process */
+	zbx_uint64_t	*mem;
+
+	/* bitmasks of memory counters found in status file and the ones that could not be parsed */
+	unsigned short	*mem_found;
+	unsigned short	*mem_invalid;
+
+	/* interned process names and command lines */
+	zbx_hashset_t	strings;
+}
+proc_snapshot_t;
+
+static void	proc_snapshot_string_free(void *data)
+{
+	zbx_free(*(char **)data);
+}
+
+static const char	*proc_snapshot_intern(proc_snapshot_t *snapshot, char *str)
+{
+	char	**pstr;
+
+	if (NULL == (pstr = (char **)zbx_hashset_search(&snapshot->strings, &str)))
+	{
+		str = zbx_strdup(NULL, str);
+		pstr = (char **)zbx_hashset_insert(&snapshot->strings, &str, sizeof(str));
 	}
 
-	return FAIL;
+	return *pstr;
 }
 
-static int	check_procname(FILE *f_cmd, FILE *f_stat, const char *procname)
+/******************************************************************************
+ *                                                                            *
+ * Purpose: reads contents of /proc file                                      *
+ *                                                                            *
+ * Parameters: dir_fd    - [IN] /proc directory descriptor                    *
+ *             path      - [IN] file path relative to /proc                   *
+ *             buf       - [IN/OUT] buffer for file contents                  *
+ *             buf_alloc - [IN/OUT] buffer size                               *
+ *             buf_len   - [OUT] number of bytes read                         *
+ *                                                                            *
+ * Return value: SUCCEED - file was read                                      *
+ *               NOTSUPPORTED - file could not be opened                      *
+ *               FAIL - file could not be read                                *
+ *                                                                            *
+ * Comments: Contents are terminated with '\0' which is not counted in        *
+ *           buf_len.                                                         *
+ *                                                                            *
+ ******************************************************************************/
+static int	proc_snapshot_read_file(int dir_fd, const char *path, char **buf, size_t *buf_alloc, size_t *buf_len)
 {
-	char	*tmp = NULL, *p;
-	size_t	l;
-	int	ret = SUCCEED;
+	int	fd, ret = SUCCEED;
+	ssize_t	n;
 
-	if (NULL == procname || '\0' == *procname)
-		return SUCCEED;
+	if (-1 == (fd = openat(dir_fd, path, O_RDONLY)))
+		return NOTSUPPORTED;
 
-	/* process name in /proc/[pid]/status contains limited number of characters */
-	if (SUCCEED == cmp_status(f_stat, procname))
-		return SUCCEED;
+	*buf_len = 0;
 
-	if (SUCCEED == get_cmdline(f_cmd, &tmp, &l))
+	while (1)
 	{
-		if (NULL == (p = strrchr(tmp, '/')))
-			p = tmp;
-		else
-			p++;
+		if (*buf_alloc - *buf_len < ZBX_KIBIBYTE)
+		{
+			*buf_alloc = MAX(*buf_alloc * 2, 4 * ZBX_KIBIBYTE);
+			*buf = (char *)zbx_realloc(*buf, *buf_alloc);
+		}
 
-		if (0 == strcmp(p, procname))
-			goto clean;
+		/* leave space for terminating '\0' characters */
+		if (0 >= (n = read(fd, *buf + *buf_len, *buf_alloc - *buf_len - 2)))
+		{
+			if (-1 == n)
+				ret = FAIL;
+			break;
+		}
+
+		*buf_len += (size_t)n;
 	}
 
-	ret = FAIL;
-clean:
-	zbx_free(tmp);
+	close(fd);
+
+	(*buf)[*buf_len] = '\0';
 
 	return ret;
 }
 
-static int	check_user(FILE *f_stat, struct passwd *usrinfo)
+/******************************************************************************
+ *                                                                            *
+ * Purpose: parses memory counter line of /proc/<pid>/status file, e.g.       *
+ *          "VmSize:   176712 kB"                                             *
+ *                                                                            *
+ * Parameters: value - [IN] line contents after the label                     *
+ *             bytes - [OUT] counter value in bytes                           *
+ *                                                                            *
+ * Return value: SUCCEED - counter was parsed                                 *
+ *               FAIL - otherwise                                             *
+ *                                                                            *
+ ******************************************************************************/
+static int	proc_snapshot_parse_mem(char *value, zbx_uint64_t *bytes)
 {
-	zbx_uint64_t	uid;
+	char	*p_unit;
 
-	if (NULL == usrinfo || (SUCCEED == proc_read_id(f_stat, PROC_ID_TYPE_USER, &uid) && usrinfo->pw_uid == uid))
-		return SUCCEED;
+	if (NULL == (p_unit = strrchr(value, ' ')))
+		return FAIL;
 
-	return FAIL;
+	*p_unit++ = '\0';
+
+	while (' ' == *value)
+		value++;
+
+	if (FAIL == zbx_is_uint64(value, bytes))
+		return FAIL;
+
+	convert_to_bytes(p_unit, bytes);
+
+	return SUCCEED;
 }
 
-static int	check_proccomm(FILE *f_cmd, const zbx_regexp_t *proccomm_rxp)
+static void	proc_snapshot_parse_status(proc_snapshot_t *snapshot, int index, char *status)
 {
-	char	*tmp = NULL;
-	size_t	l;
-	int	ret = SUCCEED;
+	char		*line, *next, *p;
+	zbx_uint64_t	*mem = &snapshot->mem[index * PROC_SNAPSHOT_MEM_NUM];
 
-	if (NULL == proccomm_rxp)
-		return SUCCEED;
+	snapshot->name[index] = NULL;
+	snapshot->state[index] = '\0';
+	snapshot->mem_found[index] = 0;
+	snapshot->mem_invalid[index] = 0;
 
-	if (SUCCEED == get_cmdline(f_cmd, &tmp, &l))
+	for (line = status; '\0' != *line; line = next)
 	{
-		l = l - 2;
+		if (NULL != (next = strchr(line, '\n')))
+			*next++ = '\0';
+		else
+			next = line + strlen(line);
 
-		for (size_t i = 0; i < l; i++)
-			if ('\0' == tmp[i])
-				tmp[i] = ' ';
+		if (0 == strncmp(line, "Name:\t", 6))
+		{
+			snapshot->name[index] = proc_snapshot_intern(snapshot, line + 6);
+		}
+		else if (0 == strncmp(line, "State:\t", 7))
+		{
+			snapshot->state[index] = line[7];
+		}
+		else if (0 == strncmp(line, "Uid:", 4))
+		{
+			for (p = line + 4; ' ' == *p || '\t' == *p; p++)
+				;
 
-		if (0 == zbx_regexp_match_precompiled(tmp, proccomm_rxp))
-			goto clean;
+			snapshot->uid[index] = (uid_t)atoi(p);
+			snapshot->flags[index] |= PROC_SNAPSHOT_FLAG_UID;
+		}
+		else if (0 == strncmp(line, "Vm", 2))
+		{
+			for (size_t i = 0; i < PROC_SNAPSHOT_MEM_NUM; i++)
+			{
+				size_t	label_len = strlen(proc_snapshot_mem_labels[i]);
+
+				if (0 != strncmp(line, proc_snapshot_mem_labels[i], label_len))
+					continue;
+
+				if (0 == (snapshot->mem_found[index] & (1 << i)))
+				{
+					snapshot->mem_found[index] |= (unsigned short)(1 << i);
+
+					if (SUCCEED != proc_snapshot_parse_mem(line + label_len, &mem[i]))
+						snapshot->mem_invalid[index] |= (unsigned short)(1 << i);
+				}
+
+				break;
+			}
+		}
 	}
+}
 
-	ret = FAIL;
-clean:
-	zbx_free(tmp);
+static void	proc_snapshot_parse_cmdline(proc_snapshot_t *snapshot, int index, char *cmdline, size_t len)
+{
+	char	*p;
 
-	return ret;
+	/* terminate the last argument and the argument list the same way as get_cmdline() does */
+	if (0 == len || '\0' != cmdline[len - 1])
+		cmdline[len++] = '\0';
+
+	if (1 == len || '\0' != cmdline[len - 2])
+		cmdline[len++] = '\0';
+
+	if (NULL == (p = strrchr(cmdline, '/')))
+		p = cmdline;
+	else
+		p++;
+
+	snapshot->arg0[index] = proc_snapshot_intern(snapshot, p);
+
+	for (size_t i = 0; i < len - 2; i++)
+	{
+		if ('\0' == cmdline[i])
+			cmdline[i] = ' ';
+	}
+
+	snapshot->cmdline[index] = proc_snapshot_intern(snapshot, cmdline);
+	snapshot->flags[index] |= PROC_SNAPSHOT_FLAG_CMDLINE;
 }
 
-static int	check_procstate(FILE *f_stat, int zbx_proc_stat)
+/******************************************************************************
+ *                                                                            *
+ * Purpose: reads process table into snapshot                                 *
+ *                                                                            *
+ * Parameters: snapshot - [IN/OUT]                                            *
+ *             error    - [OUT] error message                                 *
+ *                                                                            *
+ * Return value: SUCCEED - snapshot was updated                               *
+ *               FAIL - /proc directory could not be opened                   *
+ *                                                                            *
+ ******************************************************************************/
+static int	proc_snapshot_update(proc_snapshot_t *snapshot, char **error)
 {
-	char	tmp[MAX_STRING_LEN], *p;
+	DIR		*dir;
+	struct dirent	*entries;
+	char		*buf = NULL, path[MAX_STRING_LEN];
+	size_t		buf_alloc = 0, buf_len;
+	int		dir_fd;
 
-	if (ZBX_PROC_STAT_ALL == zbx_proc_stat)
-		return SUCCEED;
+	if (NULL == (dir = opendir("/proc")))
+	{
+		*error = zbx_dsprintf(NULL, "Cannot open /proc: %s", zbx_strerror(errno));
+		return FAIL;
+	}
+
+	dir_fd = dirfd(dir);
 
-	rewind(f_stat);
+	snapshot->num = 0;
+	zbx_hashset_clear(&snapshot->strings);
 
-	while (NULL != fgets(tmp, (int)sizeof(tmp), f_stat))
+	while (NULL != (entries = readdir(dir)))
 	{
-		if (0 != strncmp(tmp, "State:\t", 7))
-			continue;
+		int	index = snapshot->num, ret_cmd;
 
-		p = tmp + 7;
+		if (0 == atoi(entries->d_name))
+			continue;
 
-		switch (zbx_proc_stat)
+		if (snapshot->num == snapshot->alloc)
 		{
-			case ZBX_PROC_STAT_RUN:
-				return ('R' == *p) ? SUCCEED : FAIL;
-			case ZBX_PROC_STAT_SLEEP:
-				return ('S' == *p) ? SUCCEED : FAIL;
-			case ZBX_PROC_STAT_ZOMB:
-				return ('Z' == *p) ? SUCCEED : FAIL;
-			case ZBX_PROC_STAT_DISK:
-				return ('D' == *p) ? SUCCEED : FAIL;
-			case ZBX_PROC_STAT_TRACE:
-				return ('T' == *p) ? SUCCEED : FAIL;
-			default:
-				return FAIL;
+			snapshot->alloc = MAX(snapshot->alloc * 2, 64);
+
+			snapshot->name = (const char **)zbx_realloc(snapshot->name,
+					sizeof(const char *) * (size_t)snapshot->alloc);
+			snapshot->arg0 = (const char **)zbx_realloc(snapshot->arg0,
+					sizeof(const char *) * (size_t)snapshot->alloc);
+			snapshot->cmdline = (const char **)zbx_realloc(snapshot->cmdline,
+					sizeof(const char *) * (size_t)snapshot->alloc);
+			snapshot->uid = (uid_t *)zbx_realloc(snapshot->uid, sizeof(uid_t) * (size_t)snapshot->alloc);
+			snapshot->state = (char *)zbx_realloc(snapshot->state, (size_t)snapshot->alloc);
+			snapshot->flags = (unsigned char *)zbx_realloc(snapshot->flags, (size_t)snapshot->alloc);
+			snapshot->mem = (zbx_uint64_t *)zbx_realloc(snapshot->mem,
+					sizeof(zbx_uint64_t) * PROC_SNAPSHOT_MEM_NUM * (size_t)snapshot->alloc);
+			snapshot->mem_found = (unsigned short *)zbx_realloc(snapshot->mem_found,
+					sizeof(unsigned short) * (size_t)snapshot->alloc);
+			snapshot->mem_invalid = (unsigned short *)zbx_realloc(snapshot->mem_invalid,
+					sizeof(unsigned short) * (size_t)snapshot->alloc);
 		}
+
+		snapshot->flags[index] = 0;
+		snapshot->arg0[index] = NULL;
+		snapshot->cmdline[index] = NULL;
+
+		/* processes without readable cmdline and status files are skipped as they have exited */
+		zbx_snprintf(path, sizeof(path), "%s/cmdline", entries->d_name);
+
+		if (NOTSUPPORTED == (ret_cmd = proc_snapshot_read_file(dir_fd, path, &buf, &buf_alloc, &buf_len)))
+			continue;
+
+		if (SUCCEED == ret_cmd)
+			proc_snapshot_parse_cmdline(snapshot, index, buf, buf_len);
+
+		zbx_snprintf(path, sizeof(path), "%s/status", entries->d_name);
+
+		if (SUCCEED != proc_snapshot_read_file(dir_fd, path, &buf, &buf_alloc, &buf_len))
+			continue;
+
+		proc_snapshot_parse_status(snapshot, index, buf);
+
+		snapshot->num++;
+	}
+
+	closedir(dir);
+	zbx_free(buf);
+
+	snapshot->time = time(NULL);
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets process table snapshot, rereading /proc if it has expired    *
+ *                                                                            *
+ * Parameters: snapshot - [OUT]                                               *
+ *             error    - [OUT] error message                                 *
+ *                                                                            *
+ * Return value: SUCCEED - snapshot was returned                              *
+ *               FAIL - /proc directory could not be read                     *
+ *                                                                            *
+ * Comments: Snapshot is kept per agent process and is reused by checks       *
+ *           during ProcSnapshotTTL seconds.                                  *
+ *                                                                            *
+ ******************************************************************************/
+static int	proc_snapshot_get(const proc_snapshot_t **snapshot, char **error)
+{
+	static ZBX_THREAD_LOCAL proc_snapshot_t	proc_snapshot;
+	static ZBX_THREAD_LOCAL int		init_done;
+	int					ttl = sysinfo_get_proc_snapshot_ttl();
+
+	if (0 == init_done)
+	{
+		memset(&proc_snapshot, 0, sizeof(proc_snapshot));
+		zbx_hashset_create_ext(&proc_snapshot.strings, 1000, ZBX_DEFAULT_STRING_PTR_HASH_FUNC,
+				ZBX_DEFAULT_STR_COMPARE_FUNC, proc_snapshot_string_free,
+				ZBX_DEFAULT_MEM_MALLOC_FUNC, ZBX_DEFAULT_MEM_REALLOC_FUNC, ZBX_DEFAULT_MEM_FREE_FUNC);
+		init_done = 1;
+	}
+	else if (0 != ttl && proc_snapshot.time + ttl > time(NULL))
+	{
+		*snapshot = &proc_snapshot;
+		return SUCCEED;
+	}
+
+	if (SUCCEED != proc_snapshot_update(&proc_snapshot, error))
+		return FAIL;
+
+	*snapshot = &proc_snapshot;
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: checks if snapshot process matches process name, user and         *
+ *          command line filters                                              *
+ *                                                                            *
+ ******************************************************************************/
+static int	proc_snapshot_match(const proc_snapshot_t *snapshot, int index, const char *procname,
+		const struct passwd *usrinfo, const zbx_regexp_t *proccomm_rxp)
+{
+	/* process name in /proc/[pid]/status contains limited number of characters */
+	if (NULL != procname && '\0' != *procname &&
+			(NULL == snapshot->name[index] || 0 != strcmp(snapshot->name[index], procname)) &&
+			(NULL == snapshot->arg0[index] || 0 != strcmp(snapshot->arg0[index], procname)))
+	{
+		return FAIL;
+	}
+
+	if (NULL != usrinfo && (0 == (snapshot->flags[index] & PROC_SNAPSHOT_FLAG_UID) ||
+			usrinfo->pw_uid != snapshot->uid[index]))
+	{
+		return FAIL;
+	}
+
+	if (NULL != proccomm_rxp && (NULL == snapshot->cmdline[index] ||
+			0 != zbx_regexp_match_precompiled(snapshot->cmdline[index], proccomm_rxp)))
+	{
+		return FAIL;
+	}
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets memory counter of snapshot process                           *
+ *                                                                            *
+ * Parameters: snapshot - [IN]                                                *
+ *             index    - [IN] process index in snapshot                      *
+ *             label    - [IN] counter label, e.g. "VmData:\t"                *
+ *             bytes    - [OUT] counter value in bytes                        *
+ *                                                                            *
+ * Return value: SUCCEED - counter value was returned                         *
+ *               NOTSUPPORTED - counter was not found, for example kernel     *
+ *                              threads do not have "VmSize:" counter         *
+ *               FAIL - counter was found but could not be parsed             *
+ *                                                                            *
+ ******************************************************************************/
+static int	proc_snapshot_get_mem(const proc_snapshot_t *snapshot, int index, const char *label,
+		zbx_uint64_t *bytes)
+{
+	for (size_t i = 0; i < PROC_SNAPSHOT_MEM_NUM; i++)
+	{
+		if (0 != strcmp(label, proc_snapshot_mem_labels[i]))
+			continue;
+
+		if (0 == (snapshot->mem_found[index] & (1 << i)))
+			return NOTSUPPORTED;
+
+		if (0 != (snapshot->mem_invalid[index] & (1 << i)))
+			return FAIL;
+
+		*bytes = snapshot->mem[index * PROC_SNAPSHOT_MEM_NUM + i];
+
+		return SUCCEED;
 	}
 
+	THIS_SHOULD_NEVER_HAPPEN;
+
 	return FAIL;
 }
 
@@ -685,18 +1012,16 @@ int	proc_mem(AGENT_REQUEST *request, AGENT_RESULT *result)
 #define ZBX_VMEXE	12
 #define ZBX_VMPTE	13
 
-	char		tmp[MAX_STRING_LEN], *procname, *proccomm, *param;
-	DIR		*dir;
-	struct dirent	*entries;
-	struct passwd	*usrinfo;
-	zbx_regexp_t	*proccomm_rxp = NULL;
-	FILE		*f_cmd = NULL, *f_stat = NULL;
-	zbx_uint64_t	mem_size = 0, byte_value = 0, total_memory;
-	double		pct_size = 0.0, pct_value = 0.0;
-	int		do_task, res, mem_type_code, mem_type_tried = 0, proccount = 0, invalid_user = 0,
-			invalid_read = 0, ret = SYSINFO_RET_OK;
-	char		*mem_type = NULL, *rxp_error = NULL;
-	const char	*mem_type_search = NULL;
+	char			*procname, *proccomm, *param, *error = NULL;
+	struct passwd		*usrinfo;
+	zbx_regexp_t		*proccomm_rxp = NULL;
+	const proc_snapshot_t	*snapshot;
+	zbx_uint64_t		mem_size = 0, byte_value = 0, total_memory;
+	double			pct_size = 0.0, pct_value = 0.0;
+	int			do_task, res, mem_type_code, mem_type_tried = 0, proccount = 0, invalid_user = 0,
+				invalid_read = 0, ret = SYSINFO_RET_OK;
+	char			*mem_type = NULL, *rxp_error = NULL;
+	const char		*mem_type_search = NULL;
 
 	if (5 < request->nparam)
 	{
@@ -863,42 +1188,18 @@ int	proc_mem(AGENT_REQUEST *request, AGENT_RESULT *result)
 		}
 	}
 
-	if (NULL == (dir = opendir("/proc")))
+	if (SUCCEED != proc_snapshot_get(&snapshot, &error))
 	{
-		SET_MSG_RESULT(result, zbx_dsprintf(NULL, "Cannot open /proc: %s", zbx_strerror(errno)));
+		SET_MSG_RESULT(result, error);
 		ret = SYSINFO_RET_FAIL;
 		goto clean_re;
 	}
 
-	while (NULL != (entries = readdir(dir)))
+	for (int i = 0; i < snapshot->num; i++)
 	{
-		zbx_fclose(f_cmd);
-		zbx_fclose(f_stat);
-
-		if (0 == atoi(entries->d_name))
-			continue;
-
-		zbx_snprintf(tmp, sizeof(tmp), "/proc/%s/cmdline", entries->d_name);
-
-		if (NULL == (f_cmd = fopen(tmp, "r")))
-			continue;
-
-		zbx_snprintf(tmp, sizeof(tmp), "/proc/%s/status", entries->d_name);
-
-		if (NULL == (f_stat = fopen(tmp, "r")))
+		if (FAIL == proc_snapshot_match(snapshot, i, procname, usrinfo, proccomm_rxp))
 			continue;
 
-		if (FAIL == check_procname(f_cmd, f_stat, procname))
-			continue;
-
-		if (FAIL == check_user(f_stat, usrinfo))
-			continue;
-
-		if (FAIL == check_proccomm(f_cmd, proccomm_rxp))
-			continue;
-
-		rewind(f_stat);
-
 		if (0 == mem_type_tried)
 			mem_type_tried = 1;
 
@@ -916,7 +1217,7 @@ int	proc_mem(AGENT_REQUEST *request, AGENT_RESULT *result)
 			case ZBX_VMSTK:
 			case ZBX_VMEXE:
 			case ZBX_VMPTE:
-				res = byte_value_from_proc_file(f_stat, mem_type_search, NULL, &byte_value);
+				res = proc_snapshot_get_mem(snapshot, i, mem_type_search, &byte_value);
 
 				if (NOTSUPPORTED == res)
 					continue;
@@ -931,24 +1232,21 @@ int	proc_mem(AGENT_REQUEST *request, AGENT_RESULT *result)
 				{
 					zbx_uint64_t	m;
 
-					/* VmData, VmStk and VmExe follow in /proc/PID/status file in that order. */
-					/* Therefore we do not rewind f_stat between calls. */
-
 					mem_type_search = "VmData:\t";
 
-					if (SUCCEED == (res = byte_value_from_proc_file(f_stat, mem_type_search, NULL,
+					if (SUCCEED == (res = proc_snapshot_get_mem(snapshot, i, mem_type_search,
 							&byte_value)))
 					{
 						mem_type_search = "VmStk:\t";
 
-						if (SUCCEED == (res = byte_value_from_proc_file(f_stat, mem_type_search,
-								NULL, &m)))
+						if (SUCCEED == (res = proc_snapshot_get_mem(snapshot, i, mem_type_search,
+								&m)))
 						{
 							byte_value += m;
 							mem_type_search = "VmExe:\t";
 
-							if (SUCCEED == (res = byte_value_from_proc_file(f_stat,
-									mem_type_search, NULL, &m)))
+							if (SUCCEED == (res = proc_snapshot_get_mem(snapshot, i,
+									mem_type_search, &m)))
 							{
 								byte_value += m;
 							}
@@ -973,7 +1271,7 @@ int	proc_mem(AGENT_REQUEST *request, AGENT_RESULT *result)
 				break;
 			case ZBX_PMEM:
 				mem_type_search = "VmRSS:\t";
-				res = byte_value_from_proc_file(f_stat, mem_type_search, NULL, &byte_value);
+				res = proc_snapshot_get_mem(snapshot, i, mem_type_search, &byte_value);
 
 				if (SUCCEED == res)
 				{
@@ -1021,10 +1319,6 @@ int	proc_mem(AGENT_REQUEST *request, AGENT_RESULT *result)
 		}
 	}
 clean:
-	zbx_fclose(f_cmd);
-	zbx_fclose(f_stat);
-	closedir(dir);
-
 	if ((0 == proccount && 0 != mem_type_tried) || 0 != invalid_read)
 	{
 		char	*s;
@@ -1074,13 +1368,11 @@ clean_re:
 
 int	proc_num(AGENT_REQUEST *request, AGENT_RESULT *result)
 {
-	char		tmp[MAX_STRING_LEN], *procname, *proccomm, *param, *rxp_error = NULL;
-	DIR		*dir;
-	struct dirent	*entries;
-	struct passwd	*usrinfo;
-	zbx_regexp_t	*proccomm_rxp = NULL;
-	FILE		*f_cmd = NULL, *f_stat = NULL;
-	int		proccount = 0, invalid_user = 0, zbx_proc_stat, ret = SYSINFO_RET_OK;
+	char			*procname, *proccomm, *param, *rxp_error = NULL, *error = NULL;
+	struct passwd		*usrinfo;
+	zbx_regexp_t		*proccomm_rxp = NULL;
+	const proc_snapshot_t	*snapshot;
+	int			proccount = 0, invalid_user = 0, zbx_proc_stat, ret = SYSINFO_RET_OK;
 
 	if (4 < request->nparam)
 	{
@@ -1151,48 +1443,23 @@ int	proc_num(AGENT_REQUEST *request, AGENT_RESULT *result)
 	if (1 == invalid_user)	/* handle 0 for non-existent user after all parameters have been parsed and validated */
 		goto out;
 
-	if (NULL == (dir = opendir("/proc")))
+	if (SUCCEED != proc_snapshot_get(&snapshot, &error))
 	{
-		SET_MSG_RESULT(result, zbx_dsprintf(NULL, "Cannot open /proc: %s", zbx_strerror(errno)));
+		SET_MSG_RESULT(result, error);
 		ret = SYSINFO_RET_FAIL;
 		goto clean;
 	}
 
-	while (NULL != (entries = readdir(dir)))
+	for (int i = 0; i < snapshot->num; i++)
 	{
-		zbx_fclose(f_cmd);
-		zbx_fclose(f_stat);
-
-		if (0 == atoi(entries->d_name))
+		if (FAIL == proc_snapshot_match(snapshot, i, procname, usrinfo, proccomm_rxp))
 			continue;
 
-		zbx_snprintf(tmp, sizeof(tmp), "/proc/%s/cmdline", entries->d_name);
-
-		if (NULL == (f_cmd = fopen(tmp, "r")))
-			continue;
-
-		zbx_snprintf(tmp, sizeof(tmp), "/proc/%s/status", entries->d_name);
-
-		if (NULL == (f_stat = fopen(tmp, "r")))
-			continue;
-
-		if (FAIL == check_procname(f_cmd, f_stat, procname))
-			continue;
-
-		if (FAIL == check_user(f_stat, usrinfo))
-			continue;
-
-		if (FAIL == check_proccomm(f_cmd, proccomm_rxp))
-			continue;
-
-		if (FAIL == check_procstate(f_stat, zbx_proc_stat))
+		if (FAIL == check_procstate(snapshot->state[i], zbx_proc_stat))
 			continue;
 
 		proccount++;
 	}
-	zbx_fclose(f_cmd);
-	zbx_fclose(f_stat);
-	closedir(dir);
 out:
 	SET_UI64_RESULT(result, proccount);
 clean:
@@ -206,6 +206,7 @@ int	registry_get(AGENT_REQUEST *request, AGENT_RESULT *result);
 #endif
 
 int	sysinfo_get_config_timeout(void);
+int	sysinfo_get_proc_snapshot_ttl(void);
 
 zbx_vector_ptr_t	*get_key_access_rules(void);
 #endif /* ZABBIX_SYSINFO_H */
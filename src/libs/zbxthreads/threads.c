@@ -14,6 +14,8 @@
 
 #include "zbxthreads.h"
 
+static ZBX_THREAD_LOCAL const zbx_thread_info_t	*thread_info = NULL;
+
 #if defined(_WINDOWS) || defined(__MINGW32__)
 #include "zbxwin32.h"
 #include "zbxlog.h"
@@ -24,6 +26,8 @@ static ZBX_THREAD_ENTRY(zbx_win_thread_entry, args)
 	{
 		zbx_thread_args_t	*thread_args = (zbx_thread_args_t *)args;
 
+		thread_info = &thread_args->info;
+
 		return thread_args->entry(thread_args);
 	}
 	__except(zbx_win_seh_handler(GetExceptionInformation()))
@@ -132,6 +136,7 @@ void	zbx_thread_start(ZBX_THREAD_ENTRY_POINTER(handler), zbx_thread_args_t *thre
 
 	if (0 == *thread)	/* child process */
 	{
+		thread_info = &thread_args->info;
 		(*handler)(thread_args);
 
 		/* The zbx_thread_exit must be called from the handler. */
@@ -147,6 +152,19 @@ void	zbx_thread_start(ZBX_THREAD_ENTRY_POINTER(handler), zbx_thread_args_t *thre
 #endif
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets information of the current thread                            *
+ *                                                                            *
+ * Return value: information of the thread started by zbx_thread_start() or   *
+ *               NULL for main process and threads started by other means     *
+ *                                                                            *
+ ******************************************************************************/
+const zbx_thread_info_t	*zbx_get_thread_info(void)
+{
+	return thread_info;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: Waits until the thread is in the signalled state.                 *
@@ -33,6 +33,7 @@
 #include "zbxshmem.h"
 #include "zbxsysinc.h"
 #include "zbxalgo.h"
+#include "zbxtime.h"
 
 #if defined(HAVE_LIBXML2) && defined(HAVE_LIBCURL)
 #	include "zbxcurl.h"
@@ -58,7 +59,10 @@
  *
  * The collector must be locked only when accessing service object list and working with
  * a service object. It is not locked for new data object creation during service update,
- * which is the most time consuming task.
+ * which is the most time consuming task. The copying of new data object to shared memory
+ * and destroying of the old one are done outside the lock as well - the lock is acquired
+ * only for the separate shared memory allocator and string pool operations, so pollers
+ * are blocked only for the time of data object replacement.
  *
  * As the data retrieved by VMware collector can be quite big (for example 1 Hypervisor
  * with 500 Virtual Machines will result in approximately 20 MB of data), VMware collector
@@ -193,12 +197,17 @@ char	*vmware_shared_strdup(const char *str)
 {
 	char		*strdup;
 	zbx_uint64_t	len;
+	int		locked;
+
+	locked = vmware_shmem_oplock_acquire();
 
 	strdup = vmware_strpool_strdup(str, &vmware->strpool, &len);
 
 	if (0 < len)
 		vmware->strpool_sz += zbx_shmem_required_chunk_size(len);
 
+	vmware_shmem_oplock_release(locked);
+
 	return strdup;
 }
 
@@ -224,11 +233,16 @@ void	vmware_strpool_strfree(char *str, zbx_hashset_t *strpool, zbx_uint64_t *len
 void	vmware_shared_strfree(char *str)
 {
 	zbx_uint64_t	len;
+	int		locked;
+
+	locked = vmware_shmem_oplock_acquire();
 
 	vmware_strpool_strfree(str, &vmware->strpool, &len);
 
 	if (0 < len)
 		vmware->strpool_sz -= zbx_shmem_required_chunk_size(len);
+
+	vmware_shmem_oplock_release(locked);
 }
 
 static size_t	curl_write_cb(void *ptr, size_t size, size_t nmemb, void *userdata)
@@ -327,6 +341,66 @@ static int	zbx_http_post(CURL *easyhandle, const char *request, ZBX_HTTPPAGE **r
 
 	return SUCCEED;
 }
+/******************************************************************************
+ *                                                                            *
+ * Purpose: parses SOAP response and checks it for SOAP fault                 *
+ *                                                                            *
+ * Parameters: resp  - [IN] http response                                     *
+ *             xdoc  - [OUT] xml document response (optional)                 *
+ *             error - [OUT] error message in case of failure (optional)      *
+ *                                                                            *
+ * Return value: SUCCEED - response was parsed and contains no fault          *
+ *               FAIL    - response is not valid XML or contains SOAP fault   *
+ *                                                                            *
+ ******************************************************************************/
+static int	soap_read_response(const ZBX_HTTPPAGE *resp, xmlDoc **xdoc, char **error)
+{
+#	define ZBX_XPATH_FAULT_SLOW(max_len)									\
+		"concat(substring(" ZBX_XPATH_FAULT_FAST("faultstring")",1," ZBX_STR(max_len) "),"		\
+		"substring(concat(local-name(" ZBX_XPATH_FAULT_FAST("detail") "/*[1]),':',"			\
+		ZBX_XPATH_FAULT_FAST("detail")"//*[local-name()='name']),1,"					\
+		ZBX_STR(max_len) " * number(string-length(" ZBX_XPATH_FAULT_FAST("faultstring") ")=0)"		\
+		"* number(string-length(local-name(" ZBX_XPATH_FAULT_FAST("detail") "/*[1]) )>0)))"
+
+#	define ZBX_XPATH_FAULTSTRING(sz)									\
+		(MAX_STRING_LEN < sz ? ZBX_XPATH_FAULT_FAST("faultstring") : ZBX_XPATH_FAULT_SLOW(MAX_STRING_LEN))
+
+#	define	ZBX_XPATH_FAULT_FAST(name)									\
+		"/*/*/*[local-name()='Fault'][1]/*[local-name()='" name "'][1]"
+
+	xmlDoc	*doc;
+	int	ret = SUCCEED;
+	char	*val = NULL;
+
+	if (SUCCEED != zbx_xml_try_read_value(resp->data, resp->offset, ZBX_XPATH_FAULTSTRING(resp->offset), &doc,
+			&val, error))
+	{
+		return FAIL;
+	}
+
+	if (NULL != val)
+	{
+		zbx_free(*error);
+		*error = val;
+		ret = FAIL;
+	}
+
+	if (NULL != xdoc)
+	{
+		*xdoc = doc;
+	}
+	else
+	{
+		zbx_xml_doc_free(doc);
+	}
+
+	return ret;
+
+#	undef ZBX_XPATH_FAULTSTRING
+#	undef ZBX_XPATH_FAULT_SLOW
+#	undef ZBX_XPATH_FAULT_FAST
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: unification of vmware web service call with SOAP error validation *
@@ -350,23 +424,8 @@ int	zbx_soap_post(const char *fn_parent, CURL *easyhandle, const char *request,
 		"/*[local-name()='RetrievePropertiesExResponse']"	\
 		"/*[local-name()='returnval']/*[local-name()='token'][1]"
 
-#	define ZBX_XPATH_FAULT_SLOW(max_len)									\
-		"concat(substring(" ZBX_XPATH_FAULT_FAST("faultstring")",1," ZBX_STR(max_len) "),"		\
-		"substring(concat(local-name(" ZBX_XPATH_FAULT_FAST("detail") "/*[1]),':',"			\
-		ZBX_XPATH_FAULT_FAST("detail")"//*[local-name()='name']),1,"					\
-		ZBX_STR(max_len) " * number(string-length(" ZBX_XPATH_FAULT_FAST("faultstring") ")=0)"		\
-		"* number(string-length(local-name(" ZBX_XPATH_FAULT_FAST("detail") "/*[1]) )>0)))"
-
-#	define ZBX_XPATH_FAULTSTRING(sz)									\
-		(MAX_STRING_LEN < sz ? ZBX_XPATH_FAULT_FAST("faultstring") : ZBX_XPATH_FAULT_SLOW(MAX_STRING_LEN))
-
-#	define	ZBX_XPATH_FAULT_FAST(name)									\
-		"/*/*/*[local-name()='Fault'][1]/*[local-name()='" name "'][1]"
-
-	xmlDoc		*doc;
 	ZBX_HTTPPAGE	*resp;
-	int		ret = SUCCEED;
-	char		*val = NULL;
+	int		ret;
 
 	if (SUCCEED != zbx_http_post(easyhandle, request, &resp, error))
 		return FAIL;
@@ -374,27 +433,7 @@ int	zbx_soap_post(const char *fn_parent, CURL *easyhandle, const char *request,
 	if (NULL != fn_parent)
 		zabbix_log(LOG_LEVEL_TRACE, "%s() SOAP response: %s", fn_parent, resp->data);
 
-	if (SUCCEED == zbx_xml_try_read_value(resp->data, resp->offset, ZBX_XPATH_FAULTSTRING(resp->offset), &doc,
-			&val, error))
-	{
-		if (NULL != val)
-		{
-			zbx_free(*error);
-			*error = val;
-			ret = FAIL;
-		}
-
-		if (NULL != xdoc)
-		{
-			*xdoc = doc;
-		}
-		else
-		{
-			zbx_xml_doc_free(doc);
-		}
-	}
-	else
-		ret = FAIL;
+	ret = soap_read_response(resp, xdoc, error);
 
 	if (SUCCEED == ret && NULL != xdoc)
 	{
@@ -419,9 +458,97 @@ int	zbx_soap_post(const char *fn_parent, CURL *easyhandle, const char *request,
 	return ret;
 
 #	undef ZBX_XPATH_RETRIEVE_PROPERTIES_TOKEN
-#	undef ZBX_XPATH_FAULTSTRING
-#	undef ZBX_XPATH_FAULT_SLOW
-#	undef ZBX_XPATH_FAULT_FAST
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: libxml2 callback function suppressing streaming reader errors     *
+ *                                                                            *
+ ******************************************************************************/
+#if 21200 > LIBXML_VERSION /* version 2.12.0 */
+static void	soap_reader_error(void *user_data, xmlErrorPtr err)
+#else
+static void	soap_reader_error(void *user_data, const xmlError *err)
+#endif
+{
+	ZBX_UNUSED(user_data);
+	ZBX_UNUSED(err);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: vmware web service call returning streaming reader over the       *
+ *          response instead of the parsed document                           *
+ *                                                                            *
+ * Parameters: fn_parent  - [IN] parent function name for Log records         *
+ *             easyhandle - [IN] CURL handle                                  *
+ *             request    - [IN] http request                                 *
+ *             reader     - [OUT] xml reader positioned on the SOAP body      *
+ *                                response element                            *
+ *             error      - [OUT] error message in case of failure            *
+ *                                                                            *
+ * Return value: SUCCEED - SOAP request was completed successfully            *
+ *               FAIL    - SOAP request has failed                            *
+ *                                                                            *
+ * Comments: Large responses are read node by node without building the       *
+ *           document tree. Only SOAP faults, which are small, are parsed     *
+ *           into document to extract the error message.                      *
+ *           The reader refers to cURL handle response buffer, it must be     *
+ *           freed with xmlFreeTextReader() before the next request.          *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_soap_post_reader(const char *fn_parent, CURL *easyhandle, const char *request,
+		xmlTextReaderPtr *reader, char **error)
+{
+/* according to libxml2 changelog XML_PARSE_HUGE option was introduced in version 2.7.0 */
+#if 20700 <= LIBXML_VERSION	/* version 2.7.0 */
+#	define ZBX_XML_READER_OPTS	XML_PARSE_HUGE
+#else
+#	define ZBX_XML_READER_OPTS	0
+#endif
+	ZBX_HTTPPAGE	*resp;
+	int		rc;
+
+	if (SUCCEED != zbx_http_post(easyhandle, request, &resp, error))
+		return FAIL;
+
+	if (NULL != fn_parent)
+		zabbix_log(LOG_LEVEL_TRACE, "%s() SOAP response: %s", fn_parent, resp->data);
+
+	if (NULL == resp->data || NULL == (*reader = xmlReaderForMemory(resp->data, (int)resp->offset, "noname.xml",
+			NULL, ZBX_XML_READER_OPTS)))
+	{
+		*error = zbx_strdup(*error, "Received response has no valid XML data.");
+		return FAIL;
+	}
+
+	xmlTextReaderSetStructuredErrorHandler(*reader, soap_reader_error, NULL);
+
+	/* skip envelope and body elements */
+	while (1 == (rc = xmlTextReaderRead(*reader)))
+	{
+		if (XML_READER_TYPE_ELEMENT == xmlTextReaderNodeType(*reader) && 2 == xmlTextReaderDepth(*reader))
+			break;
+	}
+
+	if (1 != rc)
+	{
+		*error = zbx_strdup(*error, "Received response has no valid XML data.");
+		goto out;
+	}
+
+	if (0 != strcmp((const char *)xmlTextReaderConstLocalName(*reader), "Fault"))
+		return SUCCEED;
+
+	if (SUCCEED == soap_read_response(resp, NULL, error))
+		*error = zbx_strdup(*error, "Cannot read SOAP fault message.");
+out:
+	xmlFreeTextReader(*reader);
+	*reader = NULL;
+
+	return FAIL;
+
+#undef ZBX_XML_READER_OPTS
 }
 
 /******************************************************************************
@@ -2555,7 +2682,7 @@ int	zbx_vmware_service_update(zbx_vmware_service_t *service, const char *config_
 #define ZBX_INIT_UPD_XML_SIZE		(100 * ZBX_KIBIBYTE)
 	CURL				*easyhandle = NULL;
 	struct curl_slist		*headers = NULL;
-	zbx_vmware_data_t		*data;
+	zbx_vmware_data_t		*data, *data_shared, *data_old;
 	zbx_vector_str_t		hvs, dss;
 	zbx_vector_cq_value_ptr_t	dvs_query_values, prop_query_values, cust_query_values;
 	zbx_vmware_alarms_data_t	alarms_data;
@@ -2722,6 +2849,13 @@ clean:
 	zbx_vector_str_clear_ext(&dss, zbx_str_free);
 	zbx_vector_str_destroy(&dss);
 out:
+	/* The new data is copied to shared memory before being published, while it is not reachable by */
+	/* other processes. This way vmware cache is locked only for separate shared memory operations   */
+	/* during the copying and pollers are blocked just for the time of data pointer swap.            */
+	vmware_shmem_oplock_enable();
+	data_shared = vmware_shmem_data_dup(data);
+	vmware_shmem_oplock_disable();
+
 	zbx_vmware_lock();
 
 	/* remove UPDATING flag and set READY or FAILED flag */
@@ -2730,8 +2864,8 @@ out:
 #undef ZBX_VMWARE_STATE_MASK
 	service->state |= (SUCCEED == ret) ? ZBX_VMWARE_STATE_READY : ZBX_VMWARE_STATE_FAILED;
 
-	vmware_data_shared_free(service->data);
-	service->data = vmware_shmem_data_dup(data);
+	data_old = service->data;
+	service->data = data_shared;
 
 	service->lastcheck = time(NULL);
 	vmware_service_update_perf_entities(service);
@@ -2756,6 +2890,11 @@ out:
 
 	zbx_vmware_unlock();
 
+	/* the old data is not reachable after the swap and can be freed without holding the lock */
+	vmware_shmem_oplock_enable();
+	vmware_data_shared_free(data_old);
+	vmware_shmem_oplock_disable();
+
 	vmware_data_free(data);
 	zbx_vector_cq_value_ptr_clear_ext(&dvs_query_values, zbx_vmware_cq_value_free);
 	zbx_vector_cq_value_ptr_destroy(&dvs_query_values);
@@ -3010,6 +3149,32 @@ void	zbx_vmware_destroy(void)
  *                                                                            *
  ******************************************************************************/
 void	zbx_vmware_lock(void)
+{
+	double	time_start;
+
+	/* lock statistics are collected only after they have been requested */
+	if (0 == vmware->lock_stats)
+	{
+		zbx_mutex_lock(vmware_lock);
+		return;
+	}
+
+	time_start = zbx_time();
+	zbx_mutex_lock(vmware_lock);
+
+	vmware->lock_wait += zbx_time() - time_start;
+	vmware->lock_num++;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: locks vmware collector for a single shared memory operation       *
+ *                                                                            *
+ * Comments: Operation locks are not included in lock statistics, they are    *
+ *           unlocked with zbx_vmware_unlock() function.                      *
+ *                                                                            *
+ ******************************************************************************/
+void	vmware_lock_operation(void)
 {
 	zbx_mutex_lock(vmware_lock);
 }
@@ -3033,6 +3198,9 @@ void	zbx_vmware_unlock(void)
  * Return value: SUCCEED - statistics were retrieved successfully             *
  *               FAIL    - no vmware collectors are running                   *
  *                                                                            *
+ * Comments: Lock statistics are collected starting with the first request,   *
+ *           so the first returned lock_wait and lock_num are zero.           *
+ *                                                                            *
  ******************************************************************************/
 int	zbx_vmware_get_statistics(zbx_vmware_stats_t *stats)
 {
@@ -3043,6 +3211,9 @@ int	zbx_vmware_get_statistics(zbx_vmware_stats_t *stats)
 
 	stats->memory_total = vmware_shmem_get_vmware_mem()->total_size;
 	stats->memory_used = vmware_shmem_get_vmware_mem()->total_size - vmware_shmem_get_vmware_mem()->free_size;
+	stats->lock_wait = vmware->lock_wait;
+	stats->lock_num = vmware->lock_num;
+	vmware->lock_stats = 1;
 
 	zbx_vmware_unlock();
 
@@ -18,9 +18,11 @@
 
 #if defined(HAVE_LIBXML2) && defined(HAVE_LIBCURL)
 #	include "zbxxml.h"
+#	include <libxml/xmlreader.h>
 #endif
 
 zbx_vmware_t			*zbx_vmware_get_vmware(void);
+void				vmware_lock_operation(void);
 
 #if defined(HAVE_LIBXML2) && defined(HAVE_LIBCURL)
 
@@ -64,6 +66,8 @@ void	zbx_vmware_shared_tags_error_set(const char *error, zbx_vmware_data_tags_t
 void	zbx_vmware_shared_tags_replace(const zbx_vector_vmware_entity_tags_ptr_t *src, zbx_vmware_data_tags_t *dst);
 int	zbx_soap_post(const char *fn_parent, CURL *easyhandle, const char *request, xmlDoc **xdoc,
 		char **token , char **error);
+int	zbx_soap_post_reader(const char *fn_parent, CURL *easyhandle, const char *request,
+		xmlTextReaderPtr *reader, char **error);
 
 void		vmware_eventlog_msg_shared_free(zbx_vector_vmware_event_ptr_t *events);
 void		vmware_eventlog_data_shared_free(zbx_vmware_eventlog_data_t *data_eventlog);
@@ -666,144 +666,270 @@ void	vmware_service_update_perf_entities(zbx_vmware_service_t *service)
 
 /******************************************************************************
  *                                                                            *
- * Purpose: updates vmware performance statistics data                        *
+ * Purpose: reads text content of current xml reader element                  *
  *                                                                            *
- * Parameters: perfdata  - [OUT] performance counter values                   *
- *             xdoc      - [IN] xml document containing performance           *
- *                              counter values for all entities               *
- *             node      - [IN] xml node containing performance counter       *
- *                              values for specified entity                   *
+ * Parameters: reader - [IN] xml reader positioned on element                 *
  *                                                                            *
- * Return value: SUCCEED - performance entity data was parsed                 *
- *               FAIL    - performance entity data did not contain valid      *
- *                         values                                             *
+ * Return value: allocated element text or NULL if element text is empty      *
  *                                                                            *
  ******************************************************************************/
-static int	vmware_service_process_perf_entity_data(zbx_vmware_perf_data_t *perfdata, xmlDoc *xdoc, xmlNode *node)
+static char	*vmware_reader_read_value(xmlTextReaderPtr reader)
 {
-	xmlXPathContext				*xpathCtx;
-	xmlXPathObject				*xpathObj;
-	xmlNodeSetPtr				nodeset;
-	char					*instance, *counter, *value;
-	int					values = 0, ret = FAIL;
-	zbx_vector_vmware_perf_value_ptr_t	*pervalues = &perfdata->values;
-	zbx_vmware_perf_value_t			*perfvalue;
+	xmlChar	*val;
+	char	*value = NULL;
 
-	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
+	if (NULL != (val = xmlTextReaderReadString(reader)))
+	{
+		if ('\0' != *val)
+			value = zbx_strdup(NULL, (const char *)val);
 
-	xpathCtx = xmlXPathNewContext(xdoc);
-	xpathCtx->node = node;
+		xmlFree(val);
+	}
 
-	if (NULL == (xpathObj = xmlXPathEvalExpression((const xmlChar *)"*[local-name()='value']", xpathCtx)))
-		goto out;
+	return value;
+}
 
-	if (0 != xmlXPathNodeSetIsEmpty(xpathObj->nodesetval))
-		goto out;
+/******************************************************************************
+ *                                                                            *
+ * Purpose: reads attribute of current xml reader element                     *
+ *                                                                            *
+ * Parameters: reader - [IN] xml reader positioned on element                 *
+ *             name   - [IN] attribute name                                   *
+ *                                                                            *
+ * Return value: allocated attribute value or NULL if attribute is missing    *
+ *               or empty                                                     *
+ *                                                                            *
+ ******************************************************************************/
+static char	*vmware_reader_read_attribute(xmlTextReaderPtr reader, const char *name)
+{
+	xmlChar	*val;
+	char	*value = NULL;
 
-	nodeset = xpathObj->nodesetval;
-	zbx_vector_vmware_perf_value_ptr_reserve(pervalues, (size_t)(nodeset->nodeNr + pervalues->values_alloc));
+	if (NULL != (val = xmlTextReaderGetAttribute(reader, (const xmlChar *)name)))
+	{
+		if ('\0' != *val)
+			value = zbx_strdup(NULL, (const char *)val);
 
-	for (int i = 0; i < nodeset->nodeNr; i++)
+		xmlFree(val);
+	}
+
+	return value;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: parses performance counter value series of entity                 *
+ *                                                                            *
+ * Parameters: perfdata - [IN/OUT] performance entity data                    *
+ *             reader   - [IN] xml reader positioned on value series element  *
+ *                                                                            *
+ * Return value: SUCCEED - valid performance counter value was parsed         *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ * Comments: The latest sample value other than -1 is used, the latest        *
+ *           sample value otherwise.                                          *
+ *                                                                            *
+ ******************************************************************************/
+static int	vmware_service_process_perf_series(zbx_vmware_perf_data_t *perfdata, xmlTextReaderPtr reader)
+{
+	char			*instance = NULL, *counter = NULL, *value = NULL, *value_last = NULL;
+	int			depth, ret = FAIL;
+	zbx_vmware_perf_value_t	*perfvalue;
+
+	depth = xmlTextReaderDepth(reader);
+
+	if (0 != xmlTextReaderIsEmptyElement(reader))
+		return FAIL;
+
+	while (1 == xmlTextReaderRead(reader) && depth < xmlTextReaderDepth(reader))
 	{
-		if (NULL == (value = zbx_xml_node_read_value(xdoc, nodeset->nodeTab[i],
-				"*[local-name()='value'][text() != '-1'][last()]")))
-		{
-			value = zbx_xml_node_read_value(xdoc, nodeset->nodeTab[i], "*[local-name()='value'][last()]");
-		}
+		const char	*name;
+
+		if (XML_READER_TYPE_ELEMENT != xmlTextReaderNodeType(reader))
+			continue;
 
-		instance = zbx_xml_node_read_value(xdoc, nodeset->nodeTab[i], "*[local-name()='id']"
-				"/*[local-name()='instance']");
-		counter = zbx_xml_node_read_value(xdoc, nodeset->nodeTab[i], "*[local-name()='id']"
-				"/*[local-name()='counterId']");
+		name = (const char *)xmlTextReaderConstLocalName(reader);
 
-		if (NULL != value && NULL != counter)
+		if (depth + 1 == xmlTextReaderDepth(reader) && 0 == strcmp(name, "value"))
 		{
-			perfvalue = (zbx_vmware_perf_value_t *)zbx_malloc(NULL, sizeof(zbx_vmware_perf_value_t));
-
-			ZBX_STR2UINT64(perfvalue->counterid, counter);
-			perfvalue->instance = (NULL != instance ? instance : zbx_strdup(NULL, ""));
+			zbx_free(value_last);
 
-			if (0 == strcmp(value, "-1") || SUCCEED != zbx_is_uint64(value, &perfvalue->value))
+			if (NULL != (value_last = vmware_reader_read_value(reader)) && 0 != strcmp(value_last, "-1"))
+				value = zbx_strdup(value, value_last);
+		}
+		else if (depth + 2 == xmlTextReaderDepth(reader))
+		{
+			if (0 == strcmp(name, "counterId"))
 			{
-				perfvalue->value = ZBX_MAX_UINT64;
-				zabbix_log(LOG_LEVEL_DEBUG, "PerfCounter inaccessible. type:%s object id:%s "
-						"counter id:" ZBX_FS_UI64 " instance:%s value:%s", perfdata->type,
-						perfdata->id, perfvalue->counterid, perfvalue->instance, value);
+				zbx_free(counter);
+				counter = vmware_reader_read_value(reader);
 			}
-			else if (FAIL == ret)
-				ret = SUCCEED;
+			else if (0 == strcmp(name, "instance"))
+			{
+				zbx_free(instance);
+				instance = vmware_reader_read_value(reader);
+			}
+		}
+	}
+
+	if (NULL == value)
+	{
+		value = value_last;
+		value_last = NULL;
+	}
 
-			zbx_vector_vmware_perf_value_ptr_append(pervalues, perfvalue);
+	if (NULL != value && NULL != counter)
+	{
+		perfvalue = (zbx_vmware_perf_value_t *)zbx_malloc(NULL, sizeof(zbx_vmware_perf_value_t));
+
+		ZBX_STR2UINT64(perfvalue->counterid, counter);
+		perfvalue->instance = (NULL != instance ? instance : zbx_strdup(NULL, ""));
 
-			instance = NULL;
-			values++;
+		if (0 == strcmp(value, "-1") || SUCCEED != zbx_is_uint64(value, &perfvalue->value))
+		{
+			perfvalue->value = ZBX_MAX_UINT64;
+			zabbix_log(LOG_LEVEL_DEBUG, "PerfCounter inaccessible. type:%s object id:%s "
+					"counter id:" ZBX_FS_UI64 " instance:%s value:%s", perfdata->type,
+					perfdata->id, perfvalue->counterid, perfvalue->instance, value);
 		}
+		else
+			ret = SUCCEED;
 
-		zbx_free(counter);
-		zbx_free(instance);
-		zbx_free(value);
-	}
+		zbx_vector_vmware_perf_value_ptr_append(&perfdata->values, perfvalue);
 
-out:
-	xmlXPathFreeObject(xpathObj);
-	xmlXPathFreeContext(xpathCtx);
+		instance = NULL;
+	}
 
-	zabbix_log(LOG_LEVEL_DEBUG, "End of %s() values:%d", __func__, values);
+	zbx_free(counter);
+	zbx_free(instance);
+	zbx_free(value);
+	zbx_free(value_last);
 
 	return ret;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: parses performance data of single entity                          *
+ *                                                                            *
+ * Parameters: reader - [IN] xml reader positioned on entity metric element   *
+ *                                                                            *
+ * Return value: performance entity data or NULL if entity data did not       *
+ *               contain valid values                                         *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_vmware_perf_data_t	*vmware_service_process_perf_entity_data(xmlTextReaderPtr reader)
+{
+	zbx_vmware_perf_data_t	*data;
+	int			depth, ret = FAIL;
+
+	data = (zbx_vmware_perf_data_t *)zbx_malloc(NULL, sizeof(zbx_vmware_perf_data_t));
+	data->id = NULL;
+	data->type = NULL;
+	data->error = NULL;
+	zbx_vector_vmware_perf_value_ptr_create(&data->values);
+
+	depth = xmlTextReaderDepth(reader);
+
+	if (0 != xmlTextReaderIsEmptyElement(reader))
+		goto out;
+
+	while (1 == xmlTextReaderRead(reader) && depth < xmlTextReaderDepth(reader))
+	{
+		const char	*name;
+
+		if (XML_READER_TYPE_ELEMENT != xmlTextReaderNodeType(reader) ||
+				depth + 1 != xmlTextReaderDepth(reader))
+		{
+			continue;
+		}
+
+		name = (const char *)xmlTextReaderConstLocalName(reader);
+
+		if (0 == strcmp(name, "entity"))
+		{
+			if (NULL == data->id)
+			{
+				data->type = vmware_reader_read_attribute(reader, "type");
+				data->id = vmware_reader_read_value(reader);
+			}
+		}
+		else if (0 == strcmp(name, "value"))
+		{
+			if (SUCCEED == vmware_service_process_perf_series(data, reader))
+				ret = SUCCEED;
+		}
+	}
+out:
+	if (SUCCEED != ret || NULL == data->type || NULL == data->id)
+	{
+		vmware_free_perfdata(data);
+		data = NULL;
+	}
+
+	return data;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: updates vmware performance statistics data                        *
  *                                                                            *
  * Parameters: perfdata - [OUT] performance entity data                       *
- *             xdoc     - [IN] performance data xml document                  *
+ *             reader   - [IN] xml reader positioned on performance query     *
+ *                             response element                               *
+ *             error    - [OUT] error message in case of failure              *
+ *                                                                            *
+ * Return value: SUCCEED - performance data was parsed                        *
+ *               FAIL    - response is not valid XML                          *
+ *                                                                            *
+ * Comments: The response is parsed with streaming reader directly into       *
+ *           performance data, without building document tree, as it can      *
+ *           contain values of thousands entities.                            *
  *                                                                            *
  ******************************************************************************/
-static void	vmware_service_parse_perf_data(zbx_vector_vmware_perf_data_ptr_t *perfdata, xmlDoc *xdoc)
+static int	vmware_service_parse_perf_data(zbx_vector_vmware_perf_data_ptr_t *perfdata, xmlTextReaderPtr reader,
+		char **error)
 {
-	xmlXPathContext	*xpathCtx;
-	xmlXPathObject	*xpathObj;
-	xmlNodeSetPtr	nodeset;
+	zbx_vector_vmware_perf_data_ptr_t	entities;
+	int					depth, rc = 1, ret = SUCCEED;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
-	xpathCtx = xmlXPathNewContext(xdoc);
+	zbx_vector_vmware_perf_data_ptr_create(&entities);
 
-	if (NULL == (xpathObj = xmlXPathEvalExpression((const xmlChar *)"/*/*/*/*", xpathCtx)))
-		goto clean;
+	depth = xmlTextReaderDepth(reader);
 
-	if (0 != xmlXPathNodeSetIsEmpty(xpathObj->nodesetval))
-		goto clean;
+	if (0 == xmlTextReaderIsEmptyElement(reader))
+	{
+		while (1 == (rc = xmlTextReaderRead(reader)) && depth < xmlTextReaderDepth(reader))
+		{
+			zbx_vmware_perf_data_t	*data;
 
-	nodeset = xpathObj->nodesetval;
-	zbx_vector_vmware_perf_data_ptr_reserve(perfdata, (size_t)(nodeset->nodeNr + perfdata->values_alloc));
+			if (XML_READER_TYPE_ELEMENT != xmlTextReaderNodeType(reader) ||
+					depth + 1 != xmlTextReaderDepth(reader))
+			{
+				continue;
+			}
 
-	for (int i = 0; i < nodeset->nodeNr; i++)
-	{
-		zbx_vmware_perf_data_t	*data;
-		int			ret = FAIL;
+			if (NULL != (data = vmware_service_process_perf_entity_data(reader)))
+				zbx_vector_vmware_perf_data_ptr_append(&entities, data);
+		}
+	}
 
-		data = (zbx_vmware_perf_data_t *)zbx_malloc(NULL, sizeof(zbx_vmware_perf_data_t));
+	if (-1 == rc)
+	{
+		*error = zbx_strdup(*error, "Received response has no valid XML data.");
+		zbx_vector_vmware_perf_data_ptr_clear_ext(&entities, vmware_free_perfdata);
+		ret = FAIL;
+	}
+	else
+		zbx_vector_vmware_perf_data_ptr_append_array(perfdata, entities.values, entities.values_num);
 
-		data->id = zbx_xml_node_read_value(xdoc, nodeset->nodeTab[i], "*[local-name()='entity']");
-		data->type = zbx_xml_node_read_value(xdoc, nodeset->nodeTab[i], "*[local-name()='entity']/@type");
-		data->error = NULL;
-		zbx_vector_vmware_perf_value_ptr_create(&data->values);
+	zbx_vector_vmware_perf_data_ptr_destroy(&entities);
 
-		if (NULL != data->type && NULL != data->id)
-			ret = vmware_service_process_perf_entity_data(data, xdoc, nodeset->nodeTab[i]);
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s() entities:%d", __func__, perfdata->values_num);
 
-		if (SUCCEED == ret)
-			zbx_vector_vmware_perf_data_ptr_append(perfdata, data);
-		else
-			vmware_free_perfdata(data);
-	}
-clean:
-	xmlXPathFreeObject(xpathObj);
-	xmlXPathFreeContext(xpathCtx);
-	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
+	return ret;
 }
 
 /******************************************************************************
@@ -913,7 +1039,7 @@ static void	vmware_service_retrieve_perf_counters(zbx_vmware_service_t *service,
 	size_t				tmp_alloc = 0, tmp_offset;
 	int				i, j, start_counter = 0;
 	zbx_vmware_perf_entity_t	*entity;
-	xmlDoc				*doc = NULL;
+	xmlTextReaderPtr		reader = NULL;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s() counters_max:%d", __func__, counters_max);
 
@@ -1000,15 +1126,22 @@ static void	vmware_service_retrieve_perf_counters(zbx_vmware_service_t *service,
 		}
 
 		zbx_vmware_unlock();
-		zbx_xml_doc_free(doc);
 
 		zbx_strcpy_alloc(&tmp, &tmp_alloc, &tmp_offset, "</ns0:QueryPerf>");
 		zbx_strcpy_alloc(&tmp, &tmp_alloc, &tmp_offset, ZBX_POST_VSPHERE_FOOTER);
 
 		zabbix_log(LOG_LEVEL_TRACE, "%s() SOAP request: %s", __func__, tmp);
 
-		if (SUCCEED != zbx_soap_post(__func__, easyhandle, tmp, &doc, NULL, &error))
+		/* parse performance data into local memory */
+		if (SUCCEED != zbx_soap_post_reader(__func__, easyhandle, tmp, &reader, &error) ||
+				SUCCEED != vmware_service_parse_perf_data(perfdata, reader, &error))
 		{
+			if (NULL != reader)
+			{
+				xmlFreeTextReader(reader);
+				reader = NULL;
+			}
+
 			for (j = i + 1; j < entities->values_num; j++)
 			{
 				entity = (zbx_vmware_perf_entity_t *)entities->values[j];
@@ -1019,15 +1152,14 @@ static void	vmware_service_retrieve_perf_counters(zbx_vmware_service_t *service,
 			break;
 		}
 
-		/* parse performance data into local memory */
-		vmware_service_parse_perf_data(perfdata, doc);
+		xmlFreeTextReader(reader);
+		reader = NULL;
 
 		while (entities->values_num > i + 1)
 			zbx_vector_vmware_perf_entity_ptr_remove_noorder(entities, entities->values_num - 1);
 	}
 
 	zbx_free(tmp);
-	zbx_xml_doc_free(doc);
 
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
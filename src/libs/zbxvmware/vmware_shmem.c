@@ -13,6 +13,7 @@
 **/
 
 #include "vmware_shmem.h"
+#include "vmware_internal.h"
 #include "zbxshmem.h"
 
 #if defined(HAVE_LIBXML2) && defined(HAVE_LIBCURL)
@@ -34,7 +35,109 @@ void	vmware_shmem_set_vmware_mem_NULL(void)
 {
 	vmware_mem = NULL;
 }
-ZBX_SHMEM_FUNC_IMPL(__vm, vmware_mem)
+ZBX_SHMEM_FUNC_IMPL(__vm_raw, vmware_mem)
+
+#define VMWARE_SHMEM_OPLOCK_DISABLED	0
+#define VMWARE_SHMEM_OPLOCK_ENABLED	1
+#define VMWARE_SHMEM_OPLOCK_HELD	2
+
+/* process local shared memory operation locking mode */
+static int	vmware_shmem_oplock = VMWARE_SHMEM_OPLOCK_DISABLED;
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: enables locking of vmware cache for every shared memory           *
+ *          operation performed by current process                            *
+ *                                                                            *
+ * Comments: Used when shared data is built or freed while not being          *
+ *           reachable by other processes, so vmware lock needs to protect    *
+ *           only the shared memory allocator and string pool.                *
+ *                                                                            *
+ ******************************************************************************/
+void	vmware_shmem_oplock_enable(void)
+{
+	vmware_shmem_oplock = VMWARE_SHMEM_OPLOCK_ENABLED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: disables per operation locking of vmware cache                    *
+ *                                                                            *
+ ******************************************************************************/
+void	vmware_shmem_oplock_disable(void)
+{
+	vmware_shmem_oplock = VMWARE_SHMEM_OPLOCK_DISABLED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: locks vmware cache for single shared memory operation if per      *
+ *          operation locking is enabled                                      *
+ *                                                                            *
+ * Return value: SUCCEED - vmware cache was locked                            *
+ *               FAIL    - per operation locking is disabled or the lock is   *
+ *                         already held by outer operation                    *
+ *                                                                            *
+ ******************************************************************************/
+int	vmware_shmem_oplock_acquire(void)
+{
+	if (VMWARE_SHMEM_OPLOCK_ENABLED != vmware_shmem_oplock)
+		return FAIL;
+
+	vmware_lock_operation();
+	vmware_shmem_oplock = VMWARE_SHMEM_OPLOCK_HELD;
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: unlocks vmware cache locked by vmware_shmem_oplock_acquire()      *
+ *                                                                            *
+ * Parameters: locked - [IN] vmware_shmem_oplock_acquire() return value       *
+ *                                                                            *
+ ******************************************************************************/
+void	vmware_shmem_oplock_release(int locked)
+{
+	if (SUCCEED != locked)
+		return;
+
+	vmware_shmem_oplock = VMWARE_SHMEM_OPLOCK_ENABLED;
+	zbx_vmware_unlock();
+}
+
+static void	*__vm_shmem_malloc_func(void *old, size_t size)
+{
+	int	locked;
+	void	*ptr;
+
+	locked = vmware_shmem_oplock_acquire();
+	ptr = __vm_raw_shmem_malloc_func(old, size);
+	vmware_shmem_oplock_release(locked);
+
+	return ptr;
+}
+
+static void	*__vm_shmem_realloc_func(void *old, size_t size)
+{
+	int	locked;
+	void	*ptr;
+
+	locked = vmware_shmem_oplock_acquire();
+	ptr = __vm_raw_shmem_realloc_func(old, size);
+	vmware_shmem_oplock_release(locked);
+
+	return ptr;
+}
+
+static void	__vm_shmem_free_func(void *ptr)
+{
+	int	locked;
+
+	locked = vmware_shmem_oplock_acquire();
+	__vm_raw_shmem_free_func(ptr);
+	vmware_shmem_oplock_release(locked);
+}
 
 #if defined(HAVE_LIBXML2) && defined(HAVE_LIBCURL)
 
@@ -25,6 +25,10 @@
 
 zbx_shmem_info_t	*vmware_shmem_get_vmware_mem(void);
 void	vmware_shmem_set_vmware_mem_NULL(void);
+void	vmware_shmem_oplock_enable(void);
+void	vmware_shmem_oplock_disable(void);
+int	vmware_shmem_oplock_acquire(void);
+void	vmware_shmem_oplock_release(int locked);
 #if defined(HAVE_LIBXML2) && defined(HAVE_LIBCURL)
 
 #define VMWARE_SHMEM_VECTOR_CREATE_DECL(ref,type) void	vmware_shmem_vector_##type##_create_ext(ref);
@@ -32,6 +32,8 @@ void	zbx_vmware_stats_ext_get(struct zbx_json *json, const void *arg)
 				vmware_stats.memory_total * 100);
 		zbx_json_adduint64(json, "used", vmware_stats.memory_used);
 		zbx_json_addfloat(json, "pused", (double)vmware_stats.memory_used / vmware_stats.memory_total * 100);
+		zbx_json_addfloat(json, "lock_wait", vmware_stats.lock_wait);
+		zbx_json_adduint64(json, "lock_num", vmware_stats.lock_num);
 		zbx_json_close(json);
 	}
 }
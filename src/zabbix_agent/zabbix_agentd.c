@@ -55,6 +55,7 @@ static char	**config_aliases = NULL;
 static char	**config_load_module = NULL;
 static char	**config_user_parameters = NULL;
 static char	*config_user_parameter_dir = NULL;
+static int	config_proc_snapshot_ttl = ZBX_PROC_SNAPSHOT_TTL_DEFAULT;
 #if defined(_WINDOWS)
 static char	**config_perf_counters = NULL;
 static char	**config_perf_counters_en = NULL;
@@ -997,6 +998,8 @@ static void	zbx_load_config(int requirement, ZBX_TASK_EX *task)
 				ZBX_CONF_PARM_OPT,	0,			0},
 		{"UserParameterDir",		&config_user_parameter_dir,		ZBX_CFG_TYPE_STRING,
 				ZBX_CONF_PARM_OPT,	0,			0},
+		{"ProcSnapshotTTL",		&config_proc_snapshot_ttl,		ZBX_CFG_TYPE_INT,
+				ZBX_CONF_PARM_OPT,	0,			ZBX_PROC_SNAPSHOT_TTL_MAX},
 #ifndef _WINDOWS
 		{"LoadModulePath",		&config_load_module_path,		ZBX_CFG_TYPE_STRING,
 				ZBX_CONF_PARM_OPT,	0,			0},
@@ -1662,6 +1665,7 @@ int	main(int argc, char **argv)
 			zbx_load_config(ZBX_CFG_FILE_REQUIRED, &t);
 			load_aliases(config_aliases);
 			zbx_set_user_parameter_dir(config_user_parameter_dir);
+			zbx_set_proc_snapshot_ttl(config_proc_snapshot_ttl);
 
 			if (FAIL == load_user_parameters(config_user_parameters, &error))
 			{
@@ -1700,6 +1704,7 @@ int	main(int argc, char **argv)
 			}
 #endif
 			zbx_set_user_parameter_dir(config_user_parameter_dir);
+			zbx_set_proc_snapshot_ttl(config_proc_snapshot_ttl);
 
 			if (FAIL == load_user_parameters(config_user_parameters, &error))
 			{
@@ -1748,6 +1753,7 @@ int	main(int argc, char **argv)
 		default:
 			zbx_load_config(ZBX_CFG_FILE_REQUIRED, &t);
 			zbx_set_user_parameter_dir(config_user_parameter_dir);
+			zbx_set_proc_snapshot_ttl(config_proc_snapshot_ttl);
 			load_aliases(config_aliases);
 #ifdef _WINDOWS
 			if (0 == (t.flags & ZBX_TASK_FLAG_FOREGROUND))
@@ -131,6 +131,45 @@ static void	get_object_ids(const zbx_vector_db_event_t *esc_events, zbx_vector_u
 	zbx_vector_uint64_uniq(objectids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: saves eventids of trigger events matching equal/not equal         *
+ *          condition                                                         *
+ *                                                                            *
+ * Parameters: esc_events         - [IN] events to check                      *
+ *             condition          - [IN/OUT] condition for matching, outputs  *
+ *                                           event ids that match condition   *
+ *             objectids          - [IN] checked trigger ids                  *
+ *             matched_objectids  - [IN/OUT] trigger ids equal to condition   *
+ *                                           value                            *
+ *                                                                            *
+ ******************************************************************************/
+static void	add_trigger_condition_matches(const zbx_vector_db_event_t *esc_events, zbx_condition_t *condition,
+		const zbx_vector_uint64_t *objectids, zbx_vector_uint64_t *matched_objectids)
+{
+	if (ZBX_CONDITION_OPERATOR_EQUAL == condition->op)
+	{
+		for (int i = 0; i < matched_objectids->values_num; i++)
+		{
+			add_condition_match(esc_events, condition, matched_objectids->values[i],
+					EVENT_OBJECT_TRIGGER);
+		}
+
+		return;
+	}
+
+	zbx_vector_uint64_sort(matched_objectids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+
+	for (int i = 0; i < objectids->values_num; i++)
+	{
+		if (FAIL == zbx_vector_uint64_bsearch(matched_objectids, objectids->values[i],
+				ZBX_DEFAULT_UINT64_COMPARE_FUNC))
+		{
+			add_condition_match(esc_events, condition, objectids->values[i], EVENT_OBJECT_TRIGGER);
+		}
+	}
+}
+
 /******************************************************************************
  *                                                                            *
  * Parameters: esc_events - [IN]     events to check                          *
@@ -143,11 +182,7 @@ static void	get_object_ids(const zbx_vector_db_event_t *esc_events, zbx_vector_u
  ******************************************************************************/
 static int	check_host_group_condition(const zbx_vector_db_event_t *esc_events, zbx_condition_t *condition)
 {
-	char			*sql = NULL;
-	size_t			sql_alloc = 0, sql_offset = 0;
-	zbx_db_result_t		result;
-	zbx_db_row_t		row;
-	zbx_vector_uint64_t	objectids, groupids;
+	zbx_vector_uint64_t	objectids, matched_objectids;
 	zbx_uint64_t		condition_value;
 
 	if (ZBX_CONDITION_OPERATOR_EQUAL != condition->op && ZBX_CONDITION_OPERATOR_NOT_EQUAL != condition->op)
@@ -156,59 +191,14 @@ static int	check_host_group_condition(const zbx_vector_db_event_t *esc_events, z
 	ZBX_STR2UINT64(condition_value, condition->value);
 
 	zbx_vector_uint64_create(&objectids);
-	zbx_vector_uint64_create(&groupids);
+	zbx_vector_uint64_create(&matched_objectids);
 
 	get_object_ids(esc_events, &objectids);
-	zbx_dc_get_nested_hostgroupids(&condition_value, 1, &groupids);
-
-	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
-		"select distinct f.triggerid"
-		" from hosts_groups hg,hosts h,items i,functions f"
-		" where hg.hostid=h.hostid"
-			" and h.hostid=i.hostid"
-			" and i.itemid=f.itemid"
-			" and");
-
-	zbx_db_add_condition_alloc(&sql, &sql_alloc, &sql_offset, "f.triggerid",
-			objectids.values, objectids.values_num);
-
-	zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, " and");
-	zbx_db_add_condition_alloc(&sql, &sql_alloc, &sql_offset, "hg.groupid", groupids.values, groupids.values_num);
-
-	result = zbx_db_select("%s", sql);
-
-	while (NULL != (row = zbx_db_fetch(result)))
-	{
-		zbx_uint64_t	objectid;
-
-		ZBX_STR2UINT64(objectid, row[0]);
-		if (ZBX_CONDITION_OPERATOR_NOT_EQUAL == condition->op)
-		{
-			int	index;
+	zbx_dc_get_triggers_by_hostgroup(&objectids, condition_value, &matched_objectids);
+	add_trigger_condition_matches(esc_events, condition, &objectids, &matched_objectids);
 
-			if (FAIL != (index = zbx_vector_uint64_search(&objectids, objectid,
-					ZBX_DEFAULT_UINT64_COMPARE_FUNC)))
-			{
-				zbx_vector_uint64_remove_noorder(&objectids, index);
-			}
-		}
-		else
-			add_condition_match(esc_events, condition, objectid, EVENT_OBJECT_TRIGGER);
-
-	}
-	zbx_db_free_result(result);
-
-	if (ZBX_CONDITION_OPERATOR_NOT_EQUAL == condition->op)
-	{
-		int	i;
-
-		for (i = 0; i < objectids.values_num; i++)
-			add_condition_match(esc_events, condition, objectids.values[i], EVENT_OBJECT_TRIGGER);
-	}
-
-	zbx_vector_uint64_destroy(&groupids);
+	zbx_vector_uint64_destroy(&matched_objectids);
 	zbx_vector_uint64_destroy(&objectids);
-	zbx_free(sql);
 
 	return SUCCEED;
 }
@@ -404,53 +394,23 @@ static void	check_object_hierarchy(int object, const zbx_vector_db_event_t *esc_
  ******************************************************************************/
 static int	check_host_template_condition(const zbx_vector_db_event_t *esc_events, zbx_condition_t *condition)
 {
-	char				*sql = NULL;
-	size_t				sql_alloc = 0;
-	zbx_db_result_t			result;
-	zbx_db_row_t			row;
-	zbx_uint64_t			condition_value;
-	zbx_vector_uint64_t		objectids;
-	zbx_vector_uint64_pair_t	objectids_pair;
+	zbx_uint64_t		condition_value;
+	zbx_vector_uint64_t	objectids, matched_objectids;
 
 	if (ZBX_CONDITION_OPERATOR_EQUAL != condition->op && ZBX_CONDITION_OPERATOR_NOT_EQUAL != condition->op)
 		return NOTSUPPORTED;
 
-	zbx_vector_uint64_create(&objectids);
-	zbx_vector_uint64_pair_create(&objectids_pair);
-
-	get_object_ids(esc_events, &objectids);
-	objectids_to_pair(&objectids, &objectids_pair);
-
 	ZBX_STR2UINT64(condition_value, condition->value);
 
-	trigger_parents_sql_alloc(&sql, &sql_alloc, &objectids);
-
-	result = zbx_db_select("%s", sql);
-
-	while (NULL != (row = zbx_db_fetch(result)))
-	{
-		zbx_uint64_pair_t	pair;
-		int			i;
-
-		ZBX_STR2UINT64(pair.first, row[0]);
-
-		if (FAIL != (i = zbx_vector_uint64_pair_search(&objectids_pair, pair, ZBX_DEFAULT_UINT64_COMPARE_FUNC)))
-			ZBX_STR2UINT64(objectids_pair.values[i].second, row[1]);
-	}
-	zbx_db_free_result(result);
+	zbx_vector_uint64_create(&objectids);
+	zbx_vector_uint64_create(&matched_objectids);
 
-	check_object_hierarchy(EVENT_OBJECT_TRIGGER, esc_events, &objectids, &objectids_pair, condition,
-			condition_value,
-			"select distinct t.triggerid,t.templateid,i.hostid"
-				" from items i,functions f,triggers t"
-				" where i.itemid=f.itemid"
-					" and f.triggerid=t.templateid"
-					" and",
-			"t.triggerid");
+	get_object_ids(esc_events, &objectids);
+	zbx_dc_get_triggers_by_template(&objectids, condition_value, &matched_objectids);
+	add_trigger_condition_matches(esc_events, condition, &objectids, &matched_objectids);
 
+	zbx_vector_uint64_destroy(&matched_objectids);
 	zbx_vector_uint64_destroy(&objectids);
-	zbx_vector_uint64_pair_destroy(&objectids_pair);
-	zbx_free(sql);
 
 	return SUCCEED;
 }
@@ -529,9 +489,8 @@ static int	check_host_condition(const zbx_vector_db_event_t *esc_events, zbx_con
  ******************************************************************************/
 static int	check_trigger_id_condition(const zbx_vector_db_event_t *esc_events, zbx_condition_t *condition)
 {
-	zbx_uint64_t			condition_value;
-	zbx_vector_uint64_t		objectids;
-	zbx_vector_uint64_pair_t	objectids_pair;
+	zbx_uint64_t		condition_value;
+	zbx_vector_uint64_t	objectids, matched_objectids;
 
 	if (ZBX_CONDITION_OPERATOR_EQUAL != condition->op && ZBX_CONDITION_OPERATOR_NOT_EQUAL != condition->op)
 		return NOTSUPPORTED;
@@ -539,7 +498,7 @@ static int	check_trigger_id_condition(const zbx_vector_db_event_t *esc_events, z
 	ZBX_STR2UINT64(condition_value, condition->value);
 
 	zbx_vector_uint64_create(&objectids);
-	zbx_vector_uint64_pair_create(&objectids_pair);
+	zbx_vector_uint64_create(&matched_objectids);
 
 	for (int i = 0; i < esc_events->values_num; i++)
 	{
@@ -557,18 +516,13 @@ static int	check_trigger_id_condition(const zbx_vector_db_event_t *esc_events, z
 	if (0 != objectids.values_num)
 	{
 		zbx_vector_uint64_uniq(&objectids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
-		objectids_to_pair(&objectids, &objectids_pair);
 
-		check_object_hierarchy(EVENT_OBJECT_TRIGGER, esc_events, &objectids, &objectids_pair, condition,
-				condition_value,
-				"select triggerid,templateid,templateid"
-					" from triggers"
-					" where templateid is not null and",
-					"triggerid");
+		zbx_dc_get_triggers_by_parent(&objectids, condition_value, &matched_objectids);
+		add_trigger_condition_matches(esc_events, condition, &objectids, &matched_objectids);
 	}
 
+	zbx_vector_uint64_destroy(&matched_objectids);
 	zbx_vector_uint64_destroy(&objectids);
-	zbx_vector_uint64_pair_destroy(&objectids_pair);
 
 	return SUCCEED;
 }
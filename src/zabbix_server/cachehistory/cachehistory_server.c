@@ -79,29 +79,219 @@ static int	zbx_trigger_topoindex_compare(const void *d1, const void *d2)
 	return 0;
 }
 
+/* the maximum number of trigger expression contexts cached by history syncer */
+#define ZBX_TRIGGER_CTX_CACHE_MAX	10000
+/* the trigger expression contexts not used for this time are dropped */
+#define ZBX_TRIGGER_CTX_TTL		(10 * SEC_PER_MIN)
+#define ZBX_TRIGGER_CTX_PURGE_PERIOD	SEC_PER_MIN
+
+/* deserialized trigger expressions, kept by history syncer between batches */
+typedef struct
+{
+	zbx_uint64_t		triggerid;
+	zbx_uint64_t		revision;
+	char			*expression;
+	char			*recovery_expression;
+	zbx_eval_context_t	*eval_ctx;
+	zbx_eval_context_t	*eval_ctx_r;
+	int			lastaccess;
+}
+zbx_trigger_ctx_t;
+
+ZBX_PTR_VECTOR_DECL(trigger_ctx_ptr, zbx_trigger_ctx_t *)
+ZBX_PTR_VECTOR_IMPL(trigger_ctx_ptr, zbx_trigger_ctx_t *)
+
+static zbx_hashset_t	trigger_ctxs;
+static int		trigger_ctxs_purge_time;
+
+static void	trigger_ctx_clear(zbx_trigger_ctx_t *tctx)
+{
+	zbx_free(tctx->expression);
+	zbx_free(tctx->recovery_expression);
+
+	if (NULL != tctx->eval_ctx)
+	{
+		zbx_eval_clear(tctx->eval_ctx);
+		zbx_free(tctx->eval_ctx);
+	}
+
+	if (NULL != tctx->eval_ctx_r)
+	{
+		zbx_eval_clear(tctx->eval_ctx_r);
+		zbx_free(tctx->eval_ctx_r);
+	}
+}
+
+static void	trigger_ctx_clean_func(void *data)
+{
+	trigger_ctx_clear((zbx_trigger_ctx_t *)data);
+}
+
+static int	trigger_ctx_compare_lastaccess(const void *d1, const void *d2)
+{
+	const zbx_trigger_ctx_t	*c1 = *(const zbx_trigger_ctx_t * const *)d1;
+	const zbx_trigger_ctx_t	*c2 = *(const zbx_trigger_ctx_t * const *)d2;
+
+	ZBX_RETURN_IF_NOT_EQUAL(c1->lastaccess, c2->lastaccess);
+
+	return 0;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: remove trigger expression contexts not used recently and evict    *
+ *          the least recently used contexts when cache is full               *
+ *                                                                            *
+ * Parameters: now - [IN] current time                                        *
+ *                                                                            *
+ ******************************************************************************/
+static void	trigger_ctxs_purge(int now)
+{
+	zbx_hashset_iter_t	iter;
+	zbx_trigger_ctx_t	*tctx;
+
+	zbx_hashset_iter_reset(&trigger_ctxs, &iter);
+	while (NULL != (tctx = (zbx_trigger_ctx_t *)zbx_hashset_iter_next(&iter)))
+	{
+		if (tctx->lastaccess + ZBX_TRIGGER_CTX_TTL < now)
+			zbx_hashset_iter_remove(&iter);
+	}
+
+	if (ZBX_TRIGGER_CTX_CACHE_MAX <= trigger_ctxs.num_data)
+	{
+		zbx_vector_trigger_ctx_ptr_t	tctxs;
+		int				i, remove_num;
+
+		zbx_vector_trigger_ctx_ptr_create(&tctxs);
+		zbx_vector_trigger_ctx_ptr_reserve(&tctxs, (size_t)trigger_ctxs.num_data);
+
+		zbx_hashset_iter_reset(&trigger_ctxs, &iter);
+		while (NULL != (tctx = (zbx_trigger_ctx_t *)zbx_hashset_iter_next(&iter)))
+			zbx_vector_trigger_ctx_ptr_append(&tctxs, tctx);
+
+		zbx_vector_trigger_ctx_ptr_sort(&tctxs, trigger_ctx_compare_lastaccess);
+
+		/* free a tenth of cache to avoid evicting on every new trigger */
+		remove_num = trigger_ctxs.num_data - ZBX_TRIGGER_CTX_CACHE_MAX * 9 / 10;
+
+		for (i = 0; i < remove_num; i++)
+			zbx_hashset_remove_direct(&trigger_ctxs, tctxs.values[i]);
+
+		zbx_vector_trigger_ctx_ptr_destroy(&tctxs);
+	}
+
+	trigger_ctxs_purge_time = now;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get trigger expression contexts from syncer cache, deserializing  *
+ *          them if trigger is not cached or was changed                      *
+ *                                                                            *
+ * Parameters: tr    - [IN] trigger                                           *
+ *             now   - [IN] current time                                      *
+ *             stats - [IN/OUT] trigger processing statistics                 *
+ *                                                                            *
+ * Return value: cached trigger expression contexts                           *
+ *                                                                            *
+ * Comments: The trigger revision is updated by configuration cache sync      *
+ *           whenever trigger expressions change, so revision mismatch        *
+ *           invalidates cached contexts.                                     *
+ *                                                                            *
+ ******************************************************************************/
+static const zbx_trigger_ctx_t	*trigger_ctx_get(const zbx_dc_trigger_t *tr, int now,
+		zbx_hc_trigger_stats_t *stats)
+{
+	zbx_trigger_ctx_t	*tctx, tctx_local = {.triggerid = tr->triggerid};
+
+	if (NULL == (tctx = (zbx_trigger_ctx_t *)zbx_hashset_search(&trigger_ctxs, &tr->triggerid)))
+	{
+		if (ZBX_TRIGGER_CTX_CACHE_MAX <= trigger_ctxs.num_data)
+			trigger_ctxs_purge(now);
+
+		tctx = (zbx_trigger_ctx_t *)zbx_hashset_insert(&trigger_ctxs, &tctx_local, sizeof(tctx_local));
+	}
+	else if (tctx->revision != tr->revision)
+	{
+		trigger_ctx_clear(tctx);
+		memset(tctx, 0, sizeof(zbx_trigger_ctx_t));
+		tctx->triggerid = tr->triggerid;
+	}
+
+	tctx->lastaccess = now;
+
+	if (NULL != tctx->eval_ctx)
+	{
+		stats->cached_num++;
+		return tctx;
+	}
+
+	tctx->revision = tr->revision;
+	tctx->expression = zbx_strdup(NULL, tr->expression);
+	tctx->recovery_expression = zbx_strdup(NULL, tr->recovery_expression);
+
+	tctx->eval_ctx = zbx_eval_deserialize_dyn(tr->expression_bin, tctx->expression, ZBX_EVAL_EXTRACT_ALL);
+	stats->deserialized_num++;
+
+	if (TRIGGER_RECOVERY_MODE_RECOVERY_EXPRESSION == tr->recovery_mode)
+	{
+		tctx->eval_ctx_r = zbx_eval_deserialize_dyn(tr->recovery_expression_bin, tctx->recovery_expression,
+				ZBX_EVAL_EXTRACT_ALL);
+		stats->deserialized_num++;
+	}
+
+	return tctx;
+}
+
+static zbx_eval_context_t	*trigger_eval_ctx_dup(const zbx_eval_context_t *src, const char *expression)
+{
+	zbx_eval_context_t	*ctx;
+
+	ctx = (zbx_eval_context_t *)zbx_malloc(NULL, sizeof(zbx_eval_context_t));
+	zbx_eval_copy(ctx, src, expression);
+
+	return ctx;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: prepare triggers for evaluation.                                  *
  *                                                                            *
  * Parameters: triggers     - [IN] array of zbx_dc_trigger_t pointers         *
  *             triggers_num - [IN] number of triggers to prepare              *
+ *             stats        - [IN/OUT] trigger processing statistics          *
+ *                                                                            *
+ * Comments: Expression contexts are modified during evaluation, so triggers  *
+ *           get copies of the cached contexts.                               *
  *                                                                            *
  ******************************************************************************/
-static void	prepare_triggers(zbx_dc_trigger_t **triggers, int triggers_num)
+static void	prepare_triggers(zbx_dc_trigger_t **triggers, int triggers_num, zbx_hc_trigger_stats_t *stats)
 {
-	int	i;
+	int	i, now;
+
+	if (NULL == trigger_ctxs.slots)
+	{
+		zbx_hashset_create_ext(&trigger_ctxs, 100, ZBX_DEFAULT_UINT64_HASH_FUNC,
+				ZBX_DEFAULT_UINT64_COMPARE_FUNC, trigger_ctx_clean_func, ZBX_DEFAULT_MEM_MALLOC_FUNC,
+				ZBX_DEFAULT_MEM_REALLOC_FUNC, ZBX_DEFAULT_MEM_FREE_FUNC);
+	}
+
+	now = (int)time(NULL);
+
+	if (trigger_ctxs_purge_time + ZBX_TRIGGER_CTX_PURGE_PERIOD <= now)
+		trigger_ctxs_purge(now);
 
 	for (i = 0; i < triggers_num; i++)
 	{
 		zbx_dc_trigger_t	*tr = triggers[i];
+		const zbx_trigger_ctx_t	*tctx;
 
-		tr->eval_ctx = zbx_eval_deserialize_dyn(tr->expression_bin, tr->expression, ZBX_EVAL_EXTRACT_ALL);
+		tctx = trigger_ctx_get(tr, now, stats);
+
+		tr->eval_ctx = trigger_eval_ctx_dup(tctx->eval_ctx, tr->expression);
 
 		if (TRIGGER_RECOVERY_MODE_RECOVERY_EXPRESSION == tr->recovery_mode)
-		{
-			tr->eval_ctx_r = zbx_eval_deserialize_dyn(tr->recovery_expression_bin, tr->recovery_expression,
-					ZBX_EVAL_EXTRACT_ALL);
-		}
+			tr->eval_ctx_r = trigger_eval_ctx_dup(tctx->eval_ctx_r, tr->recovery_expression);
 	}
 }
 
@@ -284,7 +474,9 @@ static void	recalculate_triggers(const zbx_dc_history_t *history, int history_nu
 		zbx_add_event_func_t add_event_cb, zbx_vector_trigger_diff_ptr_t *trigger_diff, zbx_uint64_t *itemids,
 		zbx_timespec_t *timespecs, zbx_hashset_t *trigger_info, zbx_vector_dc_trigger_t *trigger_order)
 {
-	int	i, item_num = 0, timers_num = 0;
+	int			i, item_num = 0, timers_num = 0;
+	zbx_hc_trigger_stats_t	stats = {0};
+	double			time_start;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
@@ -319,13 +511,15 @@ static void	recalculate_triggers(const zbx_dc_history_t *history, int history_nu
 		THIS_SHOULD_NEVER_HAPPEN;
 	}
 
+	time_start = zbx_time();
+
 	zbx_vector_dc_trigger_reserve(trigger_order, trigger_info->num_slots);
 
 	if (0 != item_num)
 	{
 		zbx_dc_config_history_sync_get_triggers_by_itemids(trigger_info, trigger_order, itemids, timespecs,
 				item_num);
-		prepare_triggers(trigger_order->values, trigger_order->values_num);
+		prepare_triggers(trigger_order->values, trigger_order->values_num, &stats);
 		zbx_determine_items_in_expressions(trigger_order, itemids, item_num);
 	}
 
@@ -337,7 +531,8 @@ static void	recalculate_triggers(const zbx_dc_history_t *history, int history_nu
 
 		if (offset != trigger_order->values_num)
 		{
-			prepare_triggers(trigger_order->values + offset, trigger_order->values_num - offset);
+			prepare_triggers(trigger_order->values + offset, trigger_order->values_num - offset,
+					&stats);
 		}
 	}
 
@@ -345,6 +540,10 @@ static void	recalculate_triggers(const zbx_dc_history_t *history, int history_nu
 	zbx_evaluate_expressions(trigger_order, history_itemids, history_items, history_errcodes);
 	process_triggers(trigger_order, add_event_cb, trigger_diff);
 
+	stats.triggers_num = (zbx_uint64_t)trigger_order->values_num;
+	stats.time = zbx_time() - time_start;
+	zbx_hc_add_trigger_stats(&stats);
+
 	zbx_dc_free_triggers(trigger_order);
 
 	zbx_hashset_clear(trigger_info);
@@ -25,6 +25,7 @@
 #include "zbxcacheconfig.h"
 #include "zbxalgo.h"
 #include "zbxdbhigh.h"
+#include "zbxserialize.h"
 
 #define ZBX_CONNECTOR_MANAGER_DELAY	1
 #define ZBX_CONNECTOR_FLUSH_INTERVAL	1
@@ -32,13 +33,33 @@
 #define ZBX_CONNECTOR_RESCHEDULE_FALSE	0
 #define ZBX_CONNECTOR_RESCHEDULE_TRUE	1
 
+/* maximum number of concurrent requests performed by single connector worker */
+#define ZBX_CONNECTOR_WORKER_TASKS_MAX	32
+
+/* lower limits of adaptive batch size */
+#define ZBX_CONNECTOR_BATCH_RECORDS_MIN	100
+#define ZBX_CONNECTOR_BATCH_BYTES_MIN	(64 * ZBX_KIBIBYTE)
+
+/* record size in worker message: timestamp, string length and string with terminating zero, */
+/* the terminating zero stands for the newline separating records in request body             */
+#define ZBX_CONNECTOR_RECORD_SIZE(str)	(strlen(str) + 1 + sizeof(int) * 2 + sizeof(zbx_uint32_t))
+
+/* connector task being processed by worker */
+typedef struct
+{
+	zbx_uint64_t		taskid;		/* the task id */
+	zbx_uint64_t		connectorid;	/* the connector id */
+	zbx_vector_uint64_t	ids;		/* object ids of data point links sent with task */
+	int			reschedule;
+}
+zbx_connector_task_t;
+
 /* connector worker data */
 typedef struct
 {
 	zbx_ipc_client_t	*client;	/* the connected worker client */
-	zbx_uint64_t		taskid;		/* the current task id (connectorid) */
-	zbx_vector_uint64_t	ids;
-	int			reschedule;
+	zbx_connector_task_t	tasks[ZBX_CONNECTOR_WORKER_TASKS_MAX];	/* tasks in progress */
+	int			tasks_num;
 }
 zbx_connector_worker_t;
 
@@ -52,6 +73,8 @@ typedef struct
 	zbx_hashset_iter_t		iter;			/* connector iterator */
 	zbx_uint64_t			config_revision;	/* configuration revision */
 	zbx_uint64_t			connector_revision;	/* connector configuration revision */
+	zbx_uint64_t			taskid;			/* last assigned task id */
+	int				tasks_num;		/* number of tasks in progress */
 }
 zbx_connector_manager_t;
 
@@ -127,7 +150,10 @@ static void	connector_destroy_manager(zbx_connector_manager_t *manager)
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s() workers: %d", __func__, manager->worker_count);
 
 	for (i = 0; i < manager->worker_count; i++)
-		zbx_vector_uint64_destroy(&manager->workers[i].ids);
+	{
+		for (int j = 0; j < ZBX_CONNECTOR_WORKER_TASKS_MAX; j++)
+			zbx_vector_uint64_destroy(&manager->workers[i].tasks[j].ids);
+	}
 
 	zbx_free(manager->workers);
 	zbx_hashset_destroy(&manager->connectors);
@@ -171,7 +197,9 @@ static void	connector_register_worker(zbx_connector_manager_t *manager, zbx_ipc_
 
 		worker = (zbx_connector_worker_t *)&manager->workers[manager->worker_count++];
 		worker->client = client;
-		zbx_vector_uint64_create(&worker->ids);
+
+		for (int i = 0; i < ZBX_CONNECTOR_WORKER_TASKS_MAX; i++)
+			zbx_vector_uint64_create(&worker->tasks[i].ids);
 	}
 
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
@@ -179,53 +207,114 @@ static void	connector_register_worker(zbx_connector_manager_t *manager, zbx_ipc_
 
 /******************************************************************************
  *                                                                            *
- * Purpose: get worker without active task                                    *
+ * Purpose: get worker that can accept more tasks                             *
  *                                                                            *
  * Parameters: manager - [IN] connector manager                               *
  *                                                                            *
- * Return value: pointer to the worker data or NULL if none                   *
+ * Return value: pointer to the least loaded worker data or NULL if all       *
+ *               workers are processing maximum number of tasks               *
  *                                                                            *
  ******************************************************************************/
 static zbx_connector_worker_t	*connector_get_free_worker(zbx_connector_manager_t *manager)
 {
-	int	i;
+	int			i;
+	zbx_connector_worker_t	*worker = NULL;
 
 	for (i = 0; i < manager->worker_count; i++)
 	{
-		if (0 == manager->workers[i].ids.values_num)
-			return &manager->workers[i];
+		if (ZBX_CONNECTOR_WORKER_TASKS_MAX == manager->workers[i].tasks_num)
+			continue;
+
+		if (NULL == worker || manager->workers[i].tasks_num < worker->tasks_num)
+		{
+			worker = &manager->workers[i];
+
+			if (0 == worker->tasks_num)
+				break;
+		}
 	}
 
-	return NULL;
+	return worker;
 }
 
-static void	connector_get_next_task(zbx_connector_t *connector, zbx_connector_worker_t *worker,
-		unsigned char **data, size_t *data_alloc, size_t *data_offset, int *reschedule, int *processed_num)
+/******************************************************************************
+ *                                                                            *
+ * Purpose: calculate size limits of the next connector request               *
+ *                                                                            *
+ * Parameters: manager       - [IN] connector manager                         *
+ *             connector     - [IN] connector                                 *
+ *             records_limit - [OUT] maximum number of records                *
+ *             bytes_limit   - [OUT] maximum size of serialized records       *
+ *                                                                            *
+ * Comments: Queued values are spread across request slots available for the  *
+ *           connector so that backlog is sent with concurrent requests       *
+ *           instead of being serialized into single large request. Sizes     *
+ *           are counted with ZBX_CONNECTOR_RECORD_SIZE(), so the limit       *
+ *           applies to worker message and request body rather than to raw    *
+ *           values.                                                          *
+ *                                                                            *
+ ******************************************************************************/
+static void	connector_get_batch_limits(const zbx_connector_manager_t *manager, const zbx_connector_t *connector,
+		int *records_limit, size_t *bytes_limit)
 {
 #define ZBX_DATA_JSON_RESERVED		(ZBX_HISTORY_TEXT_VALUE_LEN * 4 + ZBX_KIBIBYTE * 4)
 #define ZBX_DATA_JSON_RECORD_LIMIT	(ZBX_MAX_RECV_DATA_SIZE - ZBX_DATA_JSON_RESERVED)
+	int	slots;
+
+	slots = MIN(connector->max_senders - connector->senders,
+			manager->worker_count * ZBX_CONNECTOR_WORKER_TASKS_MAX - manager->tasks_num);
+	slots = MAX(slots, 1);
+
+	*records_limit = MAX((connector->queued_values_num + slots - 1) / slots, ZBX_CONNECTOR_BATCH_RECORDS_MIN);
+
+	if (0 != connector->max_records)
+		*records_limit = MIN(*records_limit, connector->max_records);
+
+	*bytes_limit = MAX(connector->queued_bytes / (size_t)slots, ZBX_CONNECTOR_BATCH_BYTES_MIN);
+	*bytes_limit = MIN(*bytes_limit, ZBX_DATA_JSON_RECORD_LIMIT);
+#undef ZBX_DATA_JSON_RESERVED
+#undef ZBX_DATA_JSON_RECORD_LIMIT
+}
+
+static void	connector_get_next_task(zbx_connector_manager_t *manager, zbx_connector_t *connector,
+		zbx_connector_task_t *task, unsigned char **data, size_t *data_alloc, size_t *data_offset,
+		int *reschedule, int *processed_num)
+{
 	zbx_data_point_link_t	*data_point_link;
-	int			i, records = 0;
+	int			i, records = 0, records_limit;
+	size_t			bytes_limit, bytes = 0;
 
 	*reschedule = ZBX_CONNECTOR_RESCHEDULE_FALSE;
 
+	connector_get_batch_limits(manager, connector, &records_limit, &bytes_limit);
+
 	while (ZBX_CONNECTOR_RESCHEDULE_FALSE == *reschedule &&
 			SUCCEED == zbx_list_pop(&connector->data_point_link_queue, (void **)&data_point_link))
 	{
 		if (0 == *data_offset)
-			zbx_connector_serialize_connector(data, data_alloc, data_offset, connector);
+		{
+			task->taskid = ++manager->taskid;
+			zbx_connector_serialize_connector(data, data_alloc, data_offset, task->taskid, connector);
+		}
 
 		for (i = 0; i < data_point_link->connector_data_points.values_num; i++, records++)
 		{
-			if ((records == connector->max_records && 0 != connector->max_records) ||
-					*data_offset > ZBX_DATA_JSON_RECORD_LIMIT)
+			const zbx_connector_data_point_t	*data_point;
+			size_t					size;
+
+			data_point = &data_point_link->connector_data_points.values[i];
+			size = ZBX_CONNECTOR_RECORD_SIZE(data_point->str);
+
+			/* the first record is always sent, values are limited by ZBX_HISTORY_TEXT_VALUE_LEN */
+			if (records == records_limit || (0 != records && bytes + size > bytes_limit))
 			{
 				*reschedule = ZBX_CONNECTOR_RESCHEDULE_TRUE;
 				break;
 			}
 
-			zbx_connector_serialize_data_point(data, data_alloc, data_offset,
-					&data_point_link->connector_data_points.values[i]);
+			zbx_connector_serialize_data_point(data, data_alloc, data_offset, data_point);
+
+			bytes += size;
 		}
 
 		/* return back to list if over the limit */
@@ -257,20 +346,21 @@ static void	connector_get_next_task(zbx_connector_t *connector, zbx_connector_wo
 					zbx_connector_data_point_free);
 		}
 
-		zbx_vector_uint64_append(&worker->ids, data_point_link->objectid);
+		zbx_vector_uint64_append(&task->ids, data_point_link->objectid);
 	}
 
 	*processed_num += records;
 
-	if (0 != worker->ids.values_num)
+	connector->queued_values_num -= records;
+	connector->queued_bytes -= bytes;
+
+	if (0 != task->ids.values_num)
 	{
-		worker->reschedule = *reschedule;
-		worker->taskid = connector->connectorid;
+		task->reschedule = *reschedule;
+		task->connectorid = connector->connectorid;
 	}
-
-#undef ZBX_DATA_JSON_RESERVED
-#undef ZBX_DATA_JSON_RECORD_LIMIT
 }
+
 /******************************************************************************
  *                                                                            *
  * Purpose: assign available queued connector tasks to free workers           *
@@ -311,8 +401,8 @@ static void	connector_assign_tasks(zbx_connector_manager_t *manager, int now, in
 			data_offset = 0;
 			int	reschedule;
 
-			connector_get_next_task(connector, worker, &data, &data_alloc, &data_offset, &reschedule,
-					processed_num);
+			connector_get_next_task(manager, connector, &worker->tasks[worker->tasks_num], &data,
+					&data_alloc, &data_offset, &reschedule, processed_num);
 
 			if (0 == data_offset)
 				break;
@@ -324,6 +414,8 @@ static void	connector_assign_tasks(zbx_connector_manager_t *manager, int now, in
 				exit(EXIT_FAILURE);
 			}
 
+			worker->tasks_num++;
+			manager->tasks_num++;
 			connector->senders++;
 
 			if (NULL == (worker = connector_get_free_worker(manager)))
@@ -385,6 +477,9 @@ static void	connector_enqueue(zbx_connector_manager_t *manager, zbx_vector_conne
 			zbx_vector_connector_data_point_append(&data_point_link->connector_data_points,
 					connector_data_point);
 
+			connector->queued_values_num++;
+			connector->queued_bytes += ZBX_CONNECTOR_RECORD_SIZE(connector_data_point.str);
+
 			if (j == connector_objects->values[i].ids.values_num - 1)
 				connector_objects->values[i].str = NULL;
 			else
@@ -417,24 +512,44 @@ static zbx_connector_worker_t	*connector_get_worker_by_client(zbx_connector_mana
 	return worker;
 }
 
-static void	connector_add_result(zbx_connector_manager_t *manager, zbx_ipc_client_t *client, int now)
+static void	connector_add_result(zbx_connector_manager_t *manager, zbx_ipc_client_t *client,
+		const zbx_ipc_message_t *message, int now)
 {
 	zbx_connector_worker_t	*worker;
+	zbx_connector_task_t	*task = NULL, task_local;
 	zbx_connector_t		*connector;
+	zbx_uint64_t		taskid;
 	int			i;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
 	worker = connector_get_worker_by_client(manager, client);
 
-	if (NULL != (connector = (zbx_connector_t *)zbx_hashset_search(&manager->connectors, &worker->taskid)))
+	(void)zbx_deserialize_value(message->data, &taskid);
+
+	for (i = 0; i < worker->tasks_num; i++)
+	{
+		if (worker->tasks[i].taskid == taskid)
+		{
+			task = &worker->tasks[i];
+			break;
+		}
+	}
+
+	if (NULL == task)
+	{
+		THIS_SHOULD_NEVER_HAPPEN;
+		exit(EXIT_FAILURE);
+	}
+
+	if (NULL != (connector = (zbx_connector_t *)zbx_hashset_search(&manager->connectors, &task->connectorid)))
 	{
-		for (i = 0; i < worker->ids.values_num; i++)
+		for (i = 0; i < task->ids.values_num; i++)
 		{
 			zbx_data_point_link_t	*data_point_link;
 
 			if (NULL == (data_point_link = (zbx_data_point_link_t *)zbx_hashset_search(
-					&connector->data_point_links, &worker->ids.values[i])))
+					&connector->data_point_links, &task->ids.values[i])))
 			{
 				continue;
 			}
@@ -452,11 +567,21 @@ static void	connector_add_result(zbx_connector_manager_t *manager, zbx_ipc_clien
 
 		connector->senders--;
 
-		if (ZBX_CONNECTOR_RESCHEDULE_TRUE == worker->reschedule)
+		if (ZBX_CONNECTOR_RESCHEDULE_TRUE == task->reschedule)
 			connector->time_flush = now;
 	}
 
-	zbx_vector_uint64_clear(&worker->ids);
+	zbx_vector_uint64_clear(&task->ids);
+
+	/* keep tasks in progress at the beginning of array by swapping finished task with the last one */
+	worker->tasks_num--;
+	task_local = *task;
+	*task = worker->tasks[worker->tasks_num];
+	worker->tasks[worker->tasks_num] = task_local;
+
+	manager->tasks_num--;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
 
 static	void	connector_get_items_totals(zbx_connector_manager_t *manager, zbx_uint64_t *queued)
@@ -692,7 +817,7 @@ ZBX_THREAD_ENTRY(connector_manager_thread, args)
 					connector_register_worker(&manager, client, message);
 					break;
 				case ZBX_IPC_CONNECTOR_RESULT:
-					connector_add_result(&manager, client, (int)time_now);
+					connector_add_result(&manager, client, message, (int)time_now);
 					break;
 				case ZBX_IPC_CONNECTOR_DIAG_STATS:
 					connector_get_diag_stats(&manager, client);
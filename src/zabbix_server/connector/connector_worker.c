@@ -17,6 +17,8 @@
 #ifdef HAVE_LIBCURL
 #	include "zbxhttp.h"
 #	include "zbxnum.h"
+#	include "zbxcurl.h"
+#	include "zbxasynchttppoller.h"
 #endif
 
 #include "zbxtimekeeper.h"
@@ -30,6 +32,46 @@
 #include "zbxcacheconfig.h"
 #include "zbxjson.h"
 #include "zbxstr.h"
+#include "zbxserialize.h"
+
+#include <event2/event.h>
+
+/* connector worker data */
+typedef struct
+{
+	zbx_ipc_socket_t			socket;
+	struct event_base			*base;
+	struct event				*socket_event;
+#ifdef HAVE_LIBCURL
+	zbx_asynchttppoller_config		*asynchttppoller_config;
+#endif
+	const zbx_thread_connector_worker_args	*args;
+	zbx_vector_connector_data_point_t	connector_data_points;
+	zbx_uint64_t				processed_num;
+	zbx_uint64_t				connections_num;
+	int					requests_num;	/* number of requests in progress */
+	int					stop;
+	const zbx_thread_info_t			*info;
+	unsigned char				state;		/* self monitoring process state */
+	double					time_wait;	/* when waiting for events started */
+	double					time_idle;
+}
+zbx_connector_worker_t;
+
+/* connector request being performed by worker */
+typedef struct
+{
+	zbx_uint64_t		taskid;
+	zbx_connector_t		connector;
+	char			*str;
+	zbx_connector_worker_t	*worker;
+#ifdef HAVE_LIBCURL
+	zbx_http_context_t	context;
+	struct event		*attempt_timer;
+	int			attempt_interval_sec;
+#endif
+}
+zbx_connector_request_t;
 
 static int	connector_object_compare_func(const void *d1, const void *d2)
 {
@@ -37,146 +79,318 @@ static int	connector_object_compare_func(const void *d1, const void *d2)
 			&((const zbx_connector_data_point_t *)d2)->ts);
 }
 
-static void	worker_process_request(zbx_ipc_socket_t *socket, const char *config_source_ip,
-		const char *config_ssl_ca_location, const char *config_ssl_cert_location,
-		const char *config_ssl_key_location, zbx_ipc_message_t *message,
-		zbx_vector_connector_data_point_t *connector_data_points, zbx_uint64_t *processed_num)
+/******************************************************************************
+ *                                                                            *
+ * Purpose: marks worker busy when it starts processing events after waiting  *
+ *                                                                            *
+ ******************************************************************************/
+static void	worker_update_selfmon_counter(void *arg)
+{
+	zbx_connector_worker_t	*worker = (zbx_connector_worker_t *)arg;
+
+	if (ZBX_PROCESS_STATE_IDLE == worker->state)
+	{
+		zbx_update_selfmon_counter(worker->info, ZBX_PROCESS_STATE_BUSY);
+		worker->state = ZBX_PROCESS_STATE_BUSY;
+		worker->time_idle += zbx_time() - worker->time_wait;
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: reports finished request to connector manager and frees it        *
+ *                                                                            *
+ * Parameters: request - [IN] the finished request                            *
+ *                                                                            *
+ ******************************************************************************/
+static void	worker_finish_request(zbx_connector_request_t *request)
 {
-	zbx_connector_t	connector;
-	char		*str = NULL, *out = NULL, *error = NULL;
-	size_t		str_alloc = 0, str_offset = 0;
+	zbx_connector_worker_t	*worker = request->worker;
+	unsigned char		data[sizeof(zbx_uint64_t)];
 
-	zbx_connector_deserialize_connector_and_data_point(message->data, message->size, &connector,
-			connector_data_points);
+	(void)zbx_serialize_value(data, request->taskid);
 
-	zbx_vector_connector_data_point_sort(connector_data_points, connector_object_compare_func);
-	for (int i = 0; i < connector_data_points->values_num; i++)
+	if (FAIL == zbx_ipc_socket_write(&worker->socket, ZBX_IPC_CONNECTOR_RESULT, data, sizeof(data)))
 	{
-		zbx_strcpy_alloc(&str, &str_alloc, &str_offset, connector_data_points->values[i].str);
-		zbx_chrcpy_alloc(&str, &str_alloc, &str_offset, '\n');
+		zabbix_log(LOG_LEVEL_CRIT, "cannot send connector result");
+		exit(EXIT_FAILURE);
 	}
 
-	*processed_num += (zbx_uint64_t)connector_data_points->values_num;
+#ifdef HAVE_LIBCURL
+	if (NULL != request->attempt_timer)
+		event_free(request->attempt_timer);
+
+	zbx_http_context_destroy(&request->context);
+#endif
+	zbx_free(request->str);
+
+	zbx_free(request->connector.url);
+	zbx_free(request->connector.timeout);
+	zbx_free(request->connector.token);
+	zbx_free(request->connector.http_proxy);
+	zbx_free(request->connector.username);
+	zbx_free(request->connector.password);
+	zbx_free(request->connector.ssl_cert_file);
+	zbx_free(request->connector.ssl_key_file);
+	zbx_free(request->connector.ssl_key_password);
+	zbx_free(request->connector.attempt_interval);
+
+	zbx_free(request);
+
+	worker->requests_num--;
+}
 
-	zbx_vector_connector_data_point_clear_ext(connector_data_points, zbx_connector_data_point_free);
 #ifdef HAVE_LIBCURL
-#define ATTEMPT_DELAY_MAX	10
-	char			query_fields[] = "", headers[] = "", status_codes[] = "200,201,202,203,204";
-	zbx_http_context_t	context;
-	int			ret, timeout_seconds, attempt_interval_sec;
+static void	worker_log_request_error(const char *url, const char *error, const char *out)
+{
+	char	*info = NULL;
 
-	zbx_http_context_create(&context);
+	if (NULL != out)
+	{
+		struct zbx_json_parse	jp;
+		size_t			info_alloc = 0;
 
-	if (FAIL == zbx_is_time_suffix(connector.timeout, &timeout_seconds, (int)strlen(connector.timeout)))
+		if (SUCCEED != zbx_json_open(out, &jp))
+		{
+			zabbix_log(LOG_LEVEL_WARNING, "cannot retrieve error from \"%s\": %s response: %s",
+					url, zbx_json_strerror(), out);
+		}
+		else
+		{
+			if (SUCCEED != zbx_json_value_by_name_dyn(&jp, ZBX_PROTO_TAG_ERROR, &info, &info_alloc,
+				NULL))
+			{
+				zabbix_log(LOG_LEVEL_WARNING, "cannot find error tag in response from \"%s\""
+						" response: %s", url, out);
+				info = NULL;
+			}
+		}
+	}
+
+	if (NULL != info)
+		zabbix_log(LOG_LEVEL_WARNING, "cannot send data to \"%s\": %s: %s", url, error, info);
+	else
+		zabbix_log(LOG_LEVEL_WARNING, "cannot send data to \"%s\": %s", url, error);
+
+	zbx_free(info);
+}
+
+static void	worker_add_request_handle(zbx_connector_request_t *request)
+{
+	CURLMcode	merr;
+
+	*request->context.errbuf = '\0';
+
+	if (CURLM_OK != (merr = curl_multi_add_handle(request->worker->asynchttppoller_config->curl_handle,
+			request->context.easyhandle)))
 	{
-		error = zbx_dsprintf(NULL, "Invalid timeout: %s", connector.timeout);
-		ret = FAIL;
-		goto skip;
+		char	*error;
+
+		error = zbx_dsprintf(NULL, "Cannot add a standard curl handle to the multi stack: %s",
+				curl_multi_strerror(merr));
+		worker_log_request_error(request->connector.url, error, NULL);
+		zbx_free(error);
+
+		worker_finish_request(request);
 	}
+}
+
+static void	worker_attempt_timer_cb(evutil_socket_t fd, short events, void *arg)
+{
+	zbx_connector_request_t	*request = (zbx_connector_request_t *)arg;
+
+	ZBX_UNUSED(fd);
+	ZBX_UNUSED(events);
+
+	worker_update_selfmon_counter(request->worker);
+	worker_add_request_handle(request);
+}
 
-	if (FAIL == zbx_is_time_suffix(connector.attempt_interval, &attempt_interval_sec,
-			(int)strlen(connector.attempt_interval)) || ATTEMPT_DELAY_MAX < attempt_interval_sec)
+/******************************************************************************
+ *                                                                            *
+ * Purpose: processes completed request attempt                               *
+ *                                                                            *
+ * Comments: Failed attempts are repeated after attempt interval until the    *
+ *           maximum number of attempts is reached, other requests of the     *
+ *           worker are being processed meanwhile.                            *
+ *                                                                            *
+ ******************************************************************************/
+static void	worker_process_http_result(CURL *easy_handle, CURLcode err, void *arg)
+{
+	char			status_codes[] = "200,201,202,203,204", *out = NULL, *error = NULL;
+	long			response_code;
+	zbx_connector_request_t	*request;
+	zbx_connector_worker_t	*worker = (zbx_connector_worker_t *)arg;
+	CURLcode		err_info;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
+
+	if (CURLE_OK != (err_info = curl_easy_getinfo(easy_handle, CURLINFO_PRIVATE, &request)))
 	{
-		error = zbx_dsprintf(NULL, "Invalid attempt delay: %s", connector.attempt_interval);
-		ret = FAIL;
-		goto skip;
+		THIS_SHOULD_NEVER_HAPPEN;
+		zabbix_log(LOG_LEVEL_CRIT, "Cannot get pointer to private data: %s", curl_easy_strerror(err_info));
+		exit(EXIT_FAILURE);
 	}
 
-	if (SUCCEED == (ret = zbx_http_request_prepare(&context, HTTP_REQUEST_POST, connector.url, headers,
-			query_fields, str, ZBX_RETRIEVE_MODE_CONTENT, connector.http_proxy, 0, timeout_seconds,
-			connector.max_attempts, connector.ssl_cert_file, connector.ssl_key_file,
-			connector.ssl_key_password, connector.verify_peer, connector.verify_host, connector.authtype,
-			connector.username, connector.password, connector.token, ZBX_POSTTYPE_NDJSON,
-			HTTP_STORE_RAW, config_source_ip, config_ssl_ca_location, config_ssl_cert_location,
-			config_ssl_key_location, &error)))
+	curl_multi_remove_handle(worker->asynchttppoller_config->curl_handle, easy_handle);
+
+	if (SUCCEED != zbx_http_request_check_attempt(easy_handle, &request->context, &err,
+			ZBX_HTTP_CHECK_RESPONSE_CODE) && 0 < --request->context.max_attempts)
 	{
-		long		response_code;
-		CURLcode	err;
+		struct timeval	tv = {0, 0};
 
-		if (!ZBX_IS_RUNNING())
-			attempt_interval_sec = 0;
+		if (ZBX_IS_RUNNING())
+			tv.tv_sec = request->attempt_interval_sec;
 
-		err = zbx_http_request_sync_perform(context.easyhandle, &context, attempt_interval_sec,
-				ZBX_HTTP_CHECK_RESPONSE_CODE);
+		if (NULL == request->attempt_timer)
+			request->attempt_timer = evtimer_new(worker->base, worker_attempt_timer_cb, request);
 
-		if (SUCCEED == (ret = zbx_http_handle_response(context.easyhandle, &context, err, &response_code,
-				&out, &error)))
+		evtimer_add(request->attempt_timer, &tv);
+		goto out;
+	}
+
+	if (SUCCEED == zbx_http_handle_response(easy_handle, &request->context, err, &response_code, &out, &error))
+	{
+		if (FAIL == zbx_int_in_list(status_codes, (int)response_code))
 		{
-			if (FAIL == (ret = zbx_int_in_list(status_codes, (int)response_code)))
-			{
-				error = zbx_dsprintf(NULL, "Response code \"%ld\" did not match any of the"
-						" required status codes \"%s\"", response_code, status_codes);
-			}
+			error = zbx_dsprintf(NULL, "Response code \"%ld\" did not match any of the"
+					" required status codes \"%s\"", response_code, status_codes);
+			worker_log_request_error(request->connector.url, error, out);
 		}
 	}
-skip:
-	if (FAIL == ret)
+	else
+		worker_log_request_error(request->connector.url, error, out);
+
+	zbx_free(error);
+	zbx_free(out);
+
+	worker_finish_request(request);
+out:
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
+}
+#endif
+
+static void	worker_process_request(zbx_connector_worker_t *worker, zbx_ipc_message_t *message)
+{
+	zbx_connector_request_t	*request;
+	char			*error = NULL;
+	size_t			str_alloc = 0, str_offset = 0;
+
+	request = (zbx_connector_request_t *)zbx_malloc(NULL, sizeof(zbx_connector_request_t));
+	memset(request, 0, sizeof(zbx_connector_request_t));
+	request->worker = worker;
+	worker->requests_num++;
+
+	zbx_connector_deserialize_connector_and_data_point(message->data, message->size, &request->taskid,
+			&request->connector, &worker->connector_data_points);
+
+	zbx_vector_connector_data_point_sort(&worker->connector_data_points, connector_object_compare_func);
+	for (int i = 0; i < worker->connector_data_points.values_num; i++)
 	{
-		char	*info = NULL;
+		zbx_strcpy_alloc(&request->str, &str_alloc, &str_offset, worker->connector_data_points.values[i].str);
+		zbx_chrcpy_alloc(&request->str, &str_alloc, &str_offset, '\n');
+	}
 
-		if (NULL != out)
-		{
-			struct zbx_json_parse	jp;
-			size_t			info_alloc = 0;
+	worker->processed_num += (zbx_uint64_t)worker->connector_data_points.values_num;
 
-			if (SUCCEED != zbx_json_open(out, &jp))
-			{
-				zabbix_log(LOG_LEVEL_WARNING, "cannot retrieve error from \"%s\": %s response: %s",
-						connector.url, zbx_json_strerror(), out);
-			}
-			else
-			{
-				if (SUCCEED != zbx_json_value_by_name_dyn(&jp, ZBX_PROTO_TAG_ERROR, &info, &info_alloc,
-					NULL))
-				{
-					zabbix_log(LOG_LEVEL_WARNING, "cannot find error tag in response from \"%s\""
-							" response: %s", connector.url, out);
-					info = NULL;
-				}
-			}
-		}
+	zbx_vector_connector_data_point_clear_ext(&worker->connector_data_points, zbx_connector_data_point_free);
+#ifdef HAVE_LIBCURL
+#define ATTEMPT_DELAY_MAX	10
+	char			query_fields[] = "", headers[] = "";
+	int			timeout_seconds;
+	CURLcode		err;
 
-		if (NULL != info)
-		{
-			zabbix_log(LOG_LEVEL_WARNING, "cannot send data to \"%s\": %s: %s", connector.url,
-					error, info);
-		}
-		else
-			zabbix_log(LOG_LEVEL_WARNING, "cannot send data to \"%s\": %s", connector.url, error);
+	zbx_http_context_create(&request->context);
 
-		zbx_free(info);
+	if (FAIL == zbx_is_time_suffix(request->connector.timeout, &timeout_seconds,
+			(int)strlen(request->connector.timeout)))
+	{
+		error = zbx_dsprintf(NULL, "Invalid timeout: %s", request->connector.timeout);
+		goto fail;
 	}
 
-	zbx_http_context_destroy(&context);
+	if (FAIL == zbx_is_time_suffix(request->connector.attempt_interval, &request->attempt_interval_sec,
+			(int)strlen(request->connector.attempt_interval)) ||
+			ATTEMPT_DELAY_MAX < request->attempt_interval_sec)
+	{
+		error = zbx_dsprintf(NULL, "Invalid attempt delay: %s", request->connector.attempt_interval);
+		goto fail;
+	}
+
+	if (SUCCEED != zbx_http_request_prepare(&request->context, HTTP_REQUEST_POST, request->connector.url,
+			headers, query_fields, request->str, ZBX_RETRIEVE_MODE_CONTENT, request->connector.http_proxy,
+			0, timeout_seconds, request->connector.max_attempts, request->connector.ssl_cert_file,
+			request->connector.ssl_key_file, request->connector.ssl_key_password,
+			request->connector.verify_peer, request->connector.verify_host, request->connector.authtype,
+			request->connector.username, request->connector.password, request->connector.token,
+			ZBX_POSTTYPE_NDJSON, HTTP_STORE_RAW, worker->args->config_source_ip,
+			worker->args->config_ssl_ca_location, worker->args->config_ssl_cert_location,
+			worker->args->config_ssl_key_location, &error))
+	{
+		goto fail;
+	}
+
+	/* concurrent requests to the same receiver share connection when HTTP/2 is available */
+	zbx_curl_setopt_multiplex(request->context.easyhandle);
+
+	if (CURLE_OK != (err = curl_easy_setopt(request->context.easyhandle, CURLOPT_PRIVATE, request)))
+	{
+		error = zbx_dsprintf(NULL, "Cannot set pointer to private data: %s", curl_easy_strerror(err));
+		goto fail;
+	}
+
+	worker->connections_num++;
+	worker_add_request_handle(request);
+
+	return;
+fail:
+	worker_log_request_error(request->connector.url, error, NULL);
 #undef ATTEMPT_DELAY_MAX
 #else
-	ZBX_UNUSED(config_source_ip);
-	ZBX_UNUSED(config_ssl_ca_location);
-	ZBX_UNUSED(config_ssl_cert_location);
-	ZBX_UNUSED(config_ssl_key_location);
-
 	zabbix_log(LOG_LEVEL_WARNING, "Support for connectors was not compiled in: missing cURL library");
 #endif
-	zbx_free(str);
 	zbx_free(error);
-	zbx_free(out);
+	worker_finish_request(request);
+}
+
+static void	worker_socket_read_cb(evutil_socket_t fd, short what, void *arg)
+{
+	zbx_connector_worker_t	*worker = (zbx_connector_worker_t *)arg;
+	zbx_ipc_message_t	message;
+
+	ZBX_UNUSED(fd);
+	ZBX_UNUSED(what);
 
-	zbx_free(connector.url);
-	zbx_free(connector.timeout);
-	zbx_free(connector.token);
-	zbx_free(connector.http_proxy);
-	zbx_free(connector.username);
-	zbx_free(connector.password);
-	zbx_free(connector.ssl_cert_file);
-	zbx_free(connector.ssl_key_file);
-	zbx_free(connector.ssl_key_password);
-	zbx_free(connector.attempt_interval);
-
-	if (FAIL == zbx_ipc_socket_write(socket, ZBX_IPC_CONNECTOR_RESULT, NULL, 0))
+	worker_update_selfmon_counter(worker);
+
+	zbx_ipc_message_init(&message);
+
+	/* process all messages already read into socket buffer as the descriptor will not be signaled for them */
+	do
 	{
-		zabbix_log(LOG_LEVEL_CRIT, "cannot send preprocessing result");
-		exit(EXIT_FAILURE);
+		if (SUCCEED != zbx_ipc_socket_read(&worker->socket, &message))
+		{
+			if (ZBX_IS_RUNNING())
+			{
+				zabbix_log(LOG_LEVEL_CRIT, "cannot read connector service request");
+				exit(EXIT_FAILURE);
+			}
+
+			worker->stop = 1;
+			event_base_loopbreak(worker->base);
+			break;
+		}
+
+		switch (message.code)
+		{
+			case ZBX_IPC_CONNECTOR_REQUEST:
+				worker_process_request(worker, &message);
+				break;
+		}
+
+		zbx_ipc_message_clean(&message);
 	}
+	while (worker->socket.rx_buffer_offset < worker->socket.rx_buffer_bytes);
 }
 
 ZBX_THREAD_ENTRY(connector_worker_thread, args)
@@ -185,24 +399,18 @@ ZBX_THREAD_ENTRY(connector_worker_thread, args)
 				/* once in STAT_INTERVAL seconds */
 	pid_t					ppid;
 	char					*error = NULL;
-	zbx_ipc_socket_t			socket;
-	zbx_ipc_message_t			message;
-	double					time_stat, time_idle = 0, time_now, time_read;
+	double					time_stat, time_now;
 	const zbx_thread_info_t			*info = &((zbx_thread_args_t *)args)->info;
 	int					server_num = ((zbx_thread_args_t *)args)->info.server_num,
 						process_num = ((zbx_thread_args_t *)args)->info.process_num;
 	unsigned char				process_type = ((zbx_thread_args_t *)args)->info.process_type;
-	zbx_vector_connector_data_point_t	connector_data_points;
-	zbx_uint64_t				processed_num = 0, connections_num = 0;
-
-	const zbx_thread_connector_worker_args	*connector_worker_args_in = (const zbx_thread_connector_worker_args *)
-						(((zbx_thread_args_t *)args)->args);
+	zbx_connector_worker_t			worker = {.args = (const zbx_thread_connector_worker_args *)
+						(((zbx_thread_args_t *)args)->args), .info = info,
+						.state = ZBX_PROCESS_STATE_BUSY};
 
 	zbx_setproctitle("%s #%d starting", get_process_type_string(info->program_type), process_num);
 
-	zbx_ipc_message_init(&message);
-
-	if (FAIL == zbx_ipc_socket_open(&socket, ZBX_IPC_SERVICE_CONNECTOR, SEC_PER_MIN, &error))
+	if (FAIL == zbx_ipc_socket_open(&worker.socket, ZBX_IPC_SERVICE_CONNECTOR, SEC_PER_MIN, &error))
 	{
 		zabbix_log(LOG_LEVEL_CRIT, "cannot connect to connector service: %s", error);
 		zbx_free(error);
@@ -210,8 +418,31 @@ ZBX_THREAD_ENTRY(connector_worker_thread, args)
 	}
 
 	ppid = getppid();
-	zbx_ipc_socket_write(&socket, ZBX_IPC_CONNECTOR_WORKER, (unsigned char *)&ppid, sizeof(ppid));
+	zbx_ipc_socket_write(&worker.socket, ZBX_IPC_CONNECTOR_WORKER, (unsigned char *)&ppid, sizeof(ppid));
+
+	if (NULL == (worker.base = event_base_new()))
+	{
+		zabbix_log(LOG_LEVEL_CRIT, "cannot initialize event base");
+		exit(EXIT_FAILURE);
+	}
+
+	worker.socket_event = event_new(worker.base, worker.socket.fd, EV_READ | EV_PERSIST, worker_socket_read_cb,
+			&worker);
+	event_add(worker.socket_event, NULL);
 
+#ifdef HAVE_LIBCURL
+	zbx_async_httpagent_init();
+
+	if (NULL == (worker.asynchttppoller_config = zbx_async_httpagent_create(worker.base,
+			worker_process_http_result, worker_update_selfmon_counter, &worker, &error)))
+	{
+		zabbix_log(LOG_LEVEL_CRIT, "cannot initialize HTTP requests: %s", error);
+		zbx_free(error);
+		exit(EXIT_FAILURE);
+	}
+
+	zbx_curl_multi_setopt_multiplex(worker.asynchttppoller_config->curl_handle);
+#endif
 	zabbix_log(LOG_LEVEL_INFORMATION, "%s #%d started [%s #%d]", get_program_type_string(info->program_type),
 			server_num, get_process_type_string(process_type), process_num);
 
@@ -219,63 +450,49 @@ ZBX_THREAD_ENTRY(connector_worker_thread, args)
 
 	zbx_setproctitle("%s #%d started", get_process_type_string(process_type), process_num);
 
-	zbx_vector_connector_data_point_create(&connector_data_points);
+	zbx_vector_connector_data_point_create(&worker.connector_data_points);
 
 	time_stat = zbx_time();
 
-	for (;;)
+	while (0 == worker.stop)
 	{
-
 		time_now = zbx_time();
 
 		if (STAT_INTERVAL < time_now - time_stat)
 		{
-			zbx_setproctitle("%s #%d [processed values " ZBX_FS_UI64 ", connections " ZBX_FS_UI64 ", idle "
-					ZBX_FS_DBL " sec during " ZBX_FS_DBL " sec]",
-					get_process_type_string(process_type), process_num, processed_num,
-					connections_num, time_idle, time_now - time_stat);
+			zbx_setproctitle("%s #%d [processed values " ZBX_FS_UI64 ", connections " ZBX_FS_UI64
+					", in progress %d, idle " ZBX_FS_DBL " sec during " ZBX_FS_DBL " sec]",
+					get_process_type_string(process_type), process_num, worker.processed_num,
+					worker.connections_num, worker.requests_num, worker.time_idle,
+					time_now - time_stat);
 
 			time_stat = time_now;
-			time_idle = 0;
-			processed_num = 0;
-			connections_num = 0;
+			worker.time_idle = 0;
+			worker.processed_num = 0;
+			worker.connections_num = 0;
 		}
 
+		/* worker is idle while waiting for events, the callbacks mark it busy when processing them */
 		zbx_update_selfmon_counter(info, ZBX_PROCESS_STATE_IDLE);
+		worker.state = ZBX_PROCESS_STATE_IDLE;
+		worker.time_wait = zbx_time();
 
-		if (SUCCEED != zbx_ipc_socket_read(&socket, &message))
-		{
-			if (ZBX_IS_RUNNING())
-			{
-				zabbix_log(LOG_LEVEL_CRIT, "cannot read connector service request");
-				exit(EXIT_FAILURE);
-			}
-
-			break;
-		}
-
-		zbx_update_selfmon_counter(info, ZBX_PROCESS_STATE_BUSY);
-
-		time_read = zbx_time();
-		time_idle += time_read - time_now;
+		event_base_loop(worker.base, EVLOOP_ONCE);
 
-		zbx_update_env(get_process_type_string(process_type), time_read);
+		worker_update_selfmon_counter(&worker);
 
-		switch (message.code)
-		{
-			case ZBX_IPC_CONNECTOR_REQUEST:
-				worker_process_request(&socket, connector_worker_args_in->config_source_ip,
-						connector_worker_args_in->config_ssl_ca_location,
-						connector_worker_args_in->config_ssl_cert_location,
-						connector_worker_args_in->config_ssl_key_location,
-						&message, &connector_data_points, &processed_num);
-				connections_num++;
-				break;
-		}
-
-		zbx_ipc_message_clean(&message);
+		zbx_update_env(get_process_type_string(process_type), zbx_time());
 	}
 
-	zbx_vector_connector_data_point_destroy(&connector_data_points);
+	event_del(worker.socket_event);
+	event_free(worker.socket_event);
+#ifdef HAVE_LIBCURL
+	zbx_async_httpagent_clean(worker.asynchttppoller_config);
+	zbx_free(worker.asynchttppoller_config);
+#endif
+	event_base_free(worker.base);
+
+	zbx_vector_connector_data_point_destroy(&worker.connector_data_points);
 	exit(EXIT_SUCCESS);
+#undef STAT_INTERVAL
 }
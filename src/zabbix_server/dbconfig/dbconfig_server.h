@@ -29,6 +29,7 @@ typedef struct
 	const char		*config_ssl_ca_location;
 	const char		*config_ssl_cert_location;
 	const char		*config_ssl_key_location;
+	const char		*config_cache_snapshot_file;
 }
 zbx_thread_dbconfig_args;
 
@@ -32,6 +32,7 @@
 					ZBX_DIAG_LLD_VALUES)
 
 #define ZBX_DIAG_ALERTING_ALERTS	0x00000001
+#define ZBX_DIAG_ALERTING_LATENCY	0x00000002
 
 #define ZBX_DIAG_ALERTING_SIMPLE	(ZBX_DIAG_ALERTING_ALERTS)
 
@@ -392,6 +393,46 @@ static void	diag_add_alerting_sources(struct zbx_json *json, const char *field,
 	zbx_json_close(json);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: add media type alert queue latency histograms to output json      *
+ *                                                                            *
+ * Parameters: json      - [OUT] the output json                              *
+ *             field     - [IN] the field name                                *
+ *             latencies - [IN] media type latency histograms                 *
+ *                                                                            *
+ ******************************************************************************/
+static void	diag_add_alerting_latency(struct zbx_json *json, const char *field,
+		const zbx_vector_am_latency_stats_ptr_t *latencies)
+{
+	static const int	bounds[] = {ZBX_AM_LATENCY_BOUNDS};
+
+	zbx_json_addarray(json, field);
+
+	for (int i = 0; i < latencies->values_num; i++)
+	{
+		const zbx_am_latency_stats_t	*latency = latencies->values[i];
+		char				name[16];
+
+		zbx_json_addobject(json, NULL);
+		zbx_json_adduint64(json, "mediatypeid", latency->mediatypeid);
+
+		for (int j = 0; j < ZBX_AM_LATENCY_BUCKETS_NUM; j++)
+		{
+			if (j < (int)ARRSIZE(bounds))
+				zbx_snprintf(name, sizeof(name), "%ds", bounds[j]);
+			else
+				zbx_strlcpy(name, "inf", sizeof(name));
+
+			zbx_json_adduint64(json, name, latency->alerts_num[j]);
+		}
+
+		zbx_json_close(json);
+	}
+
+	zbx_json_close(json);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: add requested alert manager diagnostic information to json data   *
@@ -411,8 +452,10 @@ static int	diag_add_alerting_info(const struct zbx_json_parse *jp, struct zbx_js
 	double				time1, time2, time_total = 0;
 	zbx_uint64_t			fields;
 	zbx_diag_map_t			field_map[] = {
-							{"", ZBX_DIAG_ALERTING_SIMPLE},
+							{"", ZBX_DIAG_ALERTING_SIMPLE |
+								ZBX_DIAG_ALERTING_LATENCY},
 							{"alerts", ZBX_DIAG_ALERTING_ALERTS},
+							{"latency", ZBX_DIAG_ALERTING_LATENCY},
 							{NULL, 0}
 						};
 
@@ -436,6 +479,27 @@ static int	diag_add_alerting_info(const struct zbx_json_parse *jp, struct zbx_js
 				zbx_json_addint64(json, "alerts", alerts_num);
 		}
 
+		if (0 != (fields & ZBX_DIAG_ALERTING_LATENCY))
+		{
+			zbx_vector_am_latency_stats_ptr_t	latencies;
+
+			zbx_vector_am_latency_stats_ptr_create(&latencies);
+
+			time1 = zbx_time();
+			if (FAIL == (ret = zbx_alerter_get_diag_latency(&latencies, error)))
+			{
+				zbx_vector_am_latency_stats_ptr_destroy(&latencies);
+				goto out;
+			}
+			time2 = zbx_time();
+			time_total += time2 - time1;
+
+			diag_add_alerting_latency(json, "latency", &latencies);
+			zbx_vector_am_latency_stats_ptr_clear_ext(&latencies,
+					(zbx_am_latency_stats_ptr_free_func_t)zbx_ptr_free);
+			zbx_vector_am_latency_stats_ptr_destroy(&latencies);
+		}
+
 		if (0 != tops.values_num)
 		{
 			int	i;
@@ -58,6 +58,18 @@ typedef struct
 }
 zbx_event_problem_t;
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: frees cached problem event                                        *
+ *                                                                            *
+ ******************************************************************************/
+static void	event_problem_free(zbx_event_problem_t *problem)
+{
+	zbx_vector_tags_ptr_clear_ext(&problem->tags, zbx_free_tag);
+	zbx_vector_tags_ptr_destroy(&problem->tags);
+	zbx_free(problem);
+}
+
 typedef enum
 {
 	CORRELATION_MATCH = 0,
@@ -734,35 +746,19 @@ static zbx_db_event	*get_event_by_source_object_id(int source, int object, zbx_u
  ******************************************************************************/
 static int	correlation_match_event_hostgroup(const zbx_db_event *event, zbx_uint64_t groupid)
 {
-	zbx_db_result_t		result;
-	int			ret = FAIL;
-	zbx_vector_uint64_t	groupids;
-	char			*sql = NULL;
-	size_t			sql_alloc = 0, sql_offset = 0;
-
-	zbx_vector_uint64_create(&groupids);
-	zbx_dc_get_nested_hostgroupids(&groupid, 1, &groupids);
-
-	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
-			"select hg.groupid"
-				" from hstgrp g,hosts_groups hg,items i,functions f"
-				" where f.triggerid=" ZBX_FS_UI64
-				" and i.itemid=f.itemid"
-				" and hg.hostid=i.hostid"
-				" and",
-				event->objectid);
+	int			ret;
+	zbx_vector_uint64_t	triggerids, matched_triggerids;
 
-	zbx_db_add_condition_alloc(&sql, &sql_alloc, &sql_offset, "hg.groupid", groupids.values,
-			groupids.values_num);
+	zbx_vector_uint64_create(&triggerids);
+	zbx_vector_uint64_create(&matched_triggerids);
 
-	result = zbx_db_select("%s", sql);
+	zbx_vector_uint64_append(&triggerids, event->objectid);
+	zbx_dc_get_triggers_by_hostgroup(&triggerids, groupid, &matched_triggerids);
 
-	if (NULL != zbx_db_fetch(result))
-		ret = SUCCEED;
+	ret = (0 != matched_triggerids.values_num ? SUCCEED : FAIL);
 
-	zbx_db_free_result(result);
-	zbx_free(sql);
-	zbx_vector_uint64_destroy(&groupids);
+	zbx_vector_uint64_destroy(&matched_triggerids);
+	zbx_vector_uint64_destroy(&triggerids);
 
 	return ret;
 }
@@ -946,180 +942,421 @@ static int	correlation_has_old_event_operation(const zbx_correlation_t *correlat
 	return FAIL;
 }
 
-/***********************************************************************************
- *                                                                                 *
- * Purpose: adds sql statement to match tag according to the defined               *
- *          matching operation                                                     *
- *                                                                                 *
- * Parameters: sql         - [IN/OUT]                                              *
- *             sql_alloc   - [IN/OUT]                                              *
- *             sql_offset  - [IN/OUT]                                              *
- *             tag         - [IN] tag to match                                     *
- *             value       - [IN] tag value to match                               *
- *             op          - [IN] matching operation (ZBX_CONDITION_OPERATOR_)     *
- *                                                                                 *
- ***********************************************************************************/
-static void	correlation_condition_add_tag_match(char **sql, size_t *sql_alloc, size_t *sql_offset, const char *tag,
-		const char *value, unsigned char op)
-{
-	char	*tag_esc, *value_esc;
-
-	tag_esc = zbx_db_dyn_escape_string(tag);
-	value_esc = zbx_db_dyn_escape_string(value);
-
-	switch (op)
-	{
-		case ZBX_CONDITION_OPERATOR_NOT_EQUAL:
-		case ZBX_CONDITION_OPERATOR_NOT_LIKE:
-			zbx_strcpy_alloc(sql, sql_alloc, sql_offset, "not ");
-			break;
+/* open problem tagged with a tag used in old event correlation conditions */
+typedef struct
+{
+	const char		*tag;
+	zbx_vector_ptr_t	problems;
+}
+zbx_corr_problem_tag_t;
+
+/* open trigger problems indexed by tags used in old event correlation conditions */
+typedef struct
+{
+	zbx_vector_ptr_t	problems;	/* zbx_event_problem_t sorted by eventid */
+	zbx_hashset_t		tags;		/* zbx_corr_problem_tag_t */
+	unsigned char		tags_loaded;
+	unsigned char		problems_loaded;
+}
+zbx_corr_problem_index_t;
+
+static void	corr_problem_tag_clean(void *data)
+{
+	zbx_corr_problem_tag_t	*problem_tag = (zbx_corr_problem_tag_t *)data;
+
+	zbx_vector_ptr_destroy(&problem_tag->problems);
+}
+
+static void	correlation_problem_index_init(zbx_corr_problem_index_t *index)
+{
+	zbx_vector_ptr_create(&index->problems);
+	zbx_hashset_create_ext(&index->tags, 0, ZBX_DEFAULT_STRING_PTR_HASH_FUNC, ZBX_DEFAULT_STR_PTR_COMPARE_FUNC,
+			corr_problem_tag_clean, ZBX_DEFAULT_MEM_MALLOC_FUNC, ZBX_DEFAULT_MEM_REALLOC_FUNC,
+			ZBX_DEFAULT_MEM_FREE_FUNC);
+	index->tags_loaded = 0;
+	index->problems_loaded = 0;
+}
+
+static void	correlation_problem_index_destroy(zbx_corr_problem_index_t *index)
+{
+	zbx_hashset_destroy(&index->tags);
+	zbx_vector_ptr_clear_ext(&index->problems, (zbx_clean_func_t)event_problem_free);
+	zbx_vector_ptr_destroy(&index->problems);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets old event tag name used by correlation condition             *
+ *                                                                            *
+ * Return value: old event tag name or NULL for new event conditions          *
+ *                                                                            *
+ ******************************************************************************/
+static const char	*correlation_condition_get_old_tag(const zbx_corr_condition_t *condition)
+{
+	switch (condition->type)
+	{
+		case ZBX_CORR_CONDITION_OLD_EVENT_TAG:
+			return condition->data.tag.tag;
+		case ZBX_CORR_CONDITION_OLD_EVENT_TAG_VALUE:
+			return condition->data.tag_value.tag;
+		case ZBX_CORR_CONDITION_EVENT_TAG_PAIR:
+			return condition->data.tag_pair.oldtag;
 	}
 
-	zbx_strcpy_alloc(sql, sql_alloc, sql_offset,
-			"exists (select null from problem_tag pt where p.eventid=pt.eventid and ");
+	return NULL;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: loads open trigger problems having tags used in old event         *
+ *          correlation conditions                                            *
+ *                                                                            *
+ * Parameters: index - [IN/OUT] problem index                                 *
+ *                                                                            *
+ * Comments: Only tags used by correlation conditions are loaded, so the      *
+ *           problem index is usually much smaller than problem_tag table.    *
+ *                                                                            *
+ ******************************************************************************/
+static void	correlation_problem_index_load_tags(zbx_corr_problem_index_t *index)
+{
+	zbx_hashset_iter_t	iter;
+	zbx_corr_condition_t	*condition;
+	zbx_vector_str_t	tags;
+	zbx_db_result_t		result;
+	zbx_db_row_t		row;
+	zbx_event_problem_t	*problem = NULL;
+	char			*sql = NULL;
+	size_t			sql_alloc = 0, sql_offset = 0;
 
-	switch (op)
+	index->tags_loaded = 1;
+
+	zbx_vector_str_create(&tags);
+
+	zbx_hashset_iter_reset(&correlation_rules.conditions, &iter);
+	while (NULL != (condition = (zbx_corr_condition_t *)zbx_hashset_iter_next(&iter)))
 	{
-		case ZBX_CONDITION_OPERATOR_EQUAL:
-		case ZBX_CONDITION_OPERATOR_NOT_EQUAL:
-			zbx_snprintf_alloc(sql, sql_alloc, sql_offset, "pt.tag='%s' and pt.value" ZBX_SQL_STRCMP,
-					tag_esc, ZBX_SQL_STRVAL_EQ(value_esc));
-			break;
-		case ZBX_CONDITION_OPERATOR_LIKE:
-		case ZBX_CONDITION_OPERATOR_NOT_LIKE:
-			zbx_snprintf_alloc(sql, sql_alloc, sql_offset, "pt.tag='%s' and pt.value like '%%%s%%'",
-					tag_esc, value_esc);
-			break;
+		const char	*tag;
+
+		if (NULL != (tag = correlation_condition_get_old_tag(condition)))
+			zbx_vector_str_append(&tags, (char *)tag);
 	}
 
-	zbx_chrcpy_alloc(sql, sql_alloc, sql_offset, ')');
+	if (0 == tags.values_num)
+		goto out;
+
+	zbx_vector_str_sort(&tags, ZBX_DEFAULT_STR_COMPARE_FUNC);
+	zbx_vector_str_uniq(&tags, ZBX_DEFAULT_STR_COMPARE_FUNC);
+
+	zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset,
+			"select p.eventid,p.objectid,pt.tag,pt.value"
+			" from problem p,problem_tag pt"
+			" where p.eventid=pt.eventid"
+				" and p.r_eventid is null"
+				" and p.source=" ZBX_STR(EVENT_SOURCE_TRIGGERS)
+				" and");
+
+	zbx_db_add_str_condition_alloc(&sql, &sql_alloc, &sql_offset, "pt.tag", (const char * const *)tags.values,
+			tags.values_num);
+	zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, " order by p.eventid");
+
+	result = zbx_db_select("%s", sql);
+
+	while (NULL != (row = zbx_db_fetch(result)))
+	{
+		zbx_uint64_t		eventid;
+		zbx_tag_t		*tag;
+		zbx_corr_problem_tag_t	*problem_tag, problem_tag_local;
+
+		ZBX_STR2UINT64(eventid, row[0]);
+
+		if (NULL == problem || problem->eventid != eventid)
+		{
+			problem = (zbx_event_problem_t *)zbx_malloc(NULL, sizeof(zbx_event_problem_t));
+			problem->eventid = eventid;
+			ZBX_STR2UINT64(problem->triggerid, row[1]);
+			zbx_vector_tags_ptr_create(&problem->tags);
+			zbx_vector_ptr_append(&index->problems, problem);
+		}
+
+		tag = (zbx_tag_t *)zbx_malloc(NULL, sizeof(zbx_tag_t));
+		tag->tag = zbx_strdup(NULL, row[2]);
+		tag->value = zbx_strdup(NULL, row[3]);
+		zbx_vector_tags_ptr_append(&problem->tags, tag);
+
+		problem_tag_local.tag = tag->tag;
+
+		if (NULL == (problem_tag = (zbx_corr_problem_tag_t *)zbx_hashset_search(&index->tags,
+				&problem_tag_local)))
+		{
+			problem_tag = (zbx_corr_problem_tag_t *)zbx_hashset_insert(&index->tags, &problem_tag_local,
+					sizeof(problem_tag_local));
+			zbx_vector_ptr_create(&problem_tag->problems);
+		}
+
+		/* problem tags are read in sequence, so duplicate tags can be checked with the last problem */
+		if (0 == problem_tag->problems.values_num ||
+				problem != problem_tag->problems.values[problem_tag->problems.values_num - 1])
+		{
+			zbx_vector_ptr_append(&problem_tag->problems, problem);
+		}
+	}
+	zbx_db_free_result(result);
 
-	zbx_free(value_esc);
-	zbx_free(tag_esc);
+	zbx_free(sql);
+out:
+	zbx_vector_str_destroy(&tags);
 }
 
 /******************************************************************************
  *                                                                            *
- * Purpose: creates sql filter to find events matching a correlation          *
- *          condition                                                         *
+ * Purpose: loads all open trigger problems into problem index                *
  *                                                                            *
- * Parameters: condition - [IN] correlation condition to match                *
- *             event     - [IN] new event to match                            *
+ * Parameters: index - [IN/OUT] problem index with loaded tags                *
  *                                                                            *
- * Return value: the created filter or NULL                                   *
+ * Comments: All problems are required only by correlation rules that can     *
+ *           match problems without any of the condition tags.                *
  *                                                                            *
  ******************************************************************************/
-static char	*correlation_condition_get_event_filter(const zbx_corr_condition_t *condition,
-		const zbx_db_event *event)
+static void	correlation_problem_index_load_problems(zbx_corr_problem_index_t *index)
 {
-	int			i;
-	zbx_tag_t		*tag;
-	char			*tag_esc, *filter = NULL;
-	size_t			filter_alloc = 0, filter_offset = 0;
-	zbx_vector_str_t	values;
+	zbx_db_result_t		result;
+	zbx_db_row_t		row;
+	zbx_vector_ptr_t	problems;
+	int			i = 0;
 
-	/* replace new event dependent condition with precalculated value */
-	switch (condition->type)
+	index->problems_loaded = 1;
+
+	zbx_vector_ptr_create(&problems);
+
+	result = zbx_db_select("select eventid,objectid from problem"
+			" where r_eventid is null"
+				" and source=" ZBX_STR(EVENT_SOURCE_TRIGGERS)
+			" order by eventid");
+
+	/* merge sorted problem rows with sorted tagged problems */
+	while (NULL != (row = zbx_db_fetch(result)))
 	{
-		case ZBX_CORR_CONDITION_NEW_EVENT_TAG:
-		case ZBX_CORR_CONDITION_NEW_EVENT_TAG_VALUE:
-		case ZBX_CORR_CONDITION_NEW_EVENT_HOSTGROUP:
-			return zbx_dsprintf(NULL, "%s=1",
-					correlation_condition_match_new_event(condition, event, SUCCEED));
+		zbx_uint64_t		eventid;
+		zbx_event_problem_t	*problem;
+
+		ZBX_STR2UINT64(eventid, row[0]);
+
+		for (; i < index->problems.values_num; i++)
+		{
+			if (((zbx_event_problem_t *)index->problems.values[i])->eventid >= eventid)
+				break;
+
+			/* tagged problem has been resolved since tags were loaded */
+			zbx_vector_ptr_append(&problems, index->problems.values[i]);
+		}
+
+		if (i < index->problems.values_num &&
+				((zbx_event_problem_t *)index->problems.values[i])->eventid == eventid)
+		{
+			zbx_vector_ptr_append(&problems, index->problems.values[i++]);
+			continue;
+		}
+
+		problem = (zbx_event_problem_t *)zbx_malloc(NULL, sizeof(zbx_event_problem_t));
+		problem->eventid = eventid;
+		ZBX_STR2UINT64(problem->triggerid, row[1]);
+		zbx_vector_tags_ptr_create(&problem->tags);
+		zbx_vector_ptr_append(&problems, problem);
 	}
+	zbx_db_free_result(result);
+
+	for (; i < index->problems.values_num; i++)
+		zbx_vector_ptr_append(&problems, index->problems.values[i]);
+
+	zbx_vector_ptr_destroy(&index->problems);
+	index->problems = problems;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: checks if the correlation condition matches the old event         *
+ *                                                                            *
+ * Parameters: condition - [IN] old event correlation condition               *
+ *             event     - [IN] new event                                     *
+ *             problem   - [IN] old event with correlation condition tags     *
+ *                                                                            *
+ * Return value: "1" - condition matches old event                            *
+ *               "0" - otherwise                                              *
+ *                                                                            *
+ ******************************************************************************/
+static const char	*correlation_condition_match_old_event(const zbx_corr_condition_t *condition,
+		const zbx_db_event *event, const zbx_event_problem_t *problem)
+{
+	const zbx_corr_condition_tag_value_t	*cond;
+	int					i, j, found = 0;
+	char					*pattern = NULL;
 
-	/* replace old event dependent condition with sql filter on problem_tag pt table */
 	switch (condition->type)
 	{
 		case ZBX_CORR_CONDITION_OLD_EVENT_TAG:
-			tag_esc = zbx_db_dyn_escape_string(condition->data.tag.tag);
-			zbx_snprintf_alloc(&filter, &filter_alloc, &filter_offset,
-					"exists (select null from problem_tag pt"
-						" where p.eventid=pt.eventid"
-							" and pt.tag='%s')",
-					tag_esc);
-			zbx_free(tag_esc);
-			return filter;
+			for (i = 0; i < problem->tags.values_num; i++)
+			{
+				if (0 == strcmp(problem->tags.values[i]->tag, condition->data.tag.tag))
+					return "1";
+			}
+			break;
+		case ZBX_CORR_CONDITION_OLD_EVENT_TAG_VALUE:
+			cond = &condition->data.tag_value;
 
-		case ZBX_CORR_CONDITION_EVENT_TAG_PAIR:
-			zbx_vector_str_create(&values);
+			/* same as "value like '%<condition value>%'" used by database query before */
+			if (ZBX_CONDITION_OPERATOR_LIKE == cond->op || ZBX_CONDITION_OPERATOR_NOT_LIKE == cond->op)
+				pattern = zbx_dsprintf(NULL, "%%%s%%", cond->value);
 
-			for (i = 0; i < event->tags.values_num; i++)
+			/* negative operators match problems without any tag matching positive operator */
+			for (i = 0; i < problem->tags.values_num && 0 == found; i++)
 			{
-				tag = event->tags.values[i];
-				if (0 == strcmp(tag->tag, condition->data.tag_pair.newtag))
-					zbx_vector_str_append(&values, zbx_strdup(NULL, tag->value));
+				const zbx_tag_t	*tag = problem->tags.values[i];
+
+				if (0 != strcmp(tag->tag, cond->tag))
+					continue;
+
+				switch (cond->op)
+				{
+					case ZBX_CONDITION_OPERATOR_EQUAL:
+					case ZBX_CONDITION_OPERATOR_NOT_EQUAL:
+						found = (0 == strcmp(tag->value, cond->value));
+						break;
+					case ZBX_CONDITION_OPERATOR_LIKE:
+					case ZBX_CONDITION_OPERATOR_NOT_LIKE:
+						found = (SUCCEED == zbx_db_like_match(tag->value, pattern));
+						break;
+				}
 			}
 
-			if (0 == values.values_num)
+			zbx_free(pattern);
+
+			switch (cond->op)
 			{
-				/* no new tag found, substitute condition with failure expression */
-				filter = zbx_strdup(NULL, "1=0");
+				case ZBX_CONDITION_OPERATOR_NOT_EQUAL:
+				case ZBX_CONDITION_OPERATOR_NOT_LIKE:
+					return (0 == found ? "1" : "0");
 			}
-			else
-			{
-				tag_esc = zbx_db_dyn_escape_string(condition->data.tag_pair.oldtag);
 
-				zbx_snprintf_alloc(&filter, &filter_alloc, &filter_offset,
-						"exists (select null from problem_tag pt"
-							" where p.eventid=pt.eventid"
-								" and pt.tag='%s'"
-								" and",
-						tag_esc);
+			return (0 != found ? "1" : "0");
+		case ZBX_CORR_CONDITION_EVENT_TAG_PAIR:
+			for (i = 0; i < problem->tags.values_num; i++)
+			{
+				const zbx_tag_t	*tag = problem->tags.values[i];
 
-				zbx_db_add_str_condition_alloc(&filter, &filter_alloc, &filter_offset, "pt.value",
-						(const char **)values.values, values.values_num);
+				if (0 != strcmp(tag->tag, condition->data.tag_pair.oldtag))
+					continue;
 
-				zbx_chrcpy_alloc(&filter, &filter_alloc, &filter_offset, ')');
+				for (j = 0; j < event->tags.values_num; j++)
+				{
+					const zbx_tag_t	*new_tag = event->tags.values[j];
 
-				zbx_free(tag_esc);
-				zbx_vector_str_clear_ext(&values, zbx_str_free);
+					if (0 == strcmp(new_tag->tag, condition->data.tag_pair.newtag) &&
+							0 == strcmp(new_tag->value, tag->value))
+					{
+						return "1";
+					}
+				}
 			}
+			break;
+	}
 
-			zbx_vector_str_destroy(&values);
-			return filter;
+	return "0";
+}
 
-		case ZBX_CORR_CONDITION_OLD_EVENT_TAG_VALUE:
-			correlation_condition_add_tag_match(&filter, &filter_alloc, &filter_offset,
-					condition->data.tag_value.tag, condition->data.tag_value.value,
-					condition->data.tag_value.op);
-			return filter;
+/******************************************************************************
+ *                                                                            *
+ * Purpose: prepares correlation formula for matching old events by           *
+ *          replacing new event conditions with their values                  *
+ *                                                                            *
+ * Parameters: correlation - [IN] correlation rule                            *
+ *             event       - [IN] new event                                   *
+ *             tags        - [OUT] old event tags used by the rule (optional) *
+ *                                                                            *
+ * Return value: the prepared formula or NULL if rule conditions are not      *
+ *               cached                                                       *
+ *                                                                            *
+ ******************************************************************************/
+static char	*correlation_prepare_old_event_formula(const zbx_correlation_t *correlation,
+		const zbx_db_event *event, zbx_vector_str_t *tags)
+{
+	char		*expression;
+	zbx_token_t	token;
+	int		pos = 0;
+
+	expression = zbx_strdup(NULL, correlation->formula);
+
+	for (; SUCCEED == zbx_token_find(expression, pos, &token, ZBX_TOKEN_SEARCH_BASIC); pos++)
+	{
+		const zbx_corr_condition_t	*condition;
+		zbx_uint64_t			conditionid;
+		zbx_strloc_t			*loc;
+		const char			*tag;
+
+		if (ZBX_TOKEN_OBJECTID != token.type)
+			continue;
+
+		loc = &token.data.objectid.name;
+
+		if (SUCCEED != zbx_is_uint64_n(expression + loc->l, loc->r - loc->l + 1, &conditionid))
+			continue;
+
+		if (NULL == (condition = (zbx_corr_condition_t *)zbx_hashset_search(&correlation_rules.conditions,
+				&conditionid)))
+		{
+			zbx_free(expression);
+			break;
+		}
+
+		if (NULL != (tag = correlation_condition_get_old_tag(condition)))
+		{
+			/* old event conditions are resolved for each problem */
+			if (NULL != tags)
+				zbx_vector_str_append(tags, (char *)tag);
+
+			pos = token.loc.r;
+			continue;
+		}
+
+		zbx_replace_string(&expression, token.loc.l, &token.loc.r,
+				correlation_condition_match_new_event(condition, event, SUCCEED));
+		pos = token.loc.r;
 	}
 
-	return NULL;
+	return expression;
 }
 
 /******************************************************************************
  *                                                                            *
- * Purpose: add sql statement to filter out correlation conditions and        *
- *          matching events                                                   *
+ * Purpose: checks if the old event matches prepared correlation formula      *
  *                                                                            *
- * Parameters: sql         - [IN/OUT]                                         *
- *             sql_alloc   - [IN/OUT]                                         *
- *             sql_offset  - [IN/OUT]                                         *
- *             correlation - [IN] correlation rule to match                   *
- *             event       - [IN] new event to match                          *
+ * Parameters: formula - [IN] formula with resolved new event conditions      *
+ *             event   - [IN] new event                                       *
+ *             problem - [IN] old event                                       *
  *                                                                            *
- * Return value: SUCCEED - filter was added successfully                      *
+ * Return value: SUCCEED - the old event matches correlation rule             *
  *               FAIL    - otherwise                                          *
  *                                                                            *
  ******************************************************************************/
-static int	correlation_add_event_filter(char **sql, size_t *sql_alloc, size_t *sql_offset,
-		const zbx_correlation_t *correlation, const zbx_db_event *event)
-{
-	char			*expression, *filter;
-	zbx_token_t		token;
-	int			pos = 0, ret = FAIL;
-	zbx_uint64_t		conditionid;
-	zbx_strloc_t		*loc;
-	zbx_corr_condition_t	*condition;
+static int	correlation_match_old_event(const char *formula, const zbx_db_event *event,
+		const zbx_event_problem_t *problem)
+{
+	char		*expression, error[256];
+	zbx_token_t	token;
+	int		pos = 0, ret = FAIL;
+	double		result;
 
-	zbx_snprintf_alloc(sql, sql_alloc, sql_offset, "c.correlationid=" ZBX_FS_UI64, correlation->correlationid);
+	/* rule without conditions matches all old events */
+	if ('\0' == *formula)
+		return SUCCEED;
 
-	expression = zbx_strdup(NULL, correlation->formula);
+	expression = zbx_strdup(NULL, formula);
 
 	for (; SUCCEED == zbx_token_find(expression, pos, &token, ZBX_TOKEN_SEARCH_BASIC); pos++)
 	{
+		const zbx_corr_condition_t	*condition;
+		zbx_uint64_t			conditionid;
+		zbx_strloc_t			*loc;
+
 		if (ZBX_TOKEN_OBJECTID != token.type)
 			continue;
 
@@ -1128,30 +1365,105 @@ static int	correlation_add_event_filter(char **sql, size_t *sql_alloc, size_t *s
 		if (SUCCEED != zbx_is_uint64_n(expression + loc->l, loc->r - loc->l + 1, &conditionid))
 			continue;
 
-		if (NULL == (condition = (zbx_corr_condition_t *)zbx_hashset_search(&correlation_rules.conditions, &conditionid)))
-			goto out;
-
-		if (NULL == (filter = correlation_condition_get_event_filter(condition, event)))
+		if (NULL == (condition = (zbx_corr_condition_t *)zbx_hashset_search(&correlation_rules.conditions,
+				&conditionid)))
 		{
-			THIS_SHOULD_NEVER_HAPPEN;
 			goto out;
 		}
 
-		zbx_replace_string(&expression, token.loc.l, &token.loc.r, filter);
+		zbx_replace_string(&expression, token.loc.l, &token.loc.r,
+				correlation_condition_match_old_event(condition, event, problem));
 		pos = token.loc.r;
-		zbx_free(filter);
 	}
 
-	if ('\0' != *expression)
-		zbx_snprintf_alloc(sql, sql_alloc, sql_offset, " and (%s)", expression);
-
-	ret = SUCCEED;
+	if (SUCCEED == zbx_evaluate_unknown(expression, &result, error, sizeof(error)) &&
+			SUCCEED == zbx_double_compare(result, 1))
+	{
+		ret = SUCCEED;
+	}
 out:
 	zbx_free(expression);
 
 	return ret;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: finds old events matching correlation rule                        *
+ *                                                                            *
+ * Parameters: correlation - [IN] correlation rule                            *
+ *             event       - [IN] new event                                   *
+ *             index       - [IN/OUT] open problem index                      *
+ *             problems    - [OUT] matching old events                        *
+ *                                                                            *
+ * Comments: Only problems having tags used by the rule conditions are        *
+ *           checked unless the rule matches problems without such tags.      *
+ *                                                                            *
+ ******************************************************************************/
+static void	correlation_get_old_events(const zbx_correlation_t *correlation, const zbx_db_event *event,
+		zbx_corr_problem_index_t *index, zbx_vector_ptr_t *problems)
+{
+	static zbx_event_problem_t	problem_untagged;
+
+	char				*formula;
+	zbx_vector_str_t		tags;
+	zbx_vector_ptr_t		candidates;
+	const zbx_vector_ptr_t		*pcandidates;
+	int				i;
+
+	zbx_vector_str_create(&tags);
+	zbx_vector_ptr_create(&candidates);
+
+	if (NULL == (formula = correlation_prepare_old_event_formula(correlation, event, &tags)))
+		goto out;
+
+	if (0 == index->tags_loaded)
+		correlation_problem_index_load_tags(index);
+
+	if (SUCCEED == correlation_match_old_event(formula, event, &problem_untagged))
+	{
+		if (0 == index->problems_loaded)
+			correlation_problem_index_load_problems(index);
+
+		pcandidates = &index->problems;
+	}
+	else
+	{
+		for (i = 0; i < tags.values_num; i++)
+		{
+			zbx_corr_problem_tag_t	*problem_tag, problem_tag_local = {.tag = tags.values[i]};
+
+			if (NULL != (problem_tag = (zbx_corr_problem_tag_t *)zbx_hashset_search(&index->tags,
+					&problem_tag_local)))
+			{
+				zbx_vector_ptr_append_array(&candidates, problem_tag->problems.values,
+						problem_tag->problems.values_num);
+			}
+		}
+
+		if (1 < tags.values_num)
+		{
+			zbx_vector_ptr_sort(&candidates, ZBX_DEFAULT_PTR_COMPARE_FUNC);
+			zbx_vector_ptr_uniq(&candidates, ZBX_DEFAULT_PTR_COMPARE_FUNC);
+		}
+
+		pcandidates = &candidates;
+	}
+
+	for (i = 0; i < pcandidates->values_num; i++)
+	{
+		zbx_event_problem_t	*problem = (zbx_event_problem_t *)pcandidates->values[i];
+
+		if (SUCCEED == correlation_match_old_event(formula, event, problem))
+			zbx_vector_ptr_append(problems, problem);
+	}
+
+	zbx_free(formula);
+out:
+	zbx_vector_ptr_destroy(&candidates);
+	zbx_vector_str_destroy(&tags);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: execute correlation operations for the new event and matched      *
@@ -1247,6 +1559,7 @@ zbx_problem_state_t;
  *                                                                            *
  * Parameters: event         - [IN] new event                                 *
  *             problem_state - [IN/OUT] problem state cache variable          *
+ *             index         - [IN/OUT] open problem index                    *
  *                                                                            *
  * Comments: The correlation data (zbx_event_recovery_t) of events that       *
  *           must be closed are added to event_correlation hashset            *
@@ -1254,19 +1567,16 @@ zbx_problem_state_t;
  *           The global event correlation matching is done in two parts:      *
  *             1) exclude correlations that can't possibly match the event    *
  *                based on new event tag/value/group conditions               *
- *             2) assemble sql statement to select problems/correlations      *
- *                based on the rest correlation conditions                    *
+ *             2) match the rest correlation conditions against open          *
+ *                problems in problem index                                   *
  *                                                                            *
  ******************************************************************************/
-static void	correlate_event_by_global_rules(zbx_db_event *event, zbx_problem_state_t *problem_state)
+static void	correlate_event_by_global_rules(zbx_db_event *event, zbx_problem_state_t *problem_state,
+		zbx_corr_problem_index_t *index)
 {
 	int			i;
 	zbx_correlation_t	*correlation;
 	zbx_vector_ptr_t	corr_old, corr_new;
-	char			*sql = NULL;
-	const char		*delim = "";
-	size_t			sql_alloc = 0, sql_offset = 0;
-	zbx_uint64_t		eventid, correlationid, objectid;
 
 	zbx_vector_ptr_create(&corr_old);
 	zbx_vector_ptr_create(&corr_new);
@@ -1337,53 +1647,34 @@ static void	correlate_event_by_global_rules(zbx_db_event *event, zbx_problem_sta
 
 	if (0 != corr_old.values_num)
 	{
-		zbx_db_result_t	result;
-		zbx_db_row_t	row;
+		zbx_vector_ptr_t	problems;
 
 		/* Process correlations that matches new event and either uses old events in conditions */
 		/* or has operations involving old events.                                              */
 
-		zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, "select p.eventid,p.objectid,c.correlationid"
-								" from correlation c,problem p"
-								" where p.r_eventid is null"
-								" and p.source=" ZBX_STR(EVENT_SOURCE_TRIGGERS)
-								" and (");
+		zbx_vector_ptr_create(&problems);
 
 		for (i = 0; i < corr_old.values_num; i++)
 		{
 			correlation = (zbx_correlation_t *)corr_old.values[i];
 
-			zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, delim);
-			correlation_add_event_filter(&sql, &sql_alloc, &sql_offset, correlation, event);
-			delim = " or ";
-		}
-
-		zbx_chrcpy_alloc(&sql, &sql_alloc, &sql_offset, ')');
-		result = zbx_db_select("%s", sql);
-
-		while (NULL != (row = zbx_db_fetch(result)))
-		{
-			ZBX_STR2UINT64(eventid, row[0]);
+			correlation_get_old_events(correlation, event, index, &problems);
 
-			/* check if this event is not already recovered by another correlation rule */
-			if (NULL != zbx_hashset_search(&correlation_cache, &eventid))
-				continue;
+			for (int j = 0; j < problems.values_num; j++)
+			{
+				zbx_event_problem_t	*problem = (zbx_event_problem_t *)problems.values[j];
 
-			ZBX_STR2UINT64(correlationid, row[2]);
+				/* check if this event is not already recovered by another correlation rule */
+				if (NULL != zbx_hashset_search(&correlation_cache, &problem->eventid))
+					continue;
 
-			if (FAIL == (i = zbx_vector_ptr_bsearch(&corr_old, &correlationid,
-					ZBX_DEFAULT_UINT64_PTR_COMPARE_FUNC)))
-			{
-				THIS_SHOULD_NEVER_HAPPEN;
-				continue;
+				correlation_execute_operations(correlation, event, problem->eventid, problem->triggerid);
 			}
 
-			ZBX_STR2UINT64(objectid, row[1]);
-			correlation_execute_operations((zbx_correlation_t *)corr_old.values[i], event, eventid, objectid);
+			zbx_vector_ptr_clear(&problems);
 		}
 
-		zbx_db_free_result(result);
-		zbx_free(sql);
+		zbx_vector_ptr_destroy(&problems);
 	}
 
 	zbx_vector_ptr_destroy(&corr_new);
@@ -1399,17 +1690,23 @@ static void	correlate_event_by_global_rules(zbx_db_event *event, zbx_problem_sta
 static void	correlate_events_by_global_rules(zbx_vector_ptr_t *trigger_events,
 		zbx_vector_trigger_diff_ptr_t *trigger_diff)
 {
-	int			i, index;
-	zbx_trigger_diff_t	*diff;
-	zbx_problem_state_t	problem_state = ZBX_PROBLEM_STATE_UNKNOWN;
+	int				i, index, events_num = 0;
+	zbx_trigger_diff_t		*diff;
+	zbx_problem_state_t		problem_state = ZBX_PROBLEM_STATE_UNKNOWN;
+	zbx_corr_problem_index_t	problem_index;
+	double				sec;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s() events:%d", __func__, correlation_cache.num_data);
 
+	sec = zbx_time();
+
 	zbx_dc_correlation_rules_get(&correlation_rules);
 
 	if (0 == correlation_rules.correlations.values_num)
 		goto out;
 
+	correlation_problem_index_init(&problem_index);
+
 	/* process global correlation and queue the events that must be closed */
 	for (i = 0; i < trigger_events->values_num; i++)
 	{
@@ -1418,7 +1715,8 @@ static void	correlate_events_by_global_rules(zbx_vector_ptr_t *trigger_events,
 		if (0 == (ZBX_FLAGS_DB_EVENT_CREATE & event->flags))
 			continue;
 
-		correlate_event_by_global_rules(event, &problem_state);
+		correlate_event_by_global_rules(event, &problem_state, &problem_index);
+		events_num++;
 
 		/* force value recalculation based on open problems for triggers with */
 		/* events closed by 'close new' correlation operation                */
@@ -1435,8 +1733,13 @@ static void	correlate_events_by_global_rules(zbx_vector_ptr_t *trigger_events,
 		}
 	}
 
+	zabbix_log(LOG_LEVEL_DEBUG, "%s() indexed problems:%d tags:%d", __func__, problem_index.problems.values_num,
+			problem_index.tags.num_data);
+
+	correlation_problem_index_destroy(&problem_index);
 out:
-	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s() events:%d queued:%d " ZBX_FS_DBL " sec", __func__, events_num,
+			correlation_cache.num_data, zbx_time() - sec);
 }
 
 /******************************************************************************
@@ -2537,18 +2840,6 @@ static void	get_open_problems(const zbx_vector_uint64_t *triggerids, zbx_vector_
 	zbx_vector_uint64_destroy(&eventids);
 }
 
-/******************************************************************************
- *                                                                            *
- * Purpose: frees cached problem event                                        *
- *                                                                            *
- ******************************************************************************/
-static void	event_problem_free(zbx_event_problem_t *problem)
-{
-	zbx_vector_tags_ptr_clear_ext(&problem->tags, zbx_free_tag);
-	zbx_vector_tags_ptr_destroy(&problem->tags);
-	zbx_free(problem);
-}
-
 /******************************************************************************
  *                                                                            *
  * Purpose: frees trigger dependency                                          *
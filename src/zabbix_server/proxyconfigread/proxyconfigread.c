@@ -1192,6 +1192,172 @@ out:
 	return ret;
 }
 
+/* serialized proxy configuration tables shared by proxies */
+typedef struct
+{
+	zbx_uint64_t	id;
+	zbx_uint64_t	revision;
+	char		*data;
+}
+zbx_proxyconfig_fragment_t;
+
+#define ZBX_PROXYCONFIG_FRAGMENT_EXPRESSIONS	0
+#define ZBX_PROXYCONFIG_FRAGMENT_AUTOREG		1
+#define ZBX_PROXYCONFIG_FRAGMENT_PROXY_LIST	2
+
+static zbx_proxyconfig_fragment_t	expressions_fragment, autoreg_fragment;
+static zbx_hashset_t			proxy_list_fragments;
+
+static void	proxyconfig_fragment_clean(void *data)
+{
+	zbx_proxyconfig_fragment_t	*fragment = (zbx_proxyconfig_fragment_t *)data;
+
+	zbx_free(fragment->data);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: removes cached proxy lists of the removed proxy groups            *
+ *                                                                            *
+ * Parameters: proxy_groupid - [IN] proxy group of the rebuilt proxy list     *
+ *                                                                            *
+ ******************************************************************************/
+static void	proxyconfig_prune_proxy_list_fragments(zbx_uint64_t proxy_groupid)
+{
+	zbx_hashset_iter_t		iter;
+	zbx_proxyconfig_fragment_t	*fragment;
+
+	zbx_hashset_iter_reset(&proxy_list_fragments, &iter);
+	while (NULL != (fragment = (zbx_proxyconfig_fragment_t *)zbx_hashset_iter_next(&iter)))
+	{
+		if (fragment->id != proxy_groupid && 0 == zbx_dc_get_proxy_group_revision(fragment->id))
+			zbx_hashset_iter_remove(&iter);
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets configuration tables that are the same for all proxies (or   *
+ *          proxies in the same proxy group)                                  *
+ *                                                                            *
+ * Parameters: type     - [IN] fragment type (ZBX_PROXYCONFIG_FRAGMENT_*)     *
+ *             id       - [IN] proxy group identifier for proxy list          *
+ *             revision - [IN] configuration cache revision of the tables     *
+ *             j        - [OUT] output json                                   *
+ *             error    - [OUT] error message                                 *
+ *                                                                            *
+ * Return value: SUCCEED - data was read successfully                         *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ * Comments: Serialized tables are cached and reused by following proxy       *
+ *           configuration requests until the configuration cache revision    *
+ *           of the tables changes. Otherwise each configuration change would *
+ *           make every proxy read the same data from database. Proxy lists   *
+ *           of removed proxy groups are dropped when a proxy list is read    *
+ *           from database.                                                   *
+ *                                                                            *
+ ******************************************************************************/
+static int	proxyconfig_get_shared_data(int type, zbx_uint64_t id, zbx_uint64_t revision, struct zbx_json *j,
+		char **error)
+{
+	zbx_proxyconfig_fragment_t	*fragment;
+	struct zbx_json			json;
+	zbx_vector_uint64_t		proxy_groupids;
+	int				ret;
+
+	switch (type)
+	{
+		case ZBX_PROXYCONFIG_FRAGMENT_EXPRESSIONS:
+			fragment = &expressions_fragment;
+			break;
+		case ZBX_PROXYCONFIG_FRAGMENT_AUTOREG:
+			fragment = &autoreg_fragment;
+			break;
+		case ZBX_PROXYCONFIG_FRAGMENT_PROXY_LIST:
+			if (0 == proxy_list_fragments.num_slots)
+			{
+				zbx_hashset_create_ext(&proxy_list_fragments, 0, ZBX_DEFAULT_UINT64_HASH_FUNC,
+						ZBX_DEFAULT_UINT64_COMPARE_FUNC, proxyconfig_fragment_clean,
+						ZBX_DEFAULT_MEM_MALLOC_FUNC, ZBX_DEFAULT_MEM_REALLOC_FUNC,
+						ZBX_DEFAULT_MEM_FREE_FUNC);
+			}
+
+			if (NULL == (fragment = (zbx_proxyconfig_fragment_t *)zbx_hashset_search(
+					&proxy_list_fragments, &id)))
+			{
+				zbx_proxyconfig_fragment_t	fragment_local = {.id = id};
+
+				fragment = (zbx_proxyconfig_fragment_t *)zbx_hashset_insert(&proxy_list_fragments,
+						&fragment_local, sizeof(fragment_local));
+			}
+			break;
+		default:
+			THIS_SHOULD_NEVER_HAPPEN;
+			*error = zbx_strdup(*error, "unknown configuration fragment");
+			return FAIL;
+	}
+
+	if (NULL != fragment->data && revision == fragment->revision)
+	{
+		zabbix_log(LOG_LEVEL_DEBUG, "%s() type:%d revision:" ZBX_FS_UI64 " using cached data", __func__,
+				type, revision);
+		zbx_json_addraw(j, NULL, fragment->data);
+
+		return SUCCEED;
+	}
+
+	zbx_json_init(&json, ZBX_JSON_STAT_BUF_LEN);
+
+	switch (type)
+	{
+		case ZBX_PROXYCONFIG_FRAGMENT_EXPRESSIONS:
+			ret = proxyconfig_get_expression_data(&json, error);
+			break;
+		case ZBX_PROXYCONFIG_FRAGMENT_AUTOREG:
+			ret = proxyconfig_get_table_data("config_autoreg_tls", NULL, NULL, NULL, NULL, &json, error);
+			break;
+		default:
+			zbx_vector_uint64_create(&proxy_groupids);
+			zbx_vector_uint64_append(&proxy_groupids, id);
+			ret = proxyconfig_get_table_data("proxy", "proxy_groupid", &proxy_groupids, NULL, NULL, &json,
+					error);
+			zbx_vector_uint64_destroy(&proxy_groupids);
+			break;
+	}
+
+	if (SUCCEED == ret)
+	{
+		/* cache tables without the enclosing object braces */
+		zbx_free(fragment->data);
+		fragment->data = (char *)zbx_malloc(NULL, json.buffer_size - 1);
+		memcpy(fragment->data, json.buffer + 1, json.buffer_size - 2);
+		fragment->data[json.buffer_size - 2] = '\0';
+		fragment->revision = revision;
+
+		zbx_json_addraw(j, NULL, fragment->data);
+
+		if (ZBX_PROXYCONFIG_FRAGMENT_PROXY_LIST == type)
+			proxyconfig_prune_proxy_list_fragments(id);
+	}
+
+	zbx_json_free(&json);
+
+	return ret;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets proxy configuration tables changed since the revision        *
+ *          known by proxy                                                    *
+ *                                                                            *
+ * Comments: Only regular expressions, autoregistration TLS settings and      *
+ *           proxy lists of proxy groups are served from the serialized       *
+ *           table cache, see proxyconfig_get_shared_data(). Host, item,      *
+ *           interface, macro, discovery rule and web scenario data depend    *
+ *           on the requesting proxy and are still read from database for     *
+ *           the changed objects.                                             *
+ *                                                                            *
+ ******************************************************************************/
 static int	proxyconfig_get_tables(zbx_dc_proxy_t *proxy, zbx_uint64_t proxy_config_revision,
 		const zbx_dc_revision_t *dc_revision, unsigned char hostmap_sync, zbx_uint64_t proxy_hostmap_revision,
 		zbx_uint64_t hostmap_revision, const char *failover_delay, const zbx_vector_uint64_t *del_hostproxyids,
@@ -1331,7 +1497,8 @@ static int	proxyconfig_get_tables(zbx_dc_proxy_t *proxy, zbx_uint64_t proxy_conf
 		}
 
 		if (0 != (flags & ZBX_PROXYCONFIG_SYNC_EXPRESSIONS) &&
-				SUCCEED != proxyconfig_get_expression_data(j, error))
+				SUCCEED != proxyconfig_get_shared_data(ZBX_PROXYCONFIG_FRAGMENT_EXPRESSIONS, 0,
+						dc_revision->expression, j, error))
 		{
 			goto out;
 		}
@@ -1349,27 +1516,17 @@ static int	proxyconfig_get_tables(zbx_dc_proxy_t *proxy, zbx_uint64_t proxy_conf
 		}
 
 		if (0 != (flags & ZBX_PROXYCONFIG_SYNC_AUTOREG) &&
-				SUCCEED != proxyconfig_get_table_data("config_autoreg_tls", NULL, NULL, NULL, NULL, j,
-						error))
+				SUCCEED != proxyconfig_get_shared_data(ZBX_PROXYCONFIG_FRAGMENT_AUTOREG, 0,
+						dc_revision->autoreg_tls, j, error))
 		{
 			goto out;
 		}
 
-		if (0 != (flags & ZBX_PROXYCONFIG_SYNC_PROXY_LIST))
+		if (0 != (flags & ZBX_PROXYCONFIG_SYNC_PROXY_LIST) &&
+				SUCCEED != proxyconfig_get_shared_data(ZBX_PROXYCONFIG_FRAGMENT_PROXY_LIST,
+						proxy->proxy_groupid, proxy_group_revision, j, error))
 		{
-			zbx_vector_uint64_t	proxy_groupids;
-
-			zbx_vector_uint64_create(&proxy_groupids);
-			zbx_vector_uint64_append(&proxy_groupids, proxy->proxy_groupid);
-
-			if (SUCCEED != proxyconfig_get_table_data("proxy", "proxy_groupid", &proxy_groupids,
-					NULL, NULL, j, error))
-			{
-				zbx_vector_uint64_destroy(&proxy_groupids);
-				goto out;
-			}
-
-			zbx_vector_uint64_destroy(&proxy_groupids);
+			goto out;
 		}
 
 		if (0 != (flags & ZBX_PROXYCONFIG_SYNC_HOSTMAP))
@@ -1466,6 +1623,10 @@ out:
 #undef ZBX_PROXYCONFIG_SYNC_ALL
 }
 
+#undef ZBX_PROXYCONFIG_FRAGMENT_EXPRESSIONS
+#undef ZBX_PROXYCONFIG_FRAGMENT_AUTOREG
+#undef ZBX_PROXYCONFIG_FRAGMENT_PROXY_LIST
+
 /******************************************************************************
  *                                                                            *
  * Purpose: prepares proxy configuration data                                 *
@@ -310,6 +310,7 @@ static char	*config_server		= NULL;		/* not used in zabbix_server, required for
 static int	config_housekeeping_frequency	= 1;
 static int	config_max_housekeeper_delete	= 5000;		/* applies for every separate field value */
 static int	config_confsyncer_frequency	= 10;
+static char	*config_cache_snapshot_file	= NULL;
 
 static int	config_problemhousekeeping_frequency = 60;
 
@@ -924,6 +925,8 @@ static void	zbx_load_config(ZBX_TASK_EX *task)
 				ZBX_CONF_PARM_OPT,	0,			__UINT64_C(64) * ZBX_GIBIBYTE},
 		{"CacheUpdateFrequency",	&config_confsyncer_frequency,		ZBX_CFG_TYPE_INT,
 				ZBX_CONF_PARM_OPT,	1,			SEC_PER_HOUR},
+		{"CacheSnapshotFile",		&config_cache_snapshot_file,		ZBX_CFG_TYPE_STRING,
+				ZBX_CONF_PARM_OPT,	0,			0},
 		{"HousekeepingFrequency",	&config_housekeeping_frequency,		ZBX_CFG_TYPE_INT,
 				ZBX_CONF_PARM_OPT,	0,			24},
 		{"MaxHousekeeperDelete",	&config_max_housekeeper_delete,		ZBX_CFG_TYPE_INT,
@@ -1582,7 +1585,7 @@ static int	server_startup(zbx_socket_t *listen_sock, int *ha_stat, int *ha_failo
 							config_proxyconfig_frequency, config_proxydata_frequency,
 							config_confsyncer_frequency, zbx_config_source_ip,
 							config_ssl_ca_location, config_ssl_cert_location,
-							config_ssl_key_location};
+							config_ssl_key_location, config_cache_snapshot_file};
 	zbx_thread_alerter_args		alerter_args = {zbx_config_source_ip, config_ssl_ca_location,
 							config_sms_devices};
 	zbx_thread_pinger_args		pinger_args = {zbx_config_timeout};
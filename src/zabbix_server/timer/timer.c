@@ -29,6 +29,8 @@
 #include "zbxservice.h"
 #include "zbxserialize.h"
 
+#define ZBX_EVENT_BATCH_SIZE	1000
+
 /* addition data for event maintenance calculations to pair with zbx_event_suppress_query_t */
 typedef struct
 {
@@ -37,6 +39,36 @@ typedef struct
 }
 zbx_event_suppress_data_t;
 
+ZBX_PTR_VECTOR_DECL(event_suppress_data_ptr, zbx_event_suppress_data_t*)
+
+/* event suppress record update */
+typedef struct
+{
+	zbx_uint64_t	eventid;
+	zbx_uint64_t	maintenanceid;
+	int		suppress_until;
+}
+zbx_event_suppress_update_t;
+
+ZBX_VECTOR_DECL(event_suppress_update, zbx_event_suppress_update_t)
+ZBX_VECTOR_IMPL(event_suppress_update, zbx_event_suppress_update_t)
+
+#define ZBX_PROBLEM_INDEX_RESYNC_PERIOD	SEC_PER_HOUR
+
+/* Open problems of the timer process. The index is kept between maintenance updates and is */
+/* synchronized with problem table by reading problems created or resolved since the last   */
+/* synchronization, problem tags are read for new problems. Problems removed from problem   */
+/* table are dropped by periodic full synchronization.                                      */
+typedef struct
+{
+	zbx_vector_event_suppress_query_ptr_t	problems;	/* problems sorted by eventid */
+	int					tags_loaded;	/* 1 if problem tags are loaded */
+	zbx_uint64_t				eventid;	/* the last problem or recovery eventid */
+	zbx_uint64_t				eventid_sync;	/* eventid before the last synchronization */
+	time_t					resync_time;	/* time of the next full synchronization */
+}
+zbx_problem_index_t;
+
 /******************************************************************************
  *                                                                            *
  * Purpose: logs host maintenance changes                                     *
@@ -232,6 +264,32 @@ static int	event_suppress_query_eventid_compare(const void *d1, const void *d2)
 	return 0;
 }
 
+static zbx_event_suppress_query_t	*event_suppress_query_create(zbx_db_row_t row)
+{
+	zbx_event_suppress_query_t	*query;
+
+	query = (zbx_event_suppress_query_t *)zbx_malloc(NULL, sizeof(zbx_event_suppress_query_t));
+
+	ZBX_STR2UINT64(query->eventid, row[0]);
+	ZBX_STR2UINT64(query->triggerid, row[1]);
+	ZBX_DBROW2UINT64(query->r_eventid, row[2]);
+	zbx_vector_uint64_create(&query->hostids);
+	zbx_vector_uint64_create(&query->functionids);
+	zbx_vector_tags_ptr_create(&query->tags);
+	zbx_vector_uint64_pair_create(&query->maintenances);
+
+	return query;
+}
+
+static void	event_suppress_query_add_tag(zbx_event_suppress_query_t *query, const char *name, const char *value)
+{
+	zbx_tag_t	*tag = (zbx_tag_t *)zbx_malloc(NULL, sizeof(zbx_tag_t));
+
+	tag->tag = zbx_strdup(NULL, name);
+	tag->value = zbx_strdup(NULL, value);
+	zbx_vector_tags_ptr_append(&query->tags, tag);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: fetches events that need to be queried for maintenance            *
@@ -249,30 +307,15 @@ static void	event_queries_fetch(zbx_db_result_t result, zbx_vector_event_suppres
 
 		if (NULL == query || eventid != query->eventid)
 		{
-			query = (zbx_event_suppress_query_t *)zbx_malloc(NULL, sizeof(zbx_event_suppress_query_t));
-
-			query->eventid = eventid;
-			ZBX_STR2UINT64(query->triggerid, row[1]);
-			ZBX_DBROW2UINT64(query->r_eventid, row[2]);
-			zbx_vector_uint64_create(&query->hostids);
-			zbx_vector_uint64_create(&query->functionids);
-			zbx_vector_tags_ptr_create(&query->tags);
-			zbx_vector_uint64_pair_create(&query->maintenances);
+			query = event_suppress_query_create(row);
 			zbx_vector_event_suppress_query_ptr_append(event_queries, query);
 		}
 
 		if (FAIL == zbx_db_is_null(row[3]))
-		{
-			zbx_tag_t	*tag = (zbx_tag_t *)zbx_malloc(NULL, sizeof(zbx_tag_t));
-
-			tag->tag = zbx_strdup(NULL, row[3]);
-			tag->value = zbx_strdup(NULL, row[4]);
-			zbx_vector_tags_ptr_append(&query->tags, tag);
-		}
+			event_suppress_query_add_tag(query, row[3], row[4]);
 	}
 }
 
-ZBX_PTR_VECTOR_DECL(event_suppress_data_ptr, zbx_event_suppress_data_t*)
 ZBX_PTR_VECTOR_IMPL(event_suppress_data_ptr, zbx_event_suppress_data_t*)
 
 static int	event_suppress_data_eventid_compare(const void *d1, const void *d2)
@@ -285,54 +328,218 @@ static int	event_suppress_data_eventid_compare(const void *d1, const void *d2)
 	return 0;
 }
 
+static void	problem_index_init(zbx_problem_index_t *index)
+{
+	zbx_vector_event_suppress_query_ptr_create(&index->problems);
+	index->tags_loaded = 0;
+	index->eventid = 0;
+	index->eventid_sync = 0;
+	index->resync_time = 0;
+}
+
 /******************************************************************************
  *                                                                            *
- * Purpose: Gets open, recently resolved and resolved problems with suppress  *
- *          data from database and prepares event query, event data           *
- *          structures.                                                       *
+ * Purpose: reads tags of the specified problems                              *
+ *                                                                            *
+ * Parameters: problems - [IN/OUT] problems sorted by eventid                 *
+ *             eventids - [IN] identifiers of problems to read tags for       *
  *                                                                            *
  ******************************************************************************/
-static void	db_get_query_events(zbx_vector_event_suppress_query_ptr_t *event_queries,
-		zbx_vector_event_suppress_data_ptr_t *event_data, int process_num, zbx_get_config_forks_f get_forks_cb)
+static void	problem_index_fetch_tags(zbx_vector_event_suppress_query_ptr_t *problems,
+		const zbx_vector_uint64_t *eventids)
 {
-	zbx_db_row_t			row;
-	zbx_db_result_t			result;
-	zbx_event_suppress_data_t	*data = NULL;
-	zbx_uint64_t			eventid;
-	zbx_uint64_pair_t		pair;
-	zbx_vector_uint64_t		eventids;
-	int				read_tags;
-	const char			*tag_fields, *tag_join;
+	zbx_db_row_t	row;
+	zbx_db_result_t	result;
 
-	if (SUCCEED == (read_tags = zbx_dc_maintenance_has_tags()))
+	for (int i = 0; i < eventids->values_num; i += ZBX_EVENT_BATCH_SIZE)
 	{
-		tag_fields = "t.tag,t.value";
-		tag_join = " left join problem_tag t on p.eventid=t.eventid";
+		char				*sql = NULL;
+		size_t				sql_alloc = 0, sql_offset = 0;
+		zbx_event_suppress_query_t	*query = NULL;
+
+		zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, "select eventid,tag,value from problem_tag where");
+		zbx_db_add_condition_alloc(&sql, &sql_alloc, &sql_offset, "eventid", eventids->values + i,
+				MIN(eventids->values_num - i, ZBX_EVENT_BATCH_SIZE));
+
+		result = zbx_db_select("%s", sql);
+		zbx_free(sql);
+
+		while (NULL != (row = zbx_db_fetch(result)))
+		{
+			zbx_event_suppress_query_t	query_local;
+			int				index;
+
+			ZBX_STR2UINT64(query_local.eventid, row[0]);
+
+			if (NULL == query || query->eventid != query_local.eventid)
+			{
+				if (FAIL == (index = zbx_vector_event_suppress_query_ptr_bsearch(problems, &query_local,
+						event_suppress_query_eventid_compare)))
+				{
+					query = NULL;
+					continue;
+				}
+
+				query = problems->values[index];
+			}
+
+			event_suppress_query_add_tag(query, row[1], row[2]);
+		}
+		zbx_db_free_result(result);
 	}
-	else
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: synchronizes open problem index with problem table                *
+ *                                                                            *
+ * Parameters: index        - [IN/OUT] problem index                          *
+ *             read_tags    - [IN] SUCCEED - problem tags are required for    *
+ *                                           maintenance matching             *
+ *             process_num  - [IN]                                            *
+ *             get_forks_cb - [IN]                                            *
+ *                                                                            *
+ * Comments: Only problems created or resolved since the synchronization      *
+ *           before the last one are read from database - event identifiers   *
+ *           are reserved before the transaction is committed, so the extra   *
+ *           cycle picks up problems committed out of identifier order. The   *
+ *           rest of problem data is read for new problems. Full              *
+ *           synchronization is done periodically to drop problems removed    *
+ *           from problem table by housekeeper.                               *
+ *                                                                            *
+ ******************************************************************************/
+static void	problem_index_sync(zbx_problem_index_t *index, int read_tags, int process_num,
+		zbx_get_config_forks_f get_forks_cb)
+{
+	zbx_db_row_t				row;
+	zbx_db_result_t				result;
+	zbx_vector_event_suppress_query_ptr_t	problems;
+	zbx_vector_uint64_t			eventids;
+	zbx_uint64_t				eventid_max;
+	int					i = 0, full_sync = 0;
+	time_t					now;
+	char					*sql = NULL;
+	size_t					sql_alloc = 0, sql_offset = 0;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s() problems:%d", __func__, index->problems.values_num);
+
+	/* problems were indexed without tags, tags must be read for all of them */
+	if (SUCCEED == read_tags && 0 == index->tags_loaded)
 	{
-		tag_fields = "null,null";
-		tag_join = "";
+		zbx_vector_event_suppress_query_ptr_clear_ext(&index->problems, zbx_event_suppress_query_free);
+		index->resync_time = 0;
 	}
 
-	/* get open or recently closed problems */
-	result = zbx_db_select("select p.eventid,p.objectid,p.r_eventid,%s"
+	if (index->resync_time <= (now = time(NULL)))
+		full_sync = 1;
+
+	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, "select p.eventid,p.objectid,p.r_eventid"
 			" from problem p"
-			"%s"
 			" where p.source=%d"
 				" and p.object=%d"
-				" and " ZBX_SQL_MOD(p.eventid, %d) "=%d"
-			" order by p.eventid",
-			tag_fields, tag_join,
+				" and " ZBX_SQL_MOD(p.eventid, %d) "=%d",
 			EVENT_SOURCE_TRIGGERS, EVENT_OBJECT_TRIGGER, get_forks_cb(ZBX_PROCESS_TYPE_TIMER),
 			process_num - 1);
 
-	event_queries_fetch(result, event_queries);
-	zbx_db_free_result(result);
+	if (0 == full_sync)
+	{
+		zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, " and (p.eventid>" ZBX_FS_UI64
+				" or p.r_eventid>" ZBX_FS_UI64 ")", index->eventid_sync, index->eventid_sync);
+	}
+
+	zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, " order by p.eventid");
 
-	/* get event suppress data */
+	result = zbx_db_select("%s", sql);
+	zbx_free(sql);
+
+	if (NULL == result)
+		goto out;
 
+	zbx_vector_event_suppress_query_ptr_create(&problems);
+	zbx_vector_event_suppress_query_ptr_reserve(&problems, (size_t)index->problems.values_num);
 	zbx_vector_uint64_create(&eventids);
+	eventid_max = index->eventid;
+
+	/* merge sorted problem rows with sorted index, during full synchronization */
+	/* index entries without matching rows are removed from problem table       */
+	while (NULL != (row = zbx_db_fetch(result)))
+	{
+		zbx_uint64_t			eventid;
+		zbx_event_suppress_query_t	*query;
+
+		ZBX_STR2UINT64(eventid, row[0]);
+
+		for (; i < index->problems.values_num && index->problems.values[i]->eventid < eventid; i++)
+		{
+			if (0 != full_sync)
+				zbx_event_suppress_query_free(index->problems.values[i]);
+			else
+				zbx_vector_event_suppress_query_ptr_append(&problems, index->problems.values[i]);
+		}
+
+		if (i < index->problems.values_num && index->problems.values[i]->eventid == eventid)
+		{
+			query = index->problems.values[i++];
+			ZBX_DBROW2UINT64(query->r_eventid, row[2]);
+		}
+		else
+		{
+			query = event_suppress_query_create(row);
+
+			if (SUCCEED == read_tags)
+				zbx_vector_uint64_append(&eventids, eventid);
+		}
+
+		if (eventid_max < query->eventid)
+			eventid_max = query->eventid;
+
+		if (eventid_max < query->r_eventid)
+			eventid_max = query->r_eventid;
+
+		zbx_vector_event_suppress_query_ptr_append(&problems, query);
+	}
+	zbx_db_free_result(result);
+
+	for (; i < index->problems.values_num; i++)
+	{
+		if (0 != full_sync)
+			zbx_event_suppress_query_free(index->problems.values[i]);
+		else
+			zbx_vector_event_suppress_query_ptr_append(&problems, index->problems.values[i]);
+	}
+
+	zbx_vector_event_suppress_query_ptr_destroy(&index->problems);
+	index->problems = problems;
+
+	if (0 != eventids.values_num)
+		problem_index_fetch_tags(&index->problems, &eventids);
+
+	index->tags_loaded = (SUCCEED == read_tags ? 1 : 0);
+	index->eventid_sync = index->eventid;
+	index->eventid = eventid_max;
+
+	if (0 != full_sync)
+		index->resync_time = now + ZBX_PROBLEM_INDEX_RESYNC_PERIOD;
+
+	zbx_vector_uint64_destroy(&eventids);
+out:
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s() problems:%d full:%d", __func__, index->problems.values_num,
+			full_sync);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets maintenance suppress data of events                          *
+ *                                                                            *
+ ******************************************************************************/
+static void	db_get_event_suppress_data(zbx_vector_event_suppress_data_ptr_t *event_data, int process_num,
+		zbx_get_config_forks_f get_forks_cb)
+{
+	zbx_db_row_t			row;
+	zbx_db_result_t			result;
+	zbx_event_suppress_data_t	*data = NULL;
+	zbx_uint64_t			eventid;
+	zbx_uint64_pair_t		pair;
 
 	result = zbx_db_select("select eventid,maintenanceid,suppress_until"
 			" from event_suppress"
@@ -344,14 +551,6 @@ static void	db_get_query_events(zbx_vector_event_suppress_query_ptr_t *event_que
 	{
 		ZBX_STR2UINT64(eventid, row[0]);
 
-		zbx_event_suppress_query_t	event_query_search = {.eventid = eventid};
-
-		if (FAIL == zbx_vector_event_suppress_query_ptr_bsearch(event_queries, &event_query_search,
-				event_suppress_query_eventid_compare))
-		{
-			zbx_vector_uint64_append(&eventids, eventid);
-		}
-
 		if (NULL == data || data->eventid != eventid)
 		{
 			data = (zbx_event_suppress_data_t *)zbx_malloc(NULL, sizeof(zbx_event_suppress_data_t));
@@ -365,8 +564,71 @@ static void	db_get_query_events(zbx_vector_event_suppress_query_ptr_t *event_que
 		zbx_vector_uint64_pair_append(&data->maintenances, pair);
 	}
 	zbx_db_free_result(result);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: Prepares event queries of open and recently resolved problems     *
+ *          that can be affected by maintenances and of resolved problems     *
+ *          with suppress data.                                               *
+ *                                                                            *
+ * Parameters: index           - [IN] problem index                           *
+ *             event_data      - [IN] event suppress data                     *
+ *             read_tags       - [IN] SUCCEED - read tags of resolved events  *
+ *             event_queries   - [OUT] event queries sorted by eventid        *
+ *             resolved_events - [OUT] event queries that are not part of     *
+ *                                     problem index                          *
+ *                                                                            *
+ * Comments: Problem index entries are referenced by event queries, only      *
+ *           resolved events must be freed by caller.                         *
+ *                                                                            *
+ ******************************************************************************/
+static void	db_get_query_events(zbx_problem_index_t *index, const zbx_vector_event_suppress_data_ptr_t *event_data,
+		int read_tags, zbx_vector_event_suppress_query_ptr_t *event_queries,
+		zbx_vector_event_suppress_query_ptr_t *resolved_events)
+{
+	zbx_db_result_t			result;
+	zbx_vector_uint64_t		eventids;
+	const char			*tag_fields, *tag_join;
+	int				i, j;
+
+	zbx_vector_event_suppress_query_ptr_reserve(event_queries, (size_t)index->problems.values_num);
+
+	/* skip resolved problems without suppress data - maintenances cannot be added to them */
+	for (i = 0, j = 0; i < index->problems.values_num; i++)
+	{
+		zbx_event_suppress_query_t	*query = index->problems.values[i];
 
-	/* get missing event data */
+		for (; j < event_data->values_num && event_data->values[j]->eventid < query->eventid; j++)
+			;
+
+		if (0 != query->r_eventid && (j == event_data->values_num ||
+				event_data->values[j]->eventid != query->eventid))
+		{
+			continue;
+		}
+
+		zbx_vector_uint64_clear(&query->hostids);
+		zbx_vector_uint64_clear(&query->functionids);
+		zbx_vector_uint64_pair_clear(&query->maintenances);
+
+		zbx_vector_event_suppress_query_ptr_append(event_queries, query);
+	}
+
+	/* get data of events with suppress data that are not in problem table anymore */
+
+	zbx_vector_uint64_create(&eventids);
+
+	for (i = 0; i < event_data->values_num; i++)
+	{
+		zbx_event_suppress_query_t	event_query_search = {.eventid = event_data->values[i]->eventid};
+
+		if (FAIL == zbx_vector_event_suppress_query_ptr_bsearch(&index->problems, &event_query_search,
+				event_suppress_query_eventid_compare))
+		{
+			zbx_vector_uint64_append(&eventids, event_data->values[i]->eventid);
+		}
+	}
 
 	if (0 != eventids.values_num)
 	{
@@ -375,11 +637,13 @@ static void	db_get_query_events(zbx_vector_event_suppress_query_ptr_t *event_que
 			tag_fields = "t.tag,t.value";
 			tag_join = " left join event_tag t on e.eventid=t.eventid";
 		}
+		else
+		{
+			tag_fields = "null,null";
+			tag_join = "";
+		}
 
-		zbx_vector_uint64_uniq(&eventids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
-
-#define ZBX_EVENT_BATCH_SIZE	1000
-		for (int i = 0; i < eventids.values_num; i += ZBX_EVENT_BATCH_SIZE)
+		for (i = 0; i < eventids.values_num; i += ZBX_EVENT_BATCH_SIZE)
 		{
 			char	*sql = NULL;
 			size_t	sql_alloc = 0, sql_offset = 0;
@@ -399,56 +663,197 @@ static void	db_get_query_events(zbx_vector_event_suppress_query_ptr_t *event_que
 			result = zbx_db_select("%s", sql);
 			zbx_free(sql);
 
-			event_queries_fetch(result, event_queries);
+			event_queries_fetch(result, resolved_events);
 			zbx_db_free_result(result);
 		}
-#undef ZBX_EVENT_BATCH_SIZE
+
+		zbx_vector_event_suppress_query_ptr_append_array(event_queries, resolved_events->values,
+				resolved_events->values_num);
 		zbx_vector_event_suppress_query_ptr_sort(event_queries, ZBX_DEFAULT_UINT64_PTR_COMPARE_FUNC);
 	}
 
 	zbx_vector_uint64_destroy(&eventids);
 }
 
+static int	event_maintenance_compare_by_maintenance(const void *d1, const void *d2)
+{
+	const zbx_uint64_pair_t	*p1 = (const zbx_uint64_pair_t *)d1;
+	const zbx_uint64_pair_t	*p2 = (const zbx_uint64_pair_t *)d2;
+
+	ZBX_RETURN_IF_NOT_EQUAL(p1->second, p2->second);
+	ZBX_RETURN_IF_NOT_EQUAL(p1->first, p2->first);
+
+	return 0;
+}
+
+static int	event_suppress_update_compare(const void *d1, const void *d2)
+{
+	const zbx_event_suppress_update_t	*u1 = (const zbx_event_suppress_update_t *)d1;
+	const zbx_event_suppress_update_t	*u2 = (const zbx_event_suppress_update_t *)d2;
+
+	ZBX_RETURN_IF_NOT_EQUAL(u1->maintenanceid, u2->maintenanceid);
+	ZBX_RETURN_IF_NOT_EQUAL(u1->suppress_until, u2->suppress_until);
+	ZBX_RETURN_IF_NOT_EQUAL(u1->eventid, u2->eventid);
+
+	return 0;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: completes statement with event identifier condition and executes  *
+ *          it if SQL buffer is full                                          *
+ *                                                                            *
+ ******************************************************************************/
+static int	db_event_suppress_execute_batch(char **sql, size_t *sql_alloc, size_t *sql_offset,
+		zbx_vector_uint64_t *eventids)
+{
+	zbx_db_add_condition_alloc(sql, sql_alloc, sql_offset, "eventid", eventids->values, eventids->values_num);
+	zbx_strcpy_alloc(sql, sql_alloc, sql_offset, ";\n");
+	zbx_vector_uint64_clear(eventids);
+
+	return zbx_db_execute_overflowed_sql(sql, sql_alloc, sql_offset);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: deletes event suppress records with statements covering multiple  *
+ *          events of the same maintenance                                    *
+ *                                                                            *
+ * Parameters: sql, sql_alloc, sql_offset - [IN/OUT] SQL buffer               *
+ *             event_maintenances - [IN/OUT] (eventid, maintenanceid) pairs   *
+ *                                                                            *
+ ******************************************************************************/
+static int	db_event_suppress_delete(char **sql, size_t *sql_alloc, size_t *sql_offset,
+		zbx_vector_uint64_pair_t *event_maintenances)
+{
+	zbx_vector_uint64_t	eventids;
+	int			ret = SUCCEED;
+
+	zbx_vector_uint64_create(&eventids);
+	zbx_vector_uint64_pair_sort(event_maintenances, event_maintenance_compare_by_maintenance);
+
+	for (int i = 0; i < event_maintenances->values_num && SUCCEED == ret; i++)
+	{
+		const zbx_uint64_pair_t	*pair = &event_maintenances->values[i];
+
+		zbx_vector_uint64_append(&eventids, pair->first);
+
+		if (i + 1 < event_maintenances->values_num && pair->second == event_maintenances->values[i + 1].second &&
+				ZBX_EVENT_BATCH_SIZE > eventids.values_num)
+		{
+			continue;
+		}
+
+		zbx_snprintf_alloc(sql, sql_alloc, sql_offset, "delete from event_suppress"
+				" where maintenanceid=" ZBX_FS_UI64 " and", pair->second);
+
+		ret = db_event_suppress_execute_batch(sql, sql_alloc, sql_offset, &eventids);
+	}
+
+	zbx_vector_uint64_destroy(&eventids);
+
+	return ret;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: updates event suppress records with statements covering multiple  *
+ *          events of the same maintenance                                    *
+ *                                                                            *
+ * Parameters: sql, sql_alloc, sql_offset - [IN/OUT] SQL buffer               *
+ *             updates                    - [IN/OUT] suppress_until updates   *
+ *                                                                            *
+ ******************************************************************************/
+static int	db_event_suppress_update(char **sql, size_t *sql_alloc, size_t *sql_offset,
+		zbx_vector_event_suppress_update_t *updates)
+{
+	zbx_vector_uint64_t	eventids;
+	int			ret = SUCCEED;
+
+	zbx_vector_uint64_create(&eventids);
+	zbx_vector_event_suppress_update_sort(updates, event_suppress_update_compare);
+
+	for (int i = 0; i < updates->values_num && SUCCEED == ret; i++)
+	{
+		const zbx_event_suppress_update_t	*update = &updates->values[i], *next;
+
+		zbx_vector_uint64_append(&eventids, update->eventid);
+
+		if (i + 1 < updates->values_num && ZBX_EVENT_BATCH_SIZE > eventids.values_num)
+		{
+			next = &updates->values[i + 1];
+
+			if (update->maintenanceid == next->maintenanceid && update->suppress_until == next->suppress_until)
+				continue;
+		}
+
+		zbx_snprintf_alloc(sql, sql_alloc, sql_offset, "update event_suppress set suppress_until=%d"
+				" where maintenanceid=" ZBX_FS_UI64 " and", update->suppress_until,
+				update->maintenanceid);
+
+		ret = db_event_suppress_execute_batch(sql, sql_alloc, sql_offset, &eventids);
+	}
+
+	zbx_vector_uint64_destroy(&eventids);
+
+	return ret;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: Creates/Updates event suppress data to reflect latest maintenance *
  *          changes in cache.                                                 *
  *                                                                            *
- * Parameters: suppressed_num - [OUT]                                         *
+ * Parameters: index          - [IN/OUT] open problem index                   *
+ *             suppressed_num - [OUT]                                         *
+ *             problems_num   - [OUT] number of indexed problems              *
  *             process_num    - [IN]                                          *
  *             get_forks_cb   - [IN]                                          *
  *                                                                            *
  ******************************************************************************/
-static int	db_update_event_suppress_data(int *suppressed_num, int process_num, zbx_get_config_forks_f get_forks_cb)
+static int	db_update_event_suppress_data(zbx_problem_index_t *index, int *suppressed_num, int *problems_num,
+		int process_num, zbx_get_config_forks_f get_forks_cb)
 {
-	zbx_vector_event_suppress_query_ptr_t	event_queries;
+	zbx_vector_event_suppress_query_ptr_t	event_queries, resolved_events;
 	zbx_vector_event_suppress_data_ptr_t	event_data;
-	int					txn_rc = ZBX_DB_OK;
+	zbx_vector_uint64_t			maintenanceids;
+	int					txn_rc = ZBX_DB_OK, read_tags;
 
 	*suppressed_num = 0;
 
 	zbx_vector_event_suppress_query_ptr_create(&event_queries);
+	zbx_vector_event_suppress_query_ptr_create(&resolved_events);
 	zbx_vector_event_suppress_data_ptr_create(&event_data);
+	zbx_vector_uint64_create(&maintenanceids);
+
+	zbx_dc_get_running_maintenanceids(&maintenanceids);
+
+	db_get_event_suppress_data(&event_data, process_num, get_forks_cb);
+
+	/* without running maintenances and suppressed events there is nothing to update */
+	if (0 == maintenanceids.values_num && 0 == event_data.values_num)
+		goto out;
 
-	db_get_query_events(&event_queries, &event_data, process_num, get_forks_cb);
+	read_tags = zbx_dc_maintenance_has_tags();
+
+	problem_index_sync(index, read_tags, process_num, get_forks_cb);
+	db_get_query_events(index, &event_data, read_tags, &event_queries, &resolved_events);
 
 	if (0 != event_queries.values_num)
 	{
-		zbx_db_insert_t			db_insert;
-		char				*sql = NULL;
-		size_t				sql_alloc = 0, sql_offset = 0;
-		int				j, k;
-		zbx_event_suppress_query_t	*query;
-		zbx_event_suppress_data_t	*data;
-		zbx_vector_uint64_pair_t	del_event_maintenances, suppressed;
-		zbx_vector_uint64_t		maintenanceids;
-		zbx_uint64_pair_t		pair;
+		zbx_db_insert_t				db_insert;
+		char					*sql = NULL;
+		size_t					sql_alloc = 0, sql_offset = 0;
+		int					j, k;
+		zbx_event_suppress_query_t		*query;
+		zbx_event_suppress_data_t		*data;
+		zbx_vector_uint64_pair_t		del_event_maintenances, suppressed;
+		zbx_vector_event_suppress_update_t	updates;
+		zbx_uint64_pair_t			pair;
 
-		zbx_vector_uint64_create(&maintenanceids);
 		zbx_vector_uint64_pair_create(&del_event_maintenances);
 		zbx_vector_uint64_pair_create(&suppressed);
-
-		zbx_dc_get_running_maintenanceids(&maintenanceids);
+		zbx_vector_event_suppress_update_create(&updates);
 
 		zbx_db_begin();
 
@@ -509,20 +914,13 @@ static int	db_update_event_suppress_data(int *suppressed_num, int process_num, z
 
 					if (data->maintenances.values[j].second != query->maintenances.values[k].second)
 					{
-						zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
-								"update event_suppress"
-								" set suppress_until=%d"
-								" where eventid=" ZBX_FS_UI64
-									" and maintenanceid=" ZBX_FS_UI64 ";\n",
-									(int)query->maintenances.values[k].second,
-									query->eventid,
-									query->maintenances.values[k].first);
+						zbx_event_suppress_update_t	update = {
+								.eventid = query->eventid,
+								.maintenanceid = query->maintenances.values[k].first,
+								.suppress_until =
+										(int)query->maintenances.values[k].second};
 
-						if (FAIL == zbx_db_execute_overflowed_sql(&sql, &sql_alloc,
-								&sql_offset))
-						{
-							goto cleanup;
-						}
+						zbx_vector_event_suppress_update_append(&updates, update);
 					}
 					j++;
 					k++;
@@ -553,18 +951,11 @@ static int	db_update_event_suppress_data(int *suppressed_num, int process_num, z
 			}
 		}
 
-		for (int i = 0; i < del_event_maintenances.values_num; i++)
-		{
-			zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
-					"delete from event_suppress"
-					" where eventid=" ZBX_FS_UI64
-						" and maintenanceid=" ZBX_FS_UI64 ";\n",
-						del_event_maintenances.values[i].first,
-						del_event_maintenances.values[i].second);
-
-			if (FAIL == zbx_db_execute_overflowed_sql(&sql, &sql_alloc, &sql_offset))
-				goto cleanup;
-		}
+		if (SUCCEED != db_event_suppress_update(&sql, &sql_alloc, &sql_offset, &updates))
+			goto cleanup;
+
+		if (SUCCEED != db_event_suppress_delete(&sql, &sql_alloc, &sql_offset, &del_event_maintenances))
+			goto cleanup;
 
 		if (ZBX_DB_OK > zbx_db_flush_overflowed_sql(sql, sql_offset))
 			goto cleanup;
@@ -590,18 +981,24 @@ cleanup:
 		zbx_db_insert_clean(&db_insert);
 		zbx_free(sql);
 
+		zbx_vector_event_suppress_update_destroy(&updates);
 		zbx_vector_uint64_pair_destroy(&del_event_maintenances);
-		zbx_vector_uint64_destroy(&maintenanceids);
-
 		zbx_vector_uint64_pair_destroy(&suppressed);
 	}
+out:
+	*problems_num = index->problems.values_num;
+
+	zbx_vector_uint64_destroy(&maintenanceids);
 
 	zbx_vector_event_suppress_data_ptr_clear_ext(&event_data, event_suppress_data_free);
 	zbx_vector_event_suppress_data_ptr_destroy(&event_data);
 
-	zbx_vector_event_suppress_query_ptr_clear_ext(&event_queries, zbx_event_suppress_query_free);
+	/* indexed problems are referenced by event queries and are kept for the next update */
 	zbx_vector_event_suppress_query_ptr_destroy(&event_queries);
 
+	zbx_vector_event_suppress_query_ptr_clear_ext(&resolved_events, zbx_event_suppress_query_free);
+	zbx_vector_event_suppress_query_ptr_destroy(&resolved_events);
+
 	return txn_rc;
 }
 
@@ -660,10 +1057,11 @@ ZBX_THREAD_ENTRY(timer_thread, args)
 	char			*info = NULL;
 	size_t			info_alloc = 0, info_offset = 0;
 	const zbx_thread_info_t	*thread_info = &((zbx_thread_args_t *)args)->info;
-	int			events_num, hosts_num, update, idle = 1,
+	int			events_num, hosts_num, problems_num = 0, update, idle = 1,
 				server_num = thread_info->server_num,
 				process_num = thread_info->process_num;
 	unsigned char		process_type = thread_info->process_type;
+	zbx_problem_index_t	problem_index;
 
 	zbx_thread_timer_args	*args_in = (zbx_thread_timer_args *)(((zbx_thread_args_t *)args)->args);
 
@@ -678,6 +1076,8 @@ ZBX_THREAD_ENTRY(timer_thread, args)
 
 	zbx_db_connect(ZBX_DB_CONNECT_NORMAL);
 
+	problem_index_init(&problem_index);
+
 	while (ZBX_IS_RUNNING())
 	{
 		double	sec = zbx_time();
@@ -718,8 +1118,8 @@ ZBX_THREAD_ENTRY(timer_thread, args)
 				if (SUCCEED == update)
 				{
 					zbx_dc_maintenance_set_update_flags();
-					while (ZBX_DB_DOWN == db_update_event_suppress_data(&events_num, process_num,
-							args_in->get_process_forks_cb_arg))
+					while (ZBX_DB_DOWN == db_update_event_suppress_data(&problem_index, &events_num,
+							&problems_num, process_num, args_in->get_process_forks_cb_arg))
 						;
 
 					zbx_dc_maintenance_reset_update_flag(process_num);
@@ -729,8 +1129,8 @@ ZBX_THREAD_ENTRY(timer_thread, args)
 
 				info_offset = 0;
 				zbx_snprintf_alloc(&info, &info_alloc, &info_offset,
-						"updated %d hosts, suppressed %d events in " ZBX_FS_DBL " sec",
-						hosts_num, events_num, zbx_time() - sec);
+						"updated %d hosts, suppressed %d events of %d problems in " ZBX_FS_DBL
+						" sec", hosts_num, events_num, problems_num, zbx_time() - sec);
 
 				if (MAINTENANCE_TIMER_PENDING == maintenance_timer)
 					update_time = (time_t)sec;
@@ -741,13 +1141,13 @@ ZBX_THREAD_ENTRY(timer_thread, args)
 			zbx_setproctitle("%s #%d [%s, processing maintenances]", get_process_type_string(process_type),
 					process_num, info);
 
-			while (ZBX_DB_DOWN == db_update_event_suppress_data(&events_num, process_num,
-					args_in->get_process_forks_cb_arg))
+			while (ZBX_DB_DOWN == db_update_event_suppress_data(&problem_index, &events_num, &problems_num,
+					process_num, args_in->get_process_forks_cb_arg))
 				;
 
 			info_offset = 0;
-			zbx_snprintf_alloc(&info, &info_alloc, &info_offset, "suppressed %d events in " ZBX_FS_DBL
-					" sec", events_num, zbx_time() - sec);
+			zbx_snprintf_alloc(&info, &info_alloc, &info_offset, "suppressed %d events of %d problems in "
+					ZBX_FS_DBL " sec", events_num, problems_num, zbx_time() - sec);
 
 			update_time = (time_t)sec;
 			zbx_dc_maintenance_reset_update_flag(process_num);
@@ -0,0 +1,158 @@
+/*
+** Copyright (C) 2001-2024 Zabbix SIA
+**
+** This program is free software: you can redistribute it and/or modify it under the terms of
+** the GNU Affero General Public License as published by the Free Software Foundation, version 3.
+**
+** This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+** without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+** See the GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License along with this program.
+** If not, see <https://www.gnu.org/licenses/>.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "zbxalgo.h"
+
+typedef struct
+{
+	zbx_uint64_t		id;
+	int			time;
+	zbx_timer_wheel_node_t	node;
+}
+mock_element_t;
+
+static int	mock_element_compare(const void *d1, const void *d2)
+{
+	const zbx_binary_heap_elem_t	*e1 = (const zbx_binary_heap_elem_t *)d1;
+	const zbx_binary_heap_elem_t	*e2 = (const zbx_binary_heap_elem_t *)d2;
+
+	const mock_element_t	*m1 = (const mock_element_t *)e1->data;
+	const mock_element_t	*m2 = (const mock_element_t *)e2->data;
+
+	ZBX_RETURN_IF_NOT_EQUAL(m1->time, m2->time);
+	ZBX_RETURN_IF_NOT_EQUAL(m1->id, m2->id);
+
+	return 0;
+}
+
+static mock_element_t	*mock_find_element(mock_element_t *elements, int elements_num, zbx_uint64_t id)
+{
+	int	i;
+
+	for (i = 0; i < elements_num; i++)
+	{
+		if (elements[i].id == id)
+			return &elements[i];
+	}
+
+	fail_msg("unknown element " ZBX_FS_UI64, id);
+
+	return NULL;
+}
+
+static void	mock_check_due(zbx_timer_wheel_t *wheel, zbx_mock_handle_t hcheck)
+{
+	zbx_mock_handle_t	hdue, hid;
+	mock_element_t		*element;
+	zbx_uint64_t		id;
+	int			now;
+
+	zbx_mock_assert_int_eq("next time", zbx_mock_get_object_member_int(hcheck, "nexttime"),
+			zbx_timer_wheel_get_nexttime(wheel));
+
+	now = zbx_mock_get_object_member_int(hcheck, "now");
+	zbx_timer_wheel_advance(wheel, now);
+
+	hdue = zbx_mock_get_object_member_handle(hcheck, "due");
+
+	while (ZBX_MOCK_END_OF_VECTOR != zbx_mock_vector_element(hdue, &hid))
+	{
+		if (ZBX_MOCK_SUCCESS != zbx_mock_uint64(hid, &id))
+			fail_msg("cannot read due element identifier");
+
+		if (NULL == (element = (mock_element_t *)zbx_timer_wheel_find_min(wheel)))
+			fail_msg("expected due element " ZBX_FS_UI64 " while there are no due elements", id);
+
+		zbx_mock_assert_uint64_eq("due element", id, element->id);
+		zbx_timer_wheel_remove_min(wheel);
+	}
+
+	if (NULL != (element = (mock_element_t *)zbx_timer_wheel_find_min(wheel)))
+		fail_msg("unexpected due element " ZBX_FS_UI64, element->id);
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	zbx_timer_wheel_t	wheel;
+	zbx_mock_handle_t	hdata, helement;
+	mock_element_t		*elements, *element;
+	int			elements_num = 0, i;
+
+	ZBX_UNUSED(state);
+
+	zbx_timer_wheel_create_ext(&wheel, mock_element_compare, ZBX_DEFAULT_MEM_MALLOC_FUNC,
+			ZBX_DEFAULT_MEM_FREE_FUNC);
+
+	hdata = zbx_mock_get_parameter_handle("in.elements");
+
+	while (ZBX_MOCK_END_OF_VECTOR != zbx_mock_vector_element(hdata, &helement))
+		elements_num++;
+
+	elements = (mock_element_t *)zbx_malloc(NULL, sizeof(mock_element_t) * (size_t)elements_num);
+
+	hdata = zbx_mock_get_parameter_handle("in.elements");
+
+	for (i = 0; ZBX_MOCK_END_OF_VECTOR != zbx_mock_vector_element(hdata, &helement); i++)
+	{
+		elements[i].id = zbx_mock_get_object_member_uint64(helement, "id");
+		elements[i].time = zbx_mock_get_object_member_int(helement, "time");
+		zbx_timer_wheel_insert(&wheel, &elements[i].node, &elements[i], elements[i].time);
+	}
+
+	hdata = zbx_mock_get_parameter_handle("in.checks");
+
+	while (ZBX_MOCK_END_OF_VECTOR != zbx_mock_vector_element(hdata, &helement))
+	{
+		zbx_mock_handle_t	hops, hop;
+
+		/* reschedule or remove elements before checking due elements */
+		if (ZBX_MOCK_SUCCESS == zbx_mock_object_member(helement, "updates", &hops))
+		{
+			while (ZBX_MOCK_END_OF_VECTOR != zbx_mock_vector_element(hops, &hop))
+			{
+				element = mock_find_element(elements, elements_num,
+						zbx_mock_get_object_member_uint64(hop, "id"));
+				element->time = zbx_mock_get_object_member_int(hop, "time");
+				zbx_timer_wheel_update(&wheel, &element->node, element->time);
+			}
+		}
+
+		if (ZBX_MOCK_SUCCESS == zbx_mock_object_member(helement, "removes", &hops))
+		{
+			zbx_uint64_t	id;
+
+			while (ZBX_MOCK_END_OF_VECTOR != zbx_mock_vector_element(hops, &hop))
+			{
+				if (ZBX_MOCK_SUCCESS != zbx_mock_uint64(hop, &id))
+					fail_msg("cannot read removed element identifier");
+
+				element = mock_find_element(elements, elements_num, id);
+				zbx_timer_wheel_remove(&wheel, &element->node);
+			}
+		}
+
+		mock_check_due(&wheel, helement);
+	}
+
+	zbx_mock_assert_int_eq("wheel size", (int)zbx_mock_get_parameter_uint64("out.size"),
+			zbx_timer_wheel_size(&wheel));
+
+	zbx_timer_wheel_destroy(&wheel);
+	zbx_free(elements);
+}
@@ -0,0 +1,267 @@
+/*
+** Copyright (C) 2001-2024 Zabbix SIA
+**
+** This program is free software: you can redistribute it and/or modify it under the terms of
+** the GNU Affero General Public License as published by the Free Software Foundation, version 3.
+**
+** This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+** without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+** See the GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License along with this program.
+** If not, see <https://www.gnu.org/licenses/>.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "zbxcommon.h"
+#include "zbxcacheconfig.h"
+#include "zbxalgo.h"
+#include "zbxstr.h"
+#include "dbsnapshot.h"
+
+#define SNAPSHOT_FILE	"dbsnapshot_load.snapshot"
+
+typedef struct
+{
+	unsigned char		object;
+	zbx_vector_str_t	rows;
+}
+mock_rows_t;
+
+static void	mock_write_rows(const char *path)
+{
+	zbx_mock_handle_t	hrows, hrow, hcolumns, hcolumn;
+	zbx_mock_error_t	err;
+	zbx_vector_str_t	columns;
+	const char		*value;
+
+	if (ZBX_MOCK_SUCCESS != zbx_mock_parameter_exists(path))
+		return;
+
+	zbx_vector_str_create(&columns);
+
+	hrows = zbx_mock_get_parameter_handle(path);
+	while (ZBX_MOCK_END_OF_VECTOR != (err = (zbx_mock_vector_element(hrows, &hrow))))
+	{
+		unsigned char	object;
+		zbx_uint64_t	rowid;
+
+		if (ZBX_MOCK_SUCCESS != err)
+			fail_msg("cannot read row: %s", zbx_mock_error_string(err));
+
+		object = (unsigned char)zbx_mock_get_object_member_int(hrow, "object");
+		rowid = zbx_mock_get_object_member_uint64(hrow, "rowid");
+
+		if (ZBX_MOCK_SUCCESS != zbx_mock_object_member(hrow, "columns", &hcolumns))
+		{
+			zbx_dbsnapshot_write_remove(object, rowid);
+			continue;
+		}
+
+		while (ZBX_MOCK_END_OF_VECTOR != (err = (zbx_mock_vector_element(hcolumns, &hcolumn))))
+		{
+			if (ZBX_MOCK_SUCCESS != err || ZBX_MOCK_SUCCESS != zbx_mock_string(hcolumn, &value))
+				fail_msg("cannot read row column");
+
+			zbx_vector_str_append(&columns, (char *)value);
+		}
+
+		zbx_dbsnapshot_write_row(object, rowid, columns.values, columns.values_num);
+		zbx_vector_str_clear(&columns);
+	}
+
+	zbx_vector_str_destroy(&columns);
+}
+
+static void	mock_read_changelog(const char *path, zbx_hashset_t *changelog)
+{
+	zbx_mock_handle_t	hrecords, hrecord;
+	zbx_mock_error_t	err;
+
+	hrecords = zbx_mock_get_parameter_handle(path);
+	while (ZBX_MOCK_END_OF_VECTOR != (err = (zbx_mock_vector_element(hrecords, &hrecord))))
+	{
+		zbx_dbsync_changelog_t	record;
+
+		if (ZBX_MOCK_SUCCESS != err)
+			fail_msg("cannot read changelog record: %s", zbx_mock_error_string(err));
+
+		record.changelogid = zbx_mock_get_object_member_uint64(hrecord, "changelogid");
+		record.clock = zbx_mock_get_object_member_int(hrecord, "clock");
+		zbx_hashset_insert(changelog, &record, sizeof(record));
+	}
+}
+
+/* appends raw records to the snapshot file to simulate interrupted or corrupted writes */
+static void	mock_write_tail(void)
+{
+	zbx_mock_handle_t	hrecords, hrecord;
+	zbx_mock_error_t	err;
+	FILE			*file;
+
+	if (ZBX_MOCK_SUCCESS != zbx_mock_parameter_exists("in.tail"))
+		return;
+
+	if (NULL == (file = fopen(SNAPSHOT_FILE, "ab")))
+		fail_msg("cannot open snapshot file: %s", zbx_strerror(errno));
+
+	hrecords = zbx_mock_get_parameter_handle("in.tail");
+	while (ZBX_MOCK_END_OF_VECTOR != (err = (zbx_mock_vector_element(hrecords, &hrecord))))
+	{
+		unsigned char	type;
+		zbx_uint32_t	size;
+		const char	*data;
+
+		if (ZBX_MOCK_SUCCESS != err)
+			fail_msg("cannot read tail record: %s", zbx_mock_error_string(err));
+
+		type = (unsigned char)zbx_mock_get_object_member_int(hrecord, "type");
+		size = (zbx_uint32_t)zbx_mock_get_object_member_int(hrecord, "size");
+		data = zbx_mock_get_object_member_string(hrecord, "data");
+
+		if (1 != fwrite(&type, sizeof(type), 1, file) || 1 != fwrite(&size, sizeof(size), 1, file) ||
+				strlen(data) != fwrite(data, 1, strlen(data), file))
+		{
+			fail_msg("cannot write snapshot file: %s", zbx_strerror(errno));
+		}
+	}
+
+	fclose(file);
+}
+
+static int	mock_read_row(void *data, zbx_uint64_t rowid, char **row, int columns_num)
+{
+	mock_rows_t	*rows = (mock_rows_t *)data;
+	char		*str = NULL;
+	size_t		str_alloc = 0, str_offset = 0;
+	int		i;
+
+	zbx_snprintf_alloc(&str, &str_alloc, &str_offset, "%d:" ZBX_FS_UI64 ":", rows->object, rowid);
+
+	for (i = 0; i < columns_num; i++)
+	{
+		if (0 != i)
+			zbx_chrcpy_alloc(&str, &str_alloc, &str_offset, ',');
+
+		zbx_strcpy_alloc(&str, &str_alloc, &str_offset, NULL == row[i] ? "NULL" : row[i]);
+	}
+
+	zbx_vector_str_append(&rows->rows, str);
+
+	return SUCCEED;
+}
+
+static void	mock_check_rows(void)
+{
+	zbx_mock_handle_t	hrows, hrow;
+	zbx_mock_error_t	err;
+	mock_rows_t		rows;
+	int			i = 0;
+
+	zbx_vector_str_create(&rows.rows);
+
+	for (rows.object = 1; rows.object <= ZBX_DBSYNC_OBJ_COUNT; rows.object++)
+	{
+		zbx_mock_assert_int_eq("zbx_dbsnapshot_read_rows() return value", SUCCEED,
+				zbx_dbsnapshot_read_rows(rows.object, mock_read_row, &rows));
+	}
+
+	hrows = zbx_mock_get_parameter_handle("out.rows");
+	while (ZBX_MOCK_END_OF_VECTOR != (err = (zbx_mock_vector_element(hrows, &hrow))))
+	{
+		const char	*expected;
+
+		if (ZBX_MOCK_SUCCESS != err || ZBX_MOCK_SUCCESS != zbx_mock_string(hrow, &expected))
+			fail_msg("cannot read expected row");
+
+		if (i >= rows.rows.values_num)
+			fail_msg("missing row \"%s\"", expected);
+
+		zbx_mock_assert_str_eq("restored row", expected, rows.rows.values[i++]);
+	}
+
+	zbx_mock_assert_int_eq("restored rows", i, rows.rows.values_num);
+
+	zbx_vector_str_clear_ext(&rows.rows, zbx_str_free);
+	zbx_vector_str_destroy(&rows.rows);
+}
+
+static void	mock_check_changelog(zbx_hashset_t *changelog)
+{
+	zbx_hashset_t		expected;
+	zbx_hashset_iter_t	iter;
+	zbx_dbsync_changelog_t	*record, *restored;
+
+	zbx_hashset_create(&expected, 100, ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+	mock_read_changelog("out.changelog", &expected);
+
+	zbx_mock_assert_int_eq("restored changelog records", expected.num_data, changelog->num_data);
+
+	zbx_hashset_iter_reset(&expected, &iter);
+	while (NULL != (record = (zbx_dbsync_changelog_t *)zbx_hashset_iter_next(&iter)))
+	{
+		if (NULL == (restored = (zbx_dbsync_changelog_t *)zbx_hashset_search(changelog, record)))
+			fail_msg("missing changelog record " ZBX_FS_UI64, record->changelogid);
+
+		zbx_mock_assert_int_eq("changelog record clock", record->clock, restored->clock);
+	}
+
+	zbx_hashset_destroy(&expected);
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	zbx_hashset_t	changelog;
+	int		commit_clock, ret, time_start, time_end;
+
+	ZBX_UNUSED(state);
+
+	zbx_hashset_create(&changelog, 100, ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+	zbx_dc_set_snapshot_file(SNAPSHOT_FILE);
+	time_start = (int)time(NULL);
+
+	/* write snapshot base, followed by incremental changes */
+
+	zbx_mock_assert_int_eq("zbx_dbsnapshot_begin() return value", SUCCEED, zbx_dbsnapshot_begin(ZBX_DBSYNC_INIT));
+	mock_write_rows("in.base");
+	mock_read_changelog("in.changelog", &changelog);
+	zbx_dbsnapshot_commit(&changelog);
+
+	if (ZBX_MOCK_SUCCESS == zbx_mock_parameter_exists("in.delta"))
+	{
+		zbx_mock_assert_int_eq("zbx_dbsnapshot_begin() return value", SUCCEED,
+				zbx_dbsnapshot_begin(ZBX_DBSYNC_UPDATE));
+		mock_write_rows("in.delta");
+		zbx_dbsnapshot_commit(&changelog);
+	}
+
+	/* simulate restart */
+
+	zbx_dbsnapshot_discard();
+	zbx_hashset_clear(&changelog);
+	mock_write_tail();
+
+	ret = zbx_dbsnapshot_load(&changelog, &commit_clock);
+	time_end = (int)time(NULL);
+
+	zbx_mock_assert_result_eq("zbx_dbsnapshot_load() return value",
+			zbx_mock_str_to_return_code(zbx_mock_get_parameter_string("out.return")), ret);
+
+	if (SUCCEED == ret)
+	{
+		if (commit_clock < time_start || commit_clock > time_end)
+			fail_msg("unexpected commit clock %d", commit_clock);
+
+		mock_check_rows();
+		mock_check_changelog(&changelog);
+	}
+
+	zbx_dbsnapshot_discard();
+	zbx_hashset_destroy(&changelog);
+	zbx_dc_set_snapshot_file(NULL);
+	unlink(SNAPSHOT_FILE);
+}
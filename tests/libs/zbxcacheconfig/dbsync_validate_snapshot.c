@@ -0,0 +1,43 @@
+/*
+** Copyright (C) 2001-2024 Zabbix SIA
+**
+** This program is free software: you can redistribute it and/or modify it under the terms of
+** the GNU Affero General Public License as published by the Free Software Foundation, version 3.
+**
+** This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+** without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+** See the GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License along with this program.
+** If not, see <https://www.gnu.org/licenses/>.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "zbxcommon.h"
+#include "dbsync.h"
+
+void	zbx_mock_test_entry(void **state)
+{
+	int	commit_clock, now, oldest_clock, ret;
+	char	*error = NULL;
+
+	ZBX_UNUSED(state);
+
+	commit_clock = (int)zbx_mock_get_parameter_uint64("in.commit_clock");
+	now = (int)zbx_mock_get_parameter_uint64("in.now");
+	oldest_clock = (int)zbx_mock_get_parameter_uint64("in.oldest_clock");
+
+	ret = zbx_dbsync_validate_snapshot(commit_clock, now, oldest_clock, &error);
+
+	zbx_mock_assert_result_eq("zbx_dbsync_validate_snapshot() return value",
+			zbx_mock_str_to_return_code(zbx_mock_get_parameter_string("out.return")), ret);
+
+	if (SUCCEED != ret && NULL == error)
+		fail_msg("missing error message");
+
+	zbx_free(error);
+}
@@ -18,6 +18,7 @@
 #include "zbxmockutil.h"
 
 #include "zbxnum.h"
+#include "zbxstr.h"
 #include "zbxcacheconfig/user_macro.h"
 #include "um_cache_mock.h"
 
@@ -78,6 +79,24 @@ void	zbx_mock_test_entry(void **state)
 
 	ret = zbx_mock_str_to_return_code(zbx_mock_get_parameter_string("out.result"));
 
+	/* resolution cache must return the same value on both - resolving and cached lookups */
+	for (int i = 0; i < 2; i++)
+	{
+		const char	*value_memo = NULL;
+
+		um_cache_resolve_const_memo(cache, hostids.values, hostids.values_num,
+				zbx_mock_get_parameter_string("in.macro"), ZBX_MACRO_ENV_SECURE, &value_memo);
+
+		if (NULL == value || NULL == value_memo)
+		{
+			if (value != value_memo)
+				fail_msg("Resolution cache value '%s' while expected '%s'", ZBX_NULL2STR(value_memo),
+						ZBX_NULL2STR(value));
+		}
+		else
+			zbx_mock_assert_str_eq("Resolution cache value", value, value_memo);
+	}
+
 	if (SUCCEED != ret)
 	{
 		if (NULL != value)
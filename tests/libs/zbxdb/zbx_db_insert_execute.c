@@ -0,0 +1,104 @@
+/*
+** Copyright (C) 2001-2024 Zabbix SIA
+**
+** This program is free software: you can redistribute it and/or modify it under the terms of
+** the GNU Affero General Public License as published by the Free Software Foundation, version 3.
+**
+** This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+** without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+** See the GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License along with this program.
+** If not, see <https://www.gnu.org/licenses/>.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "zbxdb.h"
+
+static int	pipeline_mode, execute_result, statements_num, pipelined_num;
+
+int	__wrap_zbx_dbconn_pipeline_begin(zbx_dbconn_t *db);
+int	__wrap_zbx_dbconn_pipeline_end(zbx_dbconn_t *db);
+int	__wrap_zbx_dbconn_pipeline_execute_sql(zbx_dbconn_t *db, char **sql, size_t *sql_alloc, size_t *sql_offset);
+int	__wrap_zbx_dbconn_execute(zbx_dbconn_t *db, const char *fmt, ...);
+
+int	__wrap_zbx_dbconn_pipeline_begin(zbx_dbconn_t *db)
+{
+	ZBX_UNUSED(db);
+
+	return pipeline_mode;
+}
+
+int	__wrap_zbx_dbconn_pipeline_end(zbx_dbconn_t *db)
+{
+	ZBX_UNUSED(db);
+
+	if (SUCCEED != pipeline_mode)
+		fail_msg("pipeline end without pipeline mode");
+
+	return ZBX_DB_OK;
+}
+
+int	__wrap_zbx_dbconn_pipeline_execute_sql(zbx_dbconn_t *db, char **sql, size_t *sql_alloc, size_t *sql_offset)
+{
+	ZBX_UNUSED(db);
+	ZBX_UNUSED(sql);
+	ZBX_UNUSED(sql_alloc);
+
+	if (SUCCEED != pipeline_mode)
+		fail_msg("pipelined statement without pipeline mode");
+
+	pipelined_num++;
+	*sql_offset = 0;
+
+	return ZBX_DB_OK == execute_result ? SUCCEED : FAIL;
+}
+
+int	__wrap_zbx_dbconn_execute(zbx_dbconn_t *db, const char *fmt, ...)
+{
+	ZBX_UNUSED(db);
+	ZBX_UNUSED(fmt);
+
+	statements_num++;
+
+	return execute_result;
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	zbx_db_insert_t	db_insert;
+	int		rows_num, data_size, ret;
+	char		*data;
+
+	ZBX_UNUSED(state);
+
+	pipeline_mode = zbx_mock_str_to_return_code(zbx_mock_get_parameter_string("in.pipeline"));
+	execute_result = (SUCCEED == zbx_mock_str_to_return_code(zbx_mock_get_parameter_string("in.execute")) ?
+			ZBX_DB_OK : ZBX_DB_FAIL);
+	rows_num = (int)zbx_mock_get_parameter_uint64("in.rows");
+	data_size = (int)zbx_mock_get_parameter_uint64("in.data_size");
+
+	data = (char *)zbx_malloc(NULL, (size_t)data_size + 1);
+	memset(data, 'x', (size_t)data_size);
+	data[data_size] = '\0';
+
+	zbx_dbconn_prepare_insert(NULL, &db_insert, "task_data", "taskid", "type", "data", (char *)NULL);
+
+	for (int i = 0; i < rows_num; i++)
+		zbx_db_insert_add_values(&db_insert, (zbx_uint64_t)(i + 1), 0, data);
+
+	ret = zbx_db_insert_execute(&db_insert);
+	zbx_db_insert_clean(&db_insert);
+	zbx_free(data);
+
+	zbx_mock_assert_result_eq("zbx_db_insert_execute() return value",
+			zbx_mock_str_to_return_code(zbx_mock_get_parameter_string("out.return")), ret);
+	zbx_mock_assert_int_eq("pipelined statements", (int)zbx_mock_get_parameter_uint64("out.pipelined"),
+			pipelined_num);
+	zbx_mock_assert_int_eq("executed statements", (int)zbx_mock_get_parameter_uint64("out.executed"),
+			statements_num);
+}
@@ -0,0 +1,126 @@
+/*
+** Copyright (C) 2001-2024 Zabbix SIA
+**
+** This program is free software: you can redistribute it and/or modify it under the terms of
+** the GNU Affero General Public License as published by the Free Software Foundation, version 3.
+**
+** This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+** without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+** See the GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License along with this program.
+** If not, see <https://www.gnu.org/licenses/>.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "zbxcommon.h"
+#include "zbxeval.h"
+#include "mock_eval.h"
+
+#include "../../../src/libs/zbxeval/execute.c"
+
+/* trigger function results are numeric variants unless the item has string value */
+static void	mock_convert_functionid_values(zbx_eval_context_t *ctx)
+{
+	int		i;
+	zbx_uint64_t	ui64;
+
+	for (i = 0; i < ctx->stack.values_num; i++)
+	{
+		zbx_eval_token_t	*token = &ctx->stack.values[i];
+
+		if (ZBX_EVAL_TOKEN_FUNCTIONID != token->type || ZBX_VARIANT_STR != token->value.type)
+			continue;
+
+		if (SUCCEED == zbx_is_uint64(token->value.data.str, &ui64))
+		{
+			zbx_variant_clear(&token->value);
+			zbx_variant_set_ui64(&token->value, ui64);
+		}
+		else
+			zbx_variant_convert(&token->value, ZBX_VARIANT_DBL);
+	}
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	zbx_eval_context_t	ctx, ctx_numeric;
+	char			*error = NULL, *error_numeric = NULL;
+	zbx_uint64_t		rules;
+	int			expected_ret, returned_ret, numeric_ret;
+	zbx_variant_t		value, value_numeric;
+	zbx_mock_handle_t	handle;
+
+	ZBX_UNUSED(state);
+
+	rules = mock_eval_read_rules("in.rules");
+	expected_ret = zbx_mock_str_to_return_code(zbx_mock_get_parameter_string("out.result"));
+
+	if (SUCCEED != zbx_eval_parse_expression(&ctx, zbx_mock_get_parameter_string("in.expression"), rules,
+			&error))
+	{
+		fail_msg("failed to parse expression: %s", error);
+	}
+
+	mock_eval_read_values(&ctx, "in.replace");
+	mock_convert_functionid_values(&ctx);
+
+	zbx_eval_copy(&ctx_numeric, &ctx, ctx.expression);
+	eval_init_execute_context(&ctx, NULL, NULL, NULL, NULL);
+	eval_init_execute_context(&ctx_numeric, NULL, NULL, NULL, NULL);
+
+	zbx_variant_set_none(&value);
+	zbx_variant_set_none(&value_numeric);
+
+	returned_ret = eval_execute_tokens(&ctx, &value, &error);
+
+	if (SUCCEED != returned_ret)
+		printf("ERROR: %s\n", error);
+
+	zbx_mock_assert_result_eq("return value", expected_ret, returned_ret);
+
+	numeric_ret = eval_execute_numeric(&ctx_numeric, &value_numeric, &error_numeric);
+
+	if (0 == strcmp(zbx_mock_get_parameter_string("out.numeric"), "yes"))
+	{
+		if (UNKNOWN == numeric_ret)
+			fail_msg("expression was not evaluated by numeric path");
+
+		/* numeric path must give the same results and errors as interpreter */
+		zbx_mock_assert_result_eq("numeric path return value", returned_ret, numeric_ret);
+
+		if (SUCCEED == numeric_ret)
+		{
+			if (ZBX_VARIANT_DBL != value.type || ZBX_VARIANT_DBL != value_numeric.type)
+				fail_msg("expected floating point values while got %s and %s",
+						zbx_variant_type_desc(&value), zbx_variant_type_desc(&value_numeric));
+
+			if (value.data.dbl != value_numeric.data.dbl)
+				fail_msg("numeric path value \"%f\" while interpreter value \"%f\"",
+						value_numeric.data.dbl, value.data.dbl);
+		}
+		else
+			zbx_mock_assert_str_eq("numeric path error", error, error_numeric);
+	}
+	else if (UNKNOWN != numeric_ret)
+		fail_msg("expression was unexpectedly evaluated by numeric path");
+
+	if (SUCCEED == expected_ret)
+	{
+		zbx_mock_assert_str_eq("output value", zbx_mock_get_parameter_string("out.value"),
+				zbx_variant_value_desc(&value));
+	}
+	else if (ZBX_MOCK_SUCCESS == zbx_mock_parameter("out.error", &handle))
+		zbx_mock_assert_str_eq("error", zbx_mock_get_parameter_string("out.error"), error);
+
+	zbx_variant_clear(&value);
+	zbx_variant_clear(&value_numeric);
+	zbx_free(error);
+	zbx_free(error_numeric);
+	zbx_eval_clear(&ctx);
+	zbx_eval_clear(&ctx_numeric);
+}